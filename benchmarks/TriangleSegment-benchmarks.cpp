@@ -0,0 +1,101 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "benchmark-helpers.hpp"
+#include "../src/TriangleSegment.hpp"
+
+#include <random>
+
+namespace {
+
+using SideCrossing = TriangleSegment::SideCrossing;
+
+constexpr const int k_crossing_count = 100000;
+
+struct CrossingCase final {
+    Vector2 inside, outside;
+};
+
+// segments that start near the center, and end just past a side, which is
+// where trackers cross most often
+std::vector<CrossingCase> make_cases(const TriangleSegment & triangle) {
+    std::default_random_engine rng{0x1234};
+    std::uniform_real_distribution<Real> dist{-0.1, 0.1};
+    std::vector<CrossingCase> cases;
+    auto center = triangle.center_in_2d();
+    while (cases.size() != std::size_t(k_crossing_count)) {
+        auto [a, b] = triangle.side_points_in_2d
+            (static_cast<TriangleSide>(cases.size() % 3));
+        auto past_side = a + (b - a)*(0.5 + dist(rng)*4) - (center - a)*0.02;
+        if (triangle.contains_point(past_side)) continue;
+        cases.push_back(CrossingCase{center + Vector2{dist(rng), dist(rng)}, past_side});
+    }
+    return cases;
+}
+
+TriangleSegment make_triangle()
+    { return TriangleSegment{Vector{0, 0, 0}, Vector{1, 0.2, 0}, Vector{0.3, 0.1, 1}}; }
+
+// what crossings were found by before: bisecting on whether the triangle
+// contains points along the segment
+SideCrossing bisect_crossing
+    (const TriangleSegment & triangle, const CrossingCase & case_)
+{
+    auto pos_along_line = [&case_] (Real x)
+        { return case_.inside + x*(case_.outside - case_.inside); };
+    auto [high_fal, low_true] = cul::find_smallest_diff<Real>(
+        [&pos_along_line, &triangle] (Real x)
+        { return !triangle.contains_point(pos_along_line(x)); });
+    return SideCrossing
+        {TriangleSide::k_side_ab, pos_along_line(high_fal),
+         pos_along_line(low_true)};
+}
+
+template <typename Func>
+void run_crossings(BenchmarkReport & report, Func && find_crossing) {
+    auto triangle = make_triangle();
+    auto cases = make_cases(triangle);
+    Real checksum = 0;
+    Stopwatch stopwatch;
+    for (auto & case_ : cases) {
+        auto crossing = find_crossing(triangle, case_);
+        checksum += crossing.inside.x;
+    }
+    auto elapsed = stopwatch.elapsed_nanoseconds();
+    report.add_measurement("crossing-mean", elapsed / k_crossing_count, "ns");
+    // keeps the work from being optimized away
+    report.add_measurement("checksum", checksum, "");
+}
+
+void run_closed_form(BenchmarkReport & report) {
+    run_crossings(report, [] (const TriangleSegment & triangle, const CrossingCase & case_)
+        { return triangle.check_for_side_crossing(case_.inside, case_.outside); });
+}
+
+void run_bisection(BenchmarkReport & report)
+    { run_crossings(report, bisect_crossing); }
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    add_benchmark("side-crossing-closed-form", run_closed_form);
+    add_benchmark("side-crossing-bisection", run_bisection);
+    return 1;
+} ();
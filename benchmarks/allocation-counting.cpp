@@ -0,0 +1,55 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "benchmark-helpers.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// replaces global (unaligned) allocation functions for the whole benchmark
+// executable, so that benchmarks may report how often they allocate
+
+namespace {
+
+std::atomic<std::size_t> s_allocation_count{0};
+
+void * allocate(std::size_t size) {
+    ++s_allocation_count;
+    if (auto * ptr = std::malloc(size ? size : 1))
+        { return ptr; }
+    throw std::bad_alloc{};
+}
+
+} // end of <anonymous> namespace
+
+std::size_t allocation_count() { return s_allocation_count.load(); }
+
+void * operator new (std::size_t size) { return allocate(size); }
+
+void * operator new [] (std::size_t size) { return allocate(size); }
+
+void operator delete (void * ptr) noexcept { std::free(ptr); }
+
+void operator delete [] (void * ptr) noexcept { std::free(ptr); }
+
+void operator delete (void * ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete [] (void * ptr, std::size_t) noexcept { std::free(ptr); }
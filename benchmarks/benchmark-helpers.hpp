@@ -0,0 +1,106 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "../src/Definitions.hpp"
+
+#include <chrono>
+#include <functional>
+
+class BenchmarkReport final {
+public:
+    struct Measurement final {
+        Measurement() {}
+
+        Measurement(std::string && name_, Real value_, const char * unit_):
+            name(std::move(name_)), value(value_), unit(unit_) {}
+
+        std::string name;
+        Real value = 0;
+        const char * unit = "";
+    };
+
+    void add_measurement(std::string && name, Real value, const char * unit)
+        { m_measurements.emplace_back(std::move(name), value, unit); }
+
+    const std::vector<Measurement> & measurements() const
+        { return m_measurements; }
+
+private:
+    std::vector<Measurement> m_measurements;
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkReport &)>;
+
+/// adds a benchmark to be run by the benchmark executable's main
+///
+/// @returns a dummy value, so that this maybe called in a static initializer
+int add_benchmark(const char * name, BenchmarkFunction &&);
+
+/// runs all benchmarks, whose names contain any of the given filters (or all
+/// of them if there are no filters)
+///
+/// @returns exit code for main
+int run_benchmarks(const std::vector<std::string> & filters);
+
+/// @returns how many times global operator new has been called so far, by
+///          any thread
+std::size_t allocation_count();
+
+class Stopwatch final {
+public:
+    Real elapsed_nanoseconds() const {
+        using Nanoseconds = std::chrono::duration<Real, std::nano>;
+        return Nanoseconds{now() - m_start}.count();
+    }
+
+    void reset() { m_start = now(); }
+
+private:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    static TimePoint now() { return std::chrono::steady_clock::now(); }
+
+    TimePoint m_start = now();
+};
+
+/// accumulates samples, so that a mean and a maximum maybe reported
+class SampleAccumulator final {
+public:
+    void add(Real sample) {
+        m_total += sample;
+        m_max = std::max(m_max, sample);
+        ++m_count;
+    }
+
+    Real mean() const { return m_count == 0 ? 0 : m_total / Real(m_count); }
+
+    Real max() const { return m_max; }
+
+    Real total() const { return m_total; }
+
+    int count() const { return m_count; }
+
+private:
+    Real m_total = 0;
+    Real m_max = 0;
+    int m_count = 0;
+};
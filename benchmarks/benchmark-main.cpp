@@ -0,0 +1,91 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "benchmark-helpers.hpp"
+
+#include <iostream>
+
+namespace {
+
+struct BenchmarkEntry final {
+    BenchmarkEntry() {}
+
+    BenchmarkEntry(const char * name_, BenchmarkFunction && function_):
+        name(name_), function(std::move(function_)) {}
+
+    const char * name = "";
+    BenchmarkFunction function;
+};
+
+std::vector<BenchmarkEntry> & benchmarks_list() {
+    // initialization order between translation units is not defined
+    static std::vector<BenchmarkEntry> s_benchmarks;
+    return s_benchmarks;
+}
+
+bool passes_filters
+    (const char * name, const std::vector<std::string> & filters);
+
+} // end of <anonymous> namespace
+
+int add_benchmark(const char * name, BenchmarkFunction && function) {
+    benchmarks_list().emplace_back(name, std::move(function));
+    return 1;
+}
+
+int run_benchmarks(const std::vector<std::string> & filters) {
+    for (auto & benchmark : benchmarks_list()) {
+        if (!passes_filters(benchmark.name, filters)) continue;
+        BenchmarkReport report;
+        try {
+            benchmark.function(report);
+        } catch (std::exception & exp) {
+            std::cerr << benchmark.name << " failed: " << exp.what()
+                      << std::endl;
+            return ~0;
+        }
+        // one measurement per line: "<benchmark> <measurement> <value> <unit>"
+        for (auto & measurement : report.measurements()) {
+            std::cout << benchmark.name << " " << measurement.name << " "
+                      << measurement.value << " " << measurement.unit
+                      << std::endl;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char ** argv) {
+    std::vector<std::string> filters{argv + 1, argv + argc};
+    return run_benchmarks(filters);
+}
+
+namespace {
+
+bool passes_filters
+    (const char * name, const std::vector<std::string> & filters)
+{
+    if (filters.empty()) return true;
+    return std::any_of
+        (filters.begin(), filters.end(),
+         [name] (const std::string & filter)
+         { return std::string{name}.find(filter) != std::string::npos; });
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,149 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/map-director/MapRegionContainer.hpp"
+
+namespace {
+
+constexpr const int k_frame_count = 2000;
+// loaded regions are a square of this many along each side
+constexpr const int k_loaded_side = 16;
+// requests look at a little more than what's loaded
+constexpr const int k_requested_side = 20;
+
+/// the container as it was, keyed by a hasher which xors x and y, for
+/// comparison
+class XorHashedRegionContainer final {
+public:
+    using RegionRefresh = MapRegionContainer::RegionRefresh;
+    using RegionDecayAdder = MapRegionContainer::RegionDecayAdder;
+
+    Optional<RegionRefresh> region_refresh_at
+        (const Vector2I & on_field_position)
+    {
+        auto itr = m_loaded_regions.find(on_field_position);
+        if (itr == m_loaded_regions.end()) return {};
+        return RegionRefresh{itr->second.keep_on_refresh};
+    }
+
+    void decay_regions(RegionDecayAdder & decay_adder) {
+        for (auto itr = m_loaded_regions.begin(); itr != m_loaded_regions.end(); ) {
+            if (itr->second.keep_on_refresh) {
+                itr->second.keep_on_refresh = false;
+                ++itr;
+            } else {
+                decay_adder.add(itr->first,
+                                std::move(itr->second.triangle_grid),
+                                std::move(itr->second.entities));
+                itr = m_loaded_regions.erase(itr);
+            }
+        }
+    }
+
+    void set_region(const Vector2I & on_field_position,
+                    const ScaledTriangleViewGrid & triangle_grid,
+                    std::vector<Entity> && entities)
+    {
+        auto * region = &m_loaded_regions[on_field_position];
+        region->entities = std::move(entities);
+        region->triangle_grid = triangle_grid;
+        region->keep_on_refresh = true;
+    }
+
+private:
+    struct XorHasher final {
+        std::size_t operator () (const Vector2I & r) const {
+            using IntHash = std::hash<int>;
+            return IntHash{}(r.x) ^ IntHash{}(r.y);
+        }
+    };
+
+    struct LoadedMapRegion {
+        std::vector<Entity> entities;
+        ScaledTriangleViewGrid triangle_grid;
+        bool keep_on_refresh = true;
+    };
+
+    std::unordered_map<Vector2I, LoadedMapRegion, XorHasher> m_loaded_regions;
+};
+
+class NullDecayAdder final : public MapRegionContainer::RegionDecayAdder {
+public:
+    void add(const Vector2I &, ScaledTriangleViewGrid &&,
+             std::vector<Entity> &&) final {}
+};
+
+/// Regions are loaded on a square, each frame every region in (a slightly
+/// larger) requested square is looked up, and then regions are decayed.
+///
+/// @param stride tiles between loaded regions, large strides put regions far
+///        apart (and off of the grid)
+template <typename ContainerT>
+void run_refresh_and_decay(BenchmarkReport & report, int stride) {
+    static const Vector2I k_origin{-k_loaded_side*10 / 2, -k_loaded_side*10 / 2};
+    ContainerT container;
+    for (int y = 0; y != k_loaded_side; ++y) {
+    for (int x = 0; x != k_loaded_side; ++x) {
+        container.set_region
+            (k_origin + Vector2I{x, y}*stride, ScaledTriangleViewGrid{}, {});
+    }}
+    NullDecayAdder decay_adder;
+    SampleAccumulator refresh_times;
+    SampleAccumulator decay_times;
+    int refreshed_count = 0;
+    for (int frame = 0; frame != k_frame_count; ++frame) {
+        Stopwatch stopwatch;
+        for (int y = 0; y != k_requested_side; ++y) {
+        for (int x = 0; x != k_requested_side; ++x) {
+            auto refresh = container.region_refresh_at
+                (k_origin + Vector2I{x, y}*stride);
+            if (!refresh) continue;
+            refresh->keep_this_frame();
+            ++refreshed_count;
+        }}
+        refresh_times.add(stopwatch.elapsed_nanoseconds());
+        stopwatch.reset();
+        container.decay_regions(decay_adder);
+        decay_times.add(stopwatch.elapsed_nanoseconds());
+    }
+    report.add_measurement
+        ("refresh-per-lookup",
+         refresh_times.mean() / Real(k_requested_side*k_requested_side), "ns");
+    report.add_measurement("decay-mean", decay_times.mean(), "ns");
+    report.add_measurement
+        ("refreshed", refreshed_count / k_frame_count, "regions");
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    static constexpr int k_far_stride =
+        MapRegionContainer::k_cell_size*MapRegionContainer::k_grid_size;
+    add_benchmark("region-container-xor-hashed", [] (BenchmarkReport & report)
+        { run_refresh_and_decay<XorHashedRegionContainer>(report, 10); });
+    add_benchmark("region-container-grid", [] (BenchmarkReport & report)
+        { run_refresh_and_decay<MapRegionContainer>(report, 10); });
+    add_benchmark("region-container-xor-hashed-far", [] (BenchmarkReport & report)
+        { run_refresh_and_decay<XorHashedRegionContainer>(report, k_far_stride); });
+    add_benchmark("region-container-grid-far", [] (BenchmarkReport & report)
+        { run_refresh_and_decay<MapRegionContainer>(report, k_far_stride); });
+    return 1;
+} ();
@@ -0,0 +1,229 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/map-director/MapRegionTracker.hpp"
+#include "../../src/map-director/RegionLoadRequest.hpp"
+#include "../../src/point-and-plane/DriverComplete.hpp"
+#include "../../src/platform.hpp"
+
+namespace {
+
+using namespace point_and_plane;
+
+constexpr const Size2I k_map_size{256, 32};
+constexpr const Real k_frame_seconds = 1. / 60.;
+constexpr const int k_frame_count = 600;
+// fast enough to cross a seam every second or so
+constexpr const Real k_player_speed = 12;
+// how finely each tile's render model is cut, standing in for the vertex
+// work real tilesets do
+constexpr const int k_tile_mesh_divisions = 12;
+
+/// a flat tile, with a finely divided (and gently rippled) render model
+class MeshedProducableTile final : public ProducableTile {
+public:
+    void operator () (ProducableTileCallbacks & callbacks) const final {
+        callbacks.add_collidable
+            (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{1, 0, -1});
+        callbacks.add_collidable
+            (Vector{0, 0, 0}, Vector{1, 0, -1}, Vector{0, 0, -1});
+        auto model = callbacks.make_render_model();
+        model->load(make_mesh());
+        callbacks.add_entity<SharedPtr<const RenderModel>>(std::move(model));
+    }
+
+private:
+    static RenderModelData make_mesh() {
+        constexpr const int k_row = k_tile_mesh_divisions + 1;
+        RenderModelData data;
+        for (int j = 0; j != k_row; ++j) {
+        for (int i = 0; i != k_row; ++i) {
+            Vector2 t{Real(i) / k_tile_mesh_divisions,
+                      Real(j) / k_tile_mesh_divisions};
+            Real ripple = std::sin(t.x*k_pi*2)*std::cos(t.y*k_pi*2)*0.01;
+            data.vertices.emplace_back(Vector{t.x, ripple, -t.y}, t);
+        }}
+        for (int j = 0; j != k_tile_mesh_divisions; ++j) {
+        for (int i = 0; i != k_tile_mesh_divisions; ++i) {
+            unsigned a = j*k_row + i;
+            for (unsigned el : { a, a + 1, a + k_row + 1,
+                                 a, a + k_row + 1, a + k_row })
+            { data.elements.push_back(el); }
+        }}
+        return data;
+    }
+};
+
+class DriverTaskCallbacks final : public TaskCallbacks {
+public:
+    explicit DriverTaskCallbacks(Driver & driver):
+        m_driver(driver) {}
+
+    void add(const SharedPtr<EveryFrameTask> &) final {}
+
+    void add(const SharedPtr<BackgroundTask> &) final {}
+
+    void add(const Entity &) final { ++m_entity_count; }
+
+    void add(const SharedPtr<TriangleLink> & link) final
+        { m_driver.add_triangle(link); }
+
+    void remove(const SharedPtr<const TriangleLink> & link) final
+        { m_driver.remove_triangle(link); }
+
+    Platform & platform() final { return Platform::null_callbacks(); }
+
+    int entity_count() const { return m_entity_count; }
+
+private:
+    Driver & m_driver;
+    int m_entity_count = 0;
+};
+
+UniquePtr<MapRegion> make_map_region(ProducableTile & tile) {
+    Grid<ProducableTile *> grid;
+    grid.set_size(k_map_size.width, k_map_size.height, &tile);
+    ProducableTileGridStacker stacker;
+    stacker.stack_with(std::move(grid), {});
+    return make_unique<TiledMapRegion>
+        (stacker.to_producables(), ScaleComputation{});
+}
+
+struct RegionLoadingSettings final {
+    int thread_count = 0;
+    /// how many seconds ahead regions are prefetched, zero for none
+    Real prefetch_horizon = 0;
+    /// time budget for region changes each frame, zero for none
+    Real seconds_per_frame = 0;
+    /// memory kept for recently decayed regions, zero for none
+    std::size_t decayed_region_cache_bytes = 0;
+    /// if set, the player is sent back to the start every so often (as a
+    /// restart would)
+    bool teleports = false;
+    /// if set, the player turns around every so often
+    bool paces = false;
+};
+
+/// the player runs along the map, across many region seams
+void run_seam_crossing
+    (BenchmarkReport & report, const RegionLoadingSettings & settings)
+{
+    static constexpr int k_frames_between_teleports = 120;
+    static constexpr int k_frames_between_turns = 90;
+    static const Vector k_start{5, 0, -Real(k_map_size.height) / 2};
+    MeshedProducableTile tile;
+    DriverComplete driver;
+    DriverTaskCallbacks callbacks{driver};
+    SampleAccumulator frame_times;
+    RegionChangeScheduler::Counters counters;
+    DecayedRegionCache::Metrics cache_metrics;
+    {
+    MapRegionTracker tracker
+        {make_map_region(tile), settings.thread_count,
+         settings.seconds_per_frame, settings.decayed_region_cache_bytes};
+    Vector velocity{k_player_speed, 0, 0};
+    Vector position = k_start;
+    for (int frame = 0; frame != k_frame_count; ++frame) {
+        if (settings.teleports && frame % k_frames_between_teleports == 0)
+            { position = k_start; }
+        if (settings.paces && frame != 0 && frame % k_frames_between_turns == 0)
+            { velocity = -velocity; }
+        Stopwatch stopwatch;
+        auto request = RegionLoadRequest::find
+            (position, Optional<Vector>{}, velocity);
+        if (settings.prefetch_horizon > 0) {
+            tracker.process_load_requests
+                (request,
+                 RegionPrefetchPlan::find
+                    (position, velocity, settings.prefetch_horizon, 0.5),
+                 callbacks);
+        } else {
+            tracker.process_load_requests(request, callbacks);
+        }
+        driver.update();
+        frame_times.add(stopwatch.elapsed_nanoseconds());
+        position += velocity*k_frame_seconds;
+    }
+    counters = tracker.region_change_counters();
+    cache_metrics = tracker.decayed_region_metrics();
+    }
+    report.add_measurement("worker-threads", settings.thread_count, "threads");
+    report.add_measurement("prefetch-horizon", settings.prefetch_horizon, "s");
+    report.add_measurement("budget", settings.seconds_per_frame*1e9, "ns");
+    report.add_measurement("frame-mean", frame_times.mean(), "ns");
+    report.add_measurement("frame-max", frame_times.max(), "ns");
+    report.add_measurement
+        ("entities-loaded", callbacks.entity_count(), "entities");
+    report.add_measurement
+        ("deferred-frames", counters.deferred_frames, "frames");
+    report.add_measurement
+        ("deferred-commits", counters.deferred_commits, "regions");
+    report.add_measurement
+        ("deferred-decays", counters.deferred_decays, "regions");
+    report.add_measurement
+        ("budget-overruns", counters.budget_overruns, "frames");
+    report.add_measurement
+        ("cache-hit-rate", cache_metrics.hit_rate()*100, "%");
+    report.add_measurement
+        ("cache-evictions", cache_metrics.evictions, "regions");
+    report.add_measurement
+        ("cache-held", Real(cache_metrics.bytes_held) / 1024, "KiB");
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    static auto add_region_loading = []
+        (const char * name, RegionLoadingSettings settings)
+    {
+        add_benchmark(name, [settings] (BenchmarkReport & report)
+            { run_seam_crossing(report, settings); });
+    };
+    RegionLoadingSettings settings;
+    add_region_loading("region-seams-frame-thread", settings);
+    settings.thread_count = 1;
+    add_region_loading("region-seams-1-worker", settings);
+    settings.thread_count = 2;
+    add_region_loading("region-seams-2-workers", settings);
+    settings.prefetch_horizon = 3;
+    add_region_loading("region-seams-2-workers-prefetch", settings);
+    settings.seconds_per_frame = 0.004;
+    add_region_loading("region-seams-2-workers-prefetch-budgeted", settings);
+
+    RegionLoadingSettings teleports;
+    teleports.teleports = true;
+    add_region_loading("region-teleports-frame-thread", teleports);
+    teleports.seconds_per_frame = 0.004;
+    add_region_loading("region-teleports-frame-thread-budgeted", teleports);
+    teleports.thread_count = 2;
+    add_region_loading("region-teleports-2-workers-budgeted", teleports);
+    teleports.decayed_region_cache_bytes = 16*1024*1024;
+    add_region_loading("region-teleports-2-workers-budgeted-cached", teleports);
+
+    RegionLoadingSettings paces;
+    paces.paces = true;
+    add_region_loading("region-paces-frame-thread", paces);
+    paces.decayed_region_cache_bytes = 16*1024*1024;
+    add_region_loading("region-paces-frame-thread-cached", paces);
+    paces.decayed_region_cache_bytes = 256*1024;
+    add_region_loading("region-paces-frame-thread-small-cache", paces);
+    return 1;
+} ();
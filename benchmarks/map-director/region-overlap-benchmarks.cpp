@@ -0,0 +1,188 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/map-director/CompositeMapRegion.hpp"
+#include "../../src/map-director/RegionLoadRequest.hpp"
+
+namespace {
+
+constexpr const Size2I k_composite_size{256, 256};
+// each sub region is a sub map of this many tiles along each side
+constexpr const int k_sub_map_side = 10;
+constexpr const Real k_frame_seconds = 1. / 60.;
+constexpr const int k_frame_count = 600;
+constexpr const Real k_player_speed = 12;
+
+using MapSubRegionOwnersMap = SubRegionGridStacker::MapSubRegionOwnersMap;
+using MapSubRegionViewGrid = CompositeMapRegion::MapSubRegionViewGrid;
+
+class NullProducableTile final : public ProducableTile {
+public:
+    void operator () (ProducableTileCallbacks &) const final {}
+};
+
+/// counts every rectangle tested, passing tests on to a real request
+class CountingLoadRequest final : public RegionLoadRequestBase {
+public:
+    explicit CountingLoadRequest(const RegionLoadRequest & request):
+        m_request(request) {}
+
+    bool overlaps_with(const RectangleI & tile_rectangle) const final {
+        ++m_test_count;
+        return m_request.overlaps_with(tile_rectangle);
+    }
+
+    Size2I max_region_size() const final
+        { return m_request.max_region_size(); }
+
+    int test_count() const { return m_test_count; }
+
+private:
+    RegionLoadRequest m_request;
+    mutable int m_test_count = 0;
+};
+
+class CountingCollector final : public RegionLoadCollectorBase {
+public:
+    void collect_load_job
+        (const SubRegionPositionFraming &, const ProducableSubGrid &) final
+    { ++m_job_count; }
+
+    int job_count() const { return m_job_count; }
+
+private:
+    int m_job_count = 0;
+};
+
+/// the walk as it was, testing every sub region one at a time, for
+/// comparison
+template <typename Func>
+void for_each_overlap_plainly
+    (const ScaleComputation & scale,
+     const Size2I & region_size,
+     const RegionLoadRequestBase & request,
+     Func && f)
+{
+    auto step_of_ = [] (int length, int max) {
+        if (length < max) return length;
+        return length / (length / max);
+    };
+    Vector2I step
+        {step_of_(region_size.width , request.max_region_size().width ),
+         step_of_(region_size.height, request.max_region_size().height)};
+    Size2I subgrid_size{step.x, step.y};
+    for (Vector2I r; r.x < region_size.width ; r.x += step.x) {
+    for (r.y = 0   ; r.y < region_size.height; r.y += step.y) {
+        RectangleI on_field_rect{scale.of(r), scale.of(subgrid_size)};
+        if (request.overlaps_with(on_field_rect)) f(r);
+    }}
+}
+
+SharedPtr<MapRegion> make_sub_map(ProducableTile & tile) {
+    Grid<ProducableTile *> grid;
+    grid.set_size(k_sub_map_side, k_sub_map_side, &tile);
+    ProducableTileGridStacker stacker;
+    stacker.stack_with(std::move(grid), {});
+    return make_shared<TiledMapRegion>
+        (stacker.to_producables(), ScaleComputation{});
+}
+
+CompositeMapRegion make_composite_map(ProducableTile & tile) {
+    auto sub_map = make_sub_map(tile);
+    auto sub_regions = make_shared<Grid<MapSubRegion>>();
+    sub_regions->set_size
+        (k_composite_size,
+         MapSubRegion{RectangleI{0, 0, k_sub_map_side, k_sub_map_side}, sub_map});
+    MapSubRegionViewGrid::Inserter inserter{sub_regions->size2()};
+    for (; !inserter.filled(); inserter.advance())
+        { inserter.push(&(*sub_regions)(inserter.position())); }
+    MapSubRegionOwnersMap owners{nullptr};
+    owners.insert(sub_regions, std::monostate{});
+    return CompositeMapRegion
+        {make_tuple(inserter.finish(), std::move(owners)),
+         ScaleComputation{k_sub_map_side, 1, k_sub_map_side}};
+}
+
+/// the player runs diagonally across the middle of the composite map
+template <typename Func>
+void run_across_composite_map(BenchmarkReport & report, Func && process) {
+    static const Vector k_start
+        {k_composite_size.width *k_sub_map_side*0.25, 0,
+         -k_composite_size.height*k_sub_map_side*0.25};
+    static const Vector k_velocity
+        {k_player_speed*0.707, 0, -k_player_speed*0.707};
+    SampleAccumulator frame_times;
+    int test_count = 0;
+    int visited_count = 0;
+    Vector position = k_start;
+    for (int frame = 0; frame != k_frame_count; ++frame) {
+        CountingLoadRequest request
+            {RegionLoadRequest::find(position, Optional<Vector>{}, k_velocity)};
+        Stopwatch stopwatch;
+        visited_count += process(request);
+        frame_times.add(stopwatch.elapsed_nanoseconds());
+        test_count += request.test_count();
+        position += k_velocity*k_frame_seconds;
+    }
+    report.add_measurement("frame-mean", frame_times.mean(), "ns");
+    report.add_measurement("frame-max", frame_times.max(), "ns");
+    report.add_measurement
+        ("overlap-tests", Real(test_count) / k_frame_count, "tests");
+    report.add_measurement
+        ("visited", Real(visited_count) / k_frame_count, "regions");
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    static const ScaleComputation k_composite_scale
+        {k_sub_map_side, 1, k_sub_map_side};
+    add_benchmark("region-overlap-256x256-plain-walk", [] (BenchmarkReport & report) {
+        run_across_composite_map(report, [] (const CountingLoadRequest & request) {
+            int visited = 0;
+            for_each_overlap_plainly
+                (k_composite_scale, k_composite_size, request,
+                 [&visited] (const Vector2I &) { ++visited; });
+            return visited;
+        });
+    });
+    add_benchmark("region-overlap-256x256-pyramid", [] (BenchmarkReport & report) {
+        run_across_composite_map(report, [] (const CountingLoadRequest & request) {
+            int visited = 0;
+            RegionPositionFraming{k_composite_scale}.for_each_overlap
+                (k_composite_size, request,
+                 [&visited] (const RegionPositionFraming &, const RectangleI &)
+                 { ++visited; });
+            return visited;
+        });
+    });
+    add_benchmark("region-overlap-256x256-composite-map", [] (BenchmarkReport & report) {
+        NullProducableTile tile;
+        auto composite_map = make_composite_map(tile);
+        run_across_composite_map(report, [&composite_map] (const CountingLoadRequest & request) {
+            CountingCollector collector;
+            composite_map.process_load_request
+                (request, RegionPositionFraming{}, collector);
+            return collector.job_count();
+        });
+    });
+    return 1;
+} ();
@@ -0,0 +1,127 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/point-and-plane/DriverComplete.hpp"
+
+#include <random>
+
+namespace {
+
+using namespace point_and_plane;
+
+constexpr const int k_field_width = 64;
+constexpr const int k_body_count = 256;
+constexpr const int k_frame_count = 120;
+
+class SlideHandler final : public EventHandler {
+public:
+    Variant<Vector2, Vector>
+        on_triangle_hit
+        (const Triangle &, const Vector &, const Vector2 &, const Vector &) const final
+        { return Vector2{}; }
+
+    Variant<Vector, Vector2>
+        on_transfer_absent_link
+        (const Triangle &, const SideCrossing &, const Vector2 &) const final
+        { return Vector2{}; }
+
+    Variant<Vector, TransferOnSegment>
+        on_transfer
+        (const Triangle &, const SideCrossing &, const Triangle &,
+         const Vector &) const final
+        { return TransferOnSegment{Vector2{}, false}; }
+};
+
+void add_field(DriverComplete & driver) {
+    for (int z = 0; z != k_field_width; ++z) {
+    for (int x = 0; x != k_field_width; ++x) {
+        Vector r{Real(x), 0, Real(z)};
+        driver.add_triangle(make_shared<TriangleLink>
+            (r, r + Vector{1, 0, 0}, r + Vector{1, 0, 1}));
+        driver.add_triangle(make_shared<TriangleLink>
+            (r, r + Vector{1, 0, 1}, r + Vector{0, 0, 1}));
+    }}
+    driver.update();
+}
+
+/// bodies hop about in clusters (as baddies near a player might), falling
+/// back toward the ground each frame
+std::vector<State> make_hopping_bodies() {
+    std::default_random_engine rng{0x1234};
+    std::uniform_real_distribution<Real> cluster_dist{4, k_field_width - 4};
+    std::uniform_real_distribution<Real> spread_dist{-2, 2};
+    std::vector<State> states;
+    Vector cluster;
+    for (int i = 0; i != k_body_count; ++i) {
+        if (i % 16 == 0)
+            { cluster = Vector{cluster_dist(rng), 0, cluster_dist(rng)}; }
+        states.emplace_back(InAir{cluster + Vector{spread_dist(rng), 2, spread_dist(rng)}, Vector{}});
+    }
+    return states;
+}
+
+void relaunch(std::vector<State> & states) {
+    for (auto & state : states) {
+        auto r = location_of(state);
+        state = InAir{Vector{r.x, 2, r.z}, Vector{0.01, -0.5, 0.01}};
+    }
+}
+
+template <int k_thread_count>
+void run_stepping(BenchmarkReport & report, bool batched) {
+    DriverComplete driver;
+    add_field(driver);
+    SlideHandler handler;
+    auto states = make_hopping_bodies();
+    std::vector<BodyStep> steps;
+    for (auto & state : states)
+        { steps.emplace_back(&state, &handler); }
+    SampleAccumulator frame_times;
+    for (int frame = 0; frame != k_frame_count; ++frame) {
+        relaunch(states);
+        Stopwatch stopwatch;
+        if (batched) {
+            driver.step_all
+                (View{steps.data(), steps.data() + steps.size()},
+                 k_thread_count);
+        } else {
+            for (auto & state : states)
+                { state = driver(state, handler); }
+        }
+        frame_times.add(stopwatch.elapsed_nanoseconds());
+    }
+    report.add_measurement("bodies", k_body_count, "bodies");
+    report.add_measurement("frame-mean", frame_times.mean(), "ns");
+    report.add_measurement
+        ("body-mean", frame_times.mean() / k_body_count, "ns");
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    add_benchmark("step-each",
+                  [] (BenchmarkReport & report) { run_stepping<1>(report, false); });
+    add_benchmark("step-all",
+                  [] (BenchmarkReport & report) { run_stepping<1>(report, true); });
+    add_benchmark("step-all-4-threads",
+                  [] (BenchmarkReport & report) { run_stepping<4>(report, true); });
+    return 1;
+} ();
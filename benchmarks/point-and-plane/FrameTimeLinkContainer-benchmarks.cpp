@@ -0,0 +1,179 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/point-and-plane/FrameTimeLinkContainer.hpp"
+
+namespace {
+
+using TriangleLinks = std::vector<SharedPtr<const TriangleLink>>;
+
+constexpr const int k_region_size = 8;
+constexpr const int k_map_regions_width = 48;
+constexpr const int k_load_radius = 2;
+// 12 units per second (max willed speed) at 60 frames per second
+constexpr const Real k_player_step = 12. / 60.;
+
+/// The old approach: every change to the set of live triangles repopulates
+/// the entire spatial map.
+class RepopulatingLinkContainer final {
+public:
+    void defer_addition_of(const SharedPtr<const TriangleLink> & link) {
+        m_links.push_back(link);
+        m_dirty = true;
+    }
+
+    void defer_removal_of(const SharedPtr<const TriangleLink> & link) {
+        auto itr = std::find(m_links.begin(), m_links.end(), link);
+        if (itr == m_links.end()) return;
+        *itr = m_links.back();
+        m_links.pop_back();
+        m_dirty = true;
+    }
+
+    void update() {
+        if (!m_dirty) return;
+        m_spm.populate(m_links);
+        m_dirty = false;
+    }
+
+    auto view_for(const Vector & a, const Vector & b) const
+        { return m_spm.view_for(a, b); }
+
+private:
+    TriangleLinks m_links;
+    bool m_dirty = false;
+    ProjectedSpatialMap m_spm;
+};
+
+class StreamingMap final {
+public:
+    StreamingMap() {
+        m_regions.set_size(k_map_regions_width, k_map_regions_width);
+        for (Vector2I r; r != m_regions.end_position(); r = m_regions.next(r)) {
+            m_regions(r) = make_region_links(r);
+        }
+    }
+
+    /// moves the loaded window, adding/removing whole regions to/from the
+    /// container
+    template <typename Container>
+    int move_window_to(const Vector & player_location, Container & container) {
+        Vector2I player_region
+            {int(std::floor(player_location.x / k_region_size)),
+             int(std::floor(player_location.z / k_region_size))};
+        RectangleI new_window
+            {player_region.x - k_load_radius, player_region.y - k_load_radius,
+             k_load_radius*2 + 1, k_load_radius*2 + 1};
+        int changed = 0;
+        for_each_region_in(m_window, [&] (const Vector2I & r) {
+            if (contains(new_window, r)) return;
+            for (auto & link : m_regions(r))
+                { container.defer_removal_of(link); }
+            changed += int(m_regions(r).size());
+        });
+        for_each_region_in(new_window, [&] (const Vector2I & r) {
+            if (contains(m_window, r)) return;
+            for (auto & link : m_regions(r))
+                { container.defer_addition_of(link); }
+            changed += int(m_regions(r).size());
+        });
+        m_window = new_window;
+        return changed;
+    }
+
+    static Real height_at(Real x, Real z)
+        { return std::sin(x*0.1)*2 + std::cos(z*0.07)*2; }
+
+private:
+    static bool contains(const RectangleI & rect, const Vector2I & r) {
+        return    r.x >= rect.left && r.x < rect.left + rect.width
+               && r.y >= rect.top  && r.y < rect.top  + rect.height;
+    }
+
+    static TriangleLinks make_region_links(const Vector2I & region) {
+        TriangleLinks links;
+        auto point_at = [] (int x, int z)
+            { return Vector{Real(x), height_at(x, z), Real(z)}; };
+        for (int z = 0; z != k_region_size; ++z) {
+        for (int x = 0; x != k_region_size; ++x) {
+            int tx = region.x*k_region_size + x;
+            int tz = region.y*k_region_size + z;
+            links.push_back(make_shared<TriangleLink>
+                (point_at(tx, tz), point_at(tx + 1, tz), point_at(tx + 1, tz + 1)));
+            links.push_back(make_shared<TriangleLink>
+                (point_at(tx, tz), point_at(tx + 1, tz + 1), point_at(tx, tz + 1)));
+        }}
+        return links;
+    }
+
+    template <typename Func>
+    void for_each_region_in(const RectangleI & rect, Func && f) const {
+        for (int y = rect.top; y != rect.top + rect.height; ++y) {
+        for (int x = rect.left; x != rect.left + rect.width; ++x) {
+            Vector2I r{x, y};
+            if (m_regions.has_position(r)) f(r);
+        }}
+    }
+
+    Grid<TriangleLinks> m_regions;
+    RectangleI m_window;
+};
+
+template <typename Container>
+void run_streaming_walk(BenchmarkReport & report) {
+    StreamingMap map;
+    Container container;
+    SampleAccumulator update_times, streaming_update_times, candidates;
+    Stopwatch stopwatch;
+    const Real map_width = k_map_regions_width*k_region_size;
+    for (Real t = 1; t < map_width - 1; t += k_player_step) {
+        // walk diagonally across the whole map
+        Vector player{t, StreamingMap::height_at(t, t) + 0.5, t};
+        int changed = map.move_window_to(player, container);
+
+        stopwatch.reset();
+        container.update();
+        auto elapsed = stopwatch.elapsed_nanoseconds();
+        update_times.add(elapsed);
+        if (changed) streaming_update_times.add(elapsed);
+
+        // a typical freebody query: falling a little, while moving forward
+        auto view = container.view_for
+            (player, player + Vector{k_player_step, -1, k_player_step});
+        candidates.add(Real(std::distance(view.begin(), view.end())));
+    }
+    report.add_measurement("frames", update_times.count(), "frames");
+    report.add_measurement("update-mean", update_times.mean(), "ns");
+    report.add_measurement("update-max", update_times.max(), "ns");
+    report.add_measurement
+        ("streaming-update-mean", streaming_update_times.mean(), "ns");
+    report.add_measurement("candidates-per-query", candidates.mean(), "links");
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    add_benchmark("streaming-walk-repopulating",
+                  run_streaming_walk<RepopulatingLinkContainer>);
+    add_benchmark("streaming-walk-incremental",
+                  run_streaming_walk<FrameTimeLinkContainer>);
+    return 1;
+} ();
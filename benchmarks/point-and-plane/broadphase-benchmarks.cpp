@@ -0,0 +1,141 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/point-and-plane/FrameTimeLinkContainer.hpp"
+
+#include <random>
+
+namespace {
+
+using TriangleLinks = std::vector<SharedPtr<const TriangleLink>>;
+
+constexpr const int k_query_count = 20000;
+// about how far a body moves in one frame, while falling
+constexpr const Real k_query_length = 0.4;
+
+/// A wide, hilly field of tiles; it sprawls in two directions at once, which
+/// no one projection line divides well.
+TriangleLinks make_field(int width) {
+    TriangleLinks links;
+    auto point_at = [] (int x, int z) {
+        return Vector{Real(x), std::sin(x*0.1)*2 + std::cos(z*0.07)*2,
+                      Real(z)};
+    };
+    for (int z = 0; z != width; ++z) {
+    for (int x = 0; x != width; ++x) {
+        links.push_back(make_shared<TriangleLink>
+            (point_at(x, z), point_at(x + 1, z), point_at(x + 1, z + 1)));
+        links.push_back(make_shared<TriangleLink>
+            (point_at(x, z), point_at(x + 1, z + 1), point_at(x, z + 1)));
+    }}
+    return links;
+}
+
+/// Flat floors stacked on top of each other, the same footprint all the way
+/// up.
+TriangleLinks make_tower(int width, int floors) {
+    TriangleLinks links;
+    for (int y = 0; y != floors; ++y) {
+    for (int z = 0; z != width; ++z) {
+    for (int x = 0; x != width; ++x) {
+        Vector r{Real(x), Real(y*4), Real(z)};
+        links.push_back(make_shared<TriangleLink>
+            (r, r + Vector{1, 0, 0}, r + Vector{1, 0, 1}));
+        links.push_back(make_shared<TriangleLink>
+            (r, r + Vector{1, 0, 1}, r + Vector{0, 0, 1}));
+    }}}
+    return links;
+}
+
+template <typename Container>
+void run_broadphase_queries
+    (BenchmarkReport & report, const TriangleLinks & links,
+     const Vector & low, const Vector & high)
+{
+    Container container;
+    Stopwatch stopwatch;
+    for (auto & link : links)
+        { container.defer_addition_of(link); }
+    container.update();
+    report.add_measurement("build", stopwatch.elapsed_nanoseconds(), "ns");
+
+    std::default_random_engine rng{0x1234};
+    std::uniform_real_distribution<Real> x_dist{low.x, high.x};
+    std::uniform_real_distribution<Real> y_dist{low.y, high.y};
+    std::uniform_real_distribution<Real> z_dist{low.z, high.z};
+    std::uniform_real_distribution<Real> displacement_dist
+        {-k_query_length, k_query_length};
+    std::vector<Tuple<Vector, Vector>> queries;
+    queries.reserve(k_query_count);
+    for (int i = 0; i != k_query_count; ++i) {
+        Vector a{x_dist(rng), y_dist(rng), z_dist(rng)};
+        Vector displacement
+            {displacement_dist(rng), -k_query_length, displacement_dist(rng)};
+        queries.emplace_back(a, a + displacement);
+    }
+
+    std::size_t candidates = 0;
+    stopwatch.reset();
+    for (auto & [a, b] : queries) {
+        auto view = container.view_for(a, b);
+        candidates += std::size_t(std::distance(view.begin(), view.end()));
+    }
+    auto elapsed = stopwatch.elapsed_nanoseconds();
+    report.add_measurement("links", Real(links.size()), "links");
+    report.add_measurement("query-mean", elapsed / k_query_count, "ns");
+    report.add_measurement
+        ("candidates-per-query", Real(candidates) / k_query_count, "links");
+}
+
+template <typename Container>
+void run_field_queries(BenchmarkReport & report) {
+    static constexpr const int k_width = 256;
+    static const auto links = make_field(k_width);
+    run_broadphase_queries<Container>
+        (report, links, Vector{0, -4, 0}, Vector{k_width, 4, k_width});
+}
+
+template <typename Container>
+void run_tower_queries(BenchmarkReport & report) {
+    static constexpr const int k_width = 32;
+    static constexpr const int k_floors = 64;
+    static const auto links = make_tower(k_width, k_floors);
+    run_broadphase_queries<Container>
+        (report, links, Vector{0, 0, 0}, Vector{k_width, k_floors*4, k_width});
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    add_benchmark("broadphase-field-projected",
+                  run_field_queries<FrameTimeLinkContainer>);
+    add_benchmark("broadphase-field-grid",
+                  run_field_queries<FrameTimeLinkGrid>);
+    add_benchmark("broadphase-field-tree",
+                  run_field_queries<FrameTimeLinkTree>);
+    add_benchmark("broadphase-tower-projected",
+                  run_tower_queries<FrameTimeLinkContainer>);
+    add_benchmark("broadphase-tower-grid",
+                  run_tower_queries<FrameTimeLinkGrid>);
+    add_benchmark("broadphase-tower-tree",
+                  run_tower_queries<FrameTimeLinkTree>);
+    return 1;
+} ();
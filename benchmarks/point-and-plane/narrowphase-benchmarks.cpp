@@ -0,0 +1,102 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/point-and-plane/PackedTriangleBatch.hpp"
+
+#include <random>
+
+namespace {
+
+constexpr const int k_query_count = 20000;
+// about how many candidates a broadphase query returns
+constexpr const int k_candidate_count = 32;
+
+std::vector<TriangleSegment> make_candidates() {
+    std::vector<TriangleSegment> triangles;
+    for (int i = 0; i != k_candidate_count / 2; ++i) {
+        Vector r{Real(i % 4), 0, Real(i / 4)};
+        triangles.emplace_back(r, r + Vector{1, 0, 0}, r + Vector{1, 0, 1});
+        triangles.emplace_back(r, r + Vector{1, 0, 1}, r + Vector{0, 0, 1});
+    }
+    return triangles;
+}
+
+std::vector<Tuple<Vector, Vector>> make_queries() {
+    std::default_random_engine rng{0x1234};
+    std::uniform_real_distribution<Real> dist{0, 4};
+    std::vector<Tuple<Vector, Vector>> queries;
+    for (int i = 0; i != k_query_count; ++i) {
+        Vector a{dist(rng), 0.2, dist(rng)};
+        queries.emplace_back(a, a + Vector{0.1, -0.4, 0.1});
+    }
+    return queries;
+}
+
+void run_scalar(BenchmarkReport & report) {
+    auto triangles = make_candidates();
+    auto queries = make_queries();
+    int hits = 0;
+    Stopwatch stopwatch;
+    for (auto & [a, b] : queries) {
+        for (auto & triangle : triangles) {
+            if (cul::is_solution(triangle.limit_with_intersection(a, b).intersection))
+                { ++hits; }
+        }
+    }
+    auto elapsed = stopwatch.elapsed_nanoseconds();
+    report.add_measurement("query-mean", elapsed / k_query_count, "ns");
+    report.add_measurement("hits-per-query", Real(hits) / k_query_count, "triangles");
+}
+
+void run_packed(BenchmarkReport & report) {
+    auto triangles = make_candidates();
+    auto queries = make_queries();
+    int hits = 0, exact_tests = 0;
+    PackedTriangleBatch batch;
+    Stopwatch stopwatch;
+    for (auto & [a, b] : queries) {
+        for (std::size_t i = 0; i < triangles.size(); i += PackedTriangleBatch::k_lane_count) {
+            batch.clear();
+            for (std::size_t j = i; j != triangles.size() && !batch.is_full(); ++j)
+                { batch.push(triangles[j]); }
+            auto may_hit = batch.possibly_hit_by(a, b);
+            for (int j = 0; j != batch.size(); ++j) {
+                if (!(may_hit & (1u << j))) continue;
+                ++exact_tests;
+                if (cul::is_solution(triangles[i + j].limit_with_intersection(a, b).intersection))
+                    { ++hits; }
+            }
+        }
+    }
+    auto elapsed = stopwatch.elapsed_nanoseconds();
+    report.add_measurement("query-mean", elapsed / k_query_count, "ns");
+    report.add_measurement("hits-per-query", Real(hits) / k_query_count, "triangles");
+    report.add_measurement
+        ("exact-tests-per-query", Real(exact_tests) / k_query_count, "triangles");
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    add_benchmark("narrowphase-scalar", run_scalar);
+    add_benchmark("narrowphase-packed", run_packed);
+    return 1;
+} ();
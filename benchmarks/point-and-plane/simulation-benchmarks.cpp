@@ -0,0 +1,382 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../benchmark-helpers.hpp"
+#include "../../src/point-and-plane/DriverComplete.hpp"
+#include "../../src/point-and-plane/HashedLinkGrid.hpp"
+#include "../../src/map-director/twist-loop-filler/twist-geometry-helpers.hpp"
+
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+using namespace point_and_plane;
+using LinkPtr = SharedPtr<TriangleLink>;
+
+constexpr const Real k_frame_seconds = 1. / 60.;
+constexpr const int k_frame_count = 240;
+constexpr const Vector k_sim_gravity{0, -10, 0};
+// bodies walk about at this speed, before sliding or falling changes it
+constexpr const Real k_walk_speed = 3;
+
+/// a standalone copy of what the game does with bodies: land on and stick
+/// to what's hit, walk across to neighbors, and fall off of open edges
+class WalkingHandler final : public EventHandler {
+public:
+    explicit WalkingHandler(Vector & velocity):
+        m_velocity(&velocity) {}
+
+    Variant<Vector2, Vector>
+        on_triangle_hit
+        (const Triangle & triangle, const Vector &, const Vector2 & inside,
+         const Vector & next) const final
+    {
+        *m_velocity = project_onto_plane(*m_velocity, triangle.normal());
+        return triangle.closest_point(next) - inside;
+    }
+
+    Variant<Vector, Vector2>
+        on_transfer_absent_link
+        (const Triangle & triangle, const SideCrossing & crossing,
+         const Vector2 & projected_new_location) const final
+    {
+        return   triangle.point_at(projected_new_location)
+               - triangle.point_at(crossing.outside);
+    }
+
+    Variant<Vector, TransferOnSegment>
+        on_transfer
+        (const Triangle & original, const SideCrossing & crossing,
+         const Triangle & next, const Vector & new_loc) const final
+    {
+        auto outside = original.point_at(crossing.outside);
+        auto rv = next.closest_point(new_loc) - next.closest_point(outside);
+        return make_tuple(rv*0.9, true);
+    }
+
+private:
+    Vector * m_velocity;
+};
+
+struct SimulationScene final {
+    std::vector<LinkPtr> links;
+    BoundingBox bounds;
+};
+
+struct Body final {
+    State state;
+    Vector velocity;
+};
+
+using CandidateCounter =
+    Variant<FrameTimeLinkContainer, FrameTimeLinkGrid, FrameTimeLinkTree>;
+
+struct SimulationCounts final {
+    int landings = 0;
+    int transfers = 0;
+    int falls = 0;
+    int respawns = 0;
+    std::size_t queries = 0;
+    std::size_t candidates = 0;
+};
+
+SimulationScene make_flat_grid(int width);
+
+SimulationScene make_slope_field(int width);
+
+SimulationScene make_twist_loop(int length);
+
+/// attaches every pair of triangles sharing a side
+void link_neighbors(const std::vector<LinkPtr> &);
+
+std::vector<Body> make_bodies(const BoundingBox &, int count);
+
+void run_simulation
+    (BenchmarkReport &, const SimulationScene &, int body_count,
+     BroadphaseType);
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_benchmarks = [] {
+    // names read: <scene>-<size>-<bodies>[-<broadphase>]
+    add_benchmark("simulation-flat-32-256", [] (BenchmarkReport & report)
+        { run_simulation(report, make_flat_grid(32), 256, BroadphaseType::projected_partition); });
+    add_benchmark("simulation-flat-128-1024", [] (BenchmarkReport & report)
+        { run_simulation(report, make_flat_grid(128), 1024, BroadphaseType::projected_partition); });
+    add_benchmark("simulation-flat-128-1024-grid", [] (BenchmarkReport & report)
+        { run_simulation(report, make_flat_grid(128), 1024, BroadphaseType::hashed_grid); });
+    add_benchmark("simulation-flat-128-1024-tree", [] (BenchmarkReport & report)
+        { run_simulation(report, make_flat_grid(128), 1024, BroadphaseType::bounding_box_tree); });
+    add_benchmark("simulation-slopes-64-512", [] (BenchmarkReport & report)
+        { run_simulation(report, make_slope_field(64), 512, BroadphaseType::projected_partition); });
+    add_benchmark("simulation-twist-loop-24-128", [] (BenchmarkReport & report)
+        { run_simulation(report, make_twist_loop(24), 128, BroadphaseType::projected_partition); });
+    return 1;
+} ();
+
+namespace {
+
+SimulationScene make_height_field(int width, Real (*height_at)(Real, Real)) {
+    SimulationScene scene;
+    auto point_at = [height_at] (int x, int z)
+        { return Vector{Real(x), height_at(x, z), Real(z)}; };
+    for (int z = 0; z != width; ++z) {
+    for (int x = 0; x != width; ++x) {
+        auto a = point_at(x, z), b = point_at(x + 1, z);
+        auto c = point_at(x + 1, z + 1), d = point_at(x, z + 1);
+        scene.links.push_back(make_shared<TriangleLink>(a, b, c));
+        scene.links.push_back(make_shared<TriangleLink>(a, c, d));
+    }}
+    scene.bounds = BoundingBox{point_at(0, 0), point_at(width, width)};
+    for (auto & link : scene.links) {
+        scene.bounds = BoundingBox::make_union
+            (scene.bounds, BoundingBox::make_for(link->segment()));
+    }
+    link_neighbors(scene.links);
+    return scene;
+}
+
+SimulationScene make_flat_grid(int width)
+    { return make_height_field(width, [] (Real, Real) { return Real(0); }); }
+
+SimulationScene make_slope_field(int width) {
+    return make_height_field(width, [] (Real x, Real z)
+        { return Real(std::sin(x*0.3)*2 + std::cos(z*0.2)*3); });
+}
+
+SimulationScene make_twist_loop(int length) {
+    class NoTexturing final : public TexturingAdapter {
+        Vector2 operator() (const Vector2 &) const final { return Vector2{}; }
+    };
+    Size2I twisty_size{2, length};
+    auto geometry = make_twisty_geometry_for
+        (twisty_size, TwistDirection::left, TwistPathDirection::north_south,
+         NoTexturing{}, 2);
+    SimulationScene scene;
+    bool has_bounds = false;
+    for (Vector2I r; r != geometry.end_position(); r = geometry.next(r)) {
+        for (auto & triangle : geometry(r)) {
+            auto link = make_shared<TriangleLink>
+                (triangle[0].position, triangle[1].position,
+                 triangle[2].position);
+            auto box = BoundingBox::make_for(link->segment());
+            scene.bounds = has_bounds ?
+                BoundingBox::make_union(scene.bounds, box) : box;
+            has_bounds = true;
+            scene.links.emplace_back(std::move(link));
+        }
+    }
+    link_neighbors(scene.links);
+    return scene;
+}
+
+void link_neighbors(const std::vector<LinkPtr> & links) {
+    // the benchmark's own broadphase, candidates for sharing a side are any
+    // whose boxes overlap
+    HashedLinkGrid grid;
+    std::unordered_map<const TriangleLink *, LinkPtr> mutable_links;
+    for (auto & link : links) {
+        grid.insert(link);
+        mutable_links.emplace(link.get(), link);
+    }
+    for (auto & link : links) {
+        auto box = BoundingBox::make_for(link->segment());
+        for (auto & other : grid.view_for(box)) {
+            if (other.get() <= link.get()) continue;
+            TriangleLink::attach_unattached_matching_points
+                (link, mutable_links[other.get()]);
+        }
+    }
+}
+
+Vector random_spawn_point
+    (std::default_random_engine & rng, const BoundingBox & bounds)
+{
+    std::uniform_real_distribution<Real> x_dist{bounds.low.x, bounds.high.x};
+    std::uniform_real_distribution<Real> z_dist{bounds.low.z, bounds.high.z};
+    std::uniform_real_distribution<Real> y_dist{1, 4};
+    return Vector{x_dist(rng), bounds.high.y + y_dist(rng), z_dist(rng)};
+}
+
+Vector random_walk_velocity(std::default_random_engine & rng) {
+    std::uniform_real_distribution<Real> angle_dist{0, k_pi*2};
+    auto angle = angle_dist(rng);
+    return Vector{std::cos(angle), 0, std::sin(angle)}*k_walk_speed;
+}
+
+std::vector<Body> make_bodies(const BoundingBox & bounds, int count) {
+    std::default_random_engine rng{0x1234};
+    std::vector<Body> bodies;
+    bodies.reserve(count);
+    for (int i = 0; i != count; ++i) {
+        bodies.push_back(Body
+            {InAir{random_spawn_point(rng, bounds), Vector{}},
+             random_walk_velocity(rng)});
+    }
+    return bodies;
+}
+
+/// turns velocities into displacements, like the game's velocity systems
+void set_displacements(std::vector<Body> & bodies) {
+    for (auto & body : bodies) {
+        if (auto * in_air = get_if<InAir>(&body.state)) {
+            body.velocity += k_sim_gravity*k_frame_seconds;
+            in_air->displacement = body.velocity*k_frame_seconds;
+        } else if (auto * on_segment = get_if<OnSegment>(&body.state)) {
+            const auto & triangle = on_segment->segment;
+            body.velocity = project_onto_plane
+                (body.velocity + k_sim_gravity*k_frame_seconds,
+                 triangle.normal());
+            auto location = triangle.point_at(on_segment->location);
+            on_segment->displacement =
+                  triangle.closest_point(location + body.velocity*k_frame_seconds)
+                - on_segment->location;
+        }
+    }
+}
+
+void count_changes
+    (const State & before, const State & after, SimulationCounts & counts)
+{
+    auto * on_before = get_if<OnSegment>(&before);
+    auto * on_after  = get_if<OnSegment>(&after );
+    if (!on_before && on_after) {
+        ++counts.landings;
+    } else if (on_before && !on_after) {
+        ++counts.falls;
+    } else if (on_before && on_after && on_before->link_id != on_after->link_id) {
+        ++counts.transfers;
+    }
+}
+
+/// the driver's broadphase is private, so candidates are counted with a
+/// matching container of the benchmark's own
+CandidateCounter make_candidate_counter
+    (BroadphaseType type, const SimulationScene & scene)
+{
+    auto counter = [type] () -> CandidateCounter {
+        switch (type) {
+        case BroadphaseType::projected_partition: return FrameTimeLinkContainer{};
+        case BroadphaseType::hashed_grid        : return FrameTimeLinkGrid{};
+        case BroadphaseType::bounding_box_tree  : return FrameTimeLinkTree{};
+        }
+        throw InvalidArgument{"make_candidate_counter: unknown broadphase type"};
+    } ();
+    std::visit([&scene] (auto & container) {
+        for (auto & link : scene.links)
+            { container.defer_addition_of(link); }
+        container.update();
+    }, counter);
+    return counter;
+}
+
+void count_candidates
+    (const CandidateCounter & counter, const std::vector<Body> & bodies,
+     SimulationCounts & counts)
+{
+    std::visit([&bodies, &counts] (const auto & container) {
+        for (auto & body : bodies) {
+            auto * in_air = get_if<InAir>(&body.state);
+            if (!in_air) continue;
+            ++counts.queries;
+            auto view = container.view_for
+                (in_air->location, in_air->location + in_air->displacement);
+            for (auto & link : view) {
+                (void)link;
+                ++counts.candidates;
+            }
+        }
+    }, counter);
+}
+
+void respawn_fallen
+    (std::default_random_engine & rng, const BoundingBox & bounds,
+     std::vector<Body> & bodies, SimulationCounts & counts)
+{
+    for (auto & body : bodies) {
+        if (location_of(body.state).y > bounds.low.y - 10) continue;
+        body.state = InAir{random_spawn_point(rng, bounds), Vector{}};
+        body.velocity = random_walk_velocity(rng);
+        ++counts.respawns;
+    }
+}
+
+void run_simulation
+    (BenchmarkReport & report, const SimulationScene & scene,
+     int body_count, BroadphaseType broadphase_type)
+{
+    DriverComplete driver{broadphase_type};
+    for (auto & link : scene.links)
+        { driver.add_triangle(link); }
+    driver.update();
+
+    auto bodies = make_bodies(scene.bounds, body_count);
+    std::vector<WalkingHandler> handlers;
+    std::vector<BodyStep> steps;
+    handlers.reserve(bodies.size());
+    for (auto & body : bodies) {
+        handlers.emplace_back(body.velocity);
+        steps.emplace_back(&body.state, &handlers.back());
+    }
+
+    auto candidate_counter = make_candidate_counter(broadphase_type, scene);
+    std::default_random_engine rng{0x4321};
+    SimulationCounts counts;
+    SampleAccumulator frame_times;
+    std::size_t allocations = 0;
+    std::vector<State> before;
+    for (int frame = 0; frame != k_frame_count; ++frame) {
+        set_displacements(bodies);
+        count_candidates(candidate_counter, bodies, counts);
+        before.clear();
+        for (auto & body : bodies)
+            { before.push_back(body.state); }
+
+        auto allocations_before = allocation_count();
+        Stopwatch stopwatch;
+        driver.step_all(View{steps.data(), steps.data() + steps.size()});
+        frame_times.add(stopwatch.elapsed_nanoseconds());
+        allocations += allocation_count() - allocations_before;
+
+        for (std::size_t i = 0; i != bodies.size(); ++i)
+            { count_changes(before[i], bodies[i].state, counts); }
+        respawn_fallen(rng, scene.bounds, bodies, counts);
+    }
+
+    auto per_frame = [] (Real x) { return x / k_frame_count; };
+    report.add_measurement("triangles", scene.links.size(), "triangles");
+    report.add_measurement("bodies", body_count, "bodies");
+    report.add_measurement("frame-mean", frame_times.mean(), "ns");
+    report.add_measurement("frame-max", frame_times.max(), "ns");
+    report.add_measurement
+        ("step-mean", frame_times.mean() / body_count, "ns");
+    report.add_measurement
+        ("candidates-per-query",
+         counts.queries == 0 ? 0 : Real(counts.candidates) / Real(counts.queries),
+         "triangles");
+    report.add_measurement("allocations-per-frame", per_frame(allocations), "allocations");
+    report.add_measurement("landings-per-frame", per_frame(counts.landings), "bodies");
+    report.add_measurement("transfers-per-frame", per_frame(counts.transfers), "bodies");
+    report.add_measurement("falls-per-frame", per_frame(counts.falls), "bodies");
+    report.add_measurement("respawns-per-frame", per_frame(counts.respawns), "bodies");
+}
+
+} // end of <anonymous> namespace
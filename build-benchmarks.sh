@@ -0,0 +1,15 @@
+g++ -O3 -Wall -std=c++17 -pthread -DNDEBUG \
+  $(find src -maxdepth 2 | grep 'cpp\b') \
+	$(find src/map-director/map-loader-task | grep 'cpp\b') \
+	$(find src/map-director/slopes-group-filler | grep 'cpp\b') \
+	$(find src/map-director/twist-loop-filler | grep 'cpp\b') \
+	$(find benchmarks | grep 'cpp\b') \
+  lib/tinyxml2/tinyxml2.cpp \
+  -Ilib/cul/inc -Ilib/ecs3/inc -Ilib/tinyxml2 \
+  -Ilib/HashMap/include \
+  -Wno-unqualified-std-cast-call \
+  -o bin/.out-benchmarks
+cd bin
+# any arguments given are used to filter which benchmarks run
+./.out-benchmarks "$@"
+cd ..
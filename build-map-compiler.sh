@@ -0,0 +1,16 @@
+g++ -O3 -Wall -std=c++17 -pthread -DNDEBUG \
+  $(find src -maxdepth 2 | grep 'cpp\b') \
+	$(find src/map-director/map-loader-task | grep 'cpp\b') \
+	$(find src/map-director/slopes-group-filler | grep 'cpp\b') \
+	$(find src/map-director/twist-loop-filler | grep 'cpp\b') \
+	$(find src/platform/map-compiler | grep 'cpp\b') \
+  lib/tinyxml2/tinyxml2.cpp \
+  -Ilib/cul/inc -Ilib/ecs3/inc -Ilib/tinyxml2 \
+  -Ilib/HashMap/include \
+  -Wno-unqualified-std-cast-call \
+  -o bin/.out-map-compiler
+cd bin
+# maps are compiled from where the game runs, as that's where tilesets are
+# found from
+./.out-map-compiler "$@"
+cd ..
@@ -1,4 +1,4 @@
-g++ -O3 -Wall -std=c++17 \
+g++ -O3 -Wall -std=c++17 -pthread \
   $(find src/platform/test | grep 'cpp\b') $(find src -maxdepth 2 | grep 'cpp\b') \
 	$(find src/map-director/map-loader-task | grep 'cpp\b') \
 	$(find src/map-director/slopes-group-filler | grep 'cpp\b') \
@@ -20,8 +20,11 @@ fi
 
 # sometimes I build to: /media/ramdisk/bin-wasm-app
 outputpath="bin"
+# set to "-DMACRO_COMPACT_TRIANGLE_SEGMENTS" to have triangles recompute their
+# normals/basis vectors, rather than store them (less memory, more time)
+triangleflags=""
 if [[ true ]]; then
-    emcc -O3 -std=c++17 \
+    emcc -O3 -std=c++17 -msimd128 \
         src/platform/wasm/wasm-main.cpp lib/tinyxml2/tinyxml2.cpp \
 				$(find src -maxdepth 1 | grep 'cpp\b') \
 			  $(find src/map-director | grep 'cpp$') \
@@ -34,7 +37,7 @@ if [[ true ]]; then
 				-Ilib/tl-expected/include \
         -Wno-unqualified-std-cast-call \
         -sNO_EXIT_RUNTIME=1 -sNO_DISABLE_EXCEPTION_CATCHING \
-        -DMACRO_NEW_20220728_VECTORS \
+        -DMACRO_NEW_20220728_VECTORS $triangleflags \
         -sEXPORTED_FUNCTIONS=_main,_to_js_start_up,_to_js_press_key,_to_js_release_key,_to_js_update \
         -sEXPORTED_RUNTIME_METHODS=cwrap,ccall,UTF8ToString \
         -o $outputpath"/out.html"
@@ -269,3 +269,63 @@ private:
     bool m_jump_pressed_before = false;
     bool m_jump_this_frame = false;
 };
+
+// ----------------------------------------------------------------------------
+
+/// Whether physics steps a body. Bodies which stay still long enough fall
+/// asleep, and those far from the player are parked; either skips all physics
+/// systems until woken. Bodies without this component are always stepped.
+class PhysicsActivity final {
+public:
+    /// how many frames a body must stay still before falling asleep
+    static constexpr const int k_still_frames_to_sleep = 30;
+    /// how little a body must move in a frame to count as still
+    static constexpr const Real k_still_distance = 0.001;
+    /// how fast a sleeping body must be pushed to wake, well above what
+    /// counts as still, so that a drifting body doesn't flip between asleep
+    /// and awake every frame
+    static constexpr const Real k_wake_speed = 0.25;
+
+    /// @returns true if a sleeping body pushed this fast should wake
+    static bool is_pushed_awake(const Vector & velocity)
+        { return magnitude(velocity) > k_wake_speed; }
+
+    bool is_awake() const noexcept { return m_state == State::awake; }
+
+    bool is_asleep() const noexcept { return m_state == State::asleep; }
+
+    bool is_parked() const noexcept { return m_state == State::parked; }
+
+    void park() {
+        m_state = State::parked;
+        m_still_frames = 0;
+    }
+
+    void wake() {
+        m_state = State::awake;
+        m_still_frames = 0;
+    }
+
+    /// notes where an awake body ended up this frame, putting it to sleep if
+    /// it's been still long enough
+    void record_location(const Vector & location) {
+        if (m_state != State::awake) return;
+        bool is_still = magnitude(location - m_last_location) <= k_still_distance;
+        m_last_location = location;
+        if (!is_still) {
+            m_still_frames = 0;
+        } else if (++m_still_frames >= k_still_frames_to_sleep) {
+            m_state = State::asleep;
+        }
+    }
+
+private:
+    enum class State { awake, asleep, parked };
+
+    State m_state = State::awake;
+    int m_still_frames = 0;
+    Vector m_last_location = Vector{k_inf, k_inf, k_inf};
+};
+
+inline bool is_awake(const EcsOpt<PhysicsActivity> & activity)
+    { return activity ? activity->is_awake() : true; }
@@ -20,10 +20,73 @@
 
 #pragma once
 
+#include "Definitions.hpp"
+
 static constexpr const auto k_testmap_filename = "comp-map-demo.tmx";
 static constexpr const bool
-    k_region_axis_container_report_maximum_sort_and_sweep = false;
+    k_region_axis_container_report_maximum_welds = false;
 constexpr const bool k_promised_files_take_at_least_one_frame = true;
 constexpr const bool k_report_lost_file_string_content = true;
+// native builds: how many worker threads promised files are read on
+constexpr const int k_file_reading_thread_count = 2;
 constexpr const bool k_report_tile_region_loads_and_unloads = false;
 constexpr const bool k_report_physics_driver_dropping_triangles = false;
+// physics broadphase: roughly how many triangles should share a division
+constexpr const int k_physics_target_bucket_occupancy = 16;
+// physics: how many threads bodies may be stepped on each frame
+constexpr const int k_physics_step_thread_count = 1;
+// physics: sleeping bodies this close to the player are woken, while the
+// player moves
+constexpr const Real k_physics_wake_distance = 8;
+// physics: bodies this far from the player are parked (regions around them
+// are likely unloaded)
+constexpr const Real k_physics_park_distance = 40;
+// map regions: how many worker threads prepare regions for loading, with none
+// regions are prepared on the frame thread (wasm builds have no threads)
+#ifdef __EMSCRIPTEN__
+constexpr const int k_region_preparation_thread_count = 0;
+#else
+constexpr const int k_region_preparation_thread_count = 2;
+#endif
+// map regions: how far ahead (in seconds) regions are prepared along the
+// player's trajectory, and the time between each point along it
+constexpr const double k_region_prefetch_horizon_seconds = 3;
+constexpr const double k_region_prefetch_step_seconds = 0.5;
+// map regions: frames the player may stand still, before regions prefetched
+// along their last heading are dropped
+constexpr const int k_region_prefetch_idle_frames = 120;
+// map regions: time (in seconds) region changes may take each frame, before
+// the rest is put off to later frames
+constexpr const double k_region_changes_seconds_per_frame = 0.004;
+// map regions: memory (in megabytes) kept for recently decayed regions, so
+// that walking back into them does not run their producables again
+constexpr const int k_decayed_region_cache_megabytes = 16;
+// map regions: added to a map's name, for the file (beside the map) where
+// triangles of its regions are kept between runs, empty to keep none (wasm
+// builds have nowhere to keep them)
+#ifdef __EMSCRIPTEN__
+constexpr const auto k_region_geometry_cache_extension = "";
+#else
+constexpr const auto k_region_geometry_cache_extension = ".geometry-cache";
+#endif
+// map regions: time (in seconds) a loaded sub map of a composite map may go
+// without being overlapped, before it's evicted
+constexpr const double k_sub_map_eviction_seconds = 30;
+// map loading: whether a map compiled by the map compiler is looked for
+// (beside the map, with ".compiled" added to its name) before loading the map
+// itself (wasm builds only fetch files as text, which compiled maps are not)
+#ifdef __EMSCRIPTEN__
+constexpr const bool k_load_compiled_maps = false;
+#else
+constexpr const bool k_load_compiled_maps = true;
+#endif
+// map loading: how many worker threads tilesets are loaded on, with none
+// tilesets are loaded on the frame thread (wasm builds have no threads)
+#ifdef __EMSCRIPTEN__
+constexpr const int k_tileset_loading_thread_count = 0;
+#else
+constexpr const int k_tileset_loading_thread_count = 4;
+#endif
+// map loading: memory (in megabytes) kept for tilesets no map is using, so
+// that maps sharing a tileset file only load it once
+constexpr const int k_tileset_cache_megabytes = 8;
@@ -25,8 +25,6 @@
 
 namespace {
 
-constexpr const Real k_error = 0.0005;
-
 inline Real round_close_to_zero(Real x)
     { return are_very_close(x, 0.) ? 0. : x; }
 
@@ -142,6 +142,9 @@ bool are_very_close(Real, Real);
 
 constexpr const Real k_pi  = cul::k_pi_for_type<Real>;
 constexpr const Real k_inf = std::numeric_limits<Real>::infinity();
+// tolerance of are_very_close, anything that must agree with it should be
+// derived from this
+constexpr const Real k_error = 0.0005;
 
 // facing north, using classic ltr x-y plane
 // y+ is up   , y- is down
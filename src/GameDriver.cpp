@@ -320,6 +320,15 @@ void GameDriverComplete::update_(Real seconds) {
 
     m_ppdriver->update();
 
+    UpdatePpStates pp_states{*m_ppdriver};
+    if (const auto * player_state = m_player_entities.physical.ptr<PpState>()) {
+        const auto * player_velocity =
+            m_player_entities.physical.ptr<Velocity>();
+        ecs::make_singles_system<Entity>(CheckPhysicsActivity
+            {point_and_plane::location_of(*player_state),
+             player_velocity ? player_velocity->value : Vector{},
+             k_physics_wake_distance, k_physics_park_distance})(m_scene);
+    }
     ecs::make_singles_system<Entity>([seconds](VisibilityChain & vis) {
         if (!vis.visible || !vis.next) return;
         if ((vis.time_spent += seconds) > VisibilityChain::k_to_next) {
@@ -336,14 +345,29 @@ void GameDriverComplete::update_(Real seconds) {
         auto & state = pent.get<PpState>();
         if (auto * on_surf = get_if<PpOnSegment>(&state)) {
             s *= on_surf->invert_normal ? -1 : 1;
-            s *= (angle_between(on_surf->segment->normal(), k_up) > k_pi*0.5) ? -1 : 1;
+            s *= (angle_between(on_surf->segment.normal(), k_up) > k_pi*0.5) ? -1 : 1;
         }
         trans = location_of(state) + s*trans_from_parent.translation;
     },
     PlayerControlToVelocity{seconds},
-    AccelerateVelocities{seconds},
-    VelocitiesToDisplacement{seconds},
-    UpdatePpState{*m_ppdriver},
+    // sleeping and parked bodies skip physics entirely
+    [accelerate = AccelerateVelocities{seconds}]
+        (PpState & state, Velocity & vel, EcsOpt<JumpVelocity> jumpvel,
+         EcsOpt<PhysicsActivity> activity)
+    { if (is_awake(activity)) accelerate(state, vel, jumpvel); },
+    [to_displacement = VelocitiesToDisplacement{seconds}]
+        (PpState & state, Velocity & vel, EcsOpt<JumpVelocity> jumpvel,
+         EcsOpt<PhysicsActivity> activity)
+    { if (is_awake(activity)) to_displacement(state, vel, jumpvel); },
+    [&pp_states] (PpState & state, EcsOpt<Velocity> vel,
+                  EcsOpt<PhysicsActivity> activity)
+    { if (is_awake(activity)) pp_states.add(state, vel); })(m_scene);
+    // all bodies are stepped together, so nearby bodies may share queries
+    pp_states.step_all(k_physics_step_thread_count);
+
+    ecs::make_singles_system<Entity>(
+    [] (const PpState & state, PhysicsActivity & activity)
+        { activity.record_location(point_and_plane::location_of(state)); },
     CheckJump{},
     [ppstate = m_player_entities.physical.ptr<PpState>(),
      plyvel  = m_player_entities.physical.ptr<Velocity>()]
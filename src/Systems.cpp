@@ -104,7 +104,7 @@ void VelocitiesToDisplacement::operator ()
 /* static */ Vector2 VelocitiesToDisplacement::find_on_segment_displacement
     (const PpOnSegment & on_segment, const Vector & dis_in_3d)
 {
-    auto & triangle   = *on_segment.segment;
+    auto & triangle   = on_segment.segment;
     auto displacement = project_onto_plane(dis_in_3d, triangle.normal());
     auto pt_v3        = triangle.point_at(on_segment.location);
     auto new_pos      = triangle.closest_point(pt_v3 + displacement);
@@ -123,7 +123,7 @@ void AccelerateVelocities::operator ()
         if (jumpvel) *jumpvel = new_vel(jumpvel->value);
     } else if (auto * on_seg = get_if<PpOnSegment>(&ppstate)) {
         auto new_vel_on_seg = [new_vel, on_seg] (Vector r) {
-            auto seg_norm = on_seg->segment->normal();
+            auto seg_norm = on_seg->segment.normal();
             return project_onto_plane(new_vel(r), seg_norm);
         };
         velocity = new_vel_on_seg(velocity.value);
@@ -133,6 +133,34 @@ void AccelerateVelocities::operator ()
 
 // ----------------------------------------------------------------------------
 
+void CheckPhysicsActivity::operator ()
+    (PpState & state, PhysicsActivity & activity, EcsOpt<Velocity> vel) const
+{
+    auto location = point_and_plane::location_of(state);
+    auto distance = magnitude(location - m_player_location);
+    if (distance > m_park_distance) {
+        activity.park();
+        return;
+    }
+    if (auto * on_segment = get_if<PpOnSegment>(&state)) {
+        // ground gone from underneath
+        if (!TriangleLinkStore::instance().find(on_segment->link_id)) {
+            state = PpInAir{location, Vector{}};
+            activity.wake();
+            return;
+        }
+    }
+    if (activity.is_awake()) return;
+    bool is_pushed = vel && PhysicsActivity::is_pushed_awake(vel->value);
+    // a player standing still is no reason to wake what's around them, else
+    // those bodies would never stay asleep
+    bool is_approached = m_player_is_moving && distance <= m_wake_distance;
+    if (is_pushed || activity.is_parked() || is_approached)
+        { activity.wake(); }
+}
+
+// ----------------------------------------------------------------------------
+
 void CheckJump::operator ()
     (PpState & state, PlayerControl & control, JumpVelocity & vel,
      EcsOpt<Velocity>) const
@@ -142,7 +170,7 @@ void CheckJump::operator ()
     // begins a jump
     auto * on_segment = get_if<PpOnSegment>(&state);
     if (on_segment && control.is_starting_jump()) {
-        auto & triangle = *on_segment->segment;
+        auto & triangle = on_segment->segment;
         auto dir = (on_segment->invert_normal ? -1 : 1)*triangle.normal()*0.1;
         vel = k_jump_vel;
         state = PpInAir{triangle.point_at(on_segment->location) + dir, Vector{}};
@@ -159,6 +187,24 @@ void CheckJump::operator ()
 
 // ----------------------------------------------------------------------------
 
+void UpdatePpStates::add(PpState & state, EcsOpt<Velocity> vel) {
+    m_states.push_back(&state);
+    m_handlers.emplace_back(vel, EcsOpt<JumpVelocity>{});
+}
+
+void UpdatePpStates::step_all(int thread_count) {
+    // handlers are done being added, so pointers to them now stay put
+    m_steps.clear();
+    for (std::size_t i = 0; i != m_states.size(); ++i)
+        { m_steps.emplace_back(m_states[i], &m_handlers[i]); }
+    m_driver.step_all
+        (View{m_steps.data(), m_steps.data() + m_steps.size()}, thread_count);
+    m_states.clear();
+    m_handlers.clear();
+}
+
+// ----------------------------------------------------------------------------
+
 Variant<Vector2, Vector>
     UpdatePpState::EventHandler::on_triangle_hit
     (const Triangle & triangle, const Vector &, const Vector2 & inside,
@@ -122,6 +122,35 @@ private:
 // accel to velocity
 // velocities to displacement
 
+/// Wakes or parks bodies, ahead of all other physics systems.
+///
+/// Bodies are woken when pushed, when the player comes near, or when the
+/// triangle they're on is removed (whereupon they're dropped into the air).
+/// Bodies far from the player are parked, as the regions around them are
+/// likely unloaded.
+class CheckPhysicsActivity final {
+public:
+    /// @param player_velocity sleeping bodies near the player are only woken
+    ///        while the player moves
+    CheckPhysicsActivity
+        (const Vector & player_location,
+         const Vector & player_velocity,
+         Real wake_distance,
+         Real park_distance):
+        m_player_location(player_location),
+        m_player_is_moving(!are_very_close(player_velocity, Vector{})),
+        m_wake_distance(wake_distance),
+        m_park_distance(park_distance) {}
+
+    void operator () (PpState &, PhysicsActivity &, EcsOpt<Velocity>) const;
+
+private:
+    Vector m_player_location;
+    bool m_player_is_moving;
+    Real m_wake_distance;
+    Real m_park_distance;
+};
+
 class CheckJump final {
 public:
     void operator () (PpState &, PlayerControl &, JumpVelocity &, EcsOpt<Velocity>) const;
@@ -165,3 +194,26 @@ public:
 private:
     point_and_plane::Driver & m_driver;
 };
+
+// ----------------------------------------------------------------------------
+
+/// Gathers bodies, like UpdatePpState; but then steps all of them with one
+/// call to the driver.
+class UpdatePpStates final {
+public:
+    explicit UpdatePpStates(point_and_plane::Driver & driver):
+        m_driver(driver) {}
+
+    void add(PpState & state, EcsOpt<Velocity> vel);
+
+    /// steps all gathered bodies, and forgets them
+    void step_all(int thread_count);
+
+private:
+    using EventHandler = UpdatePpState::EventHandler;
+
+    point_and_plane::Driver & m_driver;
+    std::vector<PpState *> m_states;
+    std::vector<EventHandler> m_handlers;
+    std::vector<point_and_plane::BodyStep> m_steps;
+};
@@ -24,6 +24,13 @@
 
 class PlatformAssetsStrategy;
 
+/// An image decoded into RGBA pixels, ready to be loaded into a texture.
+struct DecodedImage final {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> rgba_pixels;
+};
+
 class Texture {
 public:
     static SharedPtr<const Texture> make_ground(PlatformAssetsStrategy &);
@@ -0,0 +1,108 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "TriangleEdgeWelder.hpp"
+#include "TriangleLink.hpp"
+
+#include <cmath>
+#include <unordered_map>
+
+void TriangleEdgeWelder::add(const SharedPtr<TriangleLink> & link_ptr)
+    { m_links.push_back(link_ptr); }
+
+int TriangleEdgeWelder::weld() {
+    using SideLastEntryMap =
+        std::unordered_map<SideKey, std::size_t, SideKeyHasher>;
+    std::vector<SideEntry> entries;
+    entries.reserve(m_links.size()*3);
+    SideLastEntryMap last_entries;
+    last_entries.reserve(m_links.size()*3);
+    for (std::size_t i = 0; i != m_links.size(); ++i) {
+        const auto & triangle = m_links[i]->segment();
+        auto a = triangle.point_a();
+        auto b = triangle.point_b();
+        auto c = triangle.point_c();
+        for (auto key : { key_for(a, b), key_for(b, c), key_for(c, a) }) {
+            auto [itr, is_new] = last_entries.emplace(key, entries.size());
+            if (!is_new) {
+                entries[itr->second].next = entries.size();
+                itr->second = entries.size();
+            }
+            entries.emplace_back(i);
+        }
+    }
+
+    int compared_count = 0;
+    for (const auto & entry : entries) {
+        const auto & link = m_links[entry.link_index];
+        for (auto j = entry.next; j != SideEntry::k_no_next; j = entries[j].next) {
+            const auto & other = m_links[entries[j].link_index];
+            if (link == other) continue;
+            TriangleLink::attach_unattached_matching_points(link, other);
+            ++compared_count;
+        }
+    }
+    m_links.clear();
+    return compared_count;
+}
+
+/* private */ bool TriangleEdgeWelder::QuantizedPoint::operator <
+    (const QuantizedPoint & rhs) const noexcept
+{
+    if (x != rhs.x) return x < rhs.x;
+    if (y != rhs.y) return y < rhs.y;
+    return z < rhs.z;
+}
+
+/* private */ std::size_t TriangleEdgeWelder::SideKeyHasher::operator ()
+    (const SideKey & key) const noexcept
+{
+    std::size_t hash = 0;
+    for (auto value : { key.low.x, key.low.y, key.low.z,
+                        key.high.x, key.high.y, key.high.z })
+    {
+        // boost's hash_combine
+        hash ^= std::hash<long>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+/* private static */ TriangleEdgeWelder::QuantizedPoint
+    TriangleEdgeWelder::quantize(const Vector & r)
+{
+    QuantizedPoint point;
+    point.x = std::lround(r.x*k_steps_per_unit);
+    point.y = std::lround(r.y*k_steps_per_unit);
+    point.z = std::lround(r.z*k_steps_per_unit);
+    return point;
+}
+
+/* private static */ TriangleEdgeWelder::SideKey
+    TriangleEdgeWelder::key_for(const Vector & a, const Vector & b)
+{
+    auto qa = quantize(a);
+    auto qb = quantize(b);
+    // sides are the same either way around
+    if (qb < qa) std::swap(qa, qb);
+    SideKey key;
+    key.low = qa;
+    key.high = qb;
+    return key;
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "Definitions.hpp"
+
+#include <vector>
+
+class TriangleLink;
+
+/** Links triangles which share sides, with one pass over all of their sides.
+ *
+ *  Each side is keyed by its end points, quantized, so that only triangles
+ *  with (very nearly) the same side are ever compared. Pairs are attached
+ *  exactly as TriangleLink::attach_unattached_matching_points does, so
+ *  transfers are the same as those found comparing every pair.
+ *
+ *  Points which are very close, but quantize differently (rounding on either
+ *  side of a half step) are not welded. Map geometry falls well within steps.
+ */
+class TriangleEdgeWelder final {
+public:
+    /// points are quantized to this fraction of a unit
+    static constexpr const int k_steps_per_unit = 1024;
+
+    void add(const SharedPtr<TriangleLink> &);
+
+    /// Attaches each pair of triangles sharing a side (where neither is
+    /// already attached on that side), in the order they were added. All
+    /// triangles are then forgotten.
+    ///
+    /// @returns number of pairs compared
+    int weld();
+
+private:
+    struct QuantizedPoint final {
+        bool operator == (const QuantizedPoint & rhs) const noexcept
+            { return x == rhs.x && y == rhs.y && z == rhs.z; }
+
+        bool operator < (const QuantizedPoint & rhs) const noexcept;
+
+        long x = 0, y = 0, z = 0;
+    };
+
+    struct SideKey final {
+        bool operator == (const SideKey & rhs) const noexcept
+            { return low == rhs.low && high == rhs.high; }
+
+        QuantizedPoint low, high;
+    };
+
+    struct SideKeyHasher final {
+        std::size_t operator () (const SideKey &) const noexcept;
+    };
+
+    struct SideEntry final {
+        static constexpr const std::size_t k_no_next = std::size_t(-1);
+
+        explicit SideEntry(std::size_t link_index_):
+            link_index(link_index_) {}
+
+        std::size_t link_index;
+        /// next entry along the same side
+        std::size_t next = k_no_next;
+    };
+
+    static QuantizedPoint quantize(const Vector &);
+
+    static SideKey key_for(const Vector & a, const Vector & b);
+
+    std::vector<SharedPtr<TriangleLink>> m_links;
+};
@@ -45,10 +45,8 @@ void attach_if
      bool inverts_normal,
      bool flips_position)
 {
-    Transfer lhs_transfer
-        {SharedPtr<TriangleLink>{lhs}, rhs_side, inverts_normal, flips_position};
-    Transfer rhs_transfer
-        {SharedPtr<TriangleLink>{rhs}, lhs_side, inverts_normal, flips_position};
+    Transfer lhs_transfer{lhs.get(), rhs_side, inverts_normal, flips_position};
+    Transfer rhs_transfer{rhs.get(), lhs_side, inverts_normal, flips_position};
     lhs->set_transfer(lhs_side, std::move(lhs_transfer));
     rhs->set_transfer(rhs_side, std::move(rhs_transfer));
 }
@@ -68,15 +66,36 @@ void attach_if
     });
 }
 
+TriangleLink::TriangleLink():
+    m_id(TriangleLinkStore::instance().add(*this)) {}
+
 TriangleLink::TriangleLink(const Triangle & triangle):
-    TriangleFragment(triangle) {}
+    TriangleFragment(triangle),
+    m_id(TriangleLinkStore::instance().add(*this)) {}
 
 TriangleLink::TriangleLink(const Vector & a, const Vector & b, const Vector & c):
-    TriangleFragment(a, b, c) {}
+    TriangleFragment(a, b, c),
+    m_id(TriangleLinkStore::instance().add(*this)) {}
+
+TriangleLink::TriangleLink(const TriangleLink & rhs):
+    TriangleFragment(rhs),
+    m_triangle_sides(rhs.m_triangle_sides),
+    m_id(TriangleLinkStore::instance().add(*this)) {}
+
+TriangleLink::~TriangleLink()
+    { TriangleLinkStore::instance().remove(m_id); }
+
+TriangleLink & TriangleLink::operator = (const TriangleLink & rhs) {
+    // keeps this link's own id
+    TriangleFragment::operator = (rhs);
+    m_triangle_sides = rhs.m_triangle_sides;
+    return *this;
+}
 
 void TriangleLink::set_transfer(Side on_side, Transfer && transfer_to) {
+    auto * target = transfer_to.target();
     m_triangle_sides[on_side] =
-        SideInfo{std::move(transfer_to.target()),
+        SideInfo{target ? target->id() : TriangleId{},
                  transfer_to.target_side(),
                  transfer_to.inverts_normal(),
                  transfer_to.flips_position()};
@@ -84,15 +103,15 @@ void TriangleLink::set_transfer(Side on_side, Transfer && transfer_to) {
 
 bool TriangleLink::has_side_attached(Side side) const {
     verify_valid_side("TriangleLinks::has_side_attached", side);
-    return !!m_triangle_sides[side].target.lock();
+    return !!TriangleLinkStore::instance().find(m_triangle_sides[side].target);
 }
 
 TriangleLink::Transfer TriangleLink::transfers_to(Side side) const {
     verify_valid_side("TriangleLinks::transfers_to", side);
     const auto & info = m_triangle_sides[side];
-    auto ptr = info.target.lock();
-    if (!ptr) return Transfer{};
-    return Transfer{std::move(ptr), info.side, info.inverts, info.flip};
+    auto * target = TriangleLinkStore::instance().find(info.target);
+    if (!target) return Transfer{};
+    return Transfer{target, info.side, info.inverts, info.flip};
 }
 
 int TriangleLink::sides_attached_count() const {
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "TriangleSegment.hpp"
+#include "TriangleLinkStore.hpp"
 
 class TriangleFragment {
 public:
@@ -50,17 +51,18 @@ public:
     using Side = TriangleSide;
     TriangleLinkTransfer() {}
 
-    TriangleLinkTransfer(SharedPtr<const TriangleLink> && target_,
+    TriangleLinkTransfer(const TriangleLink * target_,
                          Side side_,
                          bool inverts_normal_,
                          bool flips_position_):
-        m_target(std::move(target_)),
+        m_target(target_),
         m_side(side_),
         m_inverts_normal(inverts_normal_),
         m_flips(flips_position_) {}
 
-    const SharedPtr<const TriangleLink> & target() const
-        { return m_target; }
+    /// @returns the link transfered to, which is only guaranteed to live for
+    ///          as long as the link which gave this transfer
+    const TriangleLink * target() const { return m_target; }
 
     Side target_side() const { return m_side; }
 
@@ -70,7 +72,7 @@ public:
 
 private:
     /// set if there is a valid transfer to be had
-    SharedPtr<const TriangleLink> m_target;
+    const TriangleLink * m_target = nullptr;
     /// which side of the target did the tracker transfer to
     Side m_side = Side::k_inside;
     /// caller should flip normal vector of tracker
@@ -99,12 +101,23 @@ public:
         (const SharedPtr<TriangleLink> & lhs,
          const SharedPtr<TriangleLink> & rhs);
 
-    TriangleLink() {}
+    TriangleLink();
 
     explicit TriangleLink(const Triangle &);
 
     TriangleLink(const Vector & a, const Vector & b, const Vector & c);
 
+    /// copies are new links, with their own ids, but the same neighbors
+    TriangleLink(const TriangleLink &);
+
+    ~TriangleLink();
+
+    TriangleLink & operator = (const TriangleLink &);
+
+    /// @returns this link's handle, which is stale once this link is
+    ///          destroyed
+    TriangleId id() const noexcept { return m_id; }
+
     void set_transfer(Side on_side, Transfer && transfer_to);
 
     bool has_side_attached(Side) const;
@@ -117,13 +130,15 @@ private:
     struct SideInfo final {
         SideInfo() {}
 
-        SideInfo(const WeakPtr<const TriangleLink> & target_,
+        SideInfo(TriangleId target_,
                  Side side_,
                  bool inverts_,
                  bool flip_):
             target(target_), side(side_), inverts(inverts_), flip(flip_) {}
 
-        WeakPtr<const TriangleLink> target;
+        /// neighbors are refered to by id, a neighbor being destroyed makes
+        /// this stale without touching this link
+        TriangleId target;
         Side side = Side::k_inside;
         bool inverts = false;
         bool flip = false;
@@ -132,4 +147,5 @@ private:
     static Side verify_valid_side(const char * caller, Side);
 
     std::array<SideInfo, 3> m_triangle_sides;
+    TriangleId m_id;
 };
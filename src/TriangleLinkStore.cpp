@@ -0,0 +1,90 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "TriangleLinkStore.hpp"
+#include "TriangleLink.hpp"
+
+/* static */ TriangleLinkStore & TriangleLinkStore::instance() {
+    // never destroyed, as links held by other static objects may outlive
+    // any static store
+    static auto * store = new TriangleLinkStore;
+    return *store;
+}
+
+TriangleId TriangleLinkStore::add(const TriangleLink & link) {
+    std::lock_guard lock{m_mutex};
+    std::uint32_t index = 0;
+    if (m_free_slots.empty()) {
+        if (m_slot_count == k_chunk_size*k_max_chunk_count) {
+            throw RuntimeError
+                {"TriangleLinkStore::add: too many triangle links are alive"};
+        }
+        index = m_slot_count++;
+        auto & chunk = m_chunks[index / k_chunk_size];
+        if (!chunk)
+            { chunk = make_unique<Chunk>(); }
+    } else {
+        index = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+    auto & slot = slot_at(index);
+    slot.link.store(&link, std::memory_order_release);
+    ++m_live_count;
+    return TriangleId{index, slot.generation.load(std::memory_order_relaxed)};
+}
+
+std::size_t TriangleLinkStore::count() const {
+    std::lock_guard lock{m_mutex};
+    return m_live_count;
+}
+
+void TriangleLinkStore::remove(TriangleId id) {
+    std::lock_guard lock{m_mutex};
+    if (id.is_null()) return;
+    auto & slot = slot_at(id.index());
+    auto generation = slot.generation.load(std::memory_order_relaxed);
+    if (generation != id.generation()) return;
+    slot.link.store(nullptr, std::memory_order_release);
+    // skip zero, the null handle's generation, on wrap around
+    if (++generation == 0)
+        { generation = 1; }
+    slot.generation.store(generation, std::memory_order_release);
+    m_free_slots.push_back(id.index());
+    --m_live_count;
+}
+
+void TriangleLinkStore::suspend(TriangleId id) {
+    std::lock_guard lock{m_mutex};
+    if (id.is_null()) return;
+    auto & slot = slot_at(id.index());
+    if (slot.generation.load(std::memory_order_relaxed) != id.generation())
+        { return; }
+    slot.link.store(nullptr, std::memory_order_release);
+}
+
+void TriangleLinkStore::resume(const TriangleLink & link) {
+    std::lock_guard lock{m_mutex};
+    auto id = link.id();
+    if (id.is_null()) return;
+    auto & slot = slot_at(id.index());
+    if (slot.generation.load(std::memory_order_relaxed) != id.generation())
+        { return; }
+    slot.link.store(&link, std::memory_order_release);
+}
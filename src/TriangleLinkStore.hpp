@@ -0,0 +1,130 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "Definitions.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+class TriangleLink;
+
+/// Compact handle for a triangle link. A handle outliving its link is simply
+/// "stale": the store then finds nothing for it.
+class TriangleId final {
+public:
+    TriangleId() {}
+
+    TriangleId(std::uint32_t index_, std::uint32_t generation_):
+        m_index(index_), m_generation(generation_) {}
+
+    bool operator == (const TriangleId & rhs) const noexcept
+        { return m_index == rhs.m_index && m_generation == rhs.m_generation; }
+
+    bool operator != (const TriangleId & rhs) const noexcept
+        { return !(*this == rhs); }
+
+    /// @returns true if this was never the handle of any link
+    bool is_null() const noexcept { return m_generation == 0; }
+
+    std::uint32_t index() const noexcept { return m_index; }
+
+    std::uint32_t generation() const noexcept { return m_generation; }
+
+private:
+    std::uint32_t m_index = 0;
+    // slots' generations start at one, so zero is never valid
+    std::uint32_t m_generation = 0;
+};
+
+/** Slot map of every live triangle link, links register themselves on
+ *  construction and unregister on destruction.
+ *
+ *  Unregistering bumps the slot's generation, so every handle to that link
+ *  (e.g. from neighboring links' transfers) is invalidated at once, with no
+ *  need to visit them. Suspending a link keeps its slot and generation, but
+ *  nothing is found for its handles until it's resumed.
+ *
+ *  Slots are stored in fixed size chunks which never move, so that finding
+ *  a link needs no lock. Adding and removing are locked, so that links maybe
+ *  made and destroyed on other threads. Slots are read atomically, so finding
+ *  through a stale handle may race with its slot being removed or re-issued.
+ *  However using a found link must not race with the destruction of that same
+ *  link.
+ */
+class TriangleLinkStore final {
+public:
+    static TriangleLinkStore & instance();
+
+    TriangleId add(const TriangleLink &);
+
+    std::size_t count() const;
+
+    /// @returns nullptr if the link for this handle has been destroyed or
+    ///          suspended (or if the handle is null)
+    const TriangleLink * find(TriangleId id) const noexcept {
+        if (id.is_null()) return nullptr;
+        const auto & slot = slot_at(id.index());
+        if (slot.generation.load(std::memory_order_acquire) != id.generation())
+            { return nullptr; }
+        const auto * link = slot.link.load(std::memory_order_acquire);
+        // the slot may have been re-issued after the generation was read, in
+        // which case its generation has already moved on
+        if (slot.generation.load(std::memory_order_acquire) != id.generation())
+            { return nullptr; }
+        return link;
+    }
+
+    void remove(TriangleId);
+
+    /// nothing is found for the link's handles, until resumed
+    void suspend(TriangleId);
+
+    /// the link's handles find it again, after being suspended
+    void resume(const TriangleLink &);
+
+private:
+    struct Slot final {
+        std::atomic<const TriangleLink *> link{nullptr};
+        std::atomic<std::uint32_t> generation{1};
+    };
+
+    static constexpr const std::size_t k_chunk_size = 4096;
+    static constexpr const std::size_t k_max_chunk_count = 4096;
+
+    using Chunk = std::array<Slot, k_chunk_size>;
+
+    TriangleLinkStore() {}
+
+    const Slot & slot_at(std::uint32_t index) const noexcept
+        { return (*m_chunks[index / k_chunk_size])[index % k_chunk_size]; }
+
+    Slot & slot_at(std::uint32_t index) noexcept
+        { return (*m_chunks[index / k_chunk_size])[index % k_chunk_size]; }
+
+    mutable std::mutex m_mutex;
+    std::array<UniquePtr<Chunk>, k_max_chunk_count> m_chunks;
+    std::vector<std::uint32_t> m_free_slots;
+    std::uint32_t m_slot_count = 0;
+    std::size_t m_live_count = 0;
+};
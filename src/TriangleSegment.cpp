@@ -30,18 +30,27 @@ using Side = TriangleSide;
 using SideCrossing = TriangleSegment::SideCrossing;
 using LimitIntersection = TriangleSegment::LimitIntersection;
 
-using cul::find_smallest_diff, cul::make_nonsolution_sentinel,
-      cul::make_zero_vector;
+using cul::make_nonsolution_sentinel, cul::make_zero_vector;
 using std::min_element;
 
-Real get_component_for_basis(const Vector & pt_on_place, const Vector & basis);
-
 Vector2 find_point_c_in_2d(const Vector & a, const Vector & b, const Vector & c);
 
 Real find_point_b_x_in_2d(const Vector & a, const Vector & b);
 
 inline bool within_01(Real x) { return x >= 0 && x <= 1; }
 
+// how far a point may be past a side and still be treated as inside it, the
+// same distance are_very_close treats as the same
+constexpr const Real k_edge_tolerance = k_error;
+
+constexpr const Real k_epsilon = std::numeric_limits<Real>::epsilon();
+
+inline bool is_inside_edge(Real edge_value)
+    { return edge_value >= -k_edge_tolerance; }
+
+Vector find_normal(const Vector & a, const Vector & b, const Vector & c)
+    { return normalize(cross(b - a, c - a)); }
+
 } // end of <anonymous> namespace
 
 TriangleSegment::SideCrossing::SideCrossing
@@ -55,7 +64,10 @@ TriangleSegment::TriangleSegment():
     m_c(k_north),
     m_bx_2d(find_point_b_x_in_2d(m_a, m_b)),
     m_c_2d(find_point_c_in_2d(m_a, m_b, m_c))
-    { check_invarients(); }
+{
+    set_plane_frame();
+    check_invarients();
+}
 
 TriangleSegment::TriangleSegment
     (const Vector & a, const Vector & b, const Vector & c):
@@ -78,6 +90,7 @@ TriangleSegment::TriangleSegment
     // early exceptions should catch bad a, b, c values
     m_bx_2d = find_point_b_x_in_2d(a, b);
     m_c_2d  = find_point_c_in_2d(a, b, c);
+    set_plane_frame();
     assert(!are_parallel(point_b_in_2d() - point_a_in_2d(),
                          point_b_in_2d() - point_c_in_2d()));
 
@@ -87,10 +100,16 @@ TriangleSegment::TriangleSegment
 Real TriangleSegment::area() const
     { return cul::area_of_triangle(point_a(), point_b(), point_c()); }
 
-Vector TriangleSegment::basis_i() const
-    { return normalize(point_b() - point_a()); }
+Vector TriangleSegment::basis_i() const {
+#   ifdef MACRO_COMPACT_TRIANGLE_SEGMENTS
+    return normalize(point_b() - point_a());
+#   else
+    return m_basis_i;
+#   endif
+}
 
 Vector TriangleSegment::basis_j() const {
+#   ifdef MACRO_COMPACT_TRIANGLE_SEGMENTS
     // basis j must be a vector such that i x j = n
     // unit vector cross unit vector = another unit vector
     auto rv = cross(normal(), basis_i());
@@ -98,6 +117,9 @@ Vector TriangleSegment::basis_j() const {
     assert(are_very_close(magnitude(rv), 1.));
 #   endif
     return rv;
+#   else
+    return m_basis_j;
+#   endif
 }
 
 bool TriangleSegment::projectable_onto(const Vector & n) const noexcept {
@@ -115,34 +137,11 @@ SideCrossing TriangleSegment::check_for_side_crossing
     (const Vector2 & old, const Vector2 & new_) const
 {
     check_invarients();
-    if (old == new_ || contains_point(old) == contains_point(new_))
+    if (old == new_) return SideCrossing{};
+    bool contains_old = contains_point(old);
+    if (contains_old == contains_point(new_))
         { return SideCrossing{}; }
-
-    auto mk_crossing = [this, old, new_] (TriangleSide r, Vector2 inx) {
-        bool contains_old = contains_point(old);
-        auto far_in  = contains_old ? old  : new_;
-        auto far_out = contains_old ? new_ : old ;
-        auto [li, fo] = move_to_last_in_and_first_out(
-            far_in, far_out,
-            next_in_direction(inx, far_in  - far_out),
-            next_in_direction(inx, far_out - far_in));
-        return SideCrossing{r, li, fo};
-    };
-
-    auto a2 = point_a_in_2d();
-    auto b2 = point_b_in_2d();
-    auto c2 = point_c_in_2d();
-
-    if (auto gv = ::find_intersection(a2, b2, old, new_))
-        { return mk_crossing(k_side_ab, gv.value()); }
-    if (auto gv = ::find_intersection(b2, c2, old, new_))
-        { return mk_crossing(k_side_bc, gv.value()); }
-    if (auto gv = ::find_intersection(c2, a2, old, new_))
-        { return mk_crossing(k_side_ca, gv.value()); }
-
-    return mk_crossing(
-        contains_point(new_) ? point_region(old) : point_region(new_),
-        old + new_);
+    return contains_old ? find_crossing(old, new_) : find_crossing(new_, old);
 }
 
 Vector2 TriangleSegment::closest_contained_point(const Vector & p) const {
@@ -161,14 +160,17 @@ Vector2 TriangleSegment::closest_point(const Vector & p) const {
     // https://math.stackexchange.com/questions/633181/formula-to-project-a-vector-onto-a-plane
     // by copyright law, mathematics/geometry cannot be copyrighted
 
+    // both basis vectors are unit vectors on the plane, so any part of pa
+    // along the normal falls out of these products
     auto pa = p - point_a();
-    auto pa_on_plane = pa - dot(pa, normal())*normal();
-    return Vector2{get_component_for_basis(pa_on_plane, basis_i()),
-                   get_component_for_basis(pa_on_plane, basis_j())};
+    return Vector2{dot(pa, basis_i()), dot(pa, basis_j())};
 }
 
-bool TriangleSegment::contains_point(const Vector2 & r) const noexcept
-    { return is_real(r) ? point_region(r) == k_inside : false; }
+bool TriangleSegment::contains_point(const Vector2 & r) const noexcept {
+    if (!is_real(r)) return false;
+    auto [ab, bc, ca] = edge_values_of(r);
+    return is_inside_edge(ab) && is_inside_edge(bc) && is_inside_edge(ca);
+}
 
 TriangleSegment TriangleSegment::flip() const noexcept {
     auto old_norm = normal();
@@ -225,8 +227,13 @@ LimitIntersection TriangleSegment::limit_with_intersection
     return LimitIntersection{ r, along_t(t) };
 }
 
-Vector TriangleSegment::normal() const noexcept
-    { return normalize(cross(point_b() - point_a(), point_c() - point_a())); }
+Vector TriangleSegment::normal() const noexcept {
+#   ifdef MACRO_COMPACT_TRIANGLE_SEGMENTS
+    return find_normal(m_a, m_b, m_c);
+#   else
+    return m_normal;
+#   endif
+}
 
 Vector TriangleSegment::opposing_point(Side side) const {
     switch (side) {
@@ -310,53 +317,52 @@ Tuple<Vector2, Vector2> TriangleSegment::side_points_in_2d(Side side) const {
 #   endif
 }
 
-/* private */ Tuple<Vector2, Vector2>
-    TriangleSegment::move_to_last_in_and_first_out
-    (const Vector2 & far_inside, const Vector2 & far_outside,
-     const Vector2 & hint_li, const Vector2 & hint_fo) const noexcept
+/* private */ SideCrossing TriangleSegment::find_crossing
+    (const Vector2 & far_inside, const Vector2 & far_outside) const noexcept
 {
     assert( contains_point(far_inside ));
     assert(!contains_point(far_outside));
-    if (!contains_point( hint_li ) || contains_point( hint_fo )) {
-        // same utility that's used with point and line
-        auto pos_along_line = [far_inside, far_outside](Real x)
-            { return far_inside + x*(far_outside - far_inside); };
-
-        auto [high_fal, low_true] = find_smallest_diff<Real>(
-            [pos_along_line, this](Real x)
-            { return !contains_point(pos_along_line(x)); });
-
-        return make_tuple(pos_along_line(high_fal), pos_along_line(low_true));
-    }
-    assert( contains_point(hint_li));
-    assert(!contains_point(hint_fo));
-    return make_tuple(hint_li, hint_fo);
-}
-
-/* private */ TriangleSide TriangleSegment::point_region
-    (const Vector2 & r) const
-{
-    if (!is_real(r)) {
-        throw InvalidArgument
-            {"TriangleSegment::point_region: only real vectors should reach "
-             "this function."};
-    }
-    // mmm... always use the same method? floating points are quite odd
-    // if there's a solution... r must be outside
-    auto center = center_in_2d();
-    auto is_crossed_line = [r, center] (const Vector2 & a, const Vector2 & b)
-        { return ::find_intersection(a, b, center, r).has_value(); };
-    auto a = point_a_in_2d();
-    auto b = point_b_in_2d();
-    if (are_parallel(a - b, a - r)) return k_inside;
-    if (is_crossed_line(a, b)) return k_side_ab;
-
-    auto c = point_c_in_2d();
-    // cold branch
-    if (are_parallel(b - c, b - r) || are_parallel(c - a, c - r)) return k_inside;
-    if (is_crossed_line(b, c)) return k_side_bc;
-    if (is_crossed_line(c, a)) return k_side_ca;
-    return k_inside;
+    // edge values change linearly along the segment, so where it crosses
+    // each side is solved directly; it leaves through the first one crossed
+    auto [in_ab , in_bc , in_ca ] = edge_values_of(far_inside );
+    auto [out_ab, out_bc, out_ca] = edge_values_of(far_outside);
+    Side side = k_inside;
+    Real exit_position = k_inf;
+    auto check_side = [&side, &exit_position]
+        (Side side_, Real inside_value, Real outside_value)
+    {
+        if (is_inside_edge(outside_value)) return;
+        // distances change linearly along the segment too, so this is where
+        // it's k_edge_tolerance past the side
+        auto t =   (inside_value + k_edge_tolerance)
+                 / (inside_value - outside_value);
+        if (t >= exit_position) return;
+        exit_position = t;
+        side = side_;
+    };
+    check_side(k_side_ab, in_ab, out_ab);
+    check_side(k_side_bc, in_bc, out_bc);
+    check_side(k_side_ca, in_ca, out_ca);
+    assert(side != k_inside);
+
+    // floating point error may leave the solved point on either side, so
+    // back off in steps which double, at most about as many times as there
+    // are mantissa bits (t = 0 is always in, and t = 1 always out)
+    auto pos_along_line = [far_inside, far_outside](Real x) {
+        if (x >= 1) return far_outside;
+        return far_inside + x*(far_outside - far_inside);
+    };
+    auto last_in_position = exit_position;
+    for (auto step = k_epsilon;
+         !contains_point(pos_along_line(last_in_position)); step *= 2)
+        { last_in_position = std::max(Real(0), last_in_position - step); }
+    auto first_out_position = exit_position;
+    for (auto step = k_epsilon;
+         contains_point(pos_along_line(first_out_position)); step *= 2)
+        { first_out_position = std::min(Real(1), first_out_position + step); }
+    return SideCrossing
+        {side, pos_along_line(last_in_position),
+         pos_along_line(first_out_position)};
 }
 
 /* private */ Tuple<Vector, Vector, Vector>
@@ -367,6 +373,43 @@ Tuple<Vector2, Vector2> TriangleSegment::side_points_in_2d(Side side) const {
                       cul::project_onto_plane(point_c(), n));
 }
 
+/* private */ Tuple<Real, Real, Real>
+    TriangleSegment::edge_values_of(const Vector2 & r) const noexcept
+{
+    // point a is the origin and point b lies on the x-axis, which leaves
+    // very little to compute
+    const auto & c = m_c_2d;
+    auto [inverse_ab, inverse_bc, inverse_ca] = inverse_side_lengths();
+    return make_tuple
+        (m_bx_2d*r.y*inverse_ab,
+         ((c.x - m_bx_2d)*r.y - c.y*(r.x - m_bx_2d))*inverse_bc,
+         (c.y*(r.x - c.x) - c.x*(r.y - c.y))*inverse_ca);
+}
+
+/* private */ Tuple<Real, Real, Real>
+    TriangleSegment::inverse_side_lengths() const noexcept
+{
+#   ifdef MACRO_COMPACT_TRIANGLE_SEGMENTS
+    return make_tuple(1 / m_bx_2d,
+                      1 / magnitude(m_c_2d - Vector2{m_bx_2d, 0}),
+                      1 / magnitude(m_c_2d));
+#   else
+    return make_tuple(m_inverse_ab_length, m_inverse_bc_length,
+                      m_inverse_ca_length);
+#   endif
+}
+
+/* private */ void TriangleSegment::set_plane_frame() noexcept {
+#   ifndef MACRO_COMPACT_TRIANGLE_SEGMENTS
+    m_normal  = find_normal(m_a, m_b, m_c);
+    m_basis_i = normalize(m_b - m_a);
+    m_basis_j = cross(m_normal, m_basis_i);
+    m_inverse_ab_length = 1 / m_bx_2d;
+    m_inverse_bc_length = 1 / magnitude(m_c_2d - Vector2{m_bx_2d, 0});
+    m_inverse_ca_length = 1 / magnitude(m_c_2d);
+#   endif
+}
+
 const char * to_string(TriangleSide side) {
     switch (side) {
     case Side::k_inside : return "inside";
@@ -379,17 +422,6 @@ const char * to_string(TriangleSide side) {
 
 namespace {
 
-Real get_component_for_basis(const Vector & pt_on_plane, const Vector & basis) {
-    // basis is assumed to be a normal vector
-    assert(are_very_close(magnitude(basis), 1.));
-
-    auto proj = project_onto(pt_on_plane, basis);
-
-    // anti-parallel? scalar value is negative
-    bool is_antipara = dot(proj, basis) / (magnitude(proj) * 1.) < 0.;
-    return (is_antipara ? -1. : 1.)*magnitude(proj);
-}
-
 Vector2 find_point_c_in_2d
     (const Vector & a, const Vector & b, const Vector & c)
 {
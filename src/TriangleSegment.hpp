@@ -28,6 +28,11 @@
  *  Generally, triangles must be three non-colinear points. All points must not
  *  be nearly equal to each other.
  *
+ *  The triangle's normal, plane basis vectors, and side lengths are computed
+ *  once, on construction. Defining MACRO_COMPACT_TRIANGLE_SEGMENTS instead
+ *  computes them on each call, trading speed for a smaller segment (which
+ *  maybe preferable for wasm builds).
+ *
  *  NTS: with floating points, objects hitting the very edges of triangles
  *       become *much* more likely, I need code to handle this situation!
  */
@@ -260,19 +265,36 @@ public:
 private:
     void check_invarients() const noexcept;
 
-    Tuple<Vector2, Vector2> move_to_last_in_and_first_out
-        (const Vector2 & far_inside, const Vector2 & far_outside,
-         const Vector2 & hint_li, const Vector2 & hint_fo) const noexcept;
-
-    /** @throws if non-real vector */
-    Side point_region(const Vector2 &) const;
+    /// @returns crossing of the side through which a line segment, from a
+    ///          point inside to a point outside, leaves the triangle
+    SideCrossing find_crossing
+        (const Vector2 & far_inside, const Vector2 & far_outside) const noexcept;
 
     Tuple<Vector, Vector, Vector> project_onto_plane_(const Vector &) const noexcept;
 
+    /// @returns each side's edge function for the given point, divided by
+    ///          the side's length, which is the point's signed distance from
+    ///          the side; positive toward the inside
+    Tuple<Real, Real, Real> edge_values_of(const Vector2 &) const noexcept;
+
+    /// @returns one over the length of sides ab, bc, and ca
+    Tuple<Real, Real, Real> inverse_side_lengths() const noexcept;
+
+    void set_plane_frame() noexcept;
+
     Vector m_a, m_b, m_c;
 
     Real m_bx_2d;
     Vector2 m_c_2d;
+
+#   ifndef MACRO_COMPACT_TRIANGLE_SEGMENTS
+    Vector m_normal;
+    Vector m_basis_i;
+    Vector m_basis_j;
+    Real m_inverse_ab_length;
+    Real m_inverse_bc_length;
+    Real m_inverse_ca_length;
+#   endif
 };
 
 using TriangleSide = TriangleSegment::Side;
@@ -178,6 +178,6 @@ TriangleSide TriangleLinkAttachment::right_side() const { return m_rhs_side; }
     (const SharedPtr<const TriangleLink> & link, TriangleSide side) const
 {
     return TriangleLinkTransfer
-        {SharedPtr<const TriangleLink>{link}, side,
+        {link.get(), side,
          m_has_matching_normals, m_flips_position};
 }
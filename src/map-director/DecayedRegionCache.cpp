@@ -0,0 +1,168 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "DecayedRegionCache.hpp"
+#include "MapRegionChangesTask.hpp"
+#include "../TriangleLink.hpp"
+
+namespace {
+
+std::size_t held_render_model_bytes(const SharedPtr<const RenderModel> &);
+
+template <typename T>
+Optional<T> optional_component(const Entity & entity) {
+    if (const auto * component = entity.ptr<T>())
+        { return *component; }
+    return {};
+}
+
+template <typename T>
+void add_optional_component(Entity & entity, const Optional<T> & component) {
+    if (component)
+        { entity.add<T>() = *component; }
+}
+
+template <typename T>
+void add_optional_component(Entity & entity, const SharedPtr<T> & component) {
+    if (component)
+        { entity.add<SharedPtr<T>>() = component; }
+}
+
+} // end of <anonymous> namespace
+
+DecayedRegion::DecayedRegion
+    (const Vector2I & on_field_position,
+     const SharedPtr<ViewGridTriangle> & triangle_grid,
+     const std::vector<Entity> & entities):
+    m_on_field_position(on_field_position),
+    m_triangle_grid(triangle_grid)
+{
+    m_entities.reserve(entities.size());
+    for (auto & entity : entities)
+        { m_entities.emplace_back(entity); }
+    if (m_triangle_grid) {
+        auto & link_store = TriangleLinkStore::instance();
+        for (auto & link : m_triangle_grid->elements())
+            { link_store.suspend(link->id()); }
+    }
+
+    auto links_count = m_triangle_grid ? m_triangle_grid->elements_count() : 0;
+    m_memory_size =
+        sizeof(DecayedRegion) +
+        links_count*(sizeof(TriangleLink) + sizeof(SharedPtr<TriangleLink>)) +
+        m_entities.size()*sizeof(EntitySnapshot);
+    for (auto & snapshot : m_entities)
+        { m_memory_size += held_render_model_bytes(snapshot.render_model); }
+}
+
+std::vector<Entity> DecayedRegion::make_entities() const {
+    std::vector<Entity> entities;
+    entities.reserve(m_entities.size());
+    for (auto & snapshot : m_entities)
+        { entities.push_back(snapshot.make_entity()); }
+    return entities;
+}
+
+// ----------------------------------------------------------------------------
+
+DecayedRegion::EntitySnapshot::EntitySnapshot(const Entity & entity):
+    translation(optional_component<ModelTranslation>(entity)),
+    scale(optional_component<ModelScale>(entity)),
+    x_rotation(optional_component<XRotation>(entity)),
+    y_rotation(optional_component<YRotation>(entity)),
+    texture_translation(optional_component<TextureTranslation>(entity)),
+    visibility(optional_component<ModelVisibility>(entity)),
+    render_model(optional_component<SharedPtr<const RenderModel>>(entity).
+        value_or(nullptr)),
+    texture(optional_component<SharedPtr<const Texture>>(entity).
+        value_or(nullptr)) {}
+
+Entity DecayedRegion::EntitySnapshot::make_entity() const {
+    auto entity = Entity::make_sceneless_entity();
+    add_optional_component(entity, translation);
+    add_optional_component(entity, scale);
+    add_optional_component(entity, x_rotation);
+    add_optional_component(entity, y_rotation);
+    add_optional_component(entity, texture_translation);
+    add_optional_component(entity, visibility);
+    add_optional_component(entity, render_model);
+    add_optional_component(entity, texture);
+    return entity;
+}
+
+// ----------------------------------------------------------------------------
+
+DecayedRegionCache::DecayedRegionCache(std::size_t byte_budget):
+    m_byte_budget(byte_budget) {}
+
+void DecayedRegionCache::add(DecayedRegion && region) {
+    auto position = region.on_field_position();
+    // a newer decay replaces an older one
+    if (auto itr = m_index.find(position); itr != m_index.end()) {
+        remove(itr->second);
+    }
+    m_metrics.bytes_held += region.memory_size();
+    m_regions.push_front(std::move(region));
+    m_index[position] = m_regions.begin();
+    evict_over_budget();
+}
+
+bool DecayedRegionCache::contains(const Vector2I & on_field_position) const
+    { return m_index.find(on_field_position) != m_index.end(); }
+
+Optional<DecayedRegion> DecayedRegionCache::take
+    (const Vector2I & on_field_position)
+{
+    auto itr = m_index.find(on_field_position);
+    if (itr == m_index.end()) return {};
+    Optional<DecayedRegion> region{std::move(*itr->second)};
+    remove(itr->second);
+    ++m_metrics.hits;
+    return region;
+}
+
+/* private */ DecayedRegionCache::RegionList::iterator
+    DecayedRegionCache::remove(RegionList::iterator itr)
+{
+    m_metrics.bytes_held -= itr->memory_size();
+    m_index.erase(itr->on_field_position());
+    return m_regions.erase(itr);
+}
+
+/* private */ void DecayedRegionCache::evict_over_budget() {
+    while (!m_regions.empty() && m_metrics.bytes_held > m_byte_budget) {
+        remove(std::prev(m_regions.end()));
+        ++m_metrics.evictions;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+std::size_t held_render_model_bytes
+    (const SharedPtr<const RenderModel> & render_model)
+{
+    // only those prepared for a region are held by it alone
+    auto * prepared = dynamic_cast<const PreparedRenderModel *>(render_model.get());
+    return prepared ? prepared->uploaded_bytes() : 0;
+}
+
+} // end of <anonymous> namespace
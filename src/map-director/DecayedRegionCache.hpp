@@ -0,0 +1,141 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "MapRegionContainer.hpp"
+
+#include "../Components.hpp"
+
+#include <list>
+#include <unordered_map>
+
+class Texture;
+class RenderModel;
+
+/// A region which has decayed, with its links still linked to each other,
+/// and enough of its entities kept to make them again.
+///
+/// Its links are suspended in the link store, so that neither neighboring
+/// links nor bodies find them, until the region is revived and committed.
+///
+/// Only the components producables may give to entities are kept (those of
+/// k_is_producable_entity_component), which producables are held to at
+/// compile time. Render models are kept already uploaded.
+class DecayedRegion final {
+public:
+    using ViewGridTriangle = MapRegionContainer::ViewGridTriangle;
+
+    DecayedRegion
+        (const Vector2I & on_field_position,
+         const SharedPtr<ViewGridTriangle> & triangle_grid,
+         const std::vector<Entity> & entities);
+
+    const Vector2I & on_field_position() const noexcept
+        { return m_on_field_position; }
+
+    /// (re)makes sceneless entities, with the same components as before
+    std::vector<Entity> make_entities() const;
+
+    const SharedPtr<ViewGridTriangle> & triangle_grid() const noexcept
+        { return m_triangle_grid; }
+
+    /// rough estimate of the memory this region keeps, render models shared
+    /// with other regions (like those of tilesets) are not counted
+    std::size_t memory_size() const noexcept { return m_memory_size; }
+
+private:
+    // has a member for each of k_is_producable_entity_component
+    struct EntitySnapshot final {
+        explicit EntitySnapshot(const Entity &);
+
+        Entity make_entity() const;
+
+        Optional<ModelTranslation> translation;
+        Optional<ModelScale> scale;
+        Optional<XRotation> x_rotation;
+        Optional<YRotation> y_rotation;
+        Optional<TextureTranslation> texture_translation;
+        Optional<ModelVisibility> visibility;
+        SharedPtr<const RenderModel> render_model;
+        SharedPtr<const Texture> texture;
+    };
+
+    Vector2I m_on_field_position;
+    SharedPtr<ViewGridTriangle> m_triangle_grid;
+    std::vector<EntitySnapshot> m_entities;
+    std::size_t m_memory_size = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Keeps recently decayed regions, so that they may be revived without
+/// running producables again.
+///
+/// Least recently decayed regions are dropped first, once the memory budget
+/// is exceeded.
+class DecayedRegionCache final {
+public:
+    struct Metrics final {
+        int hits = 0;
+        int misses = 0;
+        int evictions = 0;
+        std::size_t bytes_held = 0;
+
+        Real hit_rate() const noexcept
+            { return hits + misses == 0 ? 0 : Real(hits) / Real(hits + misses); }
+    };
+
+    /// keeps nothing
+    DecayedRegionCache() {}
+
+    explicit DecayedRegionCache(std::size_t byte_budget);
+
+    void add(DecayedRegion &&);
+
+    bool contains(const Vector2I & on_field_position) const;
+
+    /// @returns false if there's no budget for any regions
+    bool keeps_regions() const noexcept { return m_byte_budget != 0; }
+
+    /// removes the region at the given position, counting a hit if present
+    Optional<DecayedRegion> take(const Vector2I & on_field_position);
+
+    /// counts a miss, for a region which had to be made from producables
+    void record_miss() { ++m_metrics.misses; }
+
+    std::size_t size() const noexcept { return m_regions.size(); }
+
+    const Metrics & metrics() const noexcept { return m_metrics; }
+
+private:
+    using RegionList = std::list<DecayedRegion>;
+
+    RegionList::iterator remove(RegionList::iterator);
+
+    void evict_over_budget();
+
+    // most recently decayed at the front
+    RegionList m_regions;
+    std::unordered_map
+        <Vector2I, RegionList::iterator, Vector2IHasher> m_index;
+    std::size_t m_byte_budget = 0;
+    Metrics m_metrics;
+};
@@ -0,0 +1,200 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "LazyMapRegion.hpp"
+#include "map-loader-task.hpp"
+
+#include "../platform.hpp"
+
+#include <unordered_set>
+
+namespace {
+
+using Clock = LazyMapRegionKeeper::Clock;
+using Continuation = BackgroundTask::Continuation;
+using ContinuationStrategy = BackgroundTask::ContinuationStrategy;
+using State = LazyMapRegion::State;
+
+bool is_evictable(const LazyMapRegion &);
+
+} // end of <anonymous> namespace
+
+LazyMapRegion::LazyMapRegion
+    (const std::string & map_filename,
+     const Size2I & sub_region_grid_size):
+    m_map_filename(make_shared<const std::string>(map_filename)),
+    m_sub_region_grid_size(sub_region_grid_size),
+    m_self(make_shared<LazyMapRegion *>(this))
+{
+    if (sub_region_grid_size.width > 0 && sub_region_grid_size.height > 0)
+        { return; }
+    throw InvalidArgument{"Sub region grid must have a positive size"};
+}
+
+LazyMapRegion::~LazyMapRegion()
+    { *m_self = nullptr; }
+
+void LazyMapRegion::process_load_request
+    (const RegionLoadRequestBase & request,
+     const RegionPositionFraming & framing,
+     RegionLoadCollectorBase & collector,
+     const Optional<RectangleI> & grid_scope)
+{
+    collector.collect_lazy_region(*this);
+    if (m_state != State::admitted) return;
+
+    if (grid_scope) {
+        m_loaded_region->process_load_request
+            (request, framing, collector, to_map_scope(*grid_scope));
+    } else {
+        m_loaded_region->process_load_request(request, framing, collector);
+    }
+}
+
+Size2I LazyMapRegion::size2() const
+    { return m_loaded_region ? m_loaded_region->size2() : Size2I{}; }
+
+SharedPtr<BackgroundTask> LazyMapRegion::begin_loading(Platform & platform) {
+    if (m_state != State::unloaded) {
+        throw RuntimeError{"Lazy map region is already loading or loaded"};
+    }
+    m_state = State::loading;
+    auto loader = MapLoaderTask_::make(m_map_filename->c_str(), platform);
+    return BackgroundTask::make
+        ([loader = std::move(loader), self = m_self, has_waited = false]
+         (TaskCallbacks &, ContinuationStrategy & strategy) mutable
+         -> Continuation &
+    {
+        if (!has_waited) {
+            has_waited = true;
+            return strategy.continue_().wait_on(loader);
+        }
+        auto res = loader->retrieve();
+        // the region may have gone while its map was loading
+        if (*self) {
+            (**self).finish_loading
+                (std::move(res.map_region), res.region_content_key);
+        }
+        return strategy.finish_task();
+    });
+}
+
+void LazyMapRegion::finish_loading
+    (UniquePtr<MapRegion> && loaded_region, std::uint64_t content_key)
+{
+    if (!loaded_region) {
+        throw InvalidArgument{"Lazy map region cannot finish without a region"};
+    }
+    m_loaded_region = std::move(loaded_region);
+    m_content_key = content_key;
+    m_state = State::loaded;
+}
+
+void LazyMapRegion::admit() {
+    if (m_state != State::loaded) {
+        throw RuntimeError{"Only a loaded (and not yet admitted) lazy map "
+                           "region may be admitted"};
+    }
+    m_state = State::admitted;
+}
+
+void LazyMapRegion::evict() {
+    m_loaded_region = nullptr;
+    m_content_key = 0;
+    m_state = State::unloaded;
+}
+
+/* private */ RectangleI LazyMapRegion::to_map_scope
+    (const RectangleI & sub_region_scope) const
+{
+    auto map_size = m_loaded_region->size2();
+    auto width  = map_size.width  / m_sub_region_grid_size.width;
+    auto height = map_size.height / m_sub_region_grid_size.height;
+    const auto & scope = sub_region_scope;
+    return RectangleI
+        {scope.left *width, scope.top   *height,
+         scope.width*width, scope.height*height};
+}
+
+// ----------------------------------------------------------------------------
+
+LazyMapRegionKeeper::LazyMapRegionKeeper(Real eviction_seconds):
+    m_eviction_time(std::chrono::duration_cast<Clock::duration>
+        (std::chrono::duration<Real>{eviction_seconds})) {}
+
+std::vector<LazyMapRegion *> LazyMapRegionKeeper::touch
+    (const std::vector<LazyMapRegion *> & regions,
+     TaskCallbacks & callbacks,
+     Clock::time_point now)
+{
+    // a region is usually collected once for each of its sub regions
+    std::unordered_set<LazyMapRegion *> loaded;
+    std::vector<LazyMapRegion *> newly_loaded;
+    for (auto * region : regions) {
+        m_last_touched[region] = now;
+        switch (region->state()) {
+        case State::unloaded:
+            callbacks.add(region->begin_loading(callbacks.platform()));
+            break;
+        case State::loaded:
+            if (loaded.insert(region).second)
+                { newly_loaded.push_back(region); }
+            break;
+        default: break;
+        }
+    }
+    return newly_loaded;
+}
+
+bool LazyMapRegionKeeper::has_untouched(Clock::time_point now) const {
+    for (auto & [region, last_touched] : m_last_touched) {
+        if (now - last_touched >= m_eviction_time && is_evictable(*region))
+            { return true; }
+    }
+    return false;
+}
+
+int LazyMapRegionKeeper::evict_untouched(Clock::time_point now) {
+    int evicted = 0;
+    for (auto itr = m_last_touched.begin(); itr != m_last_touched.end(); ) {
+        auto & [region, last_touched] = *itr;
+        if (   now - last_touched < m_eviction_time
+            || region->state() == State::loading)
+        {
+            ++itr;
+            continue;
+        }
+        if (is_evictable(*region)) {
+            region->evict();
+            ++evicted;
+        }
+        itr = m_last_touched.erase(itr);
+    }
+    return evicted;
+}
+
+namespace {
+
+bool is_evictable(const LazyMapRegion & region) {
+    return    region.state() == State::loaded
+           || region.state() == State::admitted;
+}
+
+} // end of <anonymous> namespace
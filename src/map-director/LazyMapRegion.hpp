@@ -0,0 +1,135 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "MapRegion.hpp"
+
+#include "../Tasks.hpp"
+
+#include <chrono>
+#include <unordered_map>
+
+class Platform;
+
+/// Stands in for a sub map, which is only loaded once a load request first
+/// overlaps it.
+///
+/// Grid scopes given to this region are in sub regions (tiles of the
+/// composite tileset), as the map's size is not known until it's loaded.
+/// Requests are only passed on once the loaded map is admitted.
+class LazyMapRegion final : public MapRegion {
+public:
+    enum class State {
+        unloaded,
+        loading,
+        /// loaded, but not yet admitted
+        loaded,
+        admitted
+    };
+
+    LazyMapRegion
+        (const std::string & map_filename,
+         const Size2I & sub_region_grid_size);
+
+    LazyMapRegion(const LazyMapRegion &) = delete;
+
+    ~LazyMapRegion();
+
+    LazyMapRegion & operator = (const LazyMapRegion &) = delete;
+
+    /// Collects this region with the collector, whether it's loaded or not.
+    void process_load_request
+        (const RegionLoadRequestBase &,
+         const RegionPositionFraming &,
+         RegionLoadCollectorBase &,
+         const Optional<RectangleI> & grid_scope = {}) final;
+
+    /// @returns size of the loaded map, or nothing if not loaded
+    Size2I size2() const final;
+
+    /// @returns task reading, and parsing the map, and setting up its
+    ///          producables, which finishes loading this region
+    SharedPtr<BackgroundTask> begin_loading(Platform &);
+
+    void finish_loading(UniquePtr<MapRegion> &&, std::uint64_t content_key);
+
+    void admit();
+
+    /// drops the loaded map, it's loaded again once next overlapped
+    void evict();
+
+    State state() const noexcept { return m_state; }
+
+    const std::string & map_filename() const noexcept
+        { return *m_map_filename; }
+
+    /// @returns key of all files the map was loaded from
+    std::uint64_t content_key() const noexcept { return m_content_key; }
+
+private:
+    RectangleI to_map_scope(const RectangleI & sub_region_scope) const;
+
+    SharedPtr<const std::string> m_map_filename;
+    Size2I m_sub_region_grid_size;
+    State m_state = State::unloaded;
+    UniquePtr<MapRegion> m_loaded_region;
+    std::uint64_t m_content_key = 0;
+    // loading tasks may outlive this region
+    SharedPtr<LazyMapRegion *> m_self;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Starts loading lazy regions as they're overlapped, and evicts loaded ones
+/// which have gone untouched for too long.
+///
+/// Load jobs refer to the producables of their map, so any still to be
+/// prepared should be done before evicting.
+class LazyMapRegionKeeper final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LazyMapRegionKeeper() {}
+
+    explicit LazyMapRegionKeeper(Real eviction_seconds);
+
+    /// @returns regions which have finished loading, and are waiting to be
+    ///          admitted
+    std::vector<LazyMapRegion *> touch
+        (const std::vector<LazyMapRegion *> &,
+         TaskCallbacks &,
+         Clock::time_point now);
+
+    /// @returns true if any loaded region has gone untouched for too long
+    bool has_untouched(Clock::time_point now) const;
+
+    /// Regions still loading are kept, until touched again once loaded.
+    ///
+    /// @returns number of regions evicted
+    int evict_untouched(Clock::time_point now);
+
+    /// @returns number of regions touched, and not yet evicted
+    std::size_t kept_count() const noexcept { return m_last_touched.size(); }
+
+private:
+    std::unordered_map<LazyMapRegion *, Clock::time_point> m_last_touched;
+    Clock::duration m_eviction_time = Clock::duration::max();
+};
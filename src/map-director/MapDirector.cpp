@@ -21,7 +21,9 @@
 #include "MapDirector.hpp"
 #include "map-loader-task.hpp"
 #include "RegionLoadRequest.hpp"
+#include "map-loader-task/TilesetCache.hpp"
 #include "../targeting-state.hpp"
+#include "../Configuration.hpp"
 #include "../RenderModel.hpp"
 #include "../Texture.hpp"
 
@@ -39,7 +41,10 @@ public:
     MapDirectorTask
         (Entity player_physics,
          PpDriver &,
-         UniquePtr<MapRegion> && root_region);
+         UniquePtr<MapRegion> && root_region,
+         const std::string & map_filename,
+         std::uint64_t region_content_key,
+         SharedPtr<TilesetCache> && tileset_cache);
 
     Continuation & in_background
         (Callbacks &, ContinuationStrategy &) final;
@@ -55,8 +60,10 @@ class PlayerMapPreperationTask final : public BackgroundTask {
 public:
     PlayerMapPreperationTask
         (SharedPtr<MapLoaderTask_> && map_loader,
+         const char * map_filename,
          Entity && player_physics,
-         PpDriver & ppdriver);
+         PpDriver & ppdriver,
+         SharedPtr<TilesetCache> && tileset_cache);
 
     Continuation & in_background
         (Callbacks & callbacks, ContinuationStrategy & strategy) final;
@@ -64,8 +71,10 @@ public:
 private:
     bool m_finished_loading_map = false;
     SharedPtr<MapLoaderTask_> m_map_loader;
+    std::string m_map_filename;
     Entity m_player_physics;
     PpDriver & m_ppdriver;
+    SharedPtr<TilesetCache> m_tileset_cache;
 };
 
 } // end of <anonymous> namespace
@@ -77,10 +86,14 @@ private:
      Platform & platform,
      PpDriver & ppdriver)
 {
+    // held before the initial map loads, so that its tilesets are kept too
+    auto tileset_cache = TilesetCache::make_shared_cache();
     return std::make_shared<PlayerMapPreperationTask>
         (MapLoaderTask_::make(initial_map, platform),
+         initial_map,
          std::move(player_physics),
-         ppdriver);
+         ppdriver,
+         std::move(tileset_cache));
 }
 
 void MapDirector::on_every_frame
@@ -98,8 +111,12 @@ void MapDirector::on_every_frame
 /* private */ void MapDirector::check_for_other_map_segments
     (TaskCallbacks & callbacks, const Entity & physics_ent)
 {
+    auto prefetch_plan = RegionPrefetchPlan::find
+        (physics_ent,
+         k_region_prefetch_horizon_seconds,
+         k_region_prefetch_step_seconds);
     m_region_tracker.process_load_requests
-        (RegionLoadRequest::find(physics_ent), callbacks);
+        (RegionLoadRequest::find(physics_ent), prefetch_plan, callbacks);
 }
 
 namespace {
@@ -107,9 +124,14 @@ namespace {
 MapDirectorTask::MapDirectorTask
     (Entity player_physics,
      PpDriver & ppdriver,
-     UniquePtr<MapRegion> && root_region):
+     UniquePtr<MapRegion> && root_region,
+     const std::string & map_filename,
+     std::uint64_t region_content_key,
+     SharedPtr<TilesetCache> && tileset_cache):
     m_physics_physics_ref(player_physics.as_reference()),
-    m_map_director(ppdriver, std::move(root_region)) {}
+    m_map_director
+        (ppdriver, std::move(root_region), map_filename, region_content_key,
+         std::move(tileset_cache)) {}
 
 Continuation & MapDirectorTask::in_background
     (Callbacks & taskcallbacks, ContinuationStrategy & strat)
@@ -123,11 +145,15 @@ Continuation & MapDirectorTask::in_background
 
 PlayerMapPreperationTask::PlayerMapPreperationTask
     (SharedPtr<MapLoaderTask_> && map_loader,
+     const char * map_filename,
      Entity && player_physics,
-     PpDriver & ppdriver):
+     PpDriver & ppdriver,
+     SharedPtr<TilesetCache> && tileset_cache):
     m_map_loader(std::move(map_loader)),
+    m_map_filename(map_filename),
     m_player_physics(std::move(player_physics)),
-    m_ppdriver(ppdriver) {}
+    m_ppdriver(ppdriver),
+    m_tileset_cache(std::move(tileset_cache)) {}
 
 using AddEntityFunc =
     void (*)(const MapObject &,
@@ -158,6 +184,7 @@ void add_baddie_a
         add(ModelVisibility{}).
         add(TargetComponent{}).
         add<PpState>(PpInAir{location, Vector{}}).
+        add(PhysicsActivity{}).
         add_to_entity(ent);
     callbacks.add(ent);
 }
@@ -176,7 +203,8 @@ Continuation & PlayerMapPreperationTask::in_background
         (m_player_physics.as_reference());
     auto res = m_map_loader->retrieve();
     auto map_director_task = make_shared<MapDirectorTask>
-        (m_player_physics, m_ppdriver, std::move(res.map_region));
+        (m_player_physics, m_ppdriver, std::move(res.map_region),
+         m_map_filename, res.region_content_key, std::move(m_tileset_cache));
     for (auto [id, obj_ptr] : res.map_objects.map_objects()) {
         auto found = a.find(obj_ptr->get_string_attribute("type"));
         if (found == a.end()) continue;
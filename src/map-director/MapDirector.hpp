@@ -24,6 +24,8 @@
 
 #include "../map-director.hpp"
 
+class TilesetCache;
+
 /** @brief The MapDirector turns player physics things into map region
  *         loading/unloading.
  *
@@ -39,9 +41,17 @@ public:
          Platform & platform,
          PpDriver & ppdriver);
 
-    MapDirector(PpDriver & ppdriver, UniquePtr<MapRegion> && root_region):
+    /// @param tileset_cache shared tileset cache, held for as long as this
+    ///        director is around (may be null)
+    MapDirector(PpDriver & ppdriver,
+                UniquePtr<MapRegion> && root_region,
+                const std::string & map_filename,
+                std::uint64_t region_content_key,
+                SharedPtr<TilesetCache> && tileset_cache):
         m_ppdriver(&ppdriver),
-        m_region_tracker(std::move(root_region)) {}
+        m_tileset_cache(std::move(tileset_cache)),
+        m_region_tracker
+            (std::move(root_region), map_filename, region_content_key) {}
 
     void on_every_frame
         (TaskCallbacks & callbacks, const Entity & physics_ent) final;
@@ -55,5 +65,6 @@ private:
 
     // there's only one per game and it never changes
     PpDriver * m_ppdriver = nullptr;
+    SharedPtr<TilesetCache> m_tileset_cache;
     MapRegionTracker m_region_tracker;
 };
@@ -20,6 +20,14 @@
 
 #include "MapRegion.hpp"
 
+std::vector<LazyMapRegion *> RegionLoadCollectorBase::take_lazy_regions() {
+    std::vector<LazyMapRegion *> rv;
+    std::swap(rv, m_lazy_regions);
+    return rv;
+}
+
+// ----------------------------------------------------------------------------
+
 TiledMapRegion::TiledMapRegion
     (ProducableTileViewGrid && producables_view_grid,
      ScaleComputation && scale_computation):
@@ -25,6 +25,7 @@
 class RegionLoadRequestBase;
 class ScaleComputation;
 class ProducableTileGridStacker;
+class LazyMapRegion;
 
 class RegionLoadCollectorBase {
 public:
@@ -34,6 +35,16 @@ public:
 
     virtual void collect_load_job
         (const SubRegionPositionFraming &, const ProducableSubGrid &) = 0;
+
+    /// lazy regions are collected whenever overlapped, loaded or not
+    void collect_lazy_region(LazyMapRegion & region)
+        { m_lazy_regions.push_back(&region); }
+
+    /// @returns all lazy regions collected since the last call
+    std::vector<LazyMapRegion *> take_lazy_regions();
+
+private:
+    std::vector<LazyMapRegion *> m_lazy_regions;
 };
 
 // ----------------------------------------------------------------------------
@@ -20,20 +20,25 @@
 
 #include "MapRegionChangesTask.hpp"
 #include "RegionEdgeConnectionsContainer.hpp"
+#include "RegionGeometryCache.hpp"
 #include "../TriangleLink.hpp"
+#include "../TriangleEdgeWelder.hpp"
+#include "../platform.hpp"
+
+#include <algorithm>
 
 namespace {
 
 using ViewGridTriangle = MapRegionContainer::ViewGridTriangle;
 
-// has two jobs :/
-// becomes an entity and link grid adder
-class EntityAndLinkInsertingAdder final : public ProducableTileCallbacks {
+/// Gathers everything producables make, without touching anything the
+/// frame thread may be using.
+class RegionPreparingAdder final : public ProducableTileCallbacks {
 public:
-    EntityAndLinkInsertingAdder
-        (TaskCallbacks &,
-         Size2I grid_size,
-         const TilePositionFraming &);
+    RegionPreparingAdder
+        (Size2I grid_size,
+         const TilePositionFraming &,
+         bool keeps_collidables = true);
 
     SharedPtr<RenderModel> make_render_model() final;
 
@@ -44,11 +49,13 @@ public:
     void advance_grid_position()
         { m_tile_framing = m_tile_framing.advance_with(m_triangle_inserter); }
 
-    std::vector<Entity> finish_adding_entites();
+    std::vector<Entity> finish_adding_entites()
+        { return std::move(m_entities); }
 
-    SharedPtr<ViewGridTriangle> finish_adding_triangles();
+    std::vector<SharedPtr<PreparedRenderModel>> finish_adding_render_models()
+        { return std::move(m_render_models); }
 
-    // wants a finish method
+    SharedPtr<ViewGridTriangle> finish_adding_triangles();
 
 private:
     ModelScale model_scale() const final
@@ -59,16 +66,112 @@ private:
 
     ViewGridTriangle finish_triangle_grid();
 
-    TaskCallbacks & m_callbacks;
     ViewGridInserter<TriangleSegment> m_triangle_inserter;
     std::vector<Entity> m_entities;
+    std::vector<SharedPtr<PreparedRenderModel>> m_render_models;
     TilePositionFraming m_tile_framing;
+    bool m_keeps_collidables = true;
 };
 
 void link_triangles(ViewGridTriangle &);
 
 } // end of <anonymous> namespace
 
+void PreparedRenderModel::upload(PlatformAssetsStrategy & platform) {
+    auto model = platform.make_render_model();
+    model->load(m_data);
+    m_uploaded = std::move(model);
+    m_uploaded_bytes =
+        m_data.vertices.size()*sizeof(Vertex) +
+        m_data.elements.size()*sizeof(unsigned);
+    m_data = RenderModelData{};
+}
+
+void PreparedRenderModel::render() const
+    { if (m_uploaded) m_uploaded->render(); }
+
+bool PreparedRenderModel::is_loaded() const noexcept
+    { return m_uploaded && m_uploaded->is_loaded(); }
+
+/* private */ void PreparedRenderModel::load_
+    (const Vertex   * vertex_beg  , const Vertex   * vertex_end,
+     const unsigned * elements_beg, const unsigned * elements_end)
+{
+    m_data.vertices.assign(vertex_beg, vertex_end);
+    m_data.elements.assign(elements_beg, elements_end);
+}
+
+// ----------------------------------------------------------------------------
+
+/* static */ PreparedRegion PreparedRegion::revived
+    (const SubRegionPositionFraming & sub_region_framing,
+     const DecayedRegion & decayed_region)
+{
+    PreparedRegion prepared
+        {sub_region_framing,
+         SharedPtr<ViewGridTriangle>{decayed_region.triangle_grid()},
+         decayed_region.make_entities(),
+         {}};
+    prepared.m_resumes_links = true;
+    return prepared;
+}
+
+PreparedRegion::PreparedRegion
+    (const SubRegionPositionFraming & sub_region_framing,
+     SharedPtr<ViewGridTriangle> && triangle_grid,
+     std::vector<Entity> && entities,
+     std::vector<SharedPtr<PreparedRenderModel>> && render_models):
+    m_sub_region_framing(sub_region_framing),
+    m_triangle_grid(std::move(triangle_grid)),
+    m_entities(std::move(entities)),
+    m_render_models(std::move(render_models)) {}
+
+void PreparedRegion::commit
+    (MapRegionContainer & container,
+     RegionEdgeConnectionsAdder & edge_container_adder,
+     TaskCallbacks & callbacks)
+{ while (!commit_step(container, edge_container_adder, callbacks)) {} }
+
+bool PreparedRegion::commit_step
+    (MapRegionContainer & container,
+     RegionEdgeConnectionsAdder & edge_container_adder,
+     TaskCallbacks & callbacks)
+{
+    switch (m_next_step) {
+    case CommitStep::upload_render_models:
+        if (m_uploaded_count < m_render_models.size())
+            { m_render_models[m_uploaded_count++]->upload(callbacks.platform()); }
+        if (m_uploaded_count == m_render_models.size()) {
+            m_render_models.clear();
+            m_next_step = CommitStep::register_links;
+        }
+        return false;
+    case CommitStep::register_links:
+        for (auto & link : m_triangle_grid->elements()) {
+            if (m_resumes_links)
+                { TriangleLinkStore::instance().resume(*link); }
+            callbacks.add(link);
+        }
+        m_next_step = CommitStep::add_entities;
+        return false;
+    case CommitStep::add_entities:
+        for (auto & e : m_entities)
+            { callbacks.add(e); }
+        m_next_step = CommitStep::set_region;
+        return false;
+    case CommitStep::set_region:
+        m_sub_region_framing.set_containers_with
+            (std::move(m_triangle_grid), std::move(m_entities),
+             container, edge_container_adder);
+        m_next_step = CommitStep::done;
+        return true;
+    case CommitStep::done: return true;
+    }
+    throw BadBranchException{__LINE__, __FILE__};
+}
+
+// ----------------------------------------------------------------------------
+
 RegionLoadJob::RegionLoadJob
     (const SubRegionPositionFraming & sub_region_framing,
      const ProducableSubGrid & subgrid):
@@ -79,19 +182,44 @@ void RegionLoadJob::operator ()
     (MapRegionContainer & container,
      RegionEdgeConnectionsAdder & edge_container_adder,
      TaskCallbacks & callbacks) const
+{ prepare().commit(container, edge_container_adder, callbacks); }
+
+PreparedRegion RegionLoadJob::prepare() const
+    { return prepare_(nullptr); }
+
+PreparedRegion RegionLoadJob::prepare
+    (RegionGeometryCache & geometry_cache) const
+    { return prepare_(&geometry_cache); }
+
+PreparedRegion RegionLoadJob::prepare_from
+    (const DecayedRegion & decayed_region) const
+    { return PreparedRegion::revived(m_sub_region_framing, decayed_region); }
+
+/* private */ PreparedRegion RegionLoadJob::prepare_
+    (RegionGeometryCache * geometry_cache) const
 {
-    EntityAndLinkInsertingAdder triangle_entities_adder
-        {callbacks, m_subgrid.size2(), m_sub_region_framing.tile_framing()};
+    SharedPtr<ViewGridTriangle> triangle_grid;
+    if (geometry_cache)
+        { triangle_grid = geometry_cache->find(on_field_position()); }
+    bool is_cached = !!triangle_grid;
+    RegionPreparingAdder adder
+        {m_subgrid.size2(), m_sub_region_framing.tile_framing(), !is_cached};
     for (auto & producables_view : m_subgrid) {
         for (auto producable : producables_view) {
-            (*producable)(triangle_entities_adder);
+            (*producable)(adder);
         }
-        triangle_entities_adder.advance_grid_position();
+        adder.advance_grid_position();
+    }
+    if (!is_cached) {
+        triangle_grid = adder.finish_adding_triangles();
+        if (geometry_cache)
+            { geometry_cache->add(on_field_position(), *triangle_grid); }
     }
-    m_sub_region_framing.set_containers_with
-        (triangle_entities_adder.finish_adding_triangles(),
-         triangle_entities_adder.finish_adding_entites(),
-         container, edge_container_adder);
+    return PreparedRegion
+        {m_sub_region_framing,
+         std::move(triangle_grid),
+         adder.finish_adding_entites(),
+         adder.finish_adding_render_models()};
 }
 
 // ----------------------------------------------------------------------------
@@ -117,6 +245,334 @@ void RegionDecayJob::operator ()
          m_triangle_grid);
 }
 
+void RegionDecayJob::restore_to(MapRegionContainer & container) && {
+    container.set_region
+        (m_on_field_position, m_triangle_grid, std::move(m_entities));
+}
+
+DecayedRegion RegionDecayJob::to_decayed_region() const {
+    return DecayedRegion
+        {m_on_field_position, m_triangle_grid.triangle_grid(), m_entities};
+}
+
+// ----------------------------------------------------------------------------
+
+RegionPreparationQueue::RegionPreparationQueue
+    (int thread_count, RegionGeometryCache * geometry_cache):
+    m_geometry_cache(geometry_cache)
+{
+    for (int i = 0; i < thread_count; ++i)
+        { m_workers.emplace_back([this] { run_worker(); }); }
+}
+
+RegionPreparationQueue::~RegionPreparationQueue() {
+    {
+    std::unique_lock lock{m_mutex};
+    m_stopping = true;
+    }
+    m_job_pushed.notify_all();
+    for (auto & worker : m_workers)
+        { worker.join(); }
+}
+
+bool RegionPreparationQueue::push(const RegionLoadJob & job) {
+    const auto & position = job.on_field_position();
+    {
+    std::unique_lock lock{m_mutex};
+    // finished, but not yet taken
+    bool is_finished = std::any_of
+        (m_finished.begin(), m_finished.end(),
+         [&position] (const PreparedRegion & prepared)
+         { return prepared.on_field_position() == position; });
+    if (is_finished)
+        { return false; }
+    auto prefetched = m_prefetched.find(position);
+    if (prefetched != m_prefetched.end()) {
+        m_finished.emplace_back(std::move(prefetched->second));
+        m_prefetched.erase(prefetched);
+        return true;
+    }
+    auto preparing = m_preparing.find(position);
+    if (preparing != m_preparing.end()) {
+        if (preparing->second.purpose == Purpose::load)
+            { return false; }
+        // a prefetch, turned into a load, goes to the front of the line
+        preparing->second.purpose = Purpose::load;
+        for (auto & queued : m_jobs) {
+            if (queued.job.on_field_position() == position)
+                { queued.priority = k_load_priority; }
+        }
+        return true;
+    }
+    m_preparing.emplace(position, Preparation{Purpose::load, m_next_ticket++});
+    m_jobs.emplace_back(job, k_load_priority);
+    }
+    m_job_pushed.notify_one();
+    return true;
+}
+
+bool RegionPreparationQueue::push_prefetch
+    (const RegionLoadJob & job, Real seconds_to_arrival)
+{
+    if (m_workers.empty()) return false;
+    const auto & position = job.on_field_position();
+    {
+    std::unique_lock lock{m_mutex};
+    if (m_prefetched.find(position) != m_prefetched.end())
+        { return false; }
+    auto preparing = m_preparing.find(position);
+    if (preparing != m_preparing.end()) {
+        if (preparing->second.purpose == Purpose::canceled)
+            { preparing->second.purpose = Purpose::prefetch; }
+        for (auto & queued : m_jobs) {
+            if (   queued.job.on_field_position() == position
+                && queued.priority != k_load_priority)
+            { queued.priority = seconds_to_arrival; }
+        }
+        return false;
+    }
+    m_preparing.emplace
+        (position, Preparation{Purpose::prefetch, m_next_ticket++});
+    m_jobs.emplace_back(job, seconds_to_arrival);
+    }
+    m_job_pushed.notify_one();
+    return true;
+}
+
+void RegionPreparationQueue::cancel_prefetches_except
+    (const PositionSet & kept_positions)
+{
+    auto is_kept = [&kept_positions] (const Vector2I & position)
+        { return kept_positions.find(position) != kept_positions.end(); };
+    // dropped outside of the lock, as destroying links takes some time
+    std::vector<PreparedRegion> dropped;
+    std::unique_lock lock{m_mutex};
+    auto jobs_end = std::remove_if
+        (m_jobs.begin(), m_jobs.end(),
+         [this, &is_kept] (const QueuedJob & queued) {
+            const auto & position = queued.job.on_field_position();
+            if (   queued.priority == k_load_priority
+                || is_kept(position))
+            { return false; }
+            m_preparing.erase(position);
+            return true;
+         });
+    m_jobs.erase(jobs_end, m_jobs.end());
+    for (auto & [position, preparation] : m_preparing) {
+        auto & purpose = preparation.purpose;
+        if (purpose == Purpose::prefetch && !is_kept(position))
+            { purpose = Purpose::canceled; }
+    }
+    for (auto itr = m_prefetched.begin(); itr != m_prefetched.end(); ) {
+        if (is_kept(itr->first)) {
+            ++itr;
+            continue;
+        }
+        dropped.emplace_back(std::move(itr->second));
+        itr = m_prefetched.erase(itr);
+    }
+}
+
+bool RegionPreparationQueue::prepare_next() {
+    if (!m_workers.empty() || m_jobs.empty()) return false;
+    auto next = std::min_element
+        (m_jobs.begin(), m_jobs.end(),
+         [] (const QueuedJob & lhs, const QueuedJob & rhs)
+         { return lhs.priority < rhs.priority; });
+    auto job = std::move(next->job);
+    m_jobs.erase(next);
+    m_preparing.erase(job.on_field_position());
+    m_finished.emplace_back(prepare(job));
+    return true;
+}
+
+void RegionPreparationQueue::wait_for_all() {
+    if (m_workers.empty()) {
+        while (prepare_next()) {}
+        return;
+    }
+    std::unique_lock lock{m_mutex};
+    m_job_finished.wait(lock, [this] { return m_preparing.empty(); });
+}
+
+std::uint64_t RegionPreparationQueue::next_ticket() {
+    std::unique_lock lock{m_mutex};
+    return m_next_ticket;
+}
+
+bool RegionPreparationQueue::has_finished_before(std::uint64_t ticket) {
+    std::unique_lock lock{m_mutex};
+    return std::none_of
+        (m_preparing.begin(), m_preparing.end(),
+         [ticket] (const auto & pair) { return pair.second.ticket < ticket; });
+}
+
+std::vector<PreparedRegion> RegionPreparationQueue::take_finished() {
+    std::vector<PreparedRegion> finished;
+    std::exception_ptr error;
+    {
+    std::unique_lock lock{m_mutex};
+    std::swap(finished, m_finished);
+    std::swap(error, m_error);
+    }
+    if (error)
+        { std::rethrow_exception(error); }
+    return finished;
+}
+
+std::size_t RegionPreparationQueue::prefetched_count() {
+    std::unique_lock lock{m_mutex};
+    return m_prefetched.size();
+}
+
+/* private */ PreparedRegion RegionPreparationQueue::prepare
+    (const RegionLoadJob & job) const
+{
+    if (m_geometry_cache)
+        { return job.prepare(*m_geometry_cache); }
+    return job.prepare();
+}
+
+/* private */ void RegionPreparationQueue::run_worker() {
+    std::unique_lock lock{m_mutex};
+    while (true) {
+        m_job_pushed.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if (m_stopping) return;
+
+        auto next = std::min_element
+            (m_jobs.begin(), m_jobs.end(),
+             [] (const QueuedJob & lhs, const QueuedJob & rhs)
+             { return lhs.priority < rhs.priority; });
+        auto job = std::move(next->job);
+        m_jobs.erase(next);
+        lock.unlock();
+        Optional<PreparedRegion> prepared;
+        std::exception_ptr error;
+        try {
+            prepared = prepare(job);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        auto preparing = m_preparing.find(job.on_field_position());
+        auto purpose = preparing->second.purpose;
+        if (prepared && purpose == Purpose::load) {
+            m_finished.emplace_back(std::move(*prepared));
+        } else if (prepared && purpose == Purpose::prefetch) {
+            m_prefetched.emplace(job.on_field_position(), std::move(*prepared));
+        }
+        if (error && !m_error)
+            { m_error = error; }
+        m_preparing.erase(preparing);
+        m_job_finished.notify_all();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+RegionChangeScheduler::RegionChangeScheduler
+    (Real seconds_per_frame, std::size_t decayed_region_cache_bytes):
+    m_decayed_regions(decayed_region_cache_bytes)
+{
+    if (seconds_per_frame <= 0) return;
+    m_budget = std::chrono::duration_cast<Clock::duration>
+        (std::chrono::duration<Real>{seconds_per_frame});
+}
+
+void RegionChangeScheduler::add(PreparedRegion && prepared)
+    { m_commits.emplace_back(std::move(prepared)); }
+
+void RegionChangeScheduler::add(std::vector<PreparedRegion> && prepared_regions) {
+    for (auto & prepared : prepared_regions)
+        { add(std::move(prepared)); }
+}
+
+void RegionChangeScheduler::add(std::vector<RegionDecayJob> && decay_jobs) {
+    for (auto & decay_job : decay_jobs)
+        { m_decays.emplace_back(std::move(decay_job)); }
+}
+
+bool RegionChangeScheduler::is_committing
+    (const Vector2I & on_field_position) const
+{
+    return std::any_of
+        (m_commits.begin(), m_commits.end(),
+         [&on_field_position] (const PreparedRegion & prepared)
+         { return prepared.on_field_position() == on_field_position; });
+}
+
+Optional<RegionDecayJob> RegionChangeScheduler::take_decay_at
+    (const Vector2I & on_field_position)
+{
+    auto itr = std::find_if
+        (m_decays.begin(), m_decays.end(),
+         [&on_field_position] (const RegionDecayJob & decay_job)
+         { return decay_job.on_field_position() == on_field_position; });
+    if (itr == m_decays.end()) return {};
+    Optional<RegionDecayJob> decay_job{std::move(*itr)};
+    m_decays.erase(itr);
+    return decay_job;
+}
+
+void RegionChangeScheduler::run
+    (TaskCallbacks & callbacks,
+     RegionEdgeConnectionsContainer & edge_container,
+     MapRegionContainer & container,
+     RegionPreparationQueue & preparations)
+{
+    auto start = Clock::now();
+    bool has_budget = m_budget && !container.is_empty();
+    int steps_taken = 0;
+    auto may_take_step = [&] {
+        return    steps_taken == 0 || !has_budget
+               || Clock::now() - start < *m_budget;
+    };
+
+    while (may_take_step() && preparations.prepare_next())
+        { ++steps_taken; }
+    add(preparations.take_finished());
+
+    if (has_pending_changes()) {
+        auto adder = edge_container.make_adder();
+        while (!m_commits.empty() && may_take_step()) {
+            auto & prepared = m_commits.front();
+            ++steps_taken;
+            // may have been loaded another way, while this was preparing
+            if (   !prepared.has_started_commit()
+                && container.region_refresh_at(prepared.on_field_position()))
+            {
+                m_commits.pop_front();
+                continue;
+            }
+            if (prepared.commit_step(container, adder, callbacks))
+                { m_commits.pop_front(); }
+        }
+
+        auto remover = adder.finish().make_remover();
+        // at least one decay every frame, so that a steady stream of commits
+        // can't keep old regions around forever
+        bool has_decayed = false;
+        while (!m_decays.empty() && (!has_decayed || may_take_step())) {
+            has_decayed = true;
+            if (m_decayed_regions.keeps_regions()) {
+                m_decayed_regions.add(m_decays.front().to_decayed_region());
+            }
+            m_decays.front()(remover, callbacks);
+            m_decays.pop_front();
+            ++steps_taken;
+        }
+        edge_container = remover.finish();
+    }
+
+    if (has_budget && Clock::now() - start > *m_budget)
+        { ++m_counters.budget_overruns; }
+    if (has_pending_changes()) {
+        ++m_counters.deferred_frames;
+        m_counters.deferred_commits += int(m_commits.size());
+        m_counters.deferred_decays += int(m_decays.size());
+    }
+}
+
 // ----------------------------------------------------------------------------
 
 /* protected static */ std::vector<RegionDecayJob>
@@ -173,6 +629,49 @@ RegionDecayCollector RegionLoadCollector::finish() {
 
 // ----------------------------------------------------------------------------
 
+RegionPrefetchCollector::RegionPrefetchCollector
+    (MapRegionContainer & container_):
+    m_container(&container_) {}
+
+RegionPrefetchCollector::RegionPrefetchCollector
+    (MapRegionContainer & container_,
+     const DecayedRegionCache & decayed_regions_):
+    m_container(&container_),
+    m_decayed_regions(&decayed_regions_) {}
+
+void RegionPrefetchCollector::collect_load_job
+    (const SubRegionPositionFraming & sub_region_framing,
+     const ProducableSubGrid & subgrid)
+{
+    // already loaded, or loading this frame
+    if (sub_region_framing.region_refresh_for(*m_container))
+        { return; }
+    // reviving is cheaper than anything a prefetch would save
+    if (   m_decayed_regions
+        && m_decayed_regions->contains(sub_region_framing.on_field_position()))
+    { return; }
+    // waypoints are visited soonest first, so the first arrival is kept
+    m_entries.emplace
+        (sub_region_framing.on_field_position(),
+         Entry{RegionLoadJob{sub_region_framing, subgrid}, m_seconds_to_arrival});
+}
+
+void RegionPrefetchCollector::finish
+    (RegionPreparationQueue & preparations, bool cancel_others)
+{
+    if (cancel_others) {
+        RegionPreparationQueue::PositionSet kept;
+        for (auto & [position, entry] : m_entries)
+            { kept.insert(position); }
+        preparations.cancel_prefetches_except(kept);
+    }
+    for (auto & [position, entry] : m_entries)
+        { preparations.push_prefetch(entry.job, entry.seconds_to_arrival); }
+    m_entries.clear();
+}
+
+// ----------------------------------------------------------------------------
+
 RegionDecayCollector::RegionDecayCollector
     (std::vector<RegionLoadJob> && load_jobs_,
      std::vector<RegionDecayJob> && decay_jobs_,
@@ -193,18 +692,28 @@ void RegionDecayCollector::add
 RegionLoadCollector RegionDecayCollector::run_changes
     (TaskCallbacks & task_callbacks,
      RegionEdgeConnectionsContainer & edge_container,
-     MapRegionContainer & container)
+     MapRegionContainer & container,
+     RegionPreparationQueue & preparations,
+     RegionChangeScheduler & scheduler)
 {
-    if (!m_load_entries.empty() || !m_decay_entries.empty()) {
-        auto adder = edge_container.make_adder();
-        for (auto & load_entry : m_load_entries)
-            { load_entry(container, adder, task_callbacks); }
-
-        auto remover = adder.finish().make_remover();
-        for (auto & decay_entry : m_decay_entries)
-            { decay_entry(remover, task_callbacks); }
-        edge_container = remover.finish();
+    auto & decayed_regions = scheduler.decayed_regions();
+    for (auto & load_entry : m_load_entries) {
+        const auto & position = load_entry.on_field_position();
+        if (auto decay_job = scheduler.take_decay_at(position)) {
+            std::move(*decay_job).restore_to(container);
+        } else if (scheduler.is_committing(position)) {
+            continue;
+        } else if (auto decayed_region = decayed_regions.take(position)) {
+            scheduler.add(load_entry.prepare_from(*decayed_region));
+        } else if (preparations.push(load_entry)) {
+            decayed_regions.record_miss();
+        }
     }
+    // with nothing loaded, there's nothing to stand on while waiting
+    if (container.is_empty())
+        { preparations.wait_for_all(); }
+    scheduler.add(std::move(m_decay_entries));
+    scheduler.run(task_callbacks, edge_container, container, preparations);
 
     m_decay_entries.clear();
     m_load_entries.clear();
@@ -219,68 +728,54 @@ namespace {
 SharedPtr<TriangleLink> to_link(const TriangleSegment & segment)
     { return make_shared<TriangleLink>(segment); }
 
-EntityAndLinkInsertingAdder::EntityAndLinkInsertingAdder
-    (TaskCallbacks & callbacks,
-     Size2I grid_size,
-     const TilePositionFraming & tile_framing):
-    m_callbacks(callbacks),
+RegionPreparingAdder::RegionPreparingAdder
+    (Size2I grid_size,
+     const TilePositionFraming & tile_framing,
+     bool keeps_collidables):
     m_triangle_inserter(grid_size),
-    m_tile_framing(tile_framing) {}
+    m_tile_framing(tile_framing),
+    m_keeps_collidables(keeps_collidables) {}
 
-std::vector<Entity> EntityAndLinkInsertingAdder::finish_adding_entites() {
-    for (auto & e : m_entities)
-        { m_callbacks.add(e); }
-    return std::move(m_entities);
-}
-
-SharedPtr<ViewGridTriangle> EntityAndLinkInsertingAdder::finish_adding_triangles() {
+SharedPtr<ViewGridTriangle> RegionPreparingAdder::finish_adding_triangles() {
     return make_shared<ViewGridTriangle>(finish_triangle_grid());
 }
 
-SharedPtr<RenderModel> EntityAndLinkInsertingAdder::make_render_model()
-    { return m_callbacks.platform().make_render_model(); }
+SharedPtr<RenderModel> RegionPreparingAdder::make_render_model() {
+    auto model = make_shared<PreparedRenderModel>();
+    m_render_models.push_back(model);
+    return model;
+}
 
-void EntityAndLinkInsertingAdder::add_collidable_
+void RegionPreparingAdder::add_collidable_
     (const TriangleSegment & triangle_segment)
-{ m_triangle_inserter.push(m_tile_framing.transform(triangle_segment)); }
+{
+    // triangles are already had from the geometry cache
+    if (!m_keeps_collidables) return;
+    m_triangle_inserter.push(m_tile_framing.transform(triangle_segment));
+}
 
-Entity EntityAndLinkInsertingAdder::add_entity_() {
+Entity RegionPreparingAdder::add_entity_() {
     auto e = Entity::make_sceneless_entity();
-    // NOTE: region load job adds the entity to the scene
+    // NOTE: committing the prepared region adds the entity to the scene
     m_entities.push_back(e);
     return e;
 }
 
-/* private */ ViewGridTriangle EntityAndLinkInsertingAdder::
-    finish_triangle_grid()
-{
+/* private */ ViewGridTriangle RegionPreparingAdder::finish_triangle_grid() {
     auto triangle_grid = m_triangle_inserter.
         transform_values<SharedPtr<TriangleLink>>(to_link).
         finish();
-    for (auto & link : triangle_grid.elements())
-        { m_callbacks.add(link); }
-
     link_triangles(triangle_grid);
     return triangle_grid;
 }
 
 void link_triangles(ViewGridTriangle & link_grid) {
-    for (Vector2I r; r != link_grid.end_position(); r = link_grid.next(r)) {
-    for (auto & this_tri : link_grid(r)) {
-        assert(this_tri);
-        for (Vector2I v : { r, Vector2I{1, 0} + r, Vector2I{-1,  0} + r,
-                               Vector2I{0, 1} + r, Vector2I{ 0, -1} + r})
-        {
-            if (!link_grid.has_position(v)) continue;
-            for (auto & other_tri : link_grid(v)) {
-                assert(other_tri);
-
-                if (this_tri == other_tri) continue;
-                TriangleLink::attach_unattached_matching_points
-                    (this_tri, other_tri);
-            }
-        }
-    }}
+    TriangleEdgeWelder welder;
+    for (auto & link : link_grid.elements()) {
+        assert(link);
+        welder.add(link);
+    }
+    welder.weld();
 }
 
 } // end of <anonymous> namespace
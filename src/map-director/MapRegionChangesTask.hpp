@@ -22,14 +22,117 @@
 
 #include "../Definitions.hpp"
 #include "../Tasks.hpp"
+#include "../RenderModel.hpp"
 
 #include "ProducableGrid.hpp"
 #include "MapRegion.hpp"
+#include "DecayedRegionCache.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 class RegionDecayCollector;
+class RegionGeometryCache;
 class RegionEdgeConnectionsRemover;
 class RegionEdgeConnectionsContainer;
 
+/// A render model made while preparing a region, before there's a platform
+/// to make a real one with.
+///
+/// Loaded vertices and elements are held onto, until uploaded on the frame
+/// thread. Once uploaded, it renders as the platform's model.
+class PreparedRenderModel final : public RenderModel {
+public:
+    void upload(PlatformAssetsStrategy &);
+
+    void render() const final;
+
+    bool is_loaded() const noexcept final;
+
+    /// @returns size of vertices and elements last uploaded
+    std::size_t uploaded_bytes() const noexcept { return m_uploaded_bytes; }
+
+private:
+    void load_(const Vertex   * vertex_beg  , const Vertex   * vertex_end,
+               const unsigned * elements_beg, const unsigned * elements_end) final;
+
+    RenderModelData m_data;
+    SharedPtr<RenderModel> m_uploaded;
+    std::size_t m_uploaded_bytes = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Everything a load job makes, that can be made away from the frame thread.
+///
+/// Triangles are already linked to each other, and entities already have all
+/// of their components. Nothing is known to the driver, scene, or platform
+/// until committed.
+class PreparedRegion final {
+public:
+    using ViewGridTriangle = MapRegionContainer::ViewGridTriangle;
+
+    PreparedRegion() {}
+
+    /// links of decayed regions are resumed in the link store, as they're
+    /// registered
+    static PreparedRegion revived
+        (const SubRegionPositionFraming &, const DecayedRegion &);
+
+    PreparedRegion
+        (const SubRegionPositionFraming &,
+         SharedPtr<ViewGridTriangle> &&,
+         std::vector<Entity> &&,
+         std::vector<SharedPtr<PreparedRenderModel>> &&);
+
+    const Vector2I & on_field_position() const noexcept
+        { return m_sub_region_framing.on_field_position(); }
+
+    /// uploads render models, and hands links and entities off to the
+    /// rest of the game (frame thread only)
+    void commit(MapRegionContainer &,
+                RegionEdgeConnectionsAdder &,
+                TaskCallbacks &);
+
+    /// Commits one step at a time; steps are uploading each render model,
+    /// registering links with the driver, adding entities, and finally
+    /// setting the region (which has its edges welded).
+    ///
+    /// @returns true once all steps are done
+    bool commit_step(MapRegionContainer &,
+                     RegionEdgeConnectionsAdder &,
+                     TaskCallbacks &);
+
+    bool has_started_commit() const noexcept {
+        return    m_next_step != CommitStep::upload_render_models
+               || m_uploaded_count != 0;
+    }
+
+private:
+    enum class CommitStep {
+        upload_render_models,
+        register_links,
+        add_entities,
+        set_region,
+        done
+    };
+
+    CommitStep m_next_step = CommitStep::upload_render_models;
+    std::size_t m_uploaded_count = 0;
+    SubRegionPositionFraming m_sub_region_framing;
+    SharedPtr<ViewGridTriangle> m_triangle_grid;
+    std::vector<Entity> m_entities;
+    std::vector<SharedPtr<PreparedRenderModel>> m_render_models;
+    bool m_resumes_links = false;
+};
+
+// ----------------------------------------------------------------------------
+
 class RegionLoadJob final {
 public:
     using ProducableSubGrid = ProducableTileViewGrid::SubGrid;
@@ -38,11 +141,33 @@ public:
 
     RegionLoadJob(const SubRegionPositionFraming &, const ProducableSubGrid &);
 
+    /// prepares and then commits right away
     void operator () (MapRegionContainer &,
                       RegionEdgeConnectionsAdder &,
                       TaskCallbacks &) const;
 
+    /// Runs all producables of the sub region.
+    ///
+    /// This may be called from any thread, so long as the producables'
+    /// region outlives the call.
+    PreparedRegion prepare() const;
+
+    /// Prepares using triangles kept from an earlier run, if there are any.
+    /// Producables are still run for their entities. Otherwise prepares as
+    /// usual, and keeps the triangles made.
+    PreparedRegion prepare(RegionGeometryCache &) const;
+
+    /// Prepares from a region which had decayed, without running any
+    /// producables. Links are already linked, and render models already
+    /// uploaded.
+    PreparedRegion prepare_from(const DecayedRegion &) const;
+
+    const Vector2I & on_field_position() const noexcept
+        { return m_sub_region_framing.on_field_position(); }
+
 private:
+    PreparedRegion prepare_(RegionGeometryCache *) const;
+
     SubRegionPositionFraming m_sub_region_framing;
     ProducableSubGrid m_subgrid;
 };
@@ -61,6 +186,17 @@ public:
     void operator () (RegionEdgeConnectionsRemover &,
                       TaskCallbacks &) const;
 
+    /// puts the region back, as if it never decayed (its links and entities
+    /// were never removed)
+    void restore_to(MapRegionContainer &) &&;
+
+    /// keeps what's needed to revive this region, must be called before the
+    /// job is run
+    DecayedRegion to_decayed_region() const;
+
+    const Vector2I & on_field_position() const noexcept
+        { return m_on_field_position; }
+
 private:
     Vector2I m_on_field_position;
     ScaledTriangleViewGrid m_triangle_grid;
@@ -69,6 +205,188 @@ private:
 
 // ----------------------------------------------------------------------------
 
+/// Prepares load jobs on worker threads.
+///
+/// Finished regions are taken, and committed, on the frame thread. With no
+/// worker threads, jobs are prepared one at a time on the frame thread.
+///
+/// Jobs may also be prefetched, these are prepared after all loads, and held
+/// onto until they are pushed as loads.
+class RegionPreparationQueue final {
+public:
+    using PositionSet = std::unordered_set<Vector2I, Vector2IHasher>;
+
+    RegionPreparationQueue() {}
+
+    explicit RegionPreparationQueue(int thread_count):
+        RegionPreparationQueue(thread_count, nullptr) {}
+
+    /// @param geometry_cache used by all jobs prepared, if not null it must
+    ///        outlive this queue
+    RegionPreparationQueue
+        (int thread_count, RegionGeometryCache * geometry_cache);
+
+    RegionPreparationQueue(const RegionPreparationQueue &) = delete;
+
+    RegionPreparationQueue(RegionPreparationQueue &&) = delete;
+
+    ~RegionPreparationQueue();
+
+    RegionPreparationQueue & operator = (const RegionPreparationQueue &) = delete;
+
+    RegionPreparationQueue & operator = (RegionPreparationQueue &&) = delete;
+
+    /// @returns false if a job for that position is already being prepared
+    ///          for loading, or has finished and is waiting to be taken
+    bool push(const RegionLoadJob &);
+
+    /// Prefetches are prepared soonest arrival first. Nothing is prefetched
+    /// without worker threads, as there's no spare time to do so.
+    ///
+    /// @returns true if a new prefetch is queued
+    bool push_prefetch(const RegionLoadJob &, Real seconds_to_arrival);
+
+    /// drops all prefetches, whether queued or finished, not at the given
+    /// positions (jobs already being prepared are dropped once finished)
+    void cancel_prefetches_except(const PositionSet & kept_positions);
+
+    /// prepares the next queued job on this thread, only when there are no
+    /// worker threads
+    ///
+    /// @returns true if a job was prepared
+    bool prepare_next();
+
+    /// blocks until every pushed job is finished
+    void wait_for_all();
+
+    /// @returns ticket of the next job pushed, jobs pushed before it have
+    ///          lower tickets
+    std::uint64_t next_ticket();
+
+    /// @returns true if no job pushed before the given ticket is queued, or
+    ///          still being prepared
+    bool has_finished_before(std::uint64_t ticket);
+
+    /// @throws any exception thrown while preparing on a worker thread
+    /// @returns all regions finished since the last call
+    std::vector<PreparedRegion> take_finished();
+
+    /// @returns number of prefetched regions waiting to be loaded
+    std::size_t prefetched_count();
+
+private:
+    enum class Purpose { load, prefetch, canceled };
+
+    struct QueuedJob final {
+        QueuedJob(const RegionLoadJob & job_, Real priority_):
+            job(job_), priority(priority_) {}
+
+        RegionLoadJob job;
+        Real priority;
+    };
+
+    struct Preparation final {
+        Preparation(Purpose purpose_, std::uint64_t ticket_):
+            purpose(purpose_), ticket(ticket_) {}
+
+        Purpose purpose;
+        std::uint64_t ticket;
+    };
+
+    static constexpr Real k_load_priority = -k_inf;
+
+    PreparedRegion prepare(const RegionLoadJob &) const;
+
+    void run_worker();
+
+    std::mutex m_mutex;
+    std::condition_variable m_job_pushed;
+    std::condition_variable m_job_finished;
+    std::vector<QueuedJob> m_jobs;
+    std::vector<PreparedRegion> m_finished;
+    std::unordered_map<Vector2I, Preparation, Vector2IHasher> m_preparing;
+    std::unordered_map<Vector2I, PreparedRegion, Vector2IHasher> m_prefetched;
+    std::exception_ptr m_error;
+    bool m_stopping = false;
+    std::uint64_t m_next_ticket = 0;
+    RegionGeometryCache * m_geometry_cache = nullptr;
+    std::vector<std::thread> m_workers;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Runs region commits and decays across frames, within a time budget for
+/// each frame.
+///
+/// Commits go ahead of decays, oldest first. At least one commit step and one
+/// decay are taken every frame, so neither is ever stalled entirely.
+///
+/// Decayed regions are kept in a cache, so that they may be revived.
+class RegionChangeScheduler final {
+public:
+    struct Counters final {
+        /// frames ending with region work still pending
+        int deferred_frames = 0;
+        /// commits left pending at the end of each frame (summed)
+        int deferred_commits = 0;
+        /// decays left pending at the end of each frame (summed)
+        int deferred_decays = 0;
+        /// frames whose region work took longer than the budget
+        int budget_overruns = 0;
+    };
+
+    /// has no budget, and runs everything every frame
+    RegionChangeScheduler() {}
+
+    explicit RegionChangeScheduler(Real seconds_per_frame):
+        RegionChangeScheduler(seconds_per_frame, 0) {}
+
+    /// @param seconds_per_frame non-positive for no budget
+    /// @param decayed_region_cache_bytes memory budget for decayed regions,
+    ///        zero keeps none
+    RegionChangeScheduler
+        (Real seconds_per_frame, std::size_t decayed_region_cache_bytes);
+
+    void add(PreparedRegion &&);
+
+    void add(std::vector<PreparedRegion> &&);
+
+    void add(std::vector<RegionDecayJob> &&);
+
+    bool is_committing(const Vector2I & on_field_position) const;
+
+    /// removes a pending decay at the given position
+    Optional<RegionDecayJob> take_decay_at(const Vector2I & on_field_position);
+
+    /// Budget does not apply while nothing is loaded, as there is nothing to
+    /// stand on.
+    void run(TaskCallbacks &,
+             RegionEdgeConnectionsContainer &,
+             MapRegionContainer &,
+             RegionPreparationQueue &);
+
+    bool has_pending_changes() const
+        { return !m_commits.empty() || !m_decays.empty(); }
+
+    const Counters & counters() const { return m_counters; }
+
+    DecayedRegionCache & decayed_regions() { return m_decayed_regions; }
+
+    const DecayedRegionCache & decayed_regions() const
+        { return m_decayed_regions; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::deque<PreparedRegion> m_commits;
+    std::deque<RegionDecayJob> m_decays;
+    Optional<Clock::duration> m_budget;
+    Counters m_counters;
+    DecayedRegionCache m_decayed_regions;
+};
+
+// ----------------------------------------------------------------------------
+
 class RegionCollectorBase {
 protected:
     static std::vector<RegionDecayJob>
@@ -106,6 +424,45 @@ private:
 
 // ----------------------------------------------------------------------------
 
+/// Collects load jobs along a prefetch plan, for regions not yet loaded.
+///
+/// Each job keeps the soonest time the player may arrive at its region.
+/// Regions which may be revived from decayed regions are not prefetched.
+class RegionPrefetchCollector final : public RegionLoadCollectorBase {
+public:
+    explicit RegionPrefetchCollector(MapRegionContainer &);
+
+    RegionPrefetchCollector
+        (MapRegionContainer &, const DecayedRegionCache &);
+
+    void set_seconds_to_arrival(Real seconds_to_arrival)
+        { m_seconds_to_arrival = seconds_to_arrival; }
+
+    void collect_load_job
+        (const SubRegionPositionFraming &, const ProducableSubGrid &) final;
+
+    /// pushes all collected jobs as prefetches
+    ///
+    /// @param cancel_others if set, also cancels any other prefetches
+    void finish(RegionPreparationQueue &, bool cancel_others);
+
+private:
+    struct Entry final {
+        Entry(const RegionLoadJob & job_, Real seconds_to_arrival_):
+            job(job_), seconds_to_arrival(seconds_to_arrival_) {}
+
+        RegionLoadJob job;
+        Real seconds_to_arrival;
+    };
+
+    std::unordered_map<Vector2I, Entry, Vector2IHasher> m_entries;
+    MapRegionContainer * m_container = nullptr;
+    const DecayedRegionCache * m_decayed_regions = nullptr;
+    Real m_seconds_to_arrival = 0;
+};
+
+// ----------------------------------------------------------------------------
+
 class RegionDecayCollector final :
     public MapRegionContainer::RegionDecayAdder,
     public RegionCollectorBase
@@ -122,10 +479,16 @@ public:
              ScaledTriangleViewGrid && scaled_grid,
              std::vector<Entity> && entities) final;
 
+    /// Load jobs are pushed to be prepared, and then finished regions and
+    /// decays are handed to the scheduler. Loading a region which is still
+    /// waiting to decay restores it instead, and one which has decayed
+    /// recently is revived from the scheduler's cache.
     RegionLoadCollector run_changes
         (TaskCallbacks &,
          RegionEdgeConnectionsContainer &,
-         MapRegionContainer &);
+         MapRegionContainer &,
+         RegionPreparationQueue &,
+         RegionChangeScheduler &);
 
 private:
     std::vector<RegionLoadJob> m_load_entries;
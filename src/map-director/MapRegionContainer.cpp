@@ -29,21 +29,35 @@ using RegionRefresh = MapRegionContainer::RegionRefresh;
 Optional<RegionRefresh> MapRegionContainer::region_refresh_at
     (const Vector2I & on_field_position)
 {
-    auto itr = m_loaded_regions.find(on_field_position);
-    if (itr == m_loaded_regions.end()) return {};
-    return RegionRefresh{itr->second.keep_on_refresh};
+    auto * region = find(on_field_position);
+    if (!region) return {};
+    return RegionRefresh{region->keep_on_refresh};
 }
 
 void MapRegionContainer::decay_regions(RegionDecayAdder & decay_adder) {
-    for (auto itr = m_loaded_regions.begin(); itr != m_loaded_regions.end(); ) {
-        if (itr->second.keep_on_refresh) {
-            itr->second.keep_on_refresh = false;
-            ++itr;
+    auto decays = [&decay_adder]
+        (const Vector2I & on_field_position, LoadedMapRegion & region)
+    {
+        if (region.keep_on_refresh) {
+            region.keep_on_refresh = false;
+            return false;
+        }
+        decay_adder.add(on_field_position,
+                        std::move(region.triangle_grid),
+                        std::move(region.entities));
+        return true;
+    };
+    // backwards, as vacating moves the last occupied cell into the vacancy
+    for (auto i = m_gridded_regions.size(); i != 0; --i) {
+        auto & cell = m_cells[m_gridded_regions[i - 1]];
+        if (decays(cell.on_field_position, cell.region))
+            { vacate(cell); }
+    }
+    for (auto itr = m_far_regions.begin(); itr != m_far_regions.end(); ) {
+        if (decays(itr->first, itr->second)) {
+            itr = m_far_regions.erase(itr);
         } else {
-            decay_adder.add(itr->first,
-                            std::move(itr->second.triangle_grid),
-                            std::move(itr->second.entities));
-            itr = m_loaded_regions.erase(itr);
+            ++itr;
         }
     }
 }
@@ -53,8 +67,60 @@ void MapRegionContainer::set_region
      const ScaledTriangleViewGrid & triangle_grid,
      std::vector<Entity> && entities)
 {
-    auto * region = &m_loaded_regions[on_field_position];
+    auto * region = find(on_field_position);
+    if (!region) {
+        if (m_cells.empty())
+            { m_cells.resize(std::size_t(k_grid_size*k_grid_size)); }
+        auto cell_index = cell_index_for(on_field_position);
+        auto & cell = m_cells[cell_index];
+        if (cell.is_occupied) {
+            region = &m_far_regions[on_field_position];
+        } else {
+            cell.on_field_position = on_field_position;
+            cell.is_occupied = true;
+            cell.occupied_index = m_gridded_regions.size();
+            m_gridded_regions.push_back(cell_index);
+            region = &cell.region;
+        }
+    }
     region->entities = std::move(entities);
     region->triangle_grid = triangle_grid;
     region->keep_on_refresh = true;
 }
+
+/* private static */ std::size_t MapRegionContainer::cell_index_for
+    (const Vector2I & on_field_position)
+{
+    static_assert((k_grid_size & (k_grid_size - 1)) == 0,
+                  "grid size must be a power of two");
+    // floored, so that negative positions do not share cells with positive
+    // ones
+    auto to_cell = [] (int x) {
+        auto cell = x / k_cell_size;
+        return (x % k_cell_size < 0 ? cell - 1 : cell) & (k_grid_size - 1);
+    };
+    return std::size_t(to_cell(on_field_position.y)*k_grid_size +
+                       to_cell(on_field_position.x));
+}
+
+/* private */ MapRegionContainer::LoadedMapRegion *
+    MapRegionContainer::find(const Vector2I & on_field_position)
+{
+    if (!m_cells.empty()) {
+        auto & cell = m_cells[cell_index_for(on_field_position)];
+        if (cell.is_occupied && cell.on_field_position == on_field_position)
+            { return &cell.region; }
+    }
+    if (m_far_regions.empty()) return nullptr;
+    auto itr = m_far_regions.find(on_field_position);
+    return itr == m_far_regions.end() ? nullptr : &itr->second;
+}
+
+/* private */ void MapRegionContainer::vacate(GridCell & cell) {
+    auto moved_index = m_gridded_regions.back();
+    m_gridded_regions[cell.occupied_index] = moved_index;
+    m_cells[moved_index].occupied_index = cell.occupied_index;
+    m_gridded_regions.pop_back();
+    cell.region = LoadedMapRegion{};
+    cell.is_occupied = false;
+}
@@ -22,19 +22,38 @@
 
 #include "ScaleComputation.hpp"
 
+#include <cstdint>
 #include <unordered_map>
 
 class ScaledTriangleViewGrid;
 
 struct Vector2IHasher final {
     std::size_t operator () (const Vector2I & r) const {
-        using IntHash = std::hash<int>;
-        return IntHash{}(r.x) ^ IntHash{}(r.y);
+        // mixed, so that (a, b) and (b, a), or (a, a) and (b, b) do not
+        // collide as they would if x and y were merely xored
+        auto key = (std::uint64_t(std::uint32_t(r.x)) << 32) |
+                    std::uint64_t(std::uint32_t(r.y));
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return std::size_t(key);
     }
 };
 
+/// Keeps all loaded map regions.
+///
+/// Regions are kept on a grid, which wraps around, so that any window of
+/// grid cells (like the one around the player) is addressed without
+/// hashing. Regions not fitting on the grid (sharing a cell with another,
+/// which is far away or packed tightly) are kept in a hash map.
 class MapRegionContainer final {
 public:
+    /// tiles along each side of a grid cell, the same as the default largest
+    /// region
+    static constexpr const int k_cell_size = 10;
+    /// grid cells along each side of the grid, a power of two
+    static constexpr const int k_grid_size = 32;
+
     using ViewGridTriangle = ScaledTriangleViewGrid::ViewGridTriangle;
 
     struct RegionDecayAdder {
@@ -59,6 +78,12 @@ public:
 
     void decay_regions(RegionDecayAdder &);
 
+    bool is_empty() const noexcept
+        { return m_gridded_regions.empty() && m_far_regions.empty(); }
+
+    std::size_t loaded_count() const noexcept
+        { return m_gridded_regions.size() + m_far_regions.size(); }
+
     void set_region(const Vector2I & on_field_position,
                     const ScaledTriangleViewGrid & triangle_grid,
                     std::vector<Entity> && entities);
@@ -70,8 +95,24 @@ private:
         bool keep_on_refresh = true;
     };
 
+    struct GridCell final {
+        Vector2I on_field_position;
+        LoadedMapRegion region;
+        bool is_occupied = false;
+        /// where this cell is in the list of occupied cells
+        std::size_t occupied_index = 0;
+    };
+
     using LoadedRegionMap = std::unordered_map
         <Vector2I, LoadedMapRegion, Vector2IHasher>;
 
-    LoadedRegionMap m_loaded_regions;
+    static std::size_t cell_index_for(const Vector2I & on_field_position);
+
+    LoadedMapRegion * find(const Vector2I & on_field_position);
+
+    void vacate(GridCell &);
+
+    std::vector<GridCell> m_cells;
+    std::vector<std::size_t> m_gridded_regions;
+    LoadedRegionMap m_far_regions;
 };
@@ -21,28 +21,149 @@
 #include "MapRegionTracker.hpp"
 #include "MapRegionChangesTask.hpp"
 #include "RegionLoadRequest.hpp"
+#include "../Configuration.hpp"
 
 namespace {
 
 using TaskContinuation = MapRegionTracker::TaskContinuation;
 
+UniquePtr<RegionGeometryCache> make_geometry_cache
+    (const std::string & map_filename, std::uint64_t content_key);
+
 } // end of <anonymous> namespace
 
 MapRegionTracker::MapRegionTracker():
     m_load_collector(m_container) {}
 
 MapRegionTracker::MapRegionTracker
-    (UniquePtr<MapRegion> && root_region):
+    (UniquePtr<MapRegion> && root_region,
+     const std::string & map_filename,
+     std::uint64_t content_key):
+    MapRegionTracker
+        (std::move(root_region),
+         k_region_preparation_thread_count,
+         k_region_changes_seconds_per_frame,
+         std::size_t(k_decayed_region_cache_megabytes)*1024*1024,
+         make_geometry_cache(map_filename, content_key)) {}
+
+MapRegionTracker::MapRegionTracker
+    (UniquePtr<MapRegion> && root_region,
+     int preparation_thread_count,
+     Real seconds_per_frame,
+     std::size_t decayed_region_cache_bytes):
+    MapRegionTracker
+        (std::move(root_region),
+         preparation_thread_count,
+         seconds_per_frame,
+         decayed_region_cache_bytes,
+         nullptr) {}
+
+MapRegionTracker::MapRegionTracker
+    (UniquePtr<MapRegion> && root_region,
+     int preparation_thread_count,
+     Real seconds_per_frame,
+     std::size_t decayed_region_cache_bytes,
+     UniquePtr<RegionGeometryCache> && geometry_cache):
     m_load_collector(m_container),
-    m_root_region(std::move(root_region)) {}
+    m_root_region(std::move(root_region)),
+    m_scheduler(seconds_per_frame, decayed_region_cache_bytes),
+    m_geometry_cache(std::move(geometry_cache)),
+    m_lazy_regions(k_sub_map_eviction_seconds),
+    m_preparations(preparation_thread_count, m_geometry_cache.get()) {}
+
+MapRegionTracker::~MapRegionTracker() {
+    // the cache is only ever an aid, failing to save it costs nothing more
+    // than producing the regions again next run
+    if (m_geometry_cache)
+        { (void)m_geometry_cache->save(); }
+}
 
 void MapRegionTracker::process_load_requests
     (const RegionLoadRequest & request, TaskCallbacks & callbacks)
 {
     m_root_region->
         process_load_request(request, RegionPositionFraming{}, m_load_collector);
+    keep_lazy_regions(m_load_collector.take_lazy_regions(), callbacks);
     auto decay_collector = m_load_collector.finish();
     m_container.decay_regions(decay_collector);
     m_load_collector = decay_collector.run_changes
-        (callbacks, m_edge_container, m_container);
+        (callbacks, m_edge_container, m_container, m_preparations,
+         m_scheduler);
+}
+
+void MapRegionTracker::process_load_requests
+    (const RegionLoadRequest & request,
+     const RegionPrefetchPlan & prefetch_plan,
+     TaskCallbacks & callbacks)
+{
+    process_load_requests(request, callbacks);
+    prefetch_along(prefetch_plan, callbacks);
+}
+
+/* private */ void MapRegionTracker::prefetch_along
+    (const RegionPrefetchPlan & prefetch_plan, TaskCallbacks & callbacks)
+{
+    // stopping is not a change of heading, prefetches are kept for a while,
+    // in case the player heads the same way again
+    if (prefetch_plan.waypoints().empty()) {
+        if (++m_idle_prefetch_frames == k_region_prefetch_idle_frames) {
+            m_preparations.cancel_prefetches_except({});
+            m_prefetch_heading = Vector{};
+        }
+        return;
+    }
+    m_idle_prefetch_frames = 0;
+
+    RegionPrefetchCollector collector
+        {m_container, m_scheduler.decayed_regions()};
+    for (auto & waypoint : prefetch_plan.waypoints()) {
+        collector.set_seconds_to_arrival(waypoint.seconds_to_arrival);
+        m_root_region->process_load_request
+            (waypoint.request, RegionPositionFraming{}, collector);
+    }
+    // sub maps along the way start loading early too
+    keep_lazy_regions(collector.take_lazy_regions(), callbacks);
+    bool heading_changed =
+        !RegionPrefetchPlan::are_same_headings
+            (m_prefetch_heading, prefetch_plan.heading());
+    collector.finish(m_preparations, heading_changed);
+    m_prefetch_heading = prefetch_plan.heading();
 }
+
+/* private */ void MapRegionTracker::keep_lazy_regions
+    (std::vector<LazyMapRegion *> && lazy_regions, TaskCallbacks & callbacks)
+{
+    auto now = LazyMapRegionKeeper::Clock::now();
+    for (auto * region : m_lazy_regions.touch(lazy_regions, callbacks, now)) {
+        if (m_geometry_cache) {
+            (void)m_geometry_cache->check_sub_map
+                (region->map_filename(), region->content_key());
+        }
+        region->admit();
+    }
+    if (m_pending_eviction) {
+        // only sub maps untouched as of then, later jobs can't refer to them
+        const auto & pending = *m_pending_eviction;
+        if (!m_preparations.has_finished_before(pending.ticket)) return;
+        m_lazy_regions.evict_untouched(pending.untouched_as_of);
+        m_pending_eviction = {};
+    } else if (m_lazy_regions.has_untouched(now)) {
+        m_pending_eviction.emplace(now, m_preparations.next_ticket());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+UniquePtr<RegionGeometryCache> make_geometry_cache
+    (const std::string & map_filename, std::uint64_t content_key)
+{
+    std::string extension = k_region_geometry_cache_extension;
+    if (content_key == 0 || map_filename.empty() || extension.empty())
+        { return nullptr; }
+    return make_unique<RegionGeometryCache>
+        (map_filename + extension, content_key);
+}
+
+} // end of <anonymous> namespace
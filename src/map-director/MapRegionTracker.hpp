@@ -22,9 +22,12 @@
 
 #include "RegionEdgeConnectionsContainer.hpp"
 #include "MapRegionChangesTask.hpp"
+#include "RegionGeometryCache.hpp"
+#include "LazyMapRegion.hpp"
 
 class TaskCallbacks;
 class RegionLoadRequest;
+class RegionPrefetchPlan;
 class RegionLoadCollector;
 class RegionDecayCollector;
 
@@ -38,16 +41,100 @@ public:
 
     MapRegionTracker();
 
-    explicit MapRegionTracker(UniquePtr<MapRegion> && root_region);
+    /// @param map_filename region triangles are kept beside the map, between
+    ///        runs
+    /// @param content_key key of the map's contents, non-zero to keep
+    ///        region triangles on disk between runs
+    MapRegionTracker
+        (UniquePtr<MapRegion> && root_region,
+         const std::string & map_filename,
+         std::uint64_t content_key);
+
+    /// @param preparation_thread_count number of worker threads preparing
+    ///        regions, none to prepare them on the frame thread
+    /// @param seconds_per_frame time budget for region changes on each
+    ///        frame, non-positive for no budget
+    /// @param decayed_region_cache_bytes memory kept for recently decayed
+    ///        regions, zero to keep none
+    MapRegionTracker
+        (UniquePtr<MapRegion> && root_region,
+         int preparation_thread_count,
+         Real seconds_per_frame,
+         std::size_t decayed_region_cache_bytes);
+
+    /// @param geometry_cache may be null, to keep no region triangles
+    MapRegionTracker
+        (UniquePtr<MapRegion> && root_region,
+         int preparation_thread_count,
+         Real seconds_per_frame,
+         std::size_t decayed_region_cache_bytes,
+         UniquePtr<RegionGeometryCache> && geometry_cache);
+
+    MapRegionTracker(const MapRegionTracker &) = delete;
+
+    MapRegionTracker(MapRegionTracker &&) = delete;
+
+    /// saves any newly kept region triangles
+    ~MapRegionTracker();
+
+    MapRegionTracker & operator = (const MapRegionTracker &) = delete;
+
+    MapRegionTracker & operator = (MapRegionTracker &&) = delete;
 
     void process_load_requests(const RegionLoadRequest &, TaskCallbacks &);
 
+    /// Also prepares regions ahead of time along the prefetch plan.
+    ///
+    /// Prefetches are canceled whenever the player's heading changes, or once
+    /// the player has stood still for a while.
+    void process_load_requests
+        (const RegionLoadRequest &, const RegionPrefetchPlan &, TaskCallbacks &);
+
     bool has_root_region() const noexcept
         { return !!m_root_region; }
 
+    const RegionChangeScheduler::Counters & region_change_counters() const
+        { return m_scheduler.counters(); }
+
+    const DecayedRegionCache::Metrics & decayed_region_metrics() const
+        { return m_scheduler.decayed_regions().metrics(); }
+
+    /// @returns number of sub maps loading or loaded
+    std::size_t kept_sub_map_count() const noexcept
+        { return m_lazy_regions.kept_count(); }
+
 private:
+    void prefetch_along(const RegionPrefetchPlan &, TaskCallbacks &);
+
+    /// Starts loading sub maps, admits those that are loaded, and evicts
+    /// those gone untouched.
+    ///
+    /// Sub maps are evicted on a later frame than they're found untouched,
+    /// once every job pushed until then is prepared. (as those jobs may
+    /// refer to their producables)
+    void keep_lazy_regions(std::vector<LazyMapRegion *> &&, TaskCallbacks &);
+
+    struct PendingEviction final {
+        PendingEviction
+            (LazyMapRegionKeeper::Clock::time_point untouched_as_of_,
+             std::uint64_t ticket_):
+            untouched_as_of(untouched_as_of_), ticket(ticket_) {}
+
+        LazyMapRegionKeeper::Clock::time_point untouched_as_of;
+        std::uint64_t ticket;
+    };
+
     RegionLoadCollector m_load_collector;
     RegionEdgeConnectionsContainer m_edge_container;
     MapRegionContainer m_container;
     UniquePtr<MapRegion> m_root_region;
+    Vector m_prefetch_heading;
+    int m_idle_prefetch_frames = 0;
+    RegionChangeScheduler m_scheduler;
+    UniquePtr<RegionGeometryCache> m_geometry_cache;
+    LazyMapRegionKeeper m_lazy_regions;
+    Optional<PendingEviction> m_pending_eviction;
+    // declared after the root region and geometry cache, so workers are joined before its
+    // producables are gone
+    RegionPreparationQueue m_preparations;
 };
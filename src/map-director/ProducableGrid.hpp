@@ -25,8 +25,25 @@
 #include "../Components.hpp"
 
 class Platform;
+class RenderModel;
+class Texture;
 class UnfinishedProducableTileViewGrid;
 
+/// Components producables may give to entities.
+///
+/// These are all that's kept of entities once their region decays, so that
+/// they may be remade without running producables again (see DecayedRegion).
+template <typename T>
+constexpr const bool k_is_producable_entity_component =
+       std::is_same_v<T, ModelScale>
+    || std::is_same_v<T, ModelTranslation>
+    || std::is_same_v<T, XRotation>
+    || std::is_same_v<T, YRotation>
+    || std::is_same_v<T, TextureTranslation>
+    || std::is_same_v<T, ModelVisibility>
+    || std::is_same_v<T, SharedPtr<const RenderModel>>
+    || std::is_same_v<T, SharedPtr<const Texture>>;
+
 class ProducableTileCallbacks {
 public:
     virtual ~ProducableTileCallbacks() {}
@@ -40,6 +57,8 @@ public:
 
     template <typename ... Types>
     Entity add_entity(Types &&... arguments) {
+        static_assert((k_is_producable_entity_component<Types> && ...),
+                      "decayed regions would not keep this component");
         auto e = add_entity_();
         e.
             add<ModelScale, ModelTranslation, Types...>() =
@@ -50,6 +69,8 @@ public:
 
     template <typename ... Types>
     Entity add_entity_from_tuple(Tuple<Types...> && tup) {
+        static_assert((k_is_producable_entity_component<Types> && ...),
+                      "decayed regions would not keep this component");
         auto e = add_entity_();
         e.add<ModelScale, ModelTranslation, Types...>() =
             std::tuple_cat(make_tuple(model_scale(), model_translation()),
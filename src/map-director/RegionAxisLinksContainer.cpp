@@ -22,24 +22,17 @@
 
 #include "../Configuration.hpp"
 #include "../TriangleLink.hpp"
+#include "../TriangleEdgeWelder.hpp"
 
 #include <iostream>
 
 namespace {
 
-constexpr const bool k_report_maximum_sort_and_sweep =
-    k_region_axis_container_report_maximum_sort_and_sweep;
-
-Real get_x(const Vector & r) { return r.x; }
-
-Real get_z(const Vector & r) { return r.z; }
+constexpr const bool k_report_maximum_welds =
+    k_region_axis_container_report_maximum_welds;
 
 } // end of <anonymous> namespace
 
-/* static */ bool RegionAxisLinkEntry::bounds_less_than
-    (const RegionAxisLinkEntry & lhs, const RegionAxisLinkEntry & rhs)
-{ return lhs.low_bounds() < rhs.low_bounds(); }
-
 /* static */ bool RegionAxisLinkEntry::pointer_less_than
     (const RegionAxisLinkEntry & lhs, const RegionAxisLinkEntry & rhs)
 { return lhs.link() < rhs.link(); }
@@ -51,40 +44,6 @@ Real get_z(const Vector & r) { return r.z; }
 /* static */ bool RegionAxisLinkEntry::linkless(const RegionAxisLinkEntry & entry)
     { return !entry.link(); }
 
-/* static */ void RegionAxisLinkEntry::attach_matching_points
-    (const RegionAxisLinkEntry & lhs, const RegionAxisLinkEntry & rhs)
-{ TriangleLink::attach_unattached_matching_points(lhs.link(), rhs.link()); }
-
-/* static */ RegionAxisLinkEntry RegionAxisLinkEntry::computed_bounds
-    (const SharedPtr<TriangleLink> & link_ptr, RegionAxis axis)
-{
-    using Axis = RegionAxis;
-    switch (axis) {
-    case Axis::x_ways: return computed_bounds_<get_x>(link_ptr);
-    case Axis::z_ways: return computed_bounds_<get_z>(link_ptr);
-    default          : break;
-    }
-    throw RuntimeError{":c"};
-}
-
-RegionAxisLinkEntry::RegionAxisLinkEntry
-    (Real low_, Real high_, const SharedPtr<TriangleLink> & link_ptr):
-    m_low(low_), m_high(high_), m_link_ptr(link_ptr) {}
-
-template <Real (*get_i)(const Vector &)>
-/* private static */ RegionAxisLinkEntry RegionAxisLinkEntry::computed_bounds_
-    (const SharedPtr<TriangleLink> & link_ptr)
-{
-    Real low = k_inf;
-    Real high = -k_inf;
-    const auto & triangle = link_ptr->segment();
-    for (auto pt : { triangle.point_a(), triangle.point_b(), triangle.point_c() }) {
-        high = std::max(high, get_i(pt));
-        low  = std::min(low , get_i(pt));
-    }
-    return RegionAxisLinkEntry{low, high, link_ptr};
-}
-
 // ----------------------------------------------------------------------------
 
 RegionAxisLinksContainer::RegionAxisLinksContainer
@@ -117,29 +76,19 @@ RegionAxisLinksAdder RegionAxisLinksContainer::make_adder()
 }
 
 /* static */ std::vector<RegionAxisLinkEntry>
-    RegionAxisLinksAdder::sort_and_sweep
+    RegionAxisLinksAdder::weld
     (std::vector<RegionAxisLinkEntry> && entries)
 {
-    static int s_sort_sweep_max = 0;
-    int sort_sweep_count = 0;
-    std::sort(entries.begin(), entries.end(),
-              RegionAxisLinkEntry::bounds_less_than);
-    for (auto itr = entries.begin(); itr != entries.end(); ++itr) {
-        for (auto jtr = itr + 1; jtr != entries.end(); ++jtr) {
-            if (itr->high_bounds() < jtr->low_bounds())
-                break;
-            if constexpr (k_report_maximum_sort_and_sweep)
-                ++sort_sweep_count;
-            RegionAxisLinkEntry::attach_matching_points(*itr, *jtr);
-        }
-    }
-
-    if constexpr (k_report_maximum_sort_and_sweep) {
-        if (sort_sweep_count > s_sort_sweep_max) {
-            auto entries_copy = entries;
-            entries_copy.resize( std::min( std::size_t(100), entries.size() ) );
-            s_sort_sweep_max = sort_sweep_count;
-            std::cout << "New sort sweep maximum: " << sort_sweep_count << std::endl;
+    static int s_weld_max = 0;
+    TriangleEdgeWelder welder;
+    for (auto & entry : entries)
+        { welder.add(entry.link()); }
+    int weld_count = welder.weld();
+
+    if constexpr (k_report_maximum_welds) {
+        if (weld_count > s_weld_max) {
+            s_weld_max = weld_count;
+            std::cout << "New weld maximum: " << weld_count << std::endl;
         }
     }
     return std::move(entries);
@@ -155,12 +104,12 @@ void RegionAxisLinksAdder::add(const SharedPtr<TriangleLink> & link_ptr) {
     if (m_axis == RegionAxis::uninitialized) {
         throw RuntimeError{":c"};
     }
-    m_entries.push_back(RegionAxisLinkEntry::computed_bounds(link_ptr, m_axis));
+    m_entries.emplace_back(link_ptr);
 }
 
 RegionAxisLinksContainer RegionAxisLinksAdder::finish() {
     return RegionAxisLinksContainer
-        {sort_and_sweep(dedupelicate(std::move(m_entries))), m_axis};
+        {weld(dedupelicate(std::move(m_entries))), m_axis};
 }
 
 /* private static */ std::vector<RegionAxisLinkEntry>
@@ -27,9 +27,6 @@ class RegionAxisLinksRemover;
 
 class RegionAxisLinkEntry final {
 public:
-    static bool bounds_less_than(const RegionAxisLinkEntry & lhs,
-                                 const RegionAxisLinkEntry & rhs);
-
     static bool pointer_less_than(const RegionAxisLinkEntry & lhs,
                                   const RegionAxisLinkEntry & rhs);
 
@@ -38,33 +35,15 @@ public:
 
     static bool linkless(const RegionAxisLinkEntry & entry);
 
-    static void attach_matching_points(const RegionAxisLinkEntry & lhs,
-                                       const RegionAxisLinkEntry & rhs);
-
-    static RegionAxisLinkEntry computed_bounds
-        (const SharedPtr<TriangleLink> & link_ptr, RegionAxis axis);
-
     RegionAxisLinkEntry() {}
 
     explicit RegionAxisLinkEntry(const SharedPtr<TriangleLink> & link_ptr):
         m_link_ptr(link_ptr) {}
 
-    RegionAxisLinkEntry
-        (Real low_, Real high_, const SharedPtr<TriangleLink> & link_ptr);
-
-    // sortable by bounds
-    Real low_bounds() const { return m_low; }
-
-    Real high_bounds() const { return m_high; }
     // sortable by link pointer
     const SharedPtr<TriangleLink> & link() const { return m_link_ptr; }
 
 private:
-    template <Real (*get_i)(const Vector &)>
-    static RegionAxisLinkEntry computed_bounds_(const SharedPtr<TriangleLink> &);
-
-    Real m_low = -k_inf;
-    Real m_high = k_inf;
     SharedPtr<TriangleLink> m_link_ptr;
 };
 
@@ -93,7 +72,8 @@ public:
     static std::vector<RegionAxisLinkEntry> dedupelicate
         (std::vector<RegionAxisLinkEntry> &&);
 
-    static std::vector<RegionAxisLinkEntry> sort_and_sweep
+    /// links all entries' triangles which share sides
+    static std::vector<RegionAxisLinkEntry> weld
         (std::vector<RegionAxisLinkEntry> &&);
 
     RegionAxisLinksAdder() {}
@@ -103,11 +83,10 @@ public:
          RegionAxis axis_);
 
     // address by the adder on an axis...
-    // computes bounds as you add
     // contains no dupelicate link (by pointer)
     void add(const SharedPtr<TriangleLink> & link_ptr);
 
-    // sort (by bound) and sweep to do linking/gluing
+    // weld to do linking/gluing
     RegionAxisLinksContainer finish();
 
 private:
@@ -29,7 +29,7 @@
 namespace {
 
 using ViewGridTriangle = MapRegionContainer::ViewGridTriangle;
-using EntryContainer = RegionEdgeConnectionsContainerBase::EntryContainer;
+using SeamContainer = RegionEdgeConnectionsContainerBase::SeamContainer;
 
 constexpr bool k_enable_console_logging =
     k_report_tile_region_loads_and_unloads;
@@ -47,16 +47,9 @@ const char * axis_to_string(RegionAxis axis) {
 
 // ----------------------------------------------------------------------------
 
-/* protected static */
-    const RegionEdgeConnectionsContainerBase::EntryContainer
-    RegionEdgeConnectionsContainerBase::s_default_entry_container =
-    RegionEdgeConnectionsContainerBase::EntryContainer{RegionAxisAddress{}};
-
-// ----------------------------------------------------------------------------
-
 RegionEdgeConnectionsAdder::RegionEdgeConnectionsAdder
-    (EntryContainer && entries):
-    m_entries(verify_all_adders("RegionEdgeConnectionsAdder", std::move(entries)))
+    (SeamContainer && seams):
+    m_seams(std::move(seams))
 {}
 
 void RegionEdgeConnectionsAdder::add
@@ -70,7 +63,9 @@ void RegionEdgeConnectionsAdder::add
     auto addresses_and_sides = triangle_grid.
         sides_and_addresses_at(on_field_position);
     for (auto & res : addresses_and_sides) {
-        auto & adder = ensure_adder(res.address());
+        auto & touched = ensure_adder(res.address());
+        auto & adder = touched.links;
+        ++touched.region_count_change;
         triangle_grid.for_each_link_on_side
             (res.side(),
              [&adder](const SharedPtr<TriangleLink> & link_ptr) { adder.add(link_ptr); });
@@ -78,37 +73,40 @@ void RegionEdgeConnectionsAdder::add
 }
 
 RegionEdgeConnectionsContainer RegionEdgeConnectionsAdder::finish() {
-    for (auto entry : m_entries) {
-        entry.second = std::get_if<RegionAxisLinksAdder>(&entry.second)->
-            finish();
+    for (auto & [addr, touched] : m_touched) {
+        auto & seam = m_seams[addr];
+        seam.links = touched.links.finish();
+        seam.region_count += touched.region_count_change;
     }
-    return RegionEdgeConnectionsContainer{std::move(m_entries)};
-}
-
-/* private static */ EntryContainer
-    RegionEdgeConnectionsAdder::verify_all_adders
-    (const char *, EntryContainer && entries)
-{
-    for (auto entry : entries)
-        { (void)std::get<RegionAxisLinksAdder>(entry.second); }
-    return std::move(entries);
+    m_touched.clear();
+    return RegionEdgeConnectionsContainer{std::move(m_seams)};
 }
 
-/* private */ RegionAxisLinksAdder &
+/* private */ RegionEdgeConnectionsContainerBase::
+    TouchedSeam<RegionAxisLinksAdder> &
     RegionEdgeConnectionsAdder::ensure_adder
     (const RegionAxisAddress & addr)
 {
-    RegionAxisLinksAdder new_adder
-        {std::vector<RegionAxisLinkEntry>{}, addr.axis()}; // LoD
-    auto itr = m_entries.emplace(addr, std::move(new_adder)).position;
-    return *std::get_if<RegionAxisLinksAdder>(&itr->second);
+    auto itr = m_touched.find(addr);
+    if (itr != m_touched.end())
+        { return itr->second; }
+
+    TouchedSeam<RegionAxisLinksAdder> touched;
+    auto seam_itr = m_seams.find(addr);
+    if (seam_itr == m_seams.end()) {
+        touched.links = RegionAxisLinksAdder
+            {std::vector<RegionAxisLinkEntry>{}, addr.axis()}; // LoD
+    } else {
+        touched.links = seam_itr->second.links.make_adder();
+    }
+    return m_touched.emplace(addr, std::move(touched)).first->second;
 }
 
 // ----------------------------------------------------------------------------
 
 RegionEdgeConnectionsRemover::RegionEdgeConnectionsRemover
-    (EntryContainer && entries):
-    m_entries(verify_all_removers(std::move(entries)))
+    (SeamContainer && seams):
+    m_seams(std::move(seams))
 {}
 
 void RegionEdgeConnectionsRemover::remove_region
@@ -123,9 +121,10 @@ void RegionEdgeConnectionsRemover::remove_region
     auto addresses_and_sides = triangle_grid.
         sides_and_addresses_at(on_field_position);
     for (auto & res : addresses_and_sides) {
-        auto * remover = find_remover(res.address());
-        assert(remover);
-        auto & remover_ = *remover;
+        auto * touched = find_remover(res.address());
+        assert(touched);
+        auto & remover_ = touched->links;
+        --touched->region_count_change;
         triangle_grid.for_each_link_on_side
             (res.side(),
              [&remover_]
@@ -135,62 +134,47 @@ void RegionEdgeConnectionsRemover::remove_region
 }
 
 RegionEdgeConnectionsContainer RegionEdgeConnectionsRemover::finish() {
-    for (auto entry : m_entries) {
-        entry.second = std::get_if<RegionAxisLinksRemover>(&entry.second)->
-            finish();
+    for (auto & [addr, touched] : m_touched) {
+        auto seam_itr = m_seams.find(addr);
+        auto & seam = seam_itr->second;
+        seam.region_count += touched.region_count_change;
+        // no loaded region on either side, the seam goes with them
+        if (seam.region_count <= 0) {
+            m_seams.erase(seam_itr);
+        } else {
+            seam.links = touched.links.finish();
+        }
     }
-    return RegionEdgeConnectionsContainer{std::move(m_entries)};
-}
-
-/* private static */ EntryContainer
-    RegionEdgeConnectionsRemover::verify_all_removers
-    (EntryContainer && entries)
-{
-    for (auto entry : entries)
-        { (void)std::get<RegionAxisLinksRemover>(entry.second); }
-    return std::move(entries);
+    m_touched.clear();
+    return RegionEdgeConnectionsContainer{std::move(m_seams)};
 }
 
-/* private */ RegionAxisLinksRemover *
+/* private */ RegionEdgeConnectionsContainerBase::
+    TouchedSeam<RegionAxisLinksRemover> *
     RegionEdgeConnectionsRemover::find_remover
     (const RegionAxisAddress & addr)
 {
-    auto entry = m_entries.find(addr);
-    if (entry == m_entries.end()) return nullptr;
-    return std::get_if<RegionAxisLinksRemover>(&entry->second);
+    auto itr = m_touched.find(addr);
+    if (itr != m_touched.end())
+        { return &itr->second; }
+
+    auto seam_itr = m_seams.find(addr);
+    if (seam_itr == m_seams.end()) return nullptr;
+    TouchedSeam<RegionAxisLinksRemover> touched;
+    touched.links = seam_itr->second.links.make_remover();
+    return &m_touched.emplace(addr, std::move(touched)).first->second;
 }
 
 // ----------------------------------------------------------------------------
 
 RegionEdgeConnectionsContainer::RegionEdgeConnectionsContainer
-    (EntryContainer && entries):
-    m_entries(verify_containers(std::move(entries))) {}
+    (SeamContainer && seams):
+    m_seams(std::move(seams)) {}
 
 RegionEdgeConnectionsAdder
     RegionEdgeConnectionsContainer::make_adder()
-{
-    for (auto entry : m_entries) {
-        entry.second = std::get_if<RegionAxisLinksContainer>(&entry.second)->
-            make_adder();
-    }
-    return RegionEdgeConnectionsAdder{std::move(m_entries)};
-}
+    { return RegionEdgeConnectionsAdder{std::move(m_seams)}; }
 
 RegionEdgeConnectionsRemover
     RegionEdgeConnectionsContainer::make_remover()
-{
-    for (auto entry : m_entries) {
-        entry.second = std::get_if<RegionAxisLinksContainer>(&entry.second)->
-            make_remover();
-    }
-    return RegionEdgeConnectionsRemover{std::move(m_entries)};
-}
-
-/* private static */ EntryContainer
-    RegionEdgeConnectionsContainer::verify_containers
-    (EntryContainer && entries)
-{
-    for (auto entry : entries)
-        { (void)std::get<RegionAxisLinksContainer>(entry.second); }
-    return std::move(entries);
-}
+    { return RegionEdgeConnectionsRemover{std::move(m_seams)}; }
@@ -23,7 +23,7 @@
 #include "RegionAxisLinksContainer.hpp"
 #include "ScaleComputation.hpp"
 
-#include <ariajanke/cul/HashMap.hpp>
+#include <unordered_map>
 
 class RegionEdgeConnectionsContainer;
 
@@ -32,19 +32,33 @@ struct RegionAxisAddressHasher final {
         { return addr.hash(); }
 };
 
+/// Seams are stored by axis address. Adders and removers only ever visit the
+/// addresses of the regions given to them, so a change costs in proportion to
+/// the regions changed, not to every seam loaded.
 class RegionEdgeConnectionsContainerBase {
 public:
-    using EntryContainer = cul::HashMap
-        <RegionAxisAddress,
-         Variant<RegionAxisLinksContainer,
-                 RegionAxisLinksAdder,
-                 RegionAxisLinksRemover>,
-         RegionAxisAddressHasher>;
+    struct Seam final {
+        RegionAxisLinksContainer links;
+        // number of loaded regions with a side on this seam, once none are
+        // left, the seam is dropped
+        int region_count = 0;
+    };
+
+    using SeamContainer = std::unordered_map
+        <RegionAxisAddress, Seam, RegionAxisAddressHasher>;
 
 protected:
-    RegionEdgeConnectionsContainerBase() {}
+    template <typename T>
+    struct TouchedSeam final {
+        T links;
+        int region_count_change = 0;
+    };
+
+    template <typename T>
+    using TouchedSeamContainer = std::unordered_map
+        <RegionAxisAddress, TouchedSeam<T>, RegionAxisAddressHasher>;
 
-    static const EntryContainer s_default_entry_container;
+    RegionEdgeConnectionsContainerBase() {}
 };
 
 class RegionEdgeConnectionsAdder final :
@@ -55,7 +69,7 @@ public:
 
     RegionEdgeConnectionsAdder() {}
 
-    explicit RegionEdgeConnectionsAdder(EntryContainer &&);
+    explicit RegionEdgeConnectionsAdder(SeamContainer &&);
 
     void add(const Vector2I & on_field_position,
              const ScaledTriangleViewGrid & triangle_grid);
@@ -63,12 +77,11 @@ public:
     RegionEdgeConnectionsContainer finish();
 
 private:
-    static EntryContainer verify_all_adders
-        (const char * caller, EntryContainer &&);
-
-    RegionAxisLinksAdder & ensure_adder(const RegionAxisAddress & addr);
+    TouchedSeam<RegionAxisLinksAdder> & ensure_adder
+        (const RegionAxisAddress & addr);
 
-    EntryContainer m_entries = s_default_entry_container;
+    SeamContainer m_seams;
+    TouchedSeamContainer<RegionAxisLinksAdder> m_touched;
 };
 
 class RegionEdgeConnectionsRemover final :
@@ -78,7 +91,7 @@ public:
 
     RegionEdgeConnectionsRemover() {}
 
-    explicit RegionEdgeConnectionsRemover(EntryContainer &&);
+    explicit RegionEdgeConnectionsRemover(SeamContainer &&);
 
     void remove_region(const Vector2I & on_field_position,
                        const ScaledTriangleViewGrid & triangle_grid);
@@ -86,11 +99,11 @@ public:
     RegionEdgeConnectionsContainer finish();
 
 private:
-    static EntryContainer verify_all_removers(EntryContainer &&);
+    TouchedSeam<RegionAxisLinksRemover> * find_remover
+        (const RegionAxisAddress &);
 
-    RegionAxisLinksRemover * find_remover(const RegionAxisAddress &);
-
-    EntryContainer m_entries = s_default_entry_container;
+    SeamContainer m_seams;
+    TouchedSeamContainer<RegionAxisLinksRemover> m_touched;
 };
 
 class RegionEdgeConnectionsContainer final :
@@ -98,14 +111,17 @@ class RegionEdgeConnectionsContainer final :
 public:
     RegionEdgeConnectionsContainer() {}
 
-    explicit RegionEdgeConnectionsContainer(EntryContainer &&);
+    explicit RegionEdgeConnectionsContainer(SeamContainer &&);
 
     RegionEdgeConnectionsAdder make_adder();
 
     RegionEdgeConnectionsRemover make_remover();
 
-private:
-    static EntryContainer verify_containers(EntryContainer &&);
+    std::size_t seam_count() const { return m_seams.size(); }
 
-    EntryContainer m_entries = s_default_entry_container;
+    bool has_seam_at(const RegionAxisAddress & addr) const
+        { return m_seams.find(addr) != m_seams.end(); }
+
+private:
+    SeamContainer m_seams;
 };
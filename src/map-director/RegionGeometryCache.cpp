@@ -0,0 +1,498 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "RegionGeometryCache.hpp"
+
+#include "../TriangleLink.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) && !defined(__EMSCRIPTEN__)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace {
+
+using ViewGridTriangle = RegionGeometryCache::ViewGridTriangle;
+using Bytes = std::vector<char>;
+using ByteView = View<const char *>;
+using Side = TriangleSide;
+
+constexpr const std::uint32_t k_file_magic = 0x43475252; // "RRGC"
+constexpr const std::array k_sides =
+    { Side::k_side_ab, Side::k_side_bc, Side::k_side_ca };
+
+struct FileHeader final {
+    std::uint32_t magic = k_file_magic;
+    std::uint32_t version = RegionGeometryCache::k_geometry_version;
+    std::uint64_t content_key = 0;
+    std::uint64_t sub_map_count = 0;
+    std::uint64_t record_count = 0;
+};
+
+// followed by the sub map's filename
+struct SubMapHeader final {
+    std::uint64_t content_key = 0;
+    std::uint64_t filename_size = 0;
+};
+
+struct RecordHeader final {
+    std::int32_t x = 0;
+    std::int32_t y = 0;
+    std::uint64_t size = 0;
+};
+
+struct SideRecord final {
+    // index of the linked triangle within the region, negative for none
+    std::int32_t target = -1;
+    std::uint8_t target_side = 0;
+    std::uint8_t inverts_normal = 0;
+    std::uint8_t flips_position = 0;
+    std::uint8_t padding = 0;
+};
+
+class ByteReader final {
+public:
+    explicit ByteReader(const ByteView & bytes):
+        m_position(bytes.begin()), m_end(bytes.end()) {}
+
+    template <typename T>
+    bool read(T & obj) {
+        if (remaining() < sizeof(T)) return false;
+        std::memcpy(&obj, m_position, sizeof(T));
+        m_position += sizeof(T);
+        return true;
+    }
+
+    /// @returns view of the next count bytes, or an empty view if there are
+    ///          not that many
+    ByteView read_view(std::size_t count);
+
+    std::size_t remaining() const noexcept
+        { return std::size_t(m_end - m_position); }
+
+private:
+    const char * m_position;
+    const char * m_end;
+};
+
+template <typename T>
+void append(Bytes & bytes, const T & obj) {
+    auto * beg = reinterpret_cast<const char *>(&obj);
+    bytes.insert(bytes.end(), beg, beg + sizeof(T));
+}
+
+std::uint64_t fnv1a(std::uint64_t value, const ByteView & bytes);
+
+Bytes serialize_region(const ViewGridTriangle &);
+
+SharedPtr<ViewGridTriangle> deserialize_region(const ByteView &);
+
+} // end of <anonymous> namespace
+
+void RegionContentKey::add_file
+    (const std::string & filename, const std::string & contents)
+{
+    auto file_value = mix_in(mix_in(0, filename), contents);
+    // addition, so that files may be added in any order
+    m_value.fetch_add(file_value);
+}
+
+/* private static */ std::uint64_t RegionContentKey::mix_in
+    (std::uint64_t value, const std::string & string)
+{
+    return fnv1a
+        (value ^ 0xcbf29ce484222325ull,
+         ByteView{string.data(), string.data() + string.size()});
+}
+
+// ----------------------------------------------------------------------------
+
+class RegionGeometryCache::MappedFile final {
+public:
+    explicit MappedFile(const std::string & filename);
+
+    MappedFile(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    MappedFile & operator = (const MappedFile &) = delete;
+
+    ByteView bytes() const noexcept
+        { return ByteView{m_begin, m_begin + m_size}; }
+
+    bool is_mapped() const noexcept { return m_is_mapped; }
+
+private:
+    void read_whole_file(const std::string & filename);
+
+    const char * m_begin = nullptr;
+    std::size_t m_size = 0;
+    bool m_is_mapped = false;
+    // only used where files cannot be mapped
+    Bytes m_read;
+};
+
+RegionGeometryCache::MappedFile::MappedFile(const std::string & filename) {
+#   if defined(__unix__) && !defined(__EMSCRIPTEN__)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        auto * mapping = ::mmap
+            (nullptr, std::size_t(file_stat.st_size), PROT_READ, MAP_PRIVATE,
+             fd, 0);
+        if (mapping != MAP_FAILED) {
+            m_begin = static_cast<const char *>(mapping);
+            m_size = std::size_t(file_stat.st_size);
+            m_is_mapped = true;
+        }
+    }
+    // the mapping stays valid after closing
+    ::close(fd);
+#   else
+    read_whole_file(filename);
+#   endif
+}
+
+RegionGeometryCache::MappedFile::~MappedFile() {
+#   if defined(__unix__) && !defined(__EMSCRIPTEN__)
+    if (m_is_mapped)
+        { ::munmap(const_cast<char *>(m_begin), m_size); }
+#   endif
+}
+
+/* private */ void RegionGeometryCache::MappedFile::read_whole_file
+    (const std::string & filename)
+{
+    std::ifstream fin{filename, std::ios::binary};
+    if (!fin) return;
+    m_read.assign(std::istreambuf_iterator<char>{fin},
+                  std::istreambuf_iterator<char>{});
+    m_begin = m_read.data();
+    m_size = m_read.size();
+}
+
+// ----------------------------------------------------------------------------
+
+RegionGeometryCache::RegionGeometryCache() {}
+
+RegionGeometryCache::RegionGeometryCache
+    (const std::string & filename,
+     std::uint64_t content_key,
+     std::size_t max_added_regions):
+    m_filename(filename),
+    m_content_key(content_key),
+    m_max_added_regions(max_added_regions),
+    m_file(make_unique<MappedFile>(filename))
+{
+    read_mapped_records();
+    m_metrics.file_regions = int(m_file_records.size());
+}
+
+RegionGeometryCache::~RegionGeometryCache() {}
+
+SharedPtr<ViewGridTriangle> RegionGeometryCache::find
+    (const Vector2I & on_field_position)
+{
+    if (m_filename.empty()) return nullptr;
+
+    SharedPtr<ViewGridTriangle> found;
+    Optional<ByteView> file_bytes;
+    {
+    std::unique_lock lock{m_mutex};
+    auto file_record = m_file_records.find(on_field_position);
+    if (file_record != m_file_records.end()) {
+        file_bytes = file_record->second;
+    } else {
+        auto added_record = m_added_records.find(on_field_position);
+        if (added_record != m_added_records.end()) {
+            auto & bytes = added_record->second;
+            found = deserialize_region
+                (ByteView{bytes.data(), bytes.data() + bytes.size()});
+        }
+    }
+    }
+    // the mapping outlives any record dropped meanwhile
+    if (file_bytes)
+        { found = deserialize_region(*file_bytes); }
+
+    std::unique_lock lock{m_mutex};
+    ++(found ? m_metrics.hits : m_metrics.misses);
+    return found;
+}
+
+void RegionGeometryCache::add
+    (const Vector2I & on_field_position, const ViewGridTriangle & triangle_grid)
+{
+    if (m_filename.empty()) return;
+
+    auto bytes = serialize_region(triangle_grid);
+    std::unique_lock lock{m_mutex};
+    if (m_file_records.find(on_field_position) != m_file_records.end())
+        { return; }
+    // still full, as saving failed
+    if (m_added_records.size() >= m_max_added_regions)
+        { return; }
+    if (m_added_records.emplace(on_field_position, std::move(bytes)).second)
+        { m_has_changes = true; }
+    if (m_added_records.size() >= m_max_added_regions)
+        { (void)save_(); }
+}
+
+bool RegionGeometryCache::check_sub_map
+    (const std::string & filename, std::uint64_t content_key)
+{
+    std::unique_lock lock{m_mutex};
+    if (m_filename.empty()) return true;
+
+    auto itr = m_sub_map_keys.find(filename);
+    if (itr == m_sub_map_keys.end()) {
+        // regions are only ever kept from loaded sub maps, so none of
+        // these could have been made from it
+        m_sub_map_keys.emplace(filename, content_key);
+        m_has_changes = true;
+        return true;
+    }
+    if (itr->second == content_key) return true;
+
+    itr->second = content_key;
+    m_file_records.clear();
+    m_added_records.clear();
+    m_has_changes = true;
+    return false;
+}
+
+bool RegionGeometryCache::save() {
+    std::unique_lock lock{m_mutex};
+    return save_();
+}
+
+RegionGeometryCache::Metrics RegionGeometryCache::metrics() const {
+    std::unique_lock lock{m_mutex};
+    return m_metrics;
+}
+
+/* private */ void RegionGeometryCache::read_mapped_records() {
+    ByteReader reader{m_file->bytes()};
+    FileHeader header;
+    if (   !reader.read(header)
+        || header.magic != k_file_magic
+        || header.version != k_geometry_version
+        || header.content_key != m_content_key)
+    { return; }
+
+    for (std::uint64_t i = 0; i != header.sub_map_count; ++i) {
+        SubMapHeader sub_map;
+        if (!reader.read(sub_map)) return;
+        auto filename = reader.read_view(std::size_t(sub_map.filename_size));
+        if (std::size_t(filename.end() - filename.begin()) != sub_map.filename_size)
+            { return; }
+        m_sub_map_keys.emplace
+            (std::string{filename.begin(), filename.end()}, sub_map.content_key);
+    }
+    for (std::uint64_t i = 0; i != header.record_count; ++i) {
+        RecordHeader record;
+        if (!reader.read(record) || reader.remaining() < record.size) {
+            // truncated, whatever was read in full is still good
+            break;
+        }
+        m_file_records.emplace
+            (Vector2I{record.x, record.y},
+             reader.read_view(std::size_t(record.size)));
+    }
+}
+
+/* private */ bool RegionGeometryCache::save_() {
+    if (m_filename.empty() || !m_has_changes) return true;
+
+    auto write_record = [] (std::ofstream & fout, const Vector2I & r,
+                            const ByteView & bytes)
+    {
+        RecordHeader header;
+        header.x = r.x;
+        header.y = r.y;
+        header.size = std::uint64_t(bytes.end() - bytes.begin());
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        fout.write(bytes.begin(), bytes.end() - bytes.begin());
+    };
+
+    // written beside, then moved over the old file, which may still be mapped
+    auto new_filename = m_filename + ".new";
+    {
+    std::ofstream fout{new_filename, std::ios::binary | std::ios::trunc};
+    FileHeader header;
+    header.content_key = m_content_key;
+    header.sub_map_count = m_sub_map_keys.size();
+    header.record_count = m_file_records.size() + m_added_records.size();
+    fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (auto & [filename, content_key] : m_sub_map_keys) {
+        SubMapHeader sub_map;
+        sub_map.content_key = content_key;
+        sub_map.filename_size = filename.size();
+        fout.write(reinterpret_cast<const char *>(&sub_map), sizeof(sub_map));
+        fout.write(filename.data(), filename.size());
+    }
+    for (auto & [r, bytes] : m_file_records)
+        { write_record(fout, r, bytes); }
+    for (auto & [r, bytes] : m_added_records) {
+        write_record
+            (fout, r, ByteView{bytes.data(), bytes.data() + bytes.size()});
+    }
+    if (!fout) {
+        std::remove(new_filename.c_str());
+        return false;
+    }
+    }
+    if (std::rename(new_filename.c_str(), m_filename.c_str()) != 0)
+        { return false; }
+    m_has_changes = false;
+
+    // added records are read out of the new file's mapping from now on
+    auto new_file = make_unique<MappedFile>(m_filename);
+    if (!new_file->is_mapped())
+        { return true; }
+    m_replaced_files.emplace_back(std::move(m_file));
+    m_file = std::move(new_file);
+    m_file_records.clear();
+    m_added_records.clear();
+    read_mapped_records();
+    return true;
+}
+
+namespace {
+
+ByteView ByteReader::read_view(std::size_t count) {
+    if (remaining() < count) return ByteView{m_end, m_end};
+    ByteView rv{m_position, m_position + count};
+    m_position += count;
+    return rv;
+}
+
+// ----------------------------------------------------------------------------
+
+std::uint64_t fnv1a(std::uint64_t value, const ByteView & bytes) {
+    static constexpr std::uint64_t k_prime = 0x100000001b3ull;
+    for (char c : bytes) {
+        value ^= std::uint64_t(static_cast<unsigned char>(c));
+        value *= k_prime;
+    }
+    return value;
+}
+
+Bytes serialize_region(const ViewGridTriangle & triangle_grid) {
+    // links are numbered in the same order they're inserted when read back
+    std::unordered_map<const TriangleLink *, std::int32_t> indices;
+    std::vector<const TriangleLink *> links;
+    Bytes bytes;
+    append(bytes, std::int32_t(triangle_grid.width ()));
+    append(bytes, std::int32_t(triangle_grid.height()));
+    for (Vector2I r; r != triangle_grid.end_position(); r = triangle_grid.next(r)) {
+        auto cell = triangle_grid(r);
+        append(bytes, std::uint32_t(cell.end() - cell.begin()));
+        for (auto & link : cell) {
+            indices.emplace(link.get(), std::int32_t(links.size()));
+            links.push_back(link.get());
+        }
+    }
+    for (auto * link : links) {
+        const auto & triangle = link->segment();
+        for (auto pt : { triangle.point_a(), triangle.point_b(), triangle.point_c() }) {
+            append(bytes, std::array<double, 3>
+                {double(pt.x), double(pt.y), double(pt.z)});
+        }
+    }
+    for (auto * link : links) {
+        for (auto side : k_sides) {
+            auto transfer = link->transfers_to(side);
+            SideRecord record;
+            auto target = indices.find(transfer.target());
+            if (target != indices.end()) {
+                record.target = target->second;
+                record.target_side = std::uint8_t(transfer.target_side());
+                record.inverts_normal = transfer.inverts_normal();
+                record.flips_position = transfer.flips_position();
+            }
+            append(bytes, record);
+        }
+    }
+    return bytes;
+}
+
+SharedPtr<ViewGridTriangle> deserialize_region(const ByteView & bytes) {
+    ByteReader reader{bytes};
+    std::int32_t width = 0, height = 0;
+    if (!reader.read(width) || !reader.read(height) || width < 0 || height < 0)
+        { return nullptr; }
+    auto cell_count = std::size_t(width)*std::size_t(height);
+    if (reader.remaining() < cell_count*sizeof(std::uint32_t))
+        { return nullptr; }
+
+    std::vector<std::uint32_t> counts(cell_count);
+    std::size_t link_count = 0;
+    for (auto & count : counts) {
+        (void)reader.read(count);
+        link_count += count;
+    }
+    static constexpr auto k_bytes_per_link =
+        sizeof(std::array<double, 3>)*3 + sizeof(SideRecord)*k_sides.size();
+    if (reader.remaining() < link_count*k_bytes_per_link)
+        { return nullptr; }
+
+    std::vector<SharedPtr<TriangleLink>> links;
+    links.reserve(link_count);
+    ViewGridInserter<SharedPtr<TriangleLink>> inserter{width, height};
+    for (auto count : counts) {
+        for (std::uint32_t i = 0; i != count; ++i) {
+            std::array<Vector, 3> points;
+            for (auto & pt : points) {
+                std::array<double, 3> values;
+                (void)reader.read(values);
+                pt = Vector{Real(values[0]), Real(values[1]), Real(values[2])};
+            }
+            links.push_back
+                (make_shared<TriangleLink>(points[0], points[1], points[2]));
+            inserter.push(links.back());
+        }
+        inserter.advance();
+    }
+    for (auto & link : links) {
+        for (auto side : k_sides) {
+            SideRecord record;
+            (void)reader.read(record);
+            if (record.target < 0) continue;
+            if (   std::size_t(record.target) >= links.size()
+                || record.target_side >= k_sides.size())
+            { return nullptr; }
+            link->set_transfer(side, TriangleLinkTransfer
+                {links[record.target].get(), Side(record.target_side),
+                 !!record.inverts_normal, !!record.flips_position});
+        }
+    }
+    return make_shared<ViewGridTriangle>(inserter.finish());
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,166 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "MapRegionContainer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// Hashes the contents of every file that goes into making a map's regions.
+///
+/// Files may be added in any order (and from any thread), the same set of
+/// files always gives the same value.
+class RegionContentKey final {
+public:
+    void add_file(const std::string & filename, const std::string & contents);
+
+    /// @returns value mixed with the names of the given fillers, and the
+    ///          cache's geometry version
+    template <typename FillerMap>
+    std::uint64_t value_with_fillers(const FillerMap & fillers) const;
+
+    std::uint64_t value() const noexcept { return m_value; }
+
+private:
+    static std::uint64_t mix_in(std::uint64_t value, const std::string &);
+
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+// ----------------------------------------------------------------------------
+
+/// Keeps the linked triangles of each sub region on disk, between runs.
+///
+/// A cache is tied to a content key; a file saved under another key is
+/// treated as empty. Cached regions are read straight out of the file's
+/// mapping. Only links within the sub region are kept, as links across
+/// regions are made by their seams when committed.
+///
+/// Regions may also be made from sub maps, which are loaded apart from the
+/// map. Their keys are kept with the file, and checked as they're loaded.
+///
+/// Added regions are held in memory only until there are enough of them,
+/// then they're saved, and read out of the new file's mapping from then on.
+/// Should saving fail (or the file can't be mapped), no more than that many
+/// are held.
+///
+/// Finding and adding regions may be done from any thread.
+class RegionGeometryCache final {
+public:
+    using ViewGridTriangle = MapRegionContainer::ViewGridTriangle;
+
+    /// Bump whenever producables or their fillers change the triangles they
+    /// make.
+    static constexpr const std::uint32_t k_geometry_version = 2;
+
+    static constexpr const std::size_t k_default_max_added_regions = 256;
+
+    struct Metrics final {
+        int hits = 0;
+        int misses = 0;
+        /// regions read from the file when opened
+        int file_regions = 0;
+    };
+
+    /// keeps nothing, finds nothing
+    RegionGeometryCache();
+
+    /// @param max_added_regions number of regions added before saving
+    RegionGeometryCache
+        (const std::string & filename,
+         std::uint64_t content_key,
+         std::size_t max_added_regions = k_default_max_added_regions);
+
+    RegionGeometryCache(const RegionGeometryCache &) = delete;
+
+    RegionGeometryCache(RegionGeometryCache &&) = delete;
+
+    ~RegionGeometryCache();
+
+    RegionGeometryCache & operator = (const RegionGeometryCache &) = delete;
+
+    RegionGeometryCache & operator = (RegionGeometryCache &&) = delete;
+
+    /// @returns newly made links, already linked to each other, or nullptr
+    ///          if nothing is kept for that position
+    SharedPtr<ViewGridTriangle> find(const Vector2I & on_field_position);
+
+    /// Regions already kept are left alone. Adding may save, whichever
+    /// thread it's called from.
+    void add(const Vector2I & on_field_position, const ViewGridTriangle &);
+
+    /// Drops every kept region if the sub map was kept under another key, as
+    /// there's no telling which regions were made from it. Must be called
+    /// before any region made from the sub map is added.
+    ///
+    /// @returns false if kept regions were dropped
+    bool check_sub_map(const std::string & filename, std::uint64_t content_key);
+
+    /// Writes out all kept regions and sub map keys, only if either changed
+    /// since opening.
+    ///
+    /// @returns false if the file could not be written, which leaves the
+    ///          old file as it was
+    bool save();
+
+    Metrics metrics() const;
+
+private:
+    class MappedFile;
+    using Bytes = std::vector<char>;
+    using ByteView = View<const char *>;
+
+    void read_mapped_records();
+
+    bool save_();
+
+    std::string m_filename;
+    std::uint64_t m_content_key = 0;
+    std::size_t m_max_added_regions = k_default_max_added_regions;
+    UniquePtr<MappedFile> m_file;
+    // replaced by saving, records found in them may still be read
+    std::vector<UniquePtr<MappedFile>> m_replaced_files;
+
+    mutable std::mutex m_mutex;
+    // views into the mapped file, only ever dropped (the mapping stays)
+    std::unordered_map<Vector2I, ByteView, Vector2IHasher> m_file_records;
+    std::unordered_map<Vector2I, Bytes, Vector2IHasher> m_added_records;
+    std::unordered_map<std::string, std::uint64_t> m_sub_map_keys;
+    bool m_has_changes = false;
+    Metrics m_metrics;
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename FillerMap>
+std::uint64_t RegionContentKey::value_with_fillers
+    (const FillerMap & fillers) const
+{
+    auto value = mix_in(m_value, std::to_string
+        (RegionGeometryCache::k_geometry_version));
+    for (auto & name_and_filler : fillers)
+        { value = mix_in(value, name_and_filler.first); }
+    return value;
+}
@@ -38,6 +38,9 @@ constexpr Vector k_default_facing = Vector{1, 0, 0};
 TriangleSegment find_triangle_with_adjusted
     (const Vector & position, const Vector & facing, Real speed);
 
+/// touching counts as overlapping
+bool bounds_overlap(const cul::Rectangle<Real> &, const cul::Rectangle<Real> &);
+
 } // end of <anonymous> namespace
 
 RectanglePoints::RectanglePoints(const cul::Rectangle<Real> & rect):
@@ -150,6 +153,9 @@ bool RegionLoadRequest::overlaps_with
 bool RegionLoadRequest::overlaps_with_field_rectangle
     (const cul::Rectangle<Real> & field_rectangle) const
 {
+    // cheap test first, most rectangles tested are nowhere near
+    if (!bounds_overlap(m_triangle_bounds, field_rectangle)) return false;
+
     RectanglePoints tile_bounds_pts{field_rectangle};
     // my other solution maybe much more complicated... :c
     // it doesn't mean it can't be attempted
@@ -242,6 +248,53 @@ bool RegionLoadRequest::any_point_is_contained_in
 
 // ----------------------------------------------------------------------------
 
+/* static */ bool RegionPrefetchPlan::are_same_headings
+    (const Vector & lhs, const Vector & rhs)
+{
+    bool lhs_is_still = are_very_close(lhs, Vector{});
+    bool rhs_is_still = are_very_close(rhs, Vector{});
+    if (lhs_is_still || rhs_is_still)
+        { return lhs_is_still == rhs_is_still; }
+    return dot(lhs, rhs) >= k_same_heading_cosine;
+}
+
+/* static */ RegionPrefetchPlan RegionPrefetchPlan::find
+    (const Entity & physical_ent, Real horizon_seconds, Real step_seconds)
+{
+    return find
+        (point_and_plane::location_of(physical_ent.get<PpState>()),
+         physical_ent.get<Velocity>().value,
+         horizon_seconds,
+         step_seconds);
+}
+
+/* static */ RegionPrefetchPlan RegionPrefetchPlan::find
+    (const Vector & player_position,
+     const Vector & player_velocity,
+     Real horizon_seconds,
+     Real step_seconds,
+     Size2I max_region_size)
+{
+    if (step_seconds <= 0) {
+        throw InvalidArgument{"RegionPrefetchPlan::find: step_seconds must be "
+                              "a positive real number"};
+    }
+    auto velocity = project_onto_plane(player_velocity, k_plane_normal);
+    if (magnitude(velocity) < k_min_speed)
+        { return RegionPrefetchPlan{}; }
+
+    auto heading = normalize(velocity);
+    std::vector<Waypoint> waypoints;
+    for (Real t = step_seconds; t <= horizon_seconds; t += step_seconds) {
+        auto request = RegionLoadRequest::find
+            (player_position + velocity*t, heading, velocity, max_region_size);
+        waypoints.emplace_back(t, request);
+    }
+    return RegionPrefetchPlan{heading, std::move(waypoints)};
+}
+
+// ----------------------------------------------------------------------------
+
 namespace {
 
 Real interpolate(Real t, Real low, Real high)
@@ -272,4 +325,11 @@ TriangleSegment find_triangle_with_adjusted
     return TriangleSegment{a, b, c};
 }
 
+bool bounds_overlap
+    (const cul::Rectangle<Real> & lhs, const cul::Rectangle<Real> & rhs)
+{
+    return    lhs.left <= rhs.left + rhs.width  && rhs.left <= lhs.left + lhs.width
+           && lhs.top  <= rhs.top  + rhs.height && rhs.top  <= lhs.top  + lhs.height;
+}
+
 } // end of <anonymous> namespace
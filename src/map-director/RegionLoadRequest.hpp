@@ -120,3 +120,61 @@ private:
     Vector2 m_pt_c;
     Size2I m_max_size;
 };
+
+// ----------------------------------------------------------------------------
+
+/// Where the player is headed over the next few seconds, as a series of load
+/// requests along their (straight line) trajectory.
+///
+/// Regions found with these requests are meant to be prepared ahead of time,
+/// and are ordered by how soon the player may reach them.
+class RegionPrefetchPlan final {
+public:
+    /// speeds below this do not head anywhere
+    static constexpr Real k_min_speed = 0.5;
+    /// cosine of the largest angle a heading may turn, and still be
+    /// considered the same heading
+    static constexpr Real k_same_heading_cosine = 0.866;
+
+    struct Waypoint final {
+        Waypoint(Real seconds_to_arrival_, const RegionLoadRequest & request_):
+            seconds_to_arrival(seconds_to_arrival_), request(request_) {}
+
+        Real seconds_to_arrival;
+        RegionLoadRequest request;
+    };
+
+    /// @param lhs either a heading or a zero vector
+    /// @param rhs either a heading or a zero vector
+    static bool are_same_headings(const Vector & lhs, const Vector & rhs);
+
+    static RegionPrefetchPlan find
+        (const Entity & physical_ent, Real horizon_seconds, Real step_seconds);
+
+    /// @param horizon_seconds how far ahead in time the plan extends
+    /// @param step_seconds time between waypoints, must be positive
+    static RegionPrefetchPlan find
+        (const Vector & player_position,
+         const Vector & player_velocity,
+         Real horizon_seconds,
+         Real step_seconds,
+         Size2I max_region_size = RegionLoadRequest::k_default_max_region_size);
+
+    RegionPrefetchPlan() {}
+
+    /// @returns a unit vector on the load request plane, or a zero vector if
+    ///          the player is not heading anywhere
+    const Vector & heading() const { return m_heading; }
+
+
+    /// waypoints in order of their arrival times
+    const std::vector<Waypoint> & waypoints() const { return m_waypoints; }
+
+private:
+    RegionPrefetchPlan
+        (const Vector & heading, std::vector<Waypoint> && waypoints):
+        m_heading(heading), m_waypoints(std::move(waypoints)) {}
+
+    Vector m_heading;
+    std::vector<Waypoint> m_waypoints;
+};
@@ -136,17 +136,65 @@ RegionPositionFraming RegionPositionFraming::with_scaling
      const RegionLoadRequestBase & request,
      const OverlapFunc & f) const
 {
+    if (region_size.width <= 0 || region_size.height <= 0) return;
     const auto step = region_load_step(region_size, request);
+    auto blocks_along = [] (int length, int step)
+        { return (length + step - 1) / step; };
+    RectangleI all_sub_regions
+        {0, 0,
+         blocks_along(region_size.width , step.x),
+         blocks_along(region_size.height, step.y)};
+    for_each_overlap_in(all_sub_regions, step, region_size, request, f);
+}
+
+/* private */ void RegionPositionFraming::for_each_overlap_in
+    (const RectangleI & sub_region_block,
+     const Vector2I & step,
+     const Size2I & region_size,
+     const RegionLoadRequestBase & request,
+     const OverlapFunc & f) const
+{
+    const auto & block = sub_region_block;
     const auto subgrid_size = cul::convert_to<Size2I>(step);
-    for (Vector2I r; r.x < region_size.width ; r.x += step.x) {
-    for (r.y = 0   ; r.y < region_size.height; r.y += step.y) {
-        auto on_field_position = m_on_field_position + m_tile_scale.of(r);
-        RectangleI on_field_rect{on_field_position, m_tile_scale.of(subgrid_size)};
-        bool overlaps_this_subregion = request.
-            overlaps_with(on_field_rect);
-        if (!overlaps_this_subregion) continue;
-
-        f(move(r),
-          fit_rectangle_within(RectangleI{r, subgrid_size}, region_size));
-    }}
+    // bounds of the block are taken from its first and last sub regions,
+    // so that they're exactly those of every sub region put together
+    auto on_field_position_of = [this, &step] (int x, int y) {
+        return m_on_field_position +
+               m_tile_scale.of(Vector2I{x*step.x, y*step.y});
+    };
+    auto on_field_size = m_tile_scale.of(subgrid_size);
+    auto top_left = on_field_position_of(block.left, block.top);
+    auto last = on_field_position_of(block.left + block.width  - 1,
+                                     block.top  + block.height - 1);
+    RectangleI on_field_rect
+        {top_left.x, top_left.y,
+         last.x + on_field_size.width  - top_left.x,
+         last.y + on_field_size.height - top_left.y};
+    if (!request.overlaps_with(on_field_rect)) return;
+
+    if (block.width > 1) {
+        auto west_width = block.width / 2;
+        for_each_overlap_in
+            (RectangleI{block.left, block.top, west_width, block.height},
+             step, region_size, request, f);
+        for_each_overlap_in
+            (RectangleI{block.left + west_width, block.top,
+                        block.width - west_width, block.height},
+             step, region_size, request, f);
+        return;
+    } else if (block.height > 1) {
+        auto north_height = block.height / 2;
+        for_each_overlap_in
+            (RectangleI{block.left, block.top, 1, north_height},
+             step, region_size, request, f);
+        for_each_overlap_in
+            (RectangleI{block.left, block.top + north_height,
+                        1, block.height - north_height},
+             step, region_size, request, f);
+        return;
+    }
+
+    Vector2I r{block.left*step.x, block.top*step.y};
+    f(move(r),
+      fit_rectangle_within(RectangleI{r, subgrid_size}, region_size));
 }
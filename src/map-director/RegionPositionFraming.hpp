@@ -80,6 +80,9 @@ public:
     auto region_refresh_for(MapRegionContainer & container) const
         { return container.region_refresh_at(m_on_field_position); }
 
+    const Vector2I & on_field_position() const noexcept
+        { return m_on_field_position; }
+
     bool operator == (const SubRegionPositionFraming &) const;
 
 private:
@@ -126,6 +129,16 @@ private:
                            const RegionLoadRequestBase & request,
                            const OverlapFunc & f) const;
 
+    /// Tests the bounds of a block of sub regions, and only looks inside if
+    /// the request overlaps them. Blocks are halved along x first, so sub
+    /// regions are visited in the same order a plain walk would.
+    void for_each_overlap_in
+        (const RectangleI & sub_region_block,
+         const Vector2I & step,
+         const Size2I & region_size,
+         const RegionLoadRequestBase & request,
+         const OverlapFunc & f) const;
+
     Vector2I m_on_field_position;
     ScaleComputation m_tile_scale;
 };
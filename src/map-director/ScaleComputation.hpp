@@ -94,6 +94,9 @@ public:
 
     auto all_links() const { return m_triangle_grid->elements(); }
 
+    const SharedPtr<ViewGridTriangle> & triangle_grid() const noexcept
+        { return m_triangle_grid; }
+
 private:
     SharedPtr<ViewGridTriangle> m_triangle_grid;
     ScaleComputation m_scale;
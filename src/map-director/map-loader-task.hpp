@@ -32,6 +32,8 @@ public:
         UniquePtr<MapRegion> map_region;
         MapObjectCollection map_objects;
         MapObjectFraming object_framing;
+        /// hash of every file the map was loaded from
+        std::uint64_t region_content_key = 0;
     };
 
     static SharedPtr<MapLoaderTask_> make
@@ -0,0 +1,303 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "CompiledMap.hpp"
+#include "tile-layer-decoding.hpp"
+
+#include "../RegionGeometryCache.hpp"
+
+#include <ariajanke/cul/Either.hpp>
+
+#include <tinyxml2.h>
+
+#include <cstring>
+
+namespace {
+
+constexpr const std::uint32_t k_file_magic = 0x504d4352; // "RCMP"
+
+// followed by the name of each source, each layer, and then the document
+// (together, the payload)
+struct FileHeader final {
+    std::uint32_t magic = k_file_magic;
+    std::uint32_t version = CompiledMap::k_version;
+    std::uint64_t payload_checksum = 0;
+    std::uint64_t source_key = 0;
+    std::uint64_t source_count = 0;
+    std::uint64_t layer_count = 0;
+    std::uint64_t document_size = 0;
+};
+
+// followed by the source's filename
+struct SourceHeader final {
+    std::uint64_t filename_size = 0;
+};
+
+// followed by each tile id, in the layer's "next" order
+struct LayerHeader final {
+    std::int32_t width = 0;
+    std::int32_t height = 0;
+};
+
+class ByteReader final {
+public:
+    explicit ByteReader(const std::string & bytes):
+        m_position(bytes.data()), m_end(bytes.data() + bytes.size()) {}
+
+    template <typename T>
+    bool read(T & obj) {
+        if (remaining() < sizeof(T)) return false;
+        std::memcpy(&obj, m_position, sizeof(T));
+        m_position += sizeof(T);
+        return true;
+    }
+
+    /// @returns nothing if there are fewer than count bytes left
+    Optional<std::string> read_string(std::uint64_t count);
+
+    std::size_t remaining() const noexcept
+        { return std::size_t(m_end - m_position); }
+
+private:
+    const char * m_position;
+    const char * m_end;
+};
+
+template <typename T>
+void append(std::string & bytes, const T & obj) {
+    auto * beg = reinterpret_cast<const char *>(&obj);
+    bytes.append(beg, beg + sizeof(T));
+}
+
+/// @returns FNV-1a hash of bytes after the file's header
+std::uint64_t checksum_payload(const std::string & file_bytes);
+
+void parse_or_throw
+    (TiXmlDocument &, const std::string & contents,
+     const std::string & filename);
+
+Optional<Grid<int>> read_layer(ByteReader &);
+
+} // end of <anonymous> namespace
+
+/* static */ std::string CompiledMap::compiled_filename_for
+    (const std::string & map_filename)
+{ return map_filename + k_filename_suffix; }
+
+/* static */ CompiledMap CompiledMap::compile
+    (const std::string & map_filename, const FileReader & read_file)
+{
+    CompiledMap compiled;
+    std::vector<std::string> sources_contents;
+    auto parse_source = [&] (TiXmlDocument & document, const std::string & filename) {
+        auto contents = read_file(filename);
+        if (!contents) {
+            throw RuntimeError
+                {"CompiledMap::compile: cannot read \"" + filename + "\""};
+        }
+        parse_or_throw(document, *contents, filename);
+        compiled.m_source_filenames.push_back(filename);
+        sources_contents.emplace_back(std::move(*contents));
+    };
+
+    TiXmlDocument document;
+    parse_source(document, map_filename);
+    auto & root = *document.RootElement();
+
+    std::vector<TiXmlElement *> layer_elements;
+    for (auto * layer_el = root.FirstChildElement("layer"); layer_el;
+         layer_el = layer_el->NextSiblingElement("layer"))
+    {
+        auto layer = tile_layer_decoding::decode_layer_element(*layer_el);
+        if (!layer.is_right()) {
+            throw RuntimeError
+                {"CompiledMap::compile: a layer of \"" + map_filename +
+                 "\" could not be decoded"};
+        }
+        compiled.m_layers.emplace_back(layer.right());
+        layer_elements.push_back(layer_el);
+    }
+    for (auto * layer_el : layer_elements)
+        { root.DeleteChild(layer_el); }
+
+    // tilesets in their own files are written in, in place of referring to
+    // them
+    auto * tileset = root.FirstChildElement("tileset");
+    while (tileset) {
+        const auto * source = tileset->Attribute("source");
+        if (!source) {
+            tileset = tileset->NextSiblingElement("tileset");
+            continue;
+        }
+        TiXmlDocument tileset_document;
+        parse_source(tileset_document, source);
+        auto * written_in = tileset_document.RootElement()->
+            DeepClone(&document)->ToElement();
+        if (const auto * first_gid = tileset->Attribute("firstgid"))
+            { written_in->SetAttribute("firstgid", first_gid); }
+        root.InsertAfterChild(tileset, written_in);
+        root.DeleteChild(tileset);
+        tileset = written_in->NextSiblingElement("tileset");
+    }
+
+    tinyxml2::XMLPrinter printer{nullptr, true};
+    document.Print(&printer);
+    compiled.m_document_contents = printer.CStr();
+    compiled.m_source_key =
+        key_sources(compiled.m_source_filenames, sources_contents);
+    return compiled;
+}
+
+/* static */ Optional<CompiledMap> CompiledMap::read
+    (const std::string & compiled_contents)
+{
+    ByteReader reader{compiled_contents};
+    FileHeader header;
+    if (   !reader.read(header)
+        || header.magic != k_file_magic
+        || header.version != k_version
+        || header.payload_checksum != checksum_payload(compiled_contents))
+    { return {}; }
+
+    CompiledMap compiled;
+    compiled.m_source_key = header.source_key;
+    for (std::uint64_t i = 0; i != header.source_count; ++i) {
+        SourceHeader source;
+        if (!reader.read(source)) return {};
+        auto filename = reader.read_string(source.filename_size);
+        if (!filename) return {};
+        compiled.m_source_filenames.emplace_back(std::move(*filename));
+    }
+    for (std::uint64_t i = 0; i != header.layer_count; ++i) {
+        auto layer = read_layer(reader);
+        if (!layer) return {};
+        compiled.m_layers.emplace_back(std::move(*layer));
+    }
+    auto document = reader.read_string(header.document_size);
+    if (!document || compiled.m_source_filenames.empty()) return {};
+    compiled.m_document_contents = std::move(*document);
+    return compiled;
+}
+
+std::string CompiledMap::write() const {
+    FileHeader header;
+    header.source_key = m_source_key;
+    header.source_count = m_source_filenames.size();
+    header.layer_count = m_layers.size();
+    header.document_size = m_document_contents.size();
+
+    std::string bytes;
+    append(bytes, header);
+    for (auto & filename : m_source_filenames) {
+        SourceHeader source;
+        source.filename_size = filename.size();
+        append(bytes, source);
+        bytes += filename;
+    }
+    for (auto & layer : m_layers) {
+        LayerHeader layer_header;
+        if (layer.width() != 0 && layer.height() != 0) {
+            layer_header.width = layer.width();
+            layer_header.height = layer.height();
+        }
+        append(bytes, layer_header);
+        if (layer_header.width == 0) continue;
+        for (Vector2I r; r != layer.end_position(); r = layer.next(r))
+            { append(bytes, std::int32_t(layer(r))); }
+    }
+    bytes += m_document_contents;
+    header.payload_checksum = checksum_payload(bytes);
+    std::memcpy(bytes.data(), &header, sizeof(FileHeader));
+    return bytes;
+}
+
+bool CompiledMap::is_compiled_from
+    (const std::vector<std::string> & sources_contents) const
+{
+    return    sources_contents.size() == m_source_filenames.size()
+           && key_sources(m_source_filenames, sources_contents) == m_source_key;
+}
+
+/* private static */ std::uint64_t CompiledMap::key_sources
+    (const std::vector<std::string> & filenames,
+     const std::vector<std::string> & contents)
+{
+    RegionContentKey key;
+    for (std::size_t i = 0; i != filenames.size(); ++i)
+        { key.add_file(filenames[i], contents[i]); }
+    return key.value();
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+Optional<std::string> ByteReader::read_string(std::uint64_t count) {
+    if (remaining() < count) return {};
+    std::string rv{m_position, m_position + count};
+    m_position += count;
+    return rv;
+}
+
+std::uint64_t checksum_payload(const std::string & file_bytes) {
+    static constexpr std::uint64_t k_prime = 0x100000001b3ull;
+    std::uint64_t value = 0xcbf29ce484222325ull;
+    if (file_bytes.size() < sizeof(FileHeader)) return value;
+    for (auto itr = file_bytes.begin() + sizeof(FileHeader);
+         itr != file_bytes.end(); ++itr)
+    {
+        value ^= std::uint64_t(static_cast<unsigned char>(*itr));
+        value *= k_prime;
+    }
+    return value;
+}
+
+void parse_or_throw
+    (TiXmlDocument & document,
+     const std::string & contents,
+     const std::string & filename)
+{
+    auto res = document.Parse(contents.c_str(), contents.size());
+    if (res == tinyxml2::XML_SUCCESS && document.RootElement()) return;
+    throw RuntimeError
+        {"CompiledMap::compile: cannot parse \"" + filename + "\""};
+}
+
+Optional<Grid<int>> read_layer(ByteReader & reader) {
+    LayerHeader header;
+    if (!reader.read(header) || header.width < 0 || header.height < 0)
+        { return {}; }
+    auto tile_count = std::size_t(header.width)*std::size_t(header.height);
+    if (reader.remaining() / sizeof(std::int32_t) < tile_count)
+        { return {}; }
+    if (tile_count == 0)
+        { return Grid<int>{}; }
+
+    Grid<int> layer;
+    layer.set_size(header.width, header.height, 0);
+    for (Vector2I r; r != layer.end_position(); r = layer.next(r)) {
+        std::int32_t tile_id = 0;
+        reader.read(tile_id);
+        layer(r) = tile_id;
+    }
+    return layer;
+}
+
+} // end of <anonymous> namespace
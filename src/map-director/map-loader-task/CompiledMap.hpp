@@ -0,0 +1,97 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "../../Definitions.hpp"
+
+#include <cstdint>
+#include <functional>
+
+/// A map, with the tilesets it refers to, compiled ahead of time by the map
+/// compiler (see src/platform/map-compiler).
+///
+/// Tile layers are kept already decoded. The rest of the map's document is
+/// kept as one small document, with each tileset file written in where it was
+/// referred to. So loading a compiled map parses one document without any
+/// layer data, rather than the whole map and then each of its tilesets.
+///
+/// Names and contents of the files it was compiled from are keyed. A compiled
+/// map is only used if those files still have the same key; otherwise it's
+/// stale, and the map is loaded from its files as usual. The compiled map's
+/// own contents are checksummed, so a damaged one is never used either.
+///
+/// Numbers are kept in the byte order of the machine that compiled it.
+class CompiledMap final {
+public:
+    /// @returns contents of the named file, or nothing if it can't be read
+    using FileReader =
+        std::function<Optional<std::string>(const std::string & filename)>;
+
+    /// Bump whenever the layout of compiled maps changes.
+    static constexpr const std::uint32_t k_version = 2;
+
+    static constexpr const auto k_filename_suffix = ".compiled";
+
+    static std::string compiled_filename_for(const std::string & map_filename);
+
+    /// @throws RuntimeError if the map or any of its tilesets can't be read
+    ///         or parsed, or if any layer can't be decoded
+    static CompiledMap compile
+        (const std::string & map_filename, const FileReader & read_file);
+
+    /// @returns nothing if not a compiled map, is one of another version, or
+    ///          its contents don't match their checksum
+    static Optional<CompiledMap> read(const std::string & compiled_contents);
+
+    CompiledMap() {}
+
+    std::string write() const;
+
+    /// @returns names of all files compiled from, the map's first and then
+    ///          its tilesets'
+    const std::vector<std::string> & source_filenames() const noexcept
+        { return m_source_filenames; }
+
+    /// @param sources_contents contents of each source file, in the same
+    ///        order as source_filenames
+    bool is_compiled_from
+        (const std::vector<std::string> & sources_contents) const;
+
+    const std::vector<Grid<int>> & layers() const noexcept
+        { return m_layers; }
+
+    std::vector<Grid<int>> take_layers() { return std::move(m_layers); }
+
+    /// @returns the map's document, without layers and with all tilesets
+    ///          written in
+    const std::string & document_contents() const noexcept
+        { return m_document_contents; }
+
+private:
+    static std::uint64_t key_sources
+        (const std::vector<std::string> & filenames,
+         const std::vector<std::string> & contents);
+
+    std::uint64_t m_source_key = 0;
+    std::vector<std::string> m_source_filenames;
+    std::vector<Grid<int>> m_layers;
+    std::string m_document_contents;
+};
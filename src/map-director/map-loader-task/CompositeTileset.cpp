@@ -19,7 +19,7 @@
 *****************************************************************************/
 
 #include "CompositeTileset.hpp"
-#include "MapLoaderTask.hpp"
+#include "../LazyMapRegion.hpp"
 
 #include <tinyxml2.h>
 
@@ -27,36 +27,6 @@ namespace {
 
 using Continuation = BackgroundTask::Continuation;
 
-class CompositeTilesetFinisherTask final : public BackgroundTask {
-public:
-    static RectangleI get_sub_rectangle_of
-        (const Vector2I & position,
-         const Grid<MapSubRegion> & sub_region_grid,
-         const MapRegion & map_region);
-
-    CompositeTilesetFinisherTask
-        (const SharedPtr<MapLoaderTask> & map_loader_task_,
-         SharedPtr<Grid<MapSubRegion>> & sub_regions_grid_,
-         SharedPtr<MapRegion> & source_map_);
-
-    Continuation & in_background
-        (Callbacks &, ContinuationStrategy &) final;
-
-private:
-    static SharedPtr<Grid<MapSubRegion>> &
-        verify_sub_regions_grid(SharedPtr<Grid<MapSubRegion>> &);
-
-    static const SharedPtr<MapLoaderTask> &
-        verify_map_loader_task(const SharedPtr<MapLoaderTask> &);
-
-    static SharedPtr<MapRegion> & verify_source_map(SharedPtr<MapRegion> &);
-
-    SharedPtr<BackgroundTask> m_map_loader_task;
-    SharedPtr<MapLoaderTask> m_map_retriever;
-    SharedPtr<Grid<MapSubRegion>> & m_sub_regions_grid;
-    SharedPtr<MapRegion> & m_source_map;
-};
-
 } // end of <anonymous> namespace
 
 /* static */ Grid<const MapSubRegion *> CompositeTileset::to_layer
@@ -87,25 +57,35 @@ private:
 Continuation & CompositeTileset::load
     (const DocumentOwningXmlElement & tileset_element, MapContentLoader & content_loader)
 {
-    SharedPtr<MapLoaderTask> map_loader_task;
+    const char * map_filename = nullptr;
     auto properties = tileset_element->FirstChildElement("properties");
     for (auto & property : XmlRange{properties, "property"}) {
         auto name = property.Attribute("name");
         auto value = property.Attribute("value");
         if (!name || !value) continue;
         if (::strcmp(name, "filename") == 0) {
-            map_loader_task = make_shared<MapLoaderTask>(value, content_loader);
+            map_filename = value;
         }
     }
-    if (!map_loader_task) {
+    if (!map_filename) {
         throw RuntimeError{"Unhandled: composite tileset without a filename"};
     }
+    auto grid_size = size_of_tileset(*tileset_element);
+    if (!grid_size) {
+        throw RuntimeError{"Composite tileset must have a tile count and "
+                           "columns"};
+    }
+    // the sub map is only loaded once a load request first overlaps it
+    m_source_map = make_shared<LazyMapRegion>(map_filename, *grid_size);
     m_sub_regions_grid = make_shared<Grid<MapSubRegion>>();
-    m_sub_regions_grid->set_size
-        (*size_of_tileset(*tileset_element), MapSubRegion{});
-    auto task_to_wait_on = make_shared<CompositeTilesetFinisherTask>
-        (std::move(map_loader_task), m_sub_regions_grid, m_source_map);
-    content_loader.wait_on(task_to_wait_on);
+    m_sub_regions_grid->set_size(*grid_size, MapSubRegion{});
+    for (Vector2I r;
+         r != m_sub_regions_grid->end_position();
+         r = m_sub_regions_grid->next(r))
+    {
+        (*m_sub_regions_grid)(r) =
+            MapSubRegion{RectangleI{r.x, r.y, 1, 1}, m_source_map};
+    }
     return content_loader.task_continuation();
 }
 
@@ -117,79 +97,3 @@ void CompositeTileset::add_map_elements
         (to_layer(*m_sub_regions_grid, layer_wrapper),
          m_sub_regions_grid);
 }
-
-namespace {
-
-/* static */ RectangleI CompositeTilesetFinisherTask::get_sub_rectangle_of
-    (const Vector2I & position,
-     const Grid<MapSubRegion> & sub_region_grid,
-     const MapRegion & map_region)
-{
-    auto map_region_size = map_region.size2();
-    auto width  = map_region_size.width  / sub_region_grid.width ();
-    auto height = map_region_size.height / sub_region_grid.height();
-    return RectangleI{position.x*width, position.y*height, width, height};
-}
-
-CompositeTilesetFinisherTask::CompositeTilesetFinisherTask
-    (const SharedPtr<MapLoaderTask> & map_loader_task_,
-     SharedPtr<Grid<MapSubRegion>> & sub_regions_grid_,
-     SharedPtr<MapRegion> & source_map_):
-    m_map_loader_task(verify_map_loader_task(map_loader_task_)),
-    m_map_retriever(map_loader_task_),
-    m_sub_regions_grid(verify_sub_regions_grid(sub_regions_grid_)),
-    m_source_map(verify_source_map(source_map_)) {}
-
-Continuation & CompositeTilesetFinisherTask::in_background
-    (Callbacks &, ContinuationStrategy & strategy)
-{
-    if (m_map_loader_task) {
-        auto ml = std::move(m_map_loader_task);
-        return strategy.continue_().wait_on(ml);
-    }
-
-    auto res = m_map_retriever->retrieve();
-    m_source_map = std::move(res.map_region);
-    for (Vector2I r;
-         r != m_sub_regions_grid->end_position();
-         r = m_sub_regions_grid->next(r))
-    {
-        auto subrect = get_sub_rectangle_of
-            (r, *m_sub_regions_grid, *m_source_map);
-        (*m_sub_regions_grid)(r) = MapSubRegion{subrect, m_source_map};
-    }
-    return strategy.finish_task();
-}
-
-/* private static */ SharedPtr<Grid<MapSubRegion>> &
-    CompositeTilesetFinisherTask::verify_sub_regions_grid
-    (SharedPtr<Grid<MapSubRegion>> & sub_regions_grid)
-{
-    if (!sub_regions_grid) {
-        throw InvalidArgument
-            {"Forgot to instantiate a owner grid"};
-    }
-    if (sub_regions_grid->size2() == Size2I{}) {
-        throw InvalidArgument
-            {"Forgot to set a size for owner grid"};
-    }
-    return sub_regions_grid;
-}
-
-/* private static */ const SharedPtr<MapLoaderTask> &
-    CompositeTilesetFinisherTask::verify_map_loader_task
-    (const SharedPtr<MapLoaderTask> & map_loader_task)
-{
-    if (map_loader_task) return map_loader_task;
-    throw InvalidArgument{"Forgot to instantiate map loader task"};
-}
-
-/* private static */ SharedPtr<MapRegion> &
-    CompositeTilesetFinisherTask::verify_source_map
-    (SharedPtr<MapRegion> & source_map)
-{
-    if (!source_map) return source_map;
-    throw InvalidArgument{"Forgot to not instantiate source map"};
-}
-
-} // end of <anonymous> namespace
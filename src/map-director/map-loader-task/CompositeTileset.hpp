@@ -39,6 +39,10 @@ public:
 
     void add_map_elements(TilesetMapElementCollector &, const TilesetLayerWrapper &) const final;
 
+    /// the sub map is tracked (loaded, evicted, and counted against the
+    /// memory budget) by the map it's loaded for
+    bool is_shareable() const final { return false; }
+
 private:
     Size2I size2() const final { return m_sub_regions_grid->size2(); }
 
@@ -22,6 +22,7 @@
 #include "ProducablesTileset.hpp"
 
 #include "../../Definitions.hpp"
+#include "../../Texture.hpp"
 
 namespace {
 
@@ -31,6 +32,30 @@ using TaskContinuation = MapContentLoaderComplete::TaskContinuation;
 using FillerFactoryMap = ProducablesTileset::FillerFactoryMap;
 using Result = MapLoaderTask::Result;
 
+/// Adds file contents to a content key, as they're retrieved.
+class ContentKeyingFuture final : public Future<std::string> {
+public:
+    ContentKeyingFuture
+        (const char * filename,
+         FutureStringPtr && future,
+         const SharedPtr<RegionContentKey> & content_key):
+        m_filename(filename),
+        m_future(std::move(future)),
+        m_content_key(content_key) {}
+
+    OptionalEither<Lost, std::string> retrieve() final {
+        return m_future->retrieve().map([this] (std::string && contents) {
+            m_content_key->add_file(m_filename, contents);
+            return std::move(contents);
+        });
+    }
+
+private:
+    std::string m_filename;
+    FutureStringPtr m_future;
+    SharedPtr<RegionContentKey> m_content_key;
+};
+
 } // end of <anonymous> namespace
 
 MapLoaderTask::MapLoaderTask
@@ -53,6 +78,8 @@ Continuation & MapLoaderTask::in_background
             m_map_result.map_region = std::move(res.loaded_region);
             m_map_result.map_objects = std::move(res.object_collection);
             m_map_result.object_framing = std::move(res.object_framing);
+            m_map_result.region_content_key =
+                m_content_loader.region_content_key();
             return 0;
         }).
         map_left([] (MapLoadingError &&) {
@@ -84,10 +111,24 @@ const FillerFactoryMap & MapContentLoaderComplete::map_fillers() const {
 
 FutureStringPtr MapContentLoaderComplete::promise_file_contents
     (const char * filename)
-{ return m_platform->promise_file_contents(filename); }
+{
+    return make_shared<ContentKeyingFuture>
+        (filename, m_platform->promise_file_contents(filename), m_content_key);
+}
 
-SharedPtr<Texture> MapContentLoaderComplete::make_texture() const
-    { return m_platform->make_texture(); }
+FutureStringPtr MapContentLoaderComplete::promise_file_contents_if_present
+    (const char * filename)
+{
+    return make_shared<ContentKeyingFuture>
+        (filename, m_platform->promise_file_contents_if_present(filename),
+         m_content_key);
+}
+
+SharedPtr<Texture> MapContentLoaderComplete::make_texture() const {
+    auto texture = m_platform->make_texture();
+    m_made_textures.push_back(texture);
+    return texture;
+}
 
 void MapContentLoaderComplete::wait_on
     (const SharedPtr<BackgroundTask> & task)
@@ -104,3 +145,15 @@ TaskContinuation & MapContentLoaderComplete::task_continuation() const {
     if (m_continuation) return *m_continuation;
     throw RuntimeError{"Strategy was not set"};
 }
+
+std::size_t MapContentLoaderComplete::made_texture_bytes() const {
+    static constexpr const std::size_t k_bytes_per_pixel = 4;
+    std::size_t bytes = 0;
+    for (auto & weak_texture : m_made_textures) {
+        auto texture = weak_texture.lock();
+        if (!texture) continue;
+        bytes += std::size_t(texture->width())*std::size_t(texture->height())*
+                 k_bytes_per_pixel;
+    }
+    return bytes;
+}
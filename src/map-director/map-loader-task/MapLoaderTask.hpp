@@ -22,6 +22,8 @@
 
 #include "TiledMapLoader.hpp"
 
+#include "../RegionGeometryCache.hpp"
+
 #include "../map-loader-task.hpp"
 
 class MapContentLoaderComplete final : public MapContentLoader {
@@ -40,6 +42,9 @@ public:
 
     FutureStringPtr promise_file_contents(const char * filename) final;
 
+    FutureStringPtr promise_file_contents_if_present
+        (const char * filename) final;
+
     void add_warning(MapLoadingWarningEnum) final {}
 
     SharedPtr<Texture> make_texture() const final;
@@ -54,16 +59,38 @@ public:
     void assign_filler_map(const FillerFactoryMap & filler_map)
         { m_filler_map = &filler_map; }
 
+    void assign_content_key(const SharedPtr<RegionContentKey> & content_key)
+        { m_content_key = content_key; }
+
+    SharedPtr<RegionContentKey> region_content_key_ptr() const final
+        { return m_content_key; }
+
+    TilesetLoadingPool * tileset_loading_pool() const final
+        { return TilesetLoadingPool::shared(); }
+
+    TilesetCache * tileset_cache() const final
+        { return TilesetCache::shared(); }
+
     SharedPtr<RenderModel> make_render_model() const final
         { return m_platform->make_render_model(); }
 
     TaskContinuation & task_continuation() const final;
 
+    /// @returns key of all file contents promised so far, and of the fillers
+    std::uint64_t region_content_key() const
+        { return m_content_key->value_with_fillers(map_fillers()); }
+
+    /// @returns rough size of the pixels of every texture made, and still
+    ///          held onto
+    std::size_t made_texture_bytes() const;
+
 private:
     PlatformAssetsStrategy * m_platform = nullptr;
+    SharedPtr<RegionContentKey> m_content_key = make_shared<RegionContentKey>();
     ContinuationStrategy * m_strategy = nullptr;
     TaskContinuation * m_continuation = nullptr;
     const FillerFactoryMap * m_filler_map = &MapContentLoader::builtin_fillers();
+    mutable std::vector<WeakPtr<const Texture>> m_made_textures;
 };
 
 // ----------------------------------------------------------------------------
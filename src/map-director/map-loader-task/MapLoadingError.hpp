@@ -27,7 +27,7 @@
 namespace map_loading_messages {
 
 enum WarningEnum {
-    k_non_csv_tile_data,
+    k_unsupported_tile_data_encoding,
     k_tile_layer_has_no_data_element,
     k_invalid_tile_data
 };
@@ -19,6 +19,10 @@
 *****************************************************************************/
 
 #include "TiledMapLoader.hpp"
+#include "tile-layer-decoding.hpp"
+#include "CompiledMap.hpp"
+
+#include "../../Configuration.hpp"
 
 #include <ariajanke/cul/Either.hpp>
 
@@ -30,16 +34,119 @@ namespace {
 
 using MapLoadResult = tiled_map_loading::BaseState::MapLoadResult;
 
-Either<MapLoadingWarningEnum, Grid<int>> load_layer_(const TiXmlElement &);
-
 } // end of <anonymous> namespace
 
 // ----------------------------------------------------------------------------
 
 namespace tiled_map_loading {
 
-BaseState::MapLoadResult
-    FileContentsWaitState::update_progress
+CompiledMapWaitState::CompiledMapWaitState
+    (SharedPtr<const std::string> && compiled_filename_,
+     FutureStringPtr && compiled_contents_,
+     FutureStringPtr && map_contents_):
+    m_compiled_filename(std::move(compiled_filename_)),
+    m_compiled_contents(std::move(compiled_contents_)),
+    m_source_futures{std::move(map_contents_)} {}
+
+MapLoadResult CompiledMapWaitState::update_progress
+    (StateSwitcher & switcher, MapContentLoader & content_loader)
+{
+    if (!m_compiled) {
+        auto retrieved = m_compiled_contents->retrieve();
+        if (retrieved.is_empty()) return {};
+        auto contents = retrieved.require();
+        Optional<CompiledMap> compiled;
+        if (contents.is_right())
+            { compiled = CompiledMap::read(contents.right()); }
+        if (!compiled) {
+            switcher.set_next_state<FileContentsWaitState>
+                (std::move(m_source_futures.front()));
+            return {};
+        }
+        m_compiled = make_shared<CompiledMap>(std::move(*compiled));
+        const auto & filenames = m_compiled->source_filenames();
+        for (auto itr = filenames.begin() + 1; itr != filenames.end(); ++itr) {
+            m_source_futures.emplace_back
+                (content_loader.promise_file_contents(itr->c_str()));
+        }
+    }
+    if (!retrieve_sources()) return {};
+    if (   !m_has_lost_source
+        && m_compiled->is_compiled_from(m_sources_contents))
+    { return load_compiled(switcher, content_loader); }
+    return load_document(switcher);
+}
+
+/* private */ bool CompiledMapWaitState::retrieve_sources() {
+    // every future is waited on, even after one is lost, as the platform may
+    // still be writing into the others
+    while (m_sources_contents.size() != m_source_futures.size()) {
+        auto retrieved = m_source_futures[m_sources_contents.size()]->retrieve();
+        if (retrieved.is_empty()) return false;
+        auto contents = retrieved.require();
+        if (contents.is_left()) {
+            if (m_sources_contents.empty())
+                { m_is_map_lost = true; }
+            m_has_lost_source = true;
+            m_sources_contents.emplace_back();
+            continue;
+        }
+        m_sources_contents.emplace_back(std::move(contents.right()));
+    }
+    return true;
+}
+
+/* private */ MapLoadResult CompiledMapWaitState::load_compiled
+    (StateSwitcher & switcher, MapContentLoader & content_loader)
+{
+    auto document_root = DocumentOwningXmlElement::load_from_contents
+        (std::string{m_compiled->document_contents()});
+    if (!document_root)
+        { return load_document(switcher); }
+    auto load_split = InitialDocumentReadState::split_tileset_load
+        (InitialDocumentReadState::load_future_tilesets
+            (*document_root, content_loader),
+         content_loader);
+    switcher.set_next_state<TileSetLoadState>
+        (std::move(*document_root),
+         m_compiled->take_layers(),
+         std::move(load_split.future_tilesets),
+         std::move(load_split.ready_tilesets));
+    return {};
+}
+
+/* private */ MapLoadResult CompiledMapWaitState::load_document
+    (StateSwitcher & switcher)
+{
+    // stale, so the map's own document is loaded, its contents are always
+    // the first source retrieved
+    if (m_sources_contents.empty() || m_is_map_lost) {
+        return MapLoadResult{MapLoadingError
+            {map_loading_messages::k_tile_map_file_contents_not_retrieved}};
+    }
+    return FileContentsWaitState::load_document
+        (switcher, std::move(m_sources_contents.front()));
+}
+
+// ----------------------------------------------------------------------------
+
+/* static */ MapLoadResult FileContentsWaitState::load_document
+    (StateSwitcher & switcher, std::string && map_contents)
+{
+    return MapLoadingError::failed_load_as_error
+        (DocumentOwningXmlElement::load_from_contents(std::move(map_contents))).
+        fold<MapLoadResult>().
+        map([&] (DocumentOwningXmlElement && root) {
+            switcher.set_next_state<InitialDocumentReadState>(std::move(root));
+            return MapLoadResult{};
+        }).
+        map_left([] (MapLoadingError error) {
+            return MapLoadResult{std::move(error)};
+        }).
+        value();
+}
+
+MapLoadResult FileContentsWaitState::update_progress
     (StateSwitcher & switcher, MapContentLoader &)
 {
     return m_future_contents->retrieve().
@@ -47,20 +154,8 @@ BaseState::MapLoadResult
         return MapLoadingError
             {map_loading_messages::k_tile_map_file_contents_not_retrieved};
     }).
-    chain([&] (std::string && contents) {
-        using namespace map_loading_messages;
-        return MapLoadingError::failed_load_as_error
-            (DocumentOwningXmlElement::load_from_contents(std::move(contents))).
-            fold<MapLoadResult>().
-            map([&] (DocumentOwningXmlElement && root) {
-                switcher.set_next_state<InitialDocumentReadState>(std::move(root));
-                return MapLoadResult{};
-            }).
-            map_left([] (MapLoadingError error) {
-                return MapLoadResult{std::move(error)};
-            }).
-            value();
-    });
+    chain([&] (std::string && contents)
+        { return load_document(switcher, std::move(contents)); });
 }
 
 // ----------------------------------------------------------------------------
@@ -99,7 +194,7 @@ BaseState::MapLoadResult
 {
     std::vector<Grid<int>> layers;
     for (auto & layer_el : XmlRange{document_root, "layer"}) {
-        auto ei = load_layer_(layer_el);
+        auto ei = tile_layer_decoding::decode_layer_element(layer_el);
         if (ei.is_left()) {
             content_loader.add_warning(ei.left());
         } else if (ei.is_right()) {
@@ -304,9 +399,21 @@ void MapLoadStateMachine::initialize_starting_state
     (MapContentLoader & provider, const char * filename)
 {
     auto file_contents_promise = provider.promise_file_contents(filename);
+    if (!k_load_compiled_maps) {
+        m_state_driver.
+            set_current_state<FileContentsWaitState>
+            (std::move(file_contents_promise));
+        return;
+    }
+    auto compiled_filename = make_shared<const std::string>
+        (CompiledMap::compiled_filename_for(filename));
+    auto compiled_contents_promise =
+        provider.promise_file_contents_if_present(compiled_filename->c_str());
     m_state_driver.
-        set_current_state<FileContentsWaitState>
-        (std::move(file_contents_promise));
+        set_current_state<CompiledMapWaitState>
+        (std::move(compiled_filename),
+         std::move(compiled_contents_promise),
+         std::move(file_contents_promise));
 }
 
 MapLoadResult MapLoadStateMachine::
@@ -324,46 +431,3 @@ MapLoadResult MapLoadStateMachine::
 }
 
 } // end of tiled_map_loading namespace
-
-// ----------------------------------------------------------------------------
-
-namespace {
-
-static const auto k_whitespace_trimmer = make_trim_whitespace<const char *>();
-
-Either<MapLoadingWarningEnum, Grid<int>> load_layer_(const TiXmlElement & layer_el) {
-    using namespace map_loading_messages;
-    using namespace cul::either;
-    Grid<int> layer;
-    layer.set_size
-        (layer_el.IntAttribute("width"), layer_el.IntAttribute("height"), 0);
-
-    auto * data = layer_el.FirstChildElement("data");
-    if (!data) {
-        return k_tile_layer_has_no_data_element;
-    } else if (::strcmp(data->Attribute( "encoding" ), "csv")) {
-        return k_non_csv_tile_data;
-    }
-
-    auto data_text = data->GetText();
-    if (!data_text)
-        { return layer; }
-
-    Vector2I r;
-    for (auto value_str : split_range(data_text, data_text + ::strlen(data_text),
-                                      is_comma, k_whitespace_trimmer))
-    {
-        int tile_id = 0;
-        bool entry_is_numeric = cul::string_to_number
-            (value_str.begin(), value_str.end(), tile_id);
-        if (!entry_is_numeric) {
-            return left(k_invalid_tile_data).with<Grid<int>>();
-        }
-        // should warn if not a number
-        layer(r) = tile_id;
-        r = layer.next(r);
-    }
-    return layer;
-}
-
-} // end of <anonymous> namespace
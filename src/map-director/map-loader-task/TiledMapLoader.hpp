@@ -27,6 +27,7 @@
 #include "../MapRegion.hpp"
 
 class TilesetXmlGrid;
+class CompiledMap;
 
 struct MapLoadingSuccess final {
     UniquePtr<MapRegion> loaded_region;
@@ -38,6 +39,7 @@ struct MapLoadingSuccess final {
 namespace tiled_map_loading {
 
 class BaseState;
+class CompiledMapWaitState;
 class FileContentsWaitState;
 class InitialDocumentReadState;
 class TileSetLoadState;
@@ -49,8 +51,8 @@ public:
     using MapLoadResult = OptionalEither<MapLoadingError, MapLoadingSuccess>;
     using StateSwitcher = RestrictedStateSwitcher
         <BaseState,
-         FileContentsWaitState, InitialDocumentReadState, TileSetLoadState,
-         MapElementCollectorState, ExpiredState>;
+         CompiledMapWaitState, FileContentsWaitState, InitialDocumentReadState,
+         TileSetLoadState, MapElementCollectorState, ExpiredState>;
 
     virtual MapLoadResult update_progress
         (StateSwitcher &, MapContentLoader &) = 0;
@@ -58,8 +60,45 @@ public:
     virtual ~BaseState() {}
 };
 
+/// Waits on a compiled map, and then on the files it was compiled from.
+///
+/// The compiled map's layers and document are used only if it was compiled
+/// from those files as they are now. Otherwise, or if there's no compiled
+/// map, the map's own document is loaded as usual.
+class CompiledMapWaitState final : public BaseState {
+public:
+    CompiledMapWaitState
+        (SharedPtr<const std::string> && compiled_filename_,
+         FutureStringPtr && compiled_contents_,
+         FutureStringPtr && map_contents_);
+
+    MapLoadResult update_progress(StateSwitcher &, MapContentLoader &) final;
+
+private:
+    /// @returns true once every source is retrieved or lost
+    bool retrieve_sources();
+
+    MapLoadResult load_compiled(StateSwitcher &, MapContentLoader &);
+
+    MapLoadResult load_document(StateSwitcher &);
+
+    // the platform may only hold onto the name it's given
+    SharedPtr<const std::string> m_compiled_filename;
+    FutureStringPtr m_compiled_contents;
+    SharedPtr<CompiledMap> m_compiled;
+    // the map's first, then each tileset's
+    std::vector<FutureStringPtr> m_source_futures;
+    std::vector<std::string> m_sources_contents;
+    bool m_has_lost_source = false;
+    bool m_is_map_lost = false;
+};
+
 class FileContentsWaitState final : public BaseState {
 public:
+    /// parses the map's document, and moves onto reading it
+    static MapLoadResult load_document
+        (StateSwitcher &, std::string && map_contents);
+
     explicit FileContentsWaitState
         (FutureStringPtr && future_):
         m_future_contents(std::move(future_)) {}
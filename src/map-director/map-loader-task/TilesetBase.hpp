@@ -34,8 +34,11 @@ class StackableSubRegionGrid;
 class TilesetMappingTile;
 class TilesetLayerWrapper;
 class MapContentLoader;
+class RegionContentKey;
 class StackableProducableTileGrid;
 class MapTileset;
+class TilesetCache;
+class TilesetLoadingPool;
 
 class TilesetMapElementCollector {
 public:
@@ -75,6 +78,21 @@ public:
     virtual void wait_on(const SharedPtr<BackgroundTask> &) = 0;
 
     virtual TaskContinuation & task_continuation() const = 0;
+
+    /// @returns key that promised file contents are added to, as they're
+    ///          retrieved (null if contents are not keyed)
+    virtual SharedPtr<RegionContentKey> region_content_key_ptr() const
+        { return nullptr; }
+
+    /// @returns pool tilesets are loaded on (null to load them on the frame
+    ///          thread)
+    virtual TilesetLoadingPool * tileset_loading_pool() const
+        { return nullptr; }
+
+    /// @returns cache tilesets loaded from files are kept in (null to keep
+    ///          none)
+    virtual TilesetCache * tileset_cache() const
+        { return nullptr; }
 };
 
 class TilesetBase {
@@ -96,6 +114,11 @@ public:
     virtual void add_map_elements
         (TilesetMapElementCollector &, const TilesetLayerWrapper & mapping_view) const = 0;
 
+    /// @returns false if what's loaded belongs to the one map it was loaded
+    ///          for, and so must not be shared with other maps (by the
+    ///          tileset cache)
+    virtual bool is_shareable() const { return true; }
+
     Vector2I tile_id_location(int tile_id) const;
 
     int total_tile_count() const;
@@ -0,0 +1,112 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "TilesetCache.hpp"
+
+#include "../RegionGeometryCache.hpp"
+#include "../../Configuration.hpp"
+
+namespace {
+
+WeakPtr<TilesetCache> s_shared_cache;
+
+} // end of <anonymous> namespace
+
+/* static */ SharedPtr<TilesetCache> TilesetCache::make_shared_cache() {
+    if constexpr (k_tileset_cache_megabytes <= 0) {
+        return nullptr;
+    } else {
+        if (auto held = s_shared_cache.lock())
+            { return held; }
+        auto cache = make_shared<TilesetCache>
+            (std::size_t(k_tileset_cache_megabytes)*1024*1024);
+        s_shared_cache = cache;
+        return cache;
+    }
+}
+
+/* static */ TilesetCache * TilesetCache::shared()
+    { return s_shared_cache.lock().get(); }
+
+/* static */ TilesetCache::Key TilesetCache::key_for
+    (const std::string & filename,
+     const std::string & file_contents,
+     const FillerFactoryMap & fillers)
+{
+    RegionContentKey content_key;
+    content_key.add_file(filename, file_contents);
+    Key key;
+    key.content_key = content_key.value_with_fillers(fillers);
+    key.file_size = file_contents.size();
+    return key;
+}
+
+TilesetCache::TilesetCache(std::size_t byte_budget):
+    m_byte_budget(byte_budget) {}
+
+void TilesetCache::add
+    (const Key & key,
+     const SharedPtr<TilesetBase> & tileset,
+     std::size_t loaded_bytes)
+{
+    if (m_byte_budget == 0 || !tileset) return;
+    // a newer load replaces an older one
+    if (auto itr = m_index.find(key.content_key); itr != m_index.end()) {
+        remove(itr->second);
+    }
+    CachedTileset cached;
+    cached.key = key;
+    cached.tileset = tileset;
+    cached.memory_size = key.file_size + loaded_bytes;
+    m_metrics.bytes_held += cached.memory_size;
+    m_tilesets.push_front(std::move(cached));
+    m_index[key.content_key] = m_tilesets.begin();
+    evict_over_budget();
+}
+
+SharedPtr<TilesetBase> TilesetCache::find(const Key & key) {
+    auto itr = m_index.find(key.content_key);
+    if (itr == m_index.end()) {
+        ++m_metrics.misses;
+        return nullptr;
+    }
+    ++m_metrics.hits;
+    m_tilesets.splice(m_tilesets.begin(), m_tilesets, itr->second);
+    return itr->second->tileset;
+}
+
+/* private */ TilesetCache::TilesetList::iterator
+    TilesetCache::remove(TilesetList::iterator itr)
+{
+    m_metrics.bytes_held -= itr->memory_size;
+    m_index.erase(itr->key.content_key);
+    return m_tilesets.erase(itr);
+}
+
+/* private */ void TilesetCache::evict_over_budget() {
+    // tilesets in use are skipped, dropping them would not free anything
+    auto itr = m_tilesets.end();
+    while (itr != m_tilesets.begin() && m_metrics.bytes_held > m_byte_budget) {
+        --itr;
+        if (itr->is_in_use()) continue;
+        itr = remove(itr);
+        ++m_metrics.evictions;
+    }
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "TilesetBase.hpp"
+
+#include <list>
+#include <map>
+
+/// Keeps tilesets loaded from files, so that maps (and sub maps) sharing a
+/// tileset file only load it once.
+///
+/// Tilesets are found by their file's name and contents, and the names of the
+/// fillers they're loaded with, so a changed file is loaded again. Tilesets
+/// still used by a map are always kept, of the rest the least recently used
+/// are dropped first, once the memory budget is exceeded.
+///
+/// The shared cache is held by the map director, so that its textures and
+/// render models are dropped along with the rest of the game, while the
+/// platform is still around.
+class TilesetCache final {
+public:
+    using FillerFactoryMap = MapContentLoader::FillerFactoryMap;
+
+    struct Key final {
+        /// of the file's name and contents, and the fillers' names
+        std::uint64_t content_key = 0;
+        std::size_t file_size = 0;
+    };
+
+    struct Metrics final {
+        int hits = 0;
+        int misses = 0;
+        int evictions = 0;
+        std::size_t bytes_held = 0;
+    };
+
+    /// @returns cache shared by all map loads, for as long as it's held (null
+    ///          if there's no budget for any tilesets)
+    static SharedPtr<TilesetCache> make_shared_cache();
+
+    /// @returns cache shared by all map loads (frame thread only), or null if
+    ///          none is held
+    static TilesetCache * shared();
+
+    static Key key_for
+        (const std::string & filename,
+         const std::string & file_contents,
+         const FillerFactoryMap & fillers);
+
+    /// keeps nothing
+    TilesetCache() {}
+
+    explicit TilesetCache(std::size_t byte_budget);
+
+    /// @param loaded_bytes rough estimate of what the tileset has loaded, apart
+    ///        from its file (like its textures and render models)
+    void add
+        (const Key &,
+         const SharedPtr<TilesetBase> &,
+         std::size_t loaded_bytes = 0);
+
+    /// @returns tileset loaded from the same file, with the same fillers
+    ///          (null counting a miss)
+    SharedPtr<TilesetBase> find(const Key &);
+
+    std::size_t size() const noexcept { return m_tilesets.size(); }
+
+    const Metrics & metrics() const noexcept { return m_metrics; }
+
+private:
+    struct CachedTileset final {
+        Key key;
+        SharedPtr<TilesetBase> tileset;
+        std::size_t memory_size = 0;
+
+        bool is_in_use() const noexcept { return tileset.use_count() > 1; }
+    };
+
+    using TilesetList = std::list<CachedTileset>;
+
+    TilesetList::iterator remove(TilesetList::iterator);
+
+    void evict_over_budget();
+
+    // most recently used at the front
+    TilesetList m_tilesets;
+    std::map<std::uint64_t, TilesetList::iterator> m_index;
+    std::size_t m_byte_budget = 0;
+    Metrics m_metrics;
+};
@@ -23,21 +23,216 @@
 
 #include "TilesetBase.hpp"
 
+#include "../MapRegionChangesTask.hpp"
+#include "../../Configuration.hpp"
+#include "../../Texture.hpp"
+
 #include <ariajanke/cul/Either.hpp>
 
+#include <atomic>
+#include <exception>
 
 namespace {
 
 using Continuation = BackgroundTask::Continuation;
+using FillerFactoryMap = MapContentLoader::FillerFactoryMap;
+
+/// A texture made while loading a tileset on a worker, before there's a
+/// platform to make a real one with.
+///
+/// Files are decoded right away, where the platform is able to do so off of
+/// the frame thread. Whatever it's loaded from is held onto, until uploaded
+/// on the frame thread. Once uploaded, it binds as the platform's texture.
+class PreparedTexture final : public Texture {
+public:
+    /// @param decoder platform used only to decode image files
+    explicit PreparedTexture(const PlatformAssetsStrategy & decoder):
+        m_decoder(&decoder) {}
+
+    /// @throws if loaded from a file, which the platform can't load
+    void upload(PlatformAssetsStrategy &);
+
+    bool load_from_file_no_throw(const char * filename) noexcept final;
+
+    void load_from_memory
+        (int width_, int height_, const void * rgba_pixels) final;
+
+    int width() const final
+        { return m_uploaded ? m_uploaded->width() : m_width; }
+
+    int height() const final
+        { return m_uploaded ? m_uploaded->height() : m_height; }
+
+    void bind_texture() const final
+        { if (m_uploaded) m_uploaded->bind_texture(); }
+
+    /// @returns rough size of the uploaded texture's pixels
+    std::size_t uploaded_bytes() const noexcept
+        { return std::size_t(width())*std::size_t(height())*4; }
+
+private:
+    const PlatformAssetsStrategy * m_decoder = nullptr;
+    std::string m_filename;
+    std::vector<unsigned char> m_rgba_pixels;
+    int m_width = 0;
+    int m_height = 0;
+    SharedPtr<Texture> m_uploaded;
+};
+
+// ----------------------------------------------------------------------------
+
+class WaitingContinuation final : public Continuation {
+public:
+    Continuation & wait_on(const SharedPtr<BackgroundTask> & task) final {
+        waited_on_tasks.push_back(task);
+        return *this;
+    }
+
+    std::vector<SharedPtr<BackgroundTask>> waited_on_tasks;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Content loader for loading a tileset on a worker; nothing is handed to the
+/// platform, only prepared.
+class TilesetPreparingLoader final : public MapContentLoader {
+public:
+    TilesetPreparingLoader
+        (const FillerFactoryMap & filler_map,
+         const SharedPtr<RegionContentKey> & content_key,
+         const PlatformAssetsStrategy & image_decoder):
+        m_filler_map(&filler_map),
+        m_content_key(content_key),
+        m_image_decoder(&image_decoder) {}
+
+    SharedPtr<Texture> make_texture() const final;
+
+    SharedPtr<RenderModel> make_render_model() const final;
+
+    /// @throws RuntimeError as the platform may only be used from the frame
+    ///         thread
+    FutureStringPtr promise_file_contents(const char *) final;
+
+    const FillerFactoryMap & map_fillers() const final
+        { return *m_filler_map; }
+
+    bool delay_required() const final { return false; }
+
+    void add_warning(MapLoadingWarningEnum) final {}
+
+    void wait_on(const SharedPtr<BackgroundTask> & task) final
+        { (void)m_continuation.wait_on(task); }
+
+    TaskContinuation & task_continuation() const final
+        { return m_continuation; }
+
+    SharedPtr<RegionContentKey> region_content_key_ptr() const final
+        { return m_content_key; }
+
+    std::vector<SharedPtr<PreparedTexture>> finish_preparing_textures()
+        { return std::move(m_textures); }
+
+    std::vector<SharedPtr<PreparedRenderModel>> finish_preparing_render_models()
+        { return std::move(m_render_models); }
+
+    std::vector<SharedPtr<BackgroundTask>> finish_waiting_on_tasks()
+        { return std::move(m_continuation.waited_on_tasks); }
+
+private:
+    const FillerFactoryMap * m_filler_map = nullptr;
+    SharedPtr<RegionContentKey> m_content_key;
+    const PlatformAssetsStrategy * m_image_decoder = nullptr;
+    mutable WaitingContinuation m_continuation;
+    mutable std::vector<SharedPtr<PreparedTexture>> m_textures;
+    mutable std::vector<SharedPtr<PreparedRenderModel>> m_render_models;
+};
 
 } // end of <anonymous> namespace
 
+/// What a worker loads, for the frame thread to finish.
+class TilesetLoadingTask::TilesetPreparation final {
+public:
+    bool is_finished() const noexcept
+        { return m_is_finished.load(std::memory_order_acquire); }
+
+    /// worker only
+    void prepare
+        (Optional<std::string> && file_contents,
+         UnloadedTileSet && unloaded,
+         const FillerFactoryMap &,
+         const SharedPtr<RegionContentKey> &,
+         const PlatformAssetsStrategy & image_decoder) noexcept;
+
+    std::exception_ptr error;
+    Optional<MapLoadingError> loading_error;
+    SharedPtr<TilesetBase> tile_set;
+    std::vector<SharedPtr<PreparedTexture>> textures;
+    std::vector<SharedPtr<PreparedRenderModel>> render_models;
+    std::vector<SharedPtr<BackgroundTask>> waited_on_tasks;
+
+private:
+    std::atomic_bool m_is_finished{false};
+};
+
+// ----------------------------------------------------------------------------
+
+/* static */ TilesetLoadingPool * TilesetLoadingPool::shared() {
+    if constexpr (k_tileset_loading_thread_count <= 0) {
+        return nullptr;
+    } else {
+        static TilesetLoadingPool s_pool{k_tileset_loading_thread_count};
+        return &s_pool;
+    }
+}
+
+TilesetLoadingPool::TilesetLoadingPool(int thread_count) {
+    for (int i = 0; i < thread_count; ++i)
+        { m_workers.emplace_back([this] { run_worker(); }); }
+}
+
+TilesetLoadingPool::~TilesetLoadingPool() {
+    {
+    std::unique_lock lock{m_mutex};
+    m_stopping = true;
+    m_jobs.clear();
+    }
+    m_job_pushed.notify_all();
+    for (auto & worker : m_workers)
+        { worker.join(); }
+}
+
+void TilesetLoadingPool::push(Job && job) {
+    {
+    std::unique_lock lock{m_mutex};
+    m_jobs.emplace_back(std::move(job));
+    }
+    m_job_pushed.notify_one();
+}
+
+/* private */ void TilesetLoadingPool::run_worker() {
+    while (true) {
+        Job job;
+        {
+        std::unique_lock lock{m_mutex};
+        m_job_pushed.wait
+            (lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if (m_stopping) return;
+        job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
 /* static */ TilesetLoadingTask TilesetLoadingTask::begin_loading
     (const char * filename, MapContentLoader & content_provider)
 {
     return TilesetLoadingTask
-        {content_provider.promise_file_contents(filename),
-         content_provider.map_fillers()};
+        {filename,
+         content_provider.promise_file_contents(filename),
+         content_provider};
 }
 
 /* static */ TilesetLoadingTask TilesetLoadingTask::begin_loading
@@ -47,7 +242,7 @@ using Continuation = BackgroundTask::Continuation;
     const auto & el = tileset_xml.element();
     return TilesetLoadingTask
         {UnloadedTileSet{TilesetBase::make(el), std::move(tileset_xml)},
-         content_provider.map_fillers()};
+         content_provider};
 }
 
 Continuation & TilesetLoadingTask::in_background
@@ -55,22 +250,41 @@ Continuation & TilesetLoadingTask::in_background
 {
     if (m_loaded_tile_set || m_loading_error) {
         return strategy.finish_task();
-    } else if (m_unloaded.tile_set) {
+    } else if (m_preparation) {
+        return finish_preparing(callbacks, strategy);
+    } else if (!m_unloaded.tile_set) {
+        auto file_contents = retrieve_file_contents();
+        if (!file_contents) {
+            return strategy.continue_();
+        } else if (find_cached(*file_contents)) {
+            return strategy.finish_task();
+        } else if (m_loading_pool) {
+            begin_preparing(std::move(file_contents), callbacks.platform());
+        } else {
+            auto unloaded = unloaded_from_contents(std::move(*file_contents));
+            auto ei = unloaded.require();
+            if (ei.is_left()) {
+                m_loading_error = ei.left();
+            } else {
+                m_unloaded = std::move(ei.right());
+            }
+        }
+    } else if (m_loading_pool) {
+        begin_preparing({}, callbacks.platform());
+    } else {
         MapContentLoaderComplete content_loader;
         content_loader.assign_assets_strategy(callbacks.platform());
         content_loader.assign_continuation_strategy(strategy);
         content_loader.assign_filler_map(*m_filler_factory_map);
+        if (m_content_key)
+            { content_loader.assign_content_key(m_content_key); }
         auto & res = m_unloaded.tile_set->load
             (m_unloaded.xml_content, content_loader);
         m_loaded_tile_set = std::move(m_unloaded.tile_set);
         m_unloaded = UnloadedTileSet{};
+        // render models go unweighed, textures are most of a tileset
+        add_to_cache(content_loader.made_texture_bytes());
         return res;
-    } else {
-        auto ei = get_unloaded(m_tile_set_content).
-            map_left([](MapLoadingError && error)
-                     { return Optional<MapLoadingError>{std::move(error)}; });
-        m_loading_error = ei.left_or(Optional<MapLoadingError>{});
-        m_unloaded = ei.right_or(UnloadedTileSet{});
     }
     return strategy.continue_();
 }
@@ -85,17 +299,11 @@ OptionalEither<MapLoadingError, SharedPtr<TilesetBase>>
 
 /* private static */
     OptionalEither<MapLoadingError, TilesetLoadingTask::UnloadedTileSet>
-    TilesetLoadingTask::get_unloaded
-    (FutureStringPtr & tile_set_content)
+    TilesetLoadingTask::unloaded_from_contents(std::string && file_contents)
 {
     static constexpr const auto k_not_retrieved =
         map_loading_messages::k_tile_map_file_contents_not_retrieved;
-    using FutureLost = Future<std::string>::Lost;
-    return tile_set_content->retrieve().
-        map_left([] (FutureLost &&) {
-            return MapLoadingError{k_not_retrieved};
-        }).
-        chain(optionally_load_root).
+    return optionally_load_root(std::move(file_contents)).
         chain([]
             (DocumentOwningXmlElement && node) ->
                 OptionalEither<MapLoadingError, UnloadedTileSet>
@@ -114,3 +322,189 @@ OptionalEither<MapLoadingError, SharedPtr<TilesetBase>>
     if (ei.is_left()) return ei.left();
     return ei.right();
 }
+
+/* private */ Optional<std::string>
+    TilesetLoadingTask::retrieve_file_contents()
+{
+    auto retrieved = m_tile_set_content->retrieve();
+    if (retrieved.is_empty()) return {};
+    auto contents = retrieved.require();
+    if (contents.is_left()) {
+        m_loading_error = MapLoadingError
+            {map_loading_messages::k_tile_map_file_contents_not_retrieved};
+        return {};
+    }
+    return std::move(contents.right());
+}
+
+/* private */ bool TilesetLoadingTask::find_cached
+    (const std::string & file_contents)
+{
+    if (!m_tileset_cache) return false;
+    m_cache_key = TilesetCache::key_for
+        (m_filename, file_contents, *m_filler_factory_map);
+    m_loaded_tile_set = m_tileset_cache->find(*m_cache_key);
+    return !!m_loaded_tile_set;
+}
+
+/* private */ void TilesetLoadingTask::add_to_cache(std::size_t loaded_bytes) {
+    if (!m_tileset_cache || !m_cache_key) return;
+    if (!m_loaded_tile_set->is_shareable()) return;
+    m_tileset_cache->add(*m_cache_key, m_loaded_tile_set, loaded_bytes);
+}
+
+/* private */ void TilesetLoadingTask::begin_preparing
+    (Optional<std::string> && file_contents,
+     const PlatformAssetsStrategy & image_decoder)
+{
+    m_preparation = make_shared<TilesetPreparation>();
+    // the platform outlives every task, and so every job
+    m_loading_pool->push(
+        [preparation = m_preparation,
+         file_contents = std::move(file_contents),
+         unloaded = std::move(m_unloaded),
+         filler_map = *m_filler_factory_map,
+         content_key = m_content_key,
+         image_decoder = &image_decoder] () mutable
+    {
+        preparation->prepare
+            (std::move(file_contents), std::move(unloaded), filler_map,
+             content_key, *image_decoder);
+    });
+    m_unloaded = UnloadedTileSet{};
+}
+
+/* private */ Continuation & TilesetLoadingTask::finish_preparing
+    (Callbacks & callbacks, ContinuationStrategy & strategy)
+{
+    if (!m_preparation->is_finished())
+        { return strategy.continue_(); }
+    auto preparation = std::move(m_preparation);
+    if (preparation->error)
+        { std::rethrow_exception(preparation->error); }
+    if (preparation->loading_error) {
+        m_loading_error = std::move(preparation->loading_error);
+        return strategy.finish_task();
+    }
+    std::size_t loaded_bytes = 0;
+    for (auto & texture : preparation->textures) {
+        texture->upload(callbacks.platform());
+        loaded_bytes += texture->uploaded_bytes();
+    }
+    for (auto & render_model : preparation->render_models) {
+        render_model->upload(callbacks.platform());
+        loaded_bytes += render_model->uploaded_bytes();
+    }
+    m_loaded_tile_set = std::move(preparation->tile_set);
+    add_to_cache(loaded_bytes);
+
+    if (preparation->waited_on_tasks.empty())
+        { return strategy.finish_task(); }
+    auto * continuation = &strategy.continue_();
+    for (auto & task : preparation->waited_on_tasks)
+        { continuation = &continuation->wait_on(task); }
+    return *continuation;
+}
+
+// ----------------------------------------------------------------------------
+
+void TilesetLoadingTask::TilesetPreparation::prepare
+    (Optional<std::string> && file_contents,
+     UnloadedTileSet && unloaded,
+     const FillerFactoryMap & filler_map,
+     const SharedPtr<RegionContentKey> & content_key,
+     const PlatformAssetsStrategy & image_decoder) noexcept
+{
+    try {
+        if (file_contents) {
+            auto unloaded_from_file =
+                unloaded_from_contents(std::move(*file_contents));
+            auto res = unloaded_from_file.require();
+            if (res.is_left()) {
+                loading_error = res.left();
+            } else {
+                unloaded = std::move(res.right());
+            }
+        }
+        if (unloaded.tile_set) {
+            TilesetPreparingLoader content_loader
+                {filler_map, content_key, image_decoder};
+            (void)unloaded.tile_set->load(unloaded.xml_content, content_loader);
+            tile_set = std::move(unloaded.tile_set);
+            textures = content_loader.finish_preparing_textures();
+            render_models = content_loader.finish_preparing_render_models();
+            waited_on_tasks = content_loader.finish_waiting_on_tasks();
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    m_is_finished.store(true, std::memory_order_release);
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+void PreparedTexture::upload(PlatformAssetsStrategy & platform) {
+    auto texture = platform.make_texture();
+    if (!m_filename.empty()) {
+        texture->load_from_file(m_filename.c_str());
+    } else if (!m_rgba_pixels.empty()) {
+        texture->load_from_memory(m_width, m_height, m_rgba_pixels.data());
+    }
+    m_uploaded = std::move(texture);
+    m_filename.clear();
+    m_rgba_pixels = std::vector<unsigned char>{};
+}
+
+bool PreparedTexture::load_from_file_no_throw(const char * filename) noexcept {
+    try {
+        if (auto image = m_decoder->decode_image_file(filename)) {
+            m_rgba_pixels = std::move(image->rgba_pixels);
+            m_width = image->width;
+            m_height = image->height;
+            m_filename.clear();
+            return true;
+        }
+        // left for the platform to load, on the frame thread
+        m_filename = filename;
+        m_rgba_pixels.clear();
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+void PreparedTexture::load_from_memory
+    (int width_, int height_, const void * rgba_pixels)
+{
+    static constexpr const std::size_t k_bytes_per_pixel = 4;
+    const auto * beg = static_cast<const unsigned char *>(rgba_pixels);
+    m_rgba_pixels.assign
+        (beg, beg + std::size_t(width_)*std::size_t(height_)*k_bytes_per_pixel);
+    m_width = width_;
+    m_height = height_;
+    m_filename.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+SharedPtr<Texture> TilesetPreparingLoader::make_texture() const {
+    auto texture = make_shared<PreparedTexture>(*m_image_decoder);
+    m_textures.push_back(texture);
+    return texture;
+}
+
+SharedPtr<RenderModel> TilesetPreparingLoader::make_render_model() const {
+    auto render_model = make_shared<PreparedRenderModel>();
+    m_render_models.push_back(render_model);
+    return render_model;
+}
+
+FutureStringPtr TilesetPreparingLoader::promise_file_contents(const char *) {
+    throw RuntimeError
+        {"TilesetPreparingLoader::promise_file_contents: tilesets loaded on "
+         "a worker may not promise file contents"};
+}
+
+} // end of <anonymous> namespace
@@ -24,10 +24,57 @@
 
 #include "MapLoadingError.hpp"
 #include "TilesetBase.hpp"
+#include "TilesetCache.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 class MapContentLoader;
 class TilesetBase;
 
+/// Worker threads which tilesets are loaded on, shared by all map loads.
+///
+/// Tileset files are parsed, and their tiles made, on workers. Only uploading
+/// their textures and render models is left to the frame thread.
+class TilesetLoadingPool final {
+public:
+    using Job = std::function<void()>;
+
+    /// @returns pool shared by all map loads, or null if there are no
+    ///          threads to load tilesets on
+    static TilesetLoadingPool * shared();
+
+    explicit TilesetLoadingPool(int thread_count);
+
+    TilesetLoadingPool(const TilesetLoadingPool &) = delete;
+
+    TilesetLoadingPool(TilesetLoadingPool &&) = delete;
+
+    /// jobs not yet started are dropped
+    ~TilesetLoadingPool();
+
+    TilesetLoadingPool & operator = (const TilesetLoadingPool &) = delete;
+
+    TilesetLoadingPool & operator = (TilesetLoadingPool &&) = delete;
+
+    /// @param job must not throw
+    void push(Job && job);
+
+private:
+    void run_worker();
+
+    std::mutex m_mutex;
+    std::condition_variable m_job_pushed;
+    std::deque<Job> m_jobs;
+    bool m_stopping = false;
+    std::vector<std::thread> m_workers;
+};
+
+// ----------------------------------------------------------------------------
+
 class TilesetProvider {
 public:
     virtual ~TilesetProvider() {}
@@ -38,6 +85,11 @@ public:
 
 // ----------------------------------------------------------------------------
 
+/// Loads a tileset, on a worker thread if the content loader given has a pool
+/// to load on, otherwise a step at a time on the frame thread.
+///
+/// Tilesets from files are looked for in the content loader's tileset cache
+/// (if it has one) before they're loaded, and added to it after.
 class TilesetLoadingTask final :
     public BackgroundTask, public TilesetProvider
 {
@@ -56,6 +108,8 @@ public:
 
 private:
     using FillerFactoryMap = MapContentLoader::FillerFactoryMap;
+    class TilesetPreparation;
+
     struct UnloadedTileSet final {
         UnloadedTileSet() {}
 
@@ -70,19 +124,44 @@ private:
     };
 
     TilesetLoadingTask
-        (FutureStringPtr && content_,
-         const FillerFactoryMap & filler_map):
+        (const char * filename,
+         FutureStringPtr && content_,
+         const MapContentLoader & content_provider):
         m_tile_set_content(std::move(content_)),
-        m_filler_factory_map(&filler_map) {}
+        m_filler_factory_map(&content_provider.map_fillers()),
+        m_content_key(content_provider.region_content_key_ptr()),
+        m_loading_pool(content_provider.tileset_loading_pool()),
+        m_filename(filename),
+        m_tileset_cache(content_provider.tileset_cache()) {}
 
     TilesetLoadingTask
         (UnloadedTileSet && unloaded_ts_,
-         const FillerFactoryMap & filler_map):
+         const MapContentLoader & content_provider):
         m_unloaded(std::move(unloaded_ts_)),
-        m_filler_factory_map(&filler_map) {}
+        m_filler_factory_map(&content_provider.map_fillers()),
+        m_content_key(content_provider.region_content_key_ptr()),
+        m_loading_pool(content_provider.tileset_loading_pool()) {}
+
+    static OptionalEither<MapLoadingError, UnloadedTileSet>
+        unloaded_from_contents(std::string && file_contents);
+
+    /// @returns file contents if retrieved, if lost sets the loading error
+    Optional<std::string> retrieve_file_contents();
+
+    /// @returns true if a tileset loaded from the same file is found in the
+    ///          cache, in which case it's taken as the loaded tileset
+    bool find_cached(const std::string & file_contents);
+
+    void add_to_cache(std::size_t loaded_bytes);
+
+    /// parses (if given contents) and loads on a worker, images are decoded
+    /// there too if the platform is able
+    void begin_preparing
+        (Optional<std::string> && file_contents,
+         const PlatformAssetsStrategy &);
 
-    static OptionalEither<MapLoadingError, UnloadedTileSet> get_unloaded
-        (FutureStringPtr & tile_set_content);
+    /// uploads what was prepared, once the worker is finished
+    Continuation & finish_preparing(Callbacks &, ContinuationStrategy &);
 
     static OptionalEither<MapLoadingError, DocumentOwningXmlElement>
         optionally_load_root(std::string && file_contents);
@@ -92,6 +171,14 @@ private:
     FutureStringPtr m_tile_set_content;
     Optional<MapLoadingError> m_loading_error;
     const FillerFactoryMap * m_filler_factory_map = nullptr;
+    // file contents loaded by the tileset are keyed along with the map's
+    SharedPtr<RegionContentKey> m_content_key;
+    TilesetLoadingPool * m_loading_pool = nullptr;
+    SharedPtr<TilesetPreparation> m_preparation;
+    std::string m_filename;
+    TilesetCache * m_tileset_cache = nullptr;
+    // set once file contents are retrieved
+    Optional<TilesetCache::Key> m_cache_key;
 };
 
 // ----------------------------------------------------------------------------
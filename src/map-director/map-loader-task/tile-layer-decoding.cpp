@@ -0,0 +1,669 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "tile-layer-decoding.hpp"
+
+#include <ariajanke/cul/Either.hpp>
+
+#include <tinyxml2.h>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+using namespace map_loading_messages;
+using Bytes = tile_layer_decoding::Bytes;
+using WarningOpt = Optional<MapLoadingWarningEnum>;
+
+constexpr const std::size_t k_bytes_per_tile_id = 4;
+
+bool is_whitespace(char c)
+    { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+const char * skip_whitespace(const char * itr, const char * end) {
+    while (itr != end && is_whitespace(*itr)) ++itr;
+    return itr;
+}
+
+/// writes tile ids to a layer, in its "next" order
+class TileIdWriter final {
+public:
+    explicit TileIdWriter(Grid<int> & layer):
+        m_layer(layer) {}
+
+    /// @returns false if the id is out of range, or the layer is full
+    bool write(std::uint32_t tile_id) {
+        if (tile_id > std::uint32_t(INT_MAX) || is_full()) return false;
+        m_layer(m_position) = int(tile_id);
+        m_position = m_layer.next(m_position);
+        return true;
+    }
+
+    bool is_full() const
+        { return m_position == m_layer.end_position(); }
+
+private:
+    Grid<int> & m_layer;
+    Vector2I m_position;
+};
+
+/// calls a function with each decoded byte, whitespace is skipped
+///
+/// @returns false if not base64
+template <typename OnByteFunc>
+bool for_each_base64_byte(const char * beg, const char * end, OnByteFunc && f);
+
+WarningOpt read_tile_ids(const Bytes &, Grid<int> & layer);
+
+// ------------------------------- <inflating> --------------------------------
+
+class BitReader final {
+public:
+    BitReader(const std::uint8_t * beg, const std::uint8_t * end):
+        m_position(beg), m_end(end) {}
+
+    /// @returns false if there are fewer bits left
+    bool read(int bit_count, unsigned & bits);
+
+    /// drops bits to the next byte
+    void align_to_byte() {
+        m_bit_buffer = 0;
+        m_bit_count = 0;
+    }
+
+    const std::uint8_t * position() const noexcept { return m_position; }
+
+    void skip_bytes(std::size_t count) { m_position += count; }
+
+    std::size_t remaining_bytes() const noexcept
+        { return std::size_t(m_end - m_position); }
+
+private:
+    const std::uint8_t * m_position;
+    const std::uint8_t * m_end;
+    std::uint32_t m_bit_buffer = 0;
+    int m_bit_count = 0;
+};
+
+/// canonical Huffman code, decoded one bit at a time
+class HuffmanCode final {
+public:
+    static constexpr const int k_max_bits = 15;
+
+    /// @returns false if the code is over subscribed, or incomplete (unless
+    ///          allowed, as for a single distance code)
+    bool set_lengths(const std::uint8_t * lengths, int count, bool allow_incomplete);
+
+    /// @returns symbol, or -1 if no code matches
+    int decode(BitReader &) const;
+
+private:
+    std::array<std::uint16_t, k_max_bits + 1> m_counts;
+    std::array<std::uint16_t, 288> m_symbols;
+};
+
+/// inflates a raw deflate stream
+///
+/// @returns false if not valid, or inflating more than max_size
+bool inflate(BitReader &, std::size_t max_size, Bytes & out);
+
+std::uint32_t adler32(const Bytes &);
+
+std::uint32_t crc32(const Bytes &);
+
+std::uint32_t read_big_endian_32(const std::uint8_t *);
+
+std::uint32_t read_little_endian_32(const std::uint8_t *);
+
+// ------------------------------- </inflating> -------------------------------
+
+} // end of <anonymous> namespace
+
+namespace tile_layer_decoding {
+
+Either<MapLoadingWarningEnum, Grid<int>> decode_layer_element
+    (const TiXmlElement & layer_element)
+{
+    using namespace map_loading_messages;
+    Grid<int> layer;
+    layer.set_size
+        (layer_element.IntAttribute("width"),
+         layer_element.IntAttribute("height"), 0);
+
+    auto * data = layer_element.FirstChildElement("data");
+    if (!data)
+        { return k_tile_layer_has_no_data_element; }
+    auto warning = decode_data_element(*data, layer);
+    if (warning)
+        { return *warning; }
+    return layer;
+}
+
+Optional<MapLoadingWarningEnum> decode_data_element
+    (const TiXmlElement & data_element, Grid<int> & layer)
+{
+    auto encoding = data_element.Attribute("encoding");
+    auto compression = data_element.Attribute("compression");
+    auto text = data_element.GetText();
+    auto text_end = text ? text + ::strlen(text) : nullptr;
+    // tiles as elements, one for each, are not supported
+    if (!encoding)
+        { return k_unsupported_tile_data_encoding; }
+    if (::strcmp(encoding, "csv") == 0) {
+        if (compression)
+            { return k_unsupported_tile_data_encoding; }
+        return text ? decode_csv(text, text_end, layer) : WarningOpt{};
+    }
+    if (::strcmp(encoding, "base64") == 0) {
+        if (!text) return k_invalid_tile_data;
+        return decode_base64(text, text_end, compression, layer);
+    }
+    return k_unsupported_tile_data_encoding;
+}
+
+Optional<MapLoadingWarningEnum> decode_csv
+    (const char * beg, const char * end, Grid<int> & layer)
+{
+    static constexpr std::uint32_t k_max_before_digit = std::uint32_t(INT_MAX) / 10;
+    TileIdWriter writer{layer};
+    auto itr = skip_whitespace(beg, end);
+    while (itr != end) {
+        std::uint32_t tile_id = 0;
+        auto digits_beg = itr;
+        for (; itr != end; ++itr) {
+            unsigned digit = unsigned(*itr) - unsigned('0');
+            if (digit > 9) break;
+            // even if this stays in range, the writer rejects it
+            if (tile_id > k_max_before_digit)
+                { return k_invalid_tile_data; }
+            tile_id = tile_id*10 + digit;
+        }
+        if (itr == digits_beg || !writer.write(tile_id))
+            { return k_invalid_tile_data; }
+
+        itr = skip_whitespace(itr, end);
+        if (itr == end) break;
+        if (*itr != ',')
+            { return k_invalid_tile_data; }
+        itr = skip_whitespace(itr + 1, end);
+        // a trailing comma is an empty entry
+        if (itr == end)
+            { return k_invalid_tile_data; }
+    }
+    return {};
+}
+
+Optional<MapLoadingWarningEnum> decode_base64
+    (const char * beg, const char * end, const char * compression,
+     Grid<int> & layer)
+{
+    auto expected_size =
+        std::size_t(layer.width())*std::size_t(layer.height())*k_bytes_per_tile_id;
+    if (!compression || *compression == '\0') {
+        // straight into the layer, four bytes at a time
+        TileIdWriter writer{layer};
+        std::uint32_t tile_id = 0;
+        std::size_t byte_count = 0;
+        bool ids_are_valid = true;
+        bool is_base64 = for_each_base64_byte(beg, end,
+            [&] (std::uint8_t byte)
+        {
+            auto byte_of_id = byte_count++ % k_bytes_per_tile_id;
+            tile_id |= std::uint32_t(byte) << (byte_of_id*8);
+            if (byte_of_id + 1 != k_bytes_per_tile_id) return;
+            ids_are_valid = ids_are_valid && writer.write(tile_id);
+            tile_id = 0;
+        });
+        if (!is_base64 || !ids_are_valid || byte_count != expected_size)
+            { return k_invalid_tile_data; }
+        return {};
+    }
+
+    auto inflate_with = [compression] () -> Optional<Bytes> (*)(const Bytes &, std::size_t) {
+        if (::strcmp(compression, "zlib") == 0) return inflate_zlib;
+        if (::strcmp(compression, "gzip") == 0) return inflate_gzip;
+        return nullptr;
+    } ();
+    if (!inflate_with)
+        { return k_unsupported_tile_data_encoding; }
+    auto stream = base64_to_bytes(beg, end);
+    if (!stream)
+        { return k_invalid_tile_data; }
+    auto tile_bytes = inflate_with(*stream, expected_size);
+    if (!tile_bytes || tile_bytes->size() != expected_size)
+        { return k_invalid_tile_data; }
+    return read_tile_ids(*tile_bytes, layer);
+}
+
+Optional<Bytes> base64_to_bytes(const char * beg, const char * end) {
+    Bytes bytes;
+    bytes.reserve(std::size_t(end - beg) / 4 * 3);
+    bool is_base64 = for_each_base64_byte
+        (beg, end, [&bytes] (std::uint8_t byte) { bytes.push_back(byte); });
+    if (!is_base64) return {};
+    return bytes;
+}
+
+Optional<Bytes> inflate_zlib(const Bytes & stream, std::size_t max_size) {
+    static constexpr std::size_t k_header_size = 2;
+    static constexpr std::size_t k_trailer_size = 4;
+    static constexpr unsigned k_deflate_method = 8;
+    static constexpr unsigned k_preset_dictionary_flag = 0x20;
+    if (stream.size() < k_header_size + k_trailer_size) return {};
+    unsigned method_and_info = stream[0];
+    unsigned flags = stream[1];
+    if (   (method_and_info & 0xF) != k_deflate_method
+        || (method_and_info*256 + flags) % 31 != 0
+        || (flags & k_preset_dictionary_flag))
+    { return {}; }
+
+    BitReader reader{stream.data() + k_header_size, stream.data() + stream.size()};
+    Bytes out;
+    if (!inflate(reader, max_size, out)) return {};
+    if (reader.remaining_bytes() < k_trailer_size) return {};
+    if (read_big_endian_32(reader.position()) != adler32(out)) return {};
+    return out;
+}
+
+Optional<Bytes> inflate_gzip(const Bytes & stream, std::size_t max_size) {
+    static constexpr std::size_t k_header_size = 10;
+    static constexpr std::size_t k_trailer_size = 8;
+    static constexpr unsigned k_header_crc_flag = 0x02;
+    static constexpr unsigned k_extra_flag      = 0x04;
+    static constexpr unsigned k_name_flag       = 0x08;
+    static constexpr unsigned k_comment_flag    = 0x10;
+    if (   stream.size() < k_header_size + k_trailer_size
+        || stream[0] != 0x1F || stream[1] != 0x8B || stream[2] != 8)
+    { return {}; }
+
+    unsigned flags = stream[3];
+    const auto * position = stream.data() + k_header_size;
+    const auto * end = stream.data() + stream.size();
+    if (flags & k_extra_flag) {
+        if (end - position < 2) return {};
+        std::size_t extra_size = position[0] | (position[1] << 8);
+        if (std::size_t(end - position) < 2 + extra_size) return {};
+        position += 2 + extra_size;
+    }
+    for (auto string_flag : { k_name_flag, k_comment_flag }) {
+        if (!(flags & string_flag)) continue;
+        position = std::find(position, end, std::uint8_t(0));
+        if (position == end) return {};
+        ++position;
+    }
+    if (flags & k_header_crc_flag) {
+        if (end - position < 2) return {};
+        position += 2;
+    }
+
+    BitReader reader{position, end};
+    Bytes out;
+    if (!inflate(reader, max_size, out)) return {};
+    if (reader.remaining_bytes() < k_trailer_size) return {};
+    auto * trailer = reader.position();
+    if (   read_little_endian_32(trailer) != crc32(out)
+        || read_little_endian_32(trailer + 4) != std::uint32_t(out.size()))
+    { return {}; }
+    return out;
+}
+
+} // end of tile_layer_decoding namespace
+
+namespace {
+
+template <typename OnByteFunc>
+bool for_each_base64_byte(const char * beg, const char * end, OnByteFunc && f) {
+    static constexpr std::int8_t k_invalid    = -1;
+    static constexpr std::int8_t k_padding    = -2;
+    static constexpr std::int8_t k_whitespace = -3;
+    static const auto k_values = [] {
+        std::array<std::int8_t, 256> values;
+        values.fill(k_invalid);
+        const char * alphabet =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i != 64; ++i)
+            { values[static_cast<unsigned char>(alphabet[i])] = std::int8_t(i); }
+        values['='] = k_padding;
+        for (char c : { ' ', '\n', '\r', '\t' })
+            { values[static_cast<unsigned char>(c)] = k_whitespace; }
+        return values;
+    } ();
+
+    std::uint32_t quantum = 0;
+    int sextet_count = 0;
+    int padding_count = 0;
+    for (auto itr = beg; itr != end; ++itr) {
+        auto value = k_values[static_cast<unsigned char>(*itr)];
+        if (value == k_whitespace) continue;
+        if (value == k_invalid) return false;
+        if (value == k_padding) {
+            ++padding_count;
+            continue;
+        }
+        // nothing but whitespace, and padding may follow padding
+        if (padding_count != 0) return false;
+        quantum = (quantum << 6) | std::uint32_t(value);
+        if (++sextet_count != 4) continue;
+        f(std::uint8_t(quantum >> 16));
+        f(std::uint8_t(quantum >>  8));
+        f(std::uint8_t(quantum      ));
+        quantum = 0;
+        sextet_count = 0;
+    }
+    switch (sextet_count) {
+    case 0: return padding_count == 0;
+    case 2:
+        f(std::uint8_t(quantum >> 4));
+        return padding_count == 2 || padding_count == 0;
+    case 3:
+        f(std::uint8_t(quantum >> 10));
+        f(std::uint8_t(quantum >>  2));
+        return padding_count == 1 || padding_count == 0;
+    default: return false;
+    }
+}
+
+WarningOpt read_tile_ids(const Bytes & bytes, Grid<int> & layer) {
+    TileIdWriter writer{layer};
+    for (std::size_t i = 0; i + k_bytes_per_tile_id <= bytes.size(); i += k_bytes_per_tile_id) {
+        if (!writer.write(read_little_endian_32(bytes.data() + i)))
+            { return k_invalid_tile_data; }
+    }
+    return {};
+}
+
+// ----------------------------------------------------------------------------
+
+bool BitReader::read(int bit_count, unsigned & bits) {
+    while (m_bit_count < bit_count) {
+        if (m_position == m_end) return false;
+        m_bit_buffer |= std::uint32_t(*m_position++) << m_bit_count;
+        m_bit_count += 8;
+    }
+    bits = m_bit_buffer & ((std::uint32_t(1) << bit_count) - 1);
+    m_bit_buffer >>= bit_count;
+    m_bit_count -= bit_count;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool HuffmanCode::set_lengths
+    (const std::uint8_t * lengths, int count, bool allow_incomplete)
+{
+    m_counts.fill(0);
+    for (int i = 0; i != count; ++i)
+        { ++m_counts[lengths[i]]; }
+    if (m_counts[0] == count) return allow_incomplete;
+
+    int left = 1;
+    for (int length = 1; length <= k_max_bits; ++length) {
+        left = left*2 - m_counts[length];
+        if (left < 0) return false;
+    }
+
+    std::array<std::uint16_t, k_max_bits + 1> offsets;
+    offsets[1] = 0;
+    for (int length = 1; length != k_max_bits; ++length)
+        { offsets[length + 1] = offsets[length] + m_counts[length]; }
+    for (int symbol = 0; symbol != count; ++symbol) {
+        if (lengths[symbol] == 0) continue;
+        m_symbols[offsets[lengths[symbol]]++] = std::uint16_t(symbol);
+    }
+    return left == 0 || allow_incomplete;
+}
+
+int HuffmanCode::decode(BitReader & reader) const {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length <= k_max_bits; ++length) {
+        unsigned bit = 0;
+        if (!reader.read(1, bit)) return -1;
+        code |= int(bit);
+        int count = m_counts[length];
+        if (code - count < first)
+            { return m_symbols[index + (code - first)]; }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+
+bool inflate_stored_block(BitReader & reader, std::size_t max_size, Bytes & out) {
+    reader.align_to_byte();
+    if (reader.remaining_bytes() < 4) return false;
+    auto * header = reader.position();
+    unsigned length = header[0] | (header[1] << 8);
+    unsigned complement = header[2] | (header[3] << 8);
+    if ((length ^ 0xFFFF) != complement) return false;
+    reader.skip_bytes(4);
+    if (   reader.remaining_bytes() < length
+        || out.size() + length > max_size)
+    { return false; }
+    out.insert(out.end(), reader.position(), reader.position() + length);
+    reader.skip_bytes(length);
+    return true;
+}
+
+bool inflate_codes
+    (BitReader & reader, const HuffmanCode & literals_and_lengths,
+     const HuffmanCode & distances, std::size_t max_size, Bytes & out)
+{
+    static constexpr std::array<std::uint16_t, 29> k_length_bases = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static constexpr std::array<std::uint8_t, 29> k_length_extra_bits = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static constexpr std::array<std::uint16_t, 30> k_distance_bases = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+        8193, 12289, 16385, 24577 };
+    static constexpr std::array<std::uint8_t, 30> k_distance_extra_bits = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    static constexpr int k_end_of_block = 256;
+
+    while (true) {
+        int symbol = literals_and_lengths.decode(reader);
+        if (symbol < 0) return false;
+        if (symbol < k_end_of_block) {
+            if (out.size() == max_size) return false;
+            out.push_back(std::uint8_t(symbol));
+            continue;
+        }
+        if (symbol == k_end_of_block) return true;
+
+        auto length_index = std::size_t(symbol - k_end_of_block - 1);
+        if (length_index >= k_length_bases.size()) return false;
+        unsigned extra = 0;
+        if (!reader.read(k_length_extra_bits[length_index], extra)) return false;
+        std::size_t length = k_length_bases[length_index] + extra;
+
+        int distance_index = distances.decode(reader);
+        if (distance_index < 0 || std::size_t(distance_index) >= k_distance_bases.size())
+            { return false; }
+        if (!reader.read(k_distance_extra_bits[distance_index], extra)) return false;
+        std::size_t distance = k_distance_bases[distance_index] + extra;
+        if (distance > out.size() || out.size() + length > max_size)
+            { return false; }
+        // copies may overlap what they're copying
+        auto from = out.size() - distance;
+        for (std::size_t i = 0; i != length; ++i)
+            { out.push_back(out[from + i]); }
+    }
+}
+
+bool inflate_fixed_block(BitReader & reader, std::size_t max_size, Bytes & out) {
+    static const auto k_codes = [] {
+        std::array<std::uint8_t, 288> lengths;
+        std::fill(lengths.begin()      , lengths.begin() + 144, 8);
+        std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+        std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+        std::fill(lengths.begin() + 280, lengths.end()        , 8);
+        std::array<std::uint8_t, 30> distance_lengths;
+        distance_lengths.fill(5);
+        std::array<HuffmanCode, 2> codes;
+        (void)codes[0].set_lengths(lengths.data(), int(lengths.size()), false);
+        (void)codes[1].set_lengths
+            (distance_lengths.data(), int(distance_lengths.size()), true);
+        return codes;
+    } ();
+    return inflate_codes(reader, k_codes[0], k_codes[1], max_size, out);
+}
+
+bool inflate_dynamic_block(BitReader & reader, std::size_t max_size, Bytes & out) {
+    static constexpr std::array<std::uint8_t, 19> k_code_length_order =
+        { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    unsigned literal_count = 0, distance_count = 0, code_length_count = 0;
+    if (   !reader.read(5, literal_count)
+        || !reader.read(5, distance_count)
+        || !reader.read(4, code_length_count))
+    { return false; }
+    literal_count += 257;
+    distance_count += 1;
+    code_length_count += 4;
+    if (literal_count > 286 || distance_count > 30) return false;
+
+    std::array<std::uint8_t, 19> code_length_lengths{};
+    for (unsigned i = 0; i != code_length_count; ++i) {
+        unsigned length = 0;
+        if (!reader.read(3, length)) return false;
+        code_length_lengths[k_code_length_order[i]] = std::uint8_t(length);
+    }
+    HuffmanCode code_lengths;
+    if (!code_lengths.set_lengths
+        (code_length_lengths.data(), int(code_length_lengths.size()), false))
+    { return false; }
+
+    std::array<std::uint8_t, 286 + 30> lengths{};
+    unsigned index = 0;
+    while (index < literal_count + distance_count) {
+        int symbol = code_lengths.decode(reader);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            lengths[index++] = std::uint8_t(symbol);
+            continue;
+        }
+        std::uint8_t repeated = 0;
+        unsigned repeats = 0;
+        if (symbol == 16) {
+            if (index == 0 || !reader.read(2, repeats)) return false;
+            repeated = lengths[index - 1];
+            repeats += 3;
+        } else if (symbol == 17) {
+            if (!reader.read(3, repeats)) return false;
+            repeats += 3;
+        } else {
+            if (!reader.read(7, repeats)) return false;
+            repeats += 11;
+        }
+        if (index + repeats > literal_count + distance_count) return false;
+        for (unsigned i = 0; i != repeats; ++i)
+            { lengths[index++] = repeated; }
+    }
+    // there must be an end of block code
+    if (lengths[256] == 0) return false;
+
+    HuffmanCode literals_and_lengths, distances;
+    if (   !literals_and_lengths.set_lengths(lengths.data(), int(literal_count), false)
+        || !distances.set_lengths
+            (lengths.data() + literal_count, int(distance_count), distance_count == 1))
+    { return false; }
+    return inflate_codes(reader, literals_and_lengths, distances, max_size, out);
+}
+
+bool inflate(BitReader & reader, std::size_t max_size, Bytes & out) {
+    static constexpr unsigned k_stored_block  = 0;
+    static constexpr unsigned k_fixed_block   = 1;
+    static constexpr unsigned k_dynamic_block = 2;
+    out.reserve(max_size);
+    unsigned is_last = 0;
+    while (!is_last) {
+        unsigned block_type = 0;
+        if (!reader.read(1, is_last) || !reader.read(2, block_type))
+            { return false; }
+        bool block_inflated = [&] {
+            switch (block_type) {
+            case k_stored_block : return inflate_stored_block (reader, max_size, out);
+            case k_fixed_block  : return inflate_fixed_block  (reader, max_size, out);
+            case k_dynamic_block: return inflate_dynamic_block(reader, max_size, out);
+            default: return false;
+            }
+        } ();
+        if (!block_inflated) return false;
+    }
+    // trailers start on the next whole byte
+    reader.align_to_byte();
+    return true;
+}
+
+std::uint32_t adler32(const Bytes & bytes) {
+    static constexpr std::uint32_t k_modulus = 65521;
+    // largest run before sums may overflow
+    static constexpr std::size_t k_run_length = 5552;
+    std::uint32_t a = 1, b = 0;
+    for (std::size_t i = 0; i < bytes.size(); i += k_run_length) {
+        auto run_end = std::min(bytes.size(), i + k_run_length);
+        for (std::size_t j = i; j != run_end; ++j) {
+            a += bytes[j];
+            b += a;
+        }
+        a %= k_modulus;
+        b %= k_modulus;
+    }
+    return (b << 16) | a;
+}
+
+std::uint32_t crc32(const Bytes & bytes) {
+    static const auto k_table = [] {
+        std::array<std::uint32_t, 256> table;
+        for (std::uint32_t n = 0; n != 256; ++n) {
+            auto c = n;
+            for (int k = 0; k != 8; ++k)
+                { c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1; }
+            table[n] = c;
+        }
+        return table;
+    } ();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (auto byte : bytes)
+        { crc = k_table[(crc ^ byte) & 0xFF] ^ (crc >> 8); }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+std::uint32_t read_big_endian_32(const std::uint8_t * bytes) {
+    return   (std::uint32_t(bytes[0]) << 24) | (std::uint32_t(bytes[1]) << 16)
+           | (std::uint32_t(bytes[2]) <<  8) |  std::uint32_t(bytes[3]);
+}
+
+std::uint32_t read_little_endian_32(const std::uint8_t * bytes) {
+    return    std::uint32_t(bytes[0])        | (std::uint32_t(bytes[1]) <<  8)
+           | (std::uint32_t(bytes[2]) << 16) | (std::uint32_t(bytes[3]) << 24);
+}
+
+} // end of <anonymous> namespace
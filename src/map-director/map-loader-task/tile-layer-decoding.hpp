@@ -0,0 +1,72 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "MapLoadingError.hpp"
+
+#include <cstdint>
+
+/// Decodes the data of Tiled tile layers, straight into grids of tile ids.
+///
+/// Data may be csv, or base64 (uncompressed, or compressed with zlib or
+/// gzip). Tile ids are written in the grid's "next" order, which is the
+/// order Tiled writes them in. Flipped tiles are not supported (their ids
+/// are out of range).
+namespace tile_layer_decoding {
+
+using Bytes = std::vector<std::uint8_t>;
+
+/// @returns warning if the layer has no data, or its data could not be
+///          decoded
+Either<MapLoadingWarningEnum, Grid<int>> decode_layer_element
+    (const TiXmlElement & layer_element);
+
+/// @param layer grid already sized to the layer
+/// @returns warning if the data could not be decoded, the layer may be
+///          partly written
+Optional<MapLoadingWarningEnum> decode_data_element
+    (const TiXmlElement & data_element, Grid<int> & layer);
+
+/// Entries may have whitespace around them. Fewer entries than the layer
+/// has tiles leaves the rest as they were.
+Optional<MapLoadingWarningEnum> decode_csv
+    (const char * beg, const char * end, Grid<int> & layer);
+
+/// @param compression either null (for none), "zlib", or "gzip"
+Optional<MapLoadingWarningEnum> decode_base64
+    (const char * beg, const char * end, const char * compression,
+     Grid<int> & layer);
+
+/// whitespace is skipped
+///
+/// @returns nothing if not base64
+Optional<Bytes> base64_to_bytes(const char * beg, const char * end);
+
+/// @param max_size streams which inflate to more than this are invalid
+/// @returns nothing if not a valid zlib stream, or its checksum is wrong
+Optional<Bytes> inflate_zlib(const Bytes & stream, std::size_t max_size);
+
+/// @param max_size streams which inflate to more than this are invalid
+/// @returns nothing if not a valid gzip stream (of one member), or its
+///          checksum is wrong
+Optional<Bytes> inflate_gzip(const Bytes & stream, std::size_t max_size);
+
+} // end of tile_layer_decoding namespace
@@ -59,6 +59,10 @@ private:
 
 PlatformAssetsStrategy::~PlatformAssetsStrategy() {}
 
+Optional<DecodedImage> PlatformAssetsStrategy::decode_image_file
+    (const char *) const
+    { return {}; }
+
 /* static */ Platform & Platform::null_callbacks() {
     static constexpr const auto k_cannot_promise_file_contents =
         "Platform::null_callbacks()::...::promise_file_contents: cannot use "
@@ -29,6 +29,8 @@ class Texture;
 
 class RenderModel;
 
+struct DecodedImage;
+
 enum class KeyControl {
     forward,
     backward,
@@ -73,6 +75,21 @@ public:
      *        having to use a blocking call with Web Assembly.
      */
     virtual FutureStringPtr promise_file_contents(const char *) = 0;
+
+    /** Like promise_file_contents, but for a file that's expected to be
+     *  missing at times, so its contents being lost isn't reported.
+     */
+    virtual FutureStringPtr promise_file_contents_if_present
+        (const char * filename)
+        { return promise_file_contents(filename); }
+
+    /** Decodes an image file into pixels, for a texture to be loaded from
+     *  later. Unlike the rest of this class, it may be called from any thread.
+     *
+     *  @returns nothing if the file could not be decoded, or if the platform
+     *           only loads images straight into textures
+     */
+    virtual Optional<DecodedImage> decode_image_file(const char *) const;
 };
 
 /** Represents the platform on which the application runs. This class is a way
@@ -39,8 +39,8 @@
 #include <ariajanke/cul/Util.hpp>
 
 #include <array>
-#include <sstream>
 #include <fstream>
+#include <filesystem>
 
 namespace {
 
@@ -235,11 +235,16 @@ void ScopedShader::compile_fragment(const char * source_code) {
 std::string throwing_file_to_string(const char * filename) {
     std::ifstream fin;
     fin.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fin.open(filename);
-    std::stringstream sstrm;
-    sstrm << fin.rdbuf();
-    fin.close();
-    return sstrm.str();
+    fin.open(filename, std::ios::binary);
+    // read straight into the string returned, rather than through a stream
+    // buffer and a copy out of it
+    std::error_code error;
+    const auto size = std::filesystem::file_size(filename, error);
+    if (error)
+        { throw std::ios_base::failure{error.message()}; }
+    std::string contents(size, '\0');
+    fin.read(contents.data(), std::streamsize(contents.size()));
+    return contents;
 }
 
 } // end of <anonymous> namespace
@@ -105,6 +105,24 @@ OpenGlTexture::~OpenGlTexture() {
         stbi_image_free(m_pixel_data);
 }
 
+/* static */ Optional<DecodedImage> OpenGlTexture::decode_file
+    (const char * filename)
+{
+    int width = 0, height = 0, channel_count = 0;
+    auto * pixels = stbi_load(filename, &width, &height,
+                              &channel_count, k_rgba_channel_count);
+    if (!pixels)
+        return {};
+
+    DecodedImage image;
+    image.width = width;
+    image.height = height;
+    image.rgba_pixels.assign
+        (pixels, pixels + std::size_t(width*height*k_rgba_channel_count));
+    stbi_image_free(pixels);
+    return image;
+}
+
 bool OpenGlTexture::load_from_file_no_throw(const char * filename) noexcept {
     // load and generate the texture
     m_pixel_data = stbi_load(filename, &m_width, &m_height,
@@ -53,6 +53,9 @@ public:
 
     OpenGlTexture & operator = (OpenGlTexture &&);
 
+    /// may be called from any thread
+    static Optional<DecodedImage> decode_file(const char * filename);
+
     bool load_from_file_no_throw(const char *) noexcept final;
 
     void load_from_memory(int width_, int height_, const void * rgba_pixels) final;
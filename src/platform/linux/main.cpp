@@ -33,6 +33,12 @@
 #include <iostream>
 #include <map>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #include <glad/glad.h>
 
@@ -112,82 +118,67 @@ private:
     GameDriver & m_driver;
 };
 
-class BlockingFileContentPromising final {
+/// Reads promised files on worker threads, the frame thread only polls which
+/// reads are finished.
+///
+/// Contents are read straight into the string handed out by the promise.
+class ThreadedFileContentPromising final {
 public:
-    FutureStringPtr promise_file_contents(const char * filename) {
-        class Impl final : public Future<std::string> {
-        public:
-            Impl(const char * filename):
-                m_filename(filename),
-                m_contents(file_to_string(filename)) {}
-
-            OptionalEither<Lost, std::string> retrieve() final {
-                if (m_contents)
-                    { return std::move(*m_contents); }
-                print_out_lost_file_content(m_filename);
-                return Lost{};
-            }
-
-        private:
-            const char * m_filename = nullptr;
-            Optional<std::string> m_contents;
-        };
-        return make_shared<Impl>(filename);
-    }
+    ThreadedFileContentPromising();
 
-    void progress_file_promises() {}
-};
+    ThreadedFileContentPromising(const ThreadedFileContentPromising &) = delete;
 
-class SingleFrameFileContentPromising final {
-public:
-    FutureStringPtr promise_file_contents(const char * filename) {
-        m_unprocessed.emplace_back(make_shared<FutureStringImpl>(filename));
-        return m_unprocessed.back();
-    }
+    /// reads not yet started are dropped
+    ~ThreadedFileContentPromising();
 
-    void progress_file_promises() {
-        for (auto & unprocessed : m_unprocessed) {
-            unprocessed->progress();
-        }
-        m_unprocessed.clear();
-    }
+    ThreadedFileContentPromising & operator =
+        (const ThreadedFileContentPromising &) = delete;
+
+    FutureStringPtr promise_file_contents(const char * filename);
+
+    FutureStringPtr promise_file_contents_if_present(const char * filename);
+
+    void progress_file_promises();
 
 private:
     class FutureStringImpl final : public Future<std::string> {
     public:
-        FutureStringImpl(const char * filename):
-            m_filename(filename) {}
-
-        OptionalEither<Lost, std::string> retrieve() final {
-            if (!m_loaded)
-                { return {}; }
-            if (m_contents)
-                { return std::move(*m_contents); }
-            print_out_lost_file_content(m_filename);
-            return Lost{};
-        }
+        FutureStringImpl(const char * filename, bool reports_lost):
+            m_filename(filename), m_reports_lost(reports_lost) {}
 
-        void progress() {
-            m_loaded = true;
-            m_contents = file_to_string(m_filename.c_str());
-        }
+        OptionalEither<Lost, std::string> retrieve() final;
+
+        /// worker only
+        void read();
+
+        /// @returns true if read, in which case contents may be retrieved
+        bool progress();
 
     private:
-        bool m_loaded = false;
+        bool is_retrievable() const;
+
         std::string m_filename;
+        bool m_reports_lost;
         Optional<std::string> m_contents;
+        std::atomic_bool m_read = false;
+        bool m_progressed = false;
     };
 
+    FutureStringPtr promise(const char * filename, bool reports_lost);
+
+    void run_worker();
+
     std::vector<SharedPtr<FutureStringImpl>> m_unprocessed;
+
+    std::mutex m_mutex;
+    std::condition_variable m_read_pushed;
+    std::deque<SharedPtr<FutureStringImpl>> m_reads;
+    bool m_stopping = false;
+    std::vector<std::thread> m_workers;
 };
 
 class NativePlatformCallbacks final : public Platform {
 public:
-    using FilePromiser = std::conditional_t
-        <k_promised_files_take_at_least_one_frame,
-         SingleFrameFileContentPromising,
-         BlockingFileContentPromising>;
-
     explicit NativePlatformCallbacks(ShaderProgram & shader):
         m_shader(shader) {}
 
@@ -197,18 +188,23 @@ public:
 
     SharedPtr<RenderModel> make_render_model() const final;
 
+    Optional<DecodedImage> decode_image_file(const char * filename) const final
+        { return OpenGlTexture::decode_file(filename); }
+
     void set_camera_entity(EntityRef) final;
 
     glm::mat4 get_view() const;
 
     FutureStringPtr promise_file_contents(const char * filename);
 
+    FutureStringPtr promise_file_contents_if_present(const char * filename);
+
     void progress_file_promises() { m_file_promiser.progress_file_promises(); }
 
 private:
     ShaderProgram & m_shader;
     EntityRef m_camera_ent;
-    FilePromiser m_file_promiser;
+    ThreadedFileContentPromising m_file_promiser;
 };
 
 class Timer final {
@@ -496,6 +492,106 @@ FutureStringPtr NativePlatformCallbacks::promise_file_contents
     (const char * filename)
 { return m_file_promiser.promise_file_contents(filename); }
 
+FutureStringPtr NativePlatformCallbacks::promise_file_contents_if_present
+    (const char * filename)
+{ return m_file_promiser.promise_file_contents_if_present(filename); }
+
+// ----------------------------------------------------------------------------
+
+ThreadedFileContentPromising::ThreadedFileContentPromising() {
+    for (int i = 0; i < k_file_reading_thread_count; ++i)
+        { m_workers.emplace_back([this] { run_worker(); }); }
+}
+
+ThreadedFileContentPromising::~ThreadedFileContentPromising() {
+    {
+    std::unique_lock lock{m_mutex};
+    m_stopping = true;
+    m_reads.clear();
+    }
+    m_read_pushed.notify_all();
+    for (auto & worker : m_workers)
+        { worker.join(); }
+}
+
+FutureStringPtr ThreadedFileContentPromising::promise_file_contents
+    (const char * filename)
+{ return promise(filename, true); }
+
+FutureStringPtr ThreadedFileContentPromising::promise_file_contents_if_present
+    (const char * filename)
+{ return promise(filename, false); }
+
+void ThreadedFileContentPromising::progress_file_promises() {
+    auto unprocessed_end = std::remove_if
+        (m_unprocessed.begin(), m_unprocessed.end(),
+         [] (const SharedPtr<FutureStringImpl> & promised)
+         { return promised->progress(); });
+    m_unprocessed.erase(unprocessed_end, m_unprocessed.end());
+}
+
+/* private */ FutureStringPtr ThreadedFileContentPromising::promise
+    (const char * filename, bool reports_lost)
+{
+    auto promised = make_shared<FutureStringImpl>(filename, reports_lost);
+    m_unprocessed.push_back(promised);
+    {
+    std::unique_lock lock{m_mutex};
+    m_reads.push_back(promised);
+    }
+    m_read_pushed.notify_one();
+    return promised;
+}
+
+/* private */ void ThreadedFileContentPromising::run_worker() {
+    while (true) {
+        SharedPtr<FutureStringImpl> promised;
+        {
+        std::unique_lock lock{m_mutex};
+        m_read_pushed.wait
+            (lock, [this] { return m_stopping || !m_reads.empty(); });
+        if (m_stopping) return;
+        promised = std::move(m_reads.front());
+        m_reads.pop_front();
+        }
+        promised->read();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+OptionalEither<Future<std::string>::Lost, std::string>
+    ThreadedFileContentPromising::FutureStringImpl::retrieve()
+{
+    if (!is_retrievable())
+        { return {}; }
+    if (m_contents)
+        { return std::move(*m_contents); }
+    if (m_reports_lost)
+        { print_out_lost_file_content(m_filename); }
+    return Lost{};
+}
+
+void ThreadedFileContentPromising::FutureStringImpl::read() {
+    m_contents = file_to_string(m_filename.c_str());
+    m_read.store(true, std::memory_order_release);
+}
+
+bool ThreadedFileContentPromising::FutureStringImpl::progress() {
+    m_progressed = m_read.load(std::memory_order_acquire);
+    return m_progressed;
+}
+
+/* private */ bool
+    ThreadedFileContentPromising::FutureStringImpl::is_retrievable() const
+{
+    // files always take at least one frame, as they're only progressed after
+    // the frame they're promised on
+    if constexpr (k_promised_files_take_at_least_one_frame)
+        { return m_progressed; }
+    return m_read.load(std::memory_order_acquire);
+}
+
 // ----------------------------------------------------------------------------
 
 void PpStateModelMatrixAdjustment::operator ()
@@ -503,7 +599,7 @@ void PpStateModelMatrixAdjustment::operator ()
 {
     auto * on_surface = std::get_if<PpOnSegment>(&state);
     if (!on_surface) return;
-    auto norm = on_surface->segment->normal();
+    auto norm = on_surface->segment.normal();
     if (are_very_close(norm - k_up, Vector{})) {
         // directly oppose each other, axis not servicable
         // I need a vector orthogonal to up
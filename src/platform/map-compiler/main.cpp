@@ -0,0 +1,88 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../map-director/map-loader-task/CompiledMap.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Compiles each map given, along with its tilesets, for the game to load
+// without parsing any layer data. Each map is written beside itself (see
+// CompiledMap::compiled_filename_for).
+//
+// Tilesets are read by the names maps refer to them with, so this should be
+// run from the same directory the game runs from.
+
+namespace {
+
+constexpr const auto k_usage =
+    "usage: map-compiler <map filename> [<more map filenames>...]";
+
+Optional<std::string> file_to_string(const std::string & filename);
+
+bool string_to_file(const std::string & filename, const std::string & contents);
+
+} // end of <anonymous> namespace
+
+int main(int argc, char ** argv) {
+    if (argc < 2) {
+        std::cerr << k_usage << std::endl;
+        return ~0;
+    }
+    for (int i = 1; i != argc; ++i) {
+        std::string map_filename{argv[i]};
+        auto compiled_filename = CompiledMap::compiled_filename_for(map_filename);
+        try {
+            auto compiled = CompiledMap::compile(map_filename, file_to_string);
+            if (!string_to_file(compiled_filename, compiled.write())) {
+                std::cerr << "cannot write \"" << compiled_filename << "\""
+                          << std::endl;
+                return ~0;
+            }
+            std::cout << "compiled \"" << map_filename << "\" (with "
+                      << (compiled.source_filenames().size() - 1)
+                      << " tileset files) to \"" << compiled_filename << "\""
+                      << std::endl;
+        } catch (std::exception & exp) {
+            std::cerr << exp.what() << std::endl;
+            return ~0;
+        }
+    }
+    return 0;
+}
+
+namespace {
+
+Optional<std::string> file_to_string(const std::string & filename) {
+    std::ifstream file{filename, std::ios::binary};
+    if (!file) return {};
+    std::stringstream sstream;
+    sstream << file.rdbuf();
+    return sstream.str();
+}
+
+bool string_to_file(const std::string & filename, const std::string & contents) {
+    std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+    file.write(contents.data(), std::streamsize(contents.size()));
+    return bool(file);
+}
+
+} // end of <anonymous> namespace
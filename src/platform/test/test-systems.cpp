@@ -95,7 +95,7 @@ bool run_systems_tests() {
             state = (*pdriver)(state, *test_handler);
 
             are_very_close(displc, Vector{displacement.x, 0, displacement.z});
-            return test(get<PpOnSegment>(state).fragment != links_a);
+            return test(get<PpOnSegment>(state).link_id != links_a->id());
         });
         unit.start(mark(suite), [&] {
             // inverts correctly
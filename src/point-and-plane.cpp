@@ -26,28 +26,39 @@
 namespace point_and_plane {
 
 OnSegment::OnSegment
-    (const SharedPtr<const TriangleFragment> & frag_,
+    (const TriangleLink & link_,
      bool invert_norm_, Vector2 loc_, Vector2 dis_):
-    fragment(frag_), segment(&frag_->segment()),
+    link_id(link_.id()), segment(link_.segment()),
     invert_normal(invert_norm_), location(loc_), displacement(dis_)
 {
-    if (!segment->contains_point(loc_)) {
+    if (!segment.contains_point(loc_)) {
         std::cerr << loc_ << " "
-                  << segment->point_a_in_2d() << " "
-                  << segment->point_b_in_2d() << " "
-                  << segment->point_c_in_2d() << std::endl;
+                  << segment.point_a_in_2d() << " "
+                  << segment.point_b_in_2d() << " "
+                  << segment.point_c_in_2d() << std::endl;
     }
-    assert(segment->contains_point(loc_));
+    assert(segment.contains_point(loc_));
 }
 
-/* static */ UniquePtr<Driver> Driver::make_driver()
-    { return UniquePtr<Driver>{make_unique<DriverComplete>()}; }
+OnSegment::OnSegment
+    (const SharedPtr<const TriangleLink> & link_,
+     bool invert_norm_, Vector2 loc_, Vector2 dis_):
+    OnSegment(*link_, invert_norm_, loc_, dis_) {}
+
+/* static */ UniquePtr<Driver> Driver::make_driver
+    (BroadphaseType broadphase_type)
+{ return UniquePtr<Driver>{make_unique<DriverComplete>(broadphase_type)}; }
+
+void Driver::step_all(const View<BodyStep *> & bodies, int) const {
+    for (auto & body : bodies)
+        { *body.state = (*this)(*body.state, *body.handler); }
+}
 
 Vector location_of(const State & state) {
     auto * in_air = get_if<InAir>(&state);
     if (in_air) return in_air->location;
     auto & on_surf = std::get<OnSegment>(state);
-    return on_surf.segment->point_at(on_surf.location);
+    return on_surf.segment.point_at(on_surf.location);
 }
 
 Vector displaced_location_of(const State & state) {
@@ -55,14 +66,14 @@ Vector displaced_location_of(const State & state) {
         return on_air->location + on_air->displacement;
     }
     auto & on_segment = std::get<OnSegment>(state);
-    return on_segment.segment->point_at(  on_segment.location
+    return on_segment.segment.point_at(  on_segment.location
                                         + on_segment.displacement);
 }
 
 Vector segment_displacement_to_v3(const State & state) {
     using std::get;
     auto pt_at = [&state](Vector2 r)
-        { return get<OnSegment>(state).segment->point_at(r); };
+        { return get<OnSegment>(state).segment.point_at(r); };
     auto dis = get<OnSegment>(state).displacement;
     auto loc = get<OnSegment>(state).location;
     return pt_at(loc + dis) - pt_at(loc);
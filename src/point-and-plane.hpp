@@ -42,11 +42,18 @@ namespace point_and_plane {
 struct OnSegment final {
     OnSegment() {}
 
-    OnSegment(const SharedPtr<const TriangleFragment> & tri_, bool invert_norm_,
+    OnSegment(const TriangleLink & link_, bool invert_norm_,
               Vector2 loc_, Vector2 dis_);
 
-    SharedPtr<const TriangleFragment> fragment;
-    const Triangle * segment = nullptr;
+    OnSegment(const SharedPtr<const TriangleLink> & link_, bool invert_norm_,
+              Vector2 loc_, Vector2 dis_);
+
+    /// the link tracked on, this maybe stale should the link's region unload
+    TriangleId link_id;
+    /// a copy of the link's triangle, which outlives the link: a body keeps
+    /// moving along it for the rest of the frame even if its region unloads,
+    /// and reading it needs no store lookup on every step
+    Triangle segment;
     bool invert_normal = false;
     Vector2 location;
     Vector2 displacement;
@@ -137,12 +144,38 @@ public:
          const Triangle & next, const Vector & projected_new_loaction) const = 0;
 };
 
+/// one body for Driver::step_all, along with what handles its events
+struct BodyStep final {
+    BodyStep() {}
+
+    BodyStep(State * state_, const EventHandler * handler_):
+        state(state_), handler(handler_) {}
+
+    State * state = nullptr;
+    const EventHandler * handler = nullptr;
+};
+
+/// which structure the driver uses to find triangles near moving points
+enum class BroadphaseType {
+    /// projects triangles onto a line, splitting that into intervals; best
+    /// for maps that sprawl mostly in one direction
+    projected_partition,
+    /// uniform grid of 3D cells, hashed so only occupied cells use memory
+    hashed_grid,
+    /// tree of bounding boxes, adapts to however triangles are distributed
+    bounding_box_tree
+};
+
 class Driver {
 public:
-    static UniquePtr<Driver> make_driver();
+    static UniquePtr<Driver> make_driver
+        (BroadphaseType = BroadphaseType::projected_partition);
 
     virtual ~Driver() {}
 
+    /// Broadphases share ownership of the links they index, so that a link
+    /// found by a query stays alive while it's used. Only state held across
+    /// frames (e.g. OnSegment) refers to links by TriangleId.
     virtual void add_triangle(const SharedPtr<const TriangleLink> &) = 0;
 
     void add_triangles(const std::vector<SharedPtr<TriangleLink>> & links) {
@@ -162,6 +195,16 @@ public:
     // the point is to consume the displacement vector
     virtual State operator () (const State &, const EventHandler &) const = 0;
 
+    /** Steps many bodies at once, each body's state is replaced in place,
+     *  just as if this driver were called on each one.
+     *
+     *  @param thread_count bodies may be spread across up to this many
+     *         threads; if more than one, each event handler must only touch
+     *         data belonging to its own body
+     */
+    virtual void step_all(const View<BodyStep *> & bodies,
+                          int thread_count = 1) const;
+
 protected:
     Driver() {}
 };
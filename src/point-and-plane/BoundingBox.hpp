@@ -0,0 +1,70 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "../TriangleSegment.hpp"
+
+/// axis aligned bounding box, used by the 3D broadphase containers
+struct BoundingBox final {
+    static BoundingBox make_for(const TriangleSegment & triangle) {
+        return BoundingBox{triangle.point_a(), triangle.point_b()}.
+            expanded_to(triangle.point_c());
+    }
+
+    static BoundingBox make_union(const BoundingBox & lhs, const BoundingBox & rhs)
+        { return lhs.expanded_to(rhs.low).expanded_to(rhs.high); }
+
+    BoundingBox() {}
+
+    /// creates the smallest box containing both points
+    BoundingBox(const Vector & a, const Vector & b):
+        low {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)},
+        high{std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)} {}
+
+    BoundingBox expanded_to(const Vector & r) const {
+        BoundingBox rv{*this};
+        rv.low  = Vector{std::min(low.x , r.x), std::min(low.y , r.y), std::min(low.z , r.z)};
+        rv.high = Vector{std::max(high.x, r.x), std::max(high.y, r.y), std::max(high.z, r.z)};
+        return rv;
+    }
+
+    bool contains(const BoundingBox & rhs) const {
+        return    low.x <= rhs.low.x && rhs.high.x <= high.x
+               && low.y <= rhs.low.y && rhs.high.y <= high.y
+               && low.z <= rhs.low.z && rhs.high.z <= high.z;
+    }
+
+    bool overlaps(const BoundingBox & rhs) const {
+        return    low.x <= rhs.high.x && rhs.low.x <= high.x
+               && low.y <= rhs.high.y && rhs.low.y <= high.y
+               && low.z <= rhs.high.z && rhs.low.z <= high.z;
+    }
+
+    /// used as the cost of a box, by the bounding box tree
+    Real surface_area() const {
+        auto d = high - low;
+        return 2*(d.x*d.y + d.y*d.z + d.z*d.x);
+    }
+
+    Vector center() const { return (low + high)*0.5; }
+
+    Vector low, high;
+};
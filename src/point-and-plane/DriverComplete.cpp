@@ -19,6 +19,11 @@
 *****************************************************************************/
 
 #include "DriverComplete.hpp"
+#include "PackedTriangleBatch.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
 
 #if 0
 #include <iostream>
@@ -33,6 +38,27 @@ using std::get;
 using cul::find_smallest_diff, cul::is_solution, cul::project_onto,
       cul::sum_of_squares, cul::EnableIf;
 using LinkTransfer = TriangleLink::Transfer;
+using LimitIntersection = Triangle::LimitIntersection;
+
+/// @returns the link nearest to "from", whose triangle the segment between
+///          from and to passes through (or null if there are none)
+template <typename LinkRange>
+Tuple<SharedPtr<const TriangleLink>, LimitIntersection>
+    find_nearest_intersecting
+    (const LinkRange & candidates, const Vector & from, const Vector & to);
+
+/// @returns true if lhs goes before rhs, when both are hit at the same
+///          distance; by position, as links are made in no fixed order (nor
+///          at fixed addresses)
+bool is_hit_before(const TriangleSegment & lhs, const TriangleSegment & rhs);
+
+inline const SharedPtr<const TriangleLink> &
+    link_of(const SharedPtr<const TriangleLink> & link)
+    { return link; }
+
+inline const SharedPtr<const TriangleLink> &
+    link_of(const SharedPtr<const TriangleLink> * link)
+    { return *link; }
 
 template <typename Vec1, typename Vec2>
 void verify_decreasing_displacement
@@ -55,34 +81,110 @@ bool new_invert_normal
 
 namespace point_and_plane {
 
+DriverComplete::DriverComplete(BroadphaseType broadphase_type):
+    m_frametime_link_container(make_link_container(broadphase_type)) {}
+
 // should/add remove fast
 void DriverComplete::add_triangle(const SharedPtr<const TriangleLink> & link) {
-    m_frametime_link_container.defer_addition_of(link);
+    std::visit([&link] (auto & container)
+        { container.defer_addition_of(link); },
+        m_frametime_link_container);
 }
 
 void DriverComplete::remove_triangle(const SharedPtr<const TriangleLink> & link) {
-    m_frametime_link_container.defer_removal_of(link);
+    std::visit([&link] (auto & container)
+        { container.defer_removal_of(link); },
+        m_frametime_link_container);
 }
 
 void DriverComplete::clear_all_triangles() {
-    m_frametime_link_container.clear();
+    std::visit([] (auto & container) { container.clear(); },
+               m_frametime_link_container);
 }
 
 Driver & DriverComplete::update() {
-    m_frametime_link_container.update();
+    std::visit([] (auto & container) { container.update(); },
+               m_frametime_link_container);
     return *this;
 }
 
 State DriverComplete::operator ()
     (const State & state, const EventHandler & env) const
+    { return step(state, env, nullptr); }
+
+void DriverComplete::step_all
+    (const View<BodyStep *> & bodies, int thread_count) const
+{
+    using CellKey = Tuple<int, int, int>;
+    std::vector<Tuple<CellKey, BodyStep>> keyed_bodies;
+    for (auto & body : bodies) {
+        auto r = location_of(*body.state) / k_group_cell_size;
+        CellKey key{int(std::floor(r.x)), int(std::floor(r.y)),
+                    int(std::floor(r.z))};
+        keyed_bodies.emplace_back(key, body);
+    }
+    std::sort(keyed_bodies.begin(), keyed_bodies.end(),
+              [] (const Tuple<CellKey, BodyStep> & lhs,
+                  const Tuple<CellKey, BodyStep> & rhs)
+              { return get<CellKey>(lhs) < get<CellKey>(rhs); });
+
+    std::vector<BodyStep> sorted_bodies;
+    std::vector<std::size_t> group_starts;
+    sorted_bodies.reserve(keyed_bodies.size());
+    for (std::size_t i = 0; i != keyed_bodies.size(); ++i) {
+        if (i == 0 || get<CellKey>(keyed_bodies[i - 1]) != get<CellKey>(keyed_bodies[i]))
+            { group_starts.push_back(i); }
+        sorted_bodies.push_back(get<BodyStep>(keyed_bodies[i]));
+    }
+    group_starts.push_back(sorted_bodies.size());
+
+    auto step_groups = [this, &sorted_bodies, &group_starts]
+        (std::size_t first, std::size_t last)
+    {
+        for (auto i = first; i != last; ++i) {
+            auto * beg = sorted_bodies.data() + group_starts[i];
+            auto * end = sorted_bodies.data() + group_starts[i + 1];
+            step_group(View{beg, end});
+        }
+    };
+    auto group_count = group_starts.size() - 1;
+    thread_count = int(std::min(std::size_t(std::max(thread_count, 1)), group_count));
+    if (thread_count <= 1) {
+        step_groups(0, group_count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(thread_count);
+    for (int t = 0; t != thread_count; ++t) {
+        auto first = (group_count*t) / thread_count;
+        auto last = (group_count*(t + 1)) / thread_count;
+        threads.emplace_back([&step_groups, &errors, t, first, last] {
+            try {
+                step_groups(first, last);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto & thread : threads)
+        { thread.join(); }
+    for (auto & error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+/* private */ State DriverComplete::step
+    (const State & state, const EventHandler & env,
+     const SharedCandidates * shared) const
 {
     // before returning, this must be true:
     //
     // are_very_close(/* something */.displacement, make_zero_vector<Vector>())
 
-    auto next_state = [this](const State & state, const EventHandler & env) {
+    auto next_state = [this, shared](const State & state, const EventHandler & env) {
         if (auto * freebody = get_if<InAir>(&state)) {
-            return handle_freebody(*freebody, env);
+            return handle_freebody(*freebody, env, shared);
         }
         if (auto * tracker = get_if<OnSegment>(&state)) {
             return handle_tracker(*tracker, env);
@@ -107,38 +209,80 @@ State DriverComplete::operator ()
     return cur_state;
 }
 
-/* private */ State DriverComplete::handle_freebody
-    (const InAir & freebody, const EventHandler & env) const
+/* private static */ DriverComplete::LinkContainer
+    DriverComplete::make_link_container(BroadphaseType broadphase_type)
 {
+    using Bt = BroadphaseType;
+    switch (broadphase_type) {
+    case Bt::projected_partition: return FrameTimeLinkContainer{};
+    case Bt::hashed_grid        : return FrameTimeLinkGrid{};
+    case Bt::bounding_box_tree  : return FrameTimeLinkTree{};
+    default: break;
+    }
+    throw InvalidArgument
+        {"DriverComplete::make_link_container: unknown broadphase type"};
+}
 
-    const auto new_loc = freebody.location + freebody.displacement;
-    auto view = m_frametime_link_container.view_for(freebody.location, new_loc);
-    const auto beg = view.begin();
-    const auto end = view.end();
-
-    using LimitIntersection = Triangle::LimitIntersection;
-    SharedPtr<const TriangleLink> candidate;
-    LimitIntersection candidate_intx;
+/* private */ void DriverComplete::step_group
+    (const View<BodyStep *> & group) const
+{
+    BoundingBox bounds;
+    int freebody_count = 0;
+    for (auto & body : group) {
+        auto * freebody = get_if<InAir>(body.state);
+        if (!freebody) continue;
+        BoundingBox box
+            {freebody->location, freebody->location + freebody->displacement};
+        bounds = freebody_count++ == 0 ? box : BoundingBox::make_union(bounds, box);
+    }
+    if (freebody_count < 2) {
+        // nothing to share
+        for (auto & body : group)
+            { *body.state = step(*body.state, *body.handler, nullptr); }
+        return;
+    }
 
-    constexpr const auto k_caller_name = "DriverComplete::handle_freebody";
-    for (auto itr = beg; itr != end; ++itr) {
-        auto link_ptr = *itr;
-        const auto & triangle = link_ptr->segment();
+    SharedCandidates shared;
+    shared.bounds = bounds;
+    std::visit([&shared] (const auto & container) {
+        for (auto & link : container.view_for(shared.bounds))
+            { shared.links.push_back(&link); }
+    }, m_frametime_link_container);
+    // a link may be listed more than once (e.g. spanning grid cells), only
+    // its first listing is kept, so the broadphase's order is kept too
+    std::unordered_set<const TriangleLink *> listed;
+    listed.reserve(shared.links.size());
+    auto listed_end = std::remove_if
+        (shared.links.begin(), shared.links.end(),
+         [&listed] (const SharedPtr<const TriangleLink> * link)
+         { return !listed.insert(link->get()).second; });
+    shared.links.erase(listed_end, shared.links.end());
+
+    for (auto & body : group)
+        { *body.state = step(*body.state, *body.handler, &shared); }
+}
 
-        auto liminx = triangle.limit_with_intersection(freebody.location, new_loc);
-        if (!is_solution(liminx.intersection)) continue;
-        if (!candidate) {
-            candidate = link_ptr;
-            candidate_intx = liminx;
-            continue;
-        }
-        if (magnitude(liminx.limit         - freebody.location) <
-            magnitude(candidate_intx.limit - freebody.location)  )
-        {
-            candidate = link_ptr;
-            candidate_intx = liminx;
+/* private */ State DriverComplete::handle_freebody
+    (const InAir & freebody, const EventHandler & env,
+     const SharedCandidates * shared) const
+{
+    const auto new_loc = freebody.location + freebody.displacement;
+    auto [candidate, candidate_intx] = [&] {
+        // shared candidates are only complete for queries inside their bounds
+        // (which later displacements, after a hit, need not be)
+        BoundingBox query{freebody.location, new_loc};
+        if (shared && shared->bounds.contains(query)) {
+            return find_nearest_intersecting
+                (shared->links, freebody.location, new_loc);
         }
-    }
+        return std::visit([&freebody, &new_loc] (const auto & container) {
+            return find_nearest_intersecting
+                (container.view_for(freebody.location, new_loc),
+                 freebody.location, new_loc);
+        }, m_frametime_link_container);
+    } ();
+
+    constexpr const auto k_caller_name = "DriverComplete::handle_freebody";
     if (candidate) {
         const auto & triangle = candidate->segment();
         const auto & intx = candidate_intx.intersection;
@@ -170,10 +314,9 @@ State DriverComplete::operator ()
     (const OnSegment & tracker, const EventHandler & env) const
 {
     // this function is a little heavy, can we split it? (defer)
-    assert(tracker.segment);
     // ground opens up from underneath
 
-    const auto & triangle = *tracker.segment;
+    const auto & triangle = tracker.segment;
 
     // check collisions with other surfaces while traversing the "tracked" segment
 #   if 0 // <- might not be ready to delete yet?
@@ -185,20 +328,25 @@ State DriverComplete::operator ()
     auto crossing = triangle.check_for_side_crossing(tracker.location, new_loc);
     if (crossing.side == TriangleSide::k_inside) {
         auto new_tracker_location = tracker.location + tracker.displacement;
-        if (!tracker.segment->contains_point(new_tracker_location)) {
+        if (!triangle.contains_point(new_tracker_location)) {
             triangle.check_for_side_crossing(
                 tracker.location, new_tracker_location);
         }
-        assert(tracker.segment->contains_point(new_tracker_location));
-        return OnSegment{tracker.fragment, tracker.invert_normal,
-                         new_tracker_location, Vector2{}};
+        assert(triangle.contains_point(new_tracker_location));
+        OnSegment rv{tracker};
+        rv.location     = new_tracker_location;
+        rv.displacement = Vector2{};
+        return rv;
     }
 
-    const auto transfer = std::dynamic_pointer_cast<const TriangleLink>
-        (tracker.fragment)->transfers_to(crossing.side);
+    // the tracker's link may have been unloaded with its region, in which
+    // case there's nothing to transfer to
+    const auto * link = TriangleLinkStore::instance().find(tracker.link_id);
+    const auto transfer =
+        link ? link->transfers_to(crossing.side) : TriangleLinkTransfer{};
     constexpr const auto k_caller_name = "DriverComplete::handle_tracker";
     if (!transfer.target()) {
-        auto abgv = env.on_transfer_absent_link(*tracker.segment, crossing, new_loc);
+        auto abgv = env.on_transfer_absent_link(triangle, crossing, new_loc);
         if (auto * disv2 = get_if<Vector2>(&abgv)) {
             OnSegment rv{tracker};
             rv.location     = crossing.inside;
@@ -217,8 +365,8 @@ State DriverComplete::operator ()
 
     auto outside_pt = triangle.point_at(crossing.outside);
     auto stgv = env.on_transfer
-        (*tracker.segment, crossing, transfer.target()->segment(),
-         tracker.segment->point_at(new_loc));
+        (triangle, crossing, transfer.target()->segment(),
+         triangle.point_at(new_loc));
     if (auto * res = get_if<EventHandler::TransferOnSegment>(&stgv)) {
 
         verify_decreasing_displacement<Vector2, Vector2>
@@ -236,7 +384,7 @@ State DriverComplete::operator ()
             std::cout << "on: " << transfer.target()->segment() << std::endl;
 #           endif
             return OnSegment
-                {transfer.target(), new_invert_normal(transfer, tracker),
+                {*transfer.target(), new_invert_normal(transfer, tracker),
                  seg_loc, res->displacement};
         }
         OnSegment rv{tracker};
@@ -256,6 +404,62 @@ State DriverComplete::operator ()
 
 namespace {
 
+template <typename LinkRange>
+Tuple<SharedPtr<const TriangleLink>, LimitIntersection>
+    find_nearest_intersecting
+    (const LinkRange & candidates, const Vector & from, const Vector & to)
+{
+    SharedPtr<const TriangleLink> candidate;
+    LimitIntersection candidate_intx;
+    auto check_candidate = [&] (const SharedPtr<const TriangleLink> & link_ptr) {
+        const auto & triangle = link_ptr->segment();
+
+        auto liminx = triangle.limit_with_intersection(from, to);
+        if (!is_solution(liminx.intersection)) return;
+        if (!candidate) {
+            candidate = link_ptr;
+            candidate_intx = liminx;
+            return;
+        }
+        auto distance = magnitude(liminx.limit - from);
+        auto candidate_distance = magnitude(candidate_intx.limit - from);
+        // exact ties (common on shared edges) must not be settled by which
+        // link the broadphase happened to list first
+        if (   distance < candidate_distance
+            || (   distance == candidate_distance
+                && is_hit_before(triangle, candidate->segment())))
+        {
+            candidate = link_ptr;
+            candidate_intx = liminx;
+        }
+    };
+
+    // candidates are culled a batch at a time; survivors get the exact test
+    // in their original order, so the nearest found is the same as checking
+    // each of them
+    PackedTriangleBatch batch;
+    std::array<const SharedPtr<const TriangleLink> *,
+               PackedTriangleBatch::k_lane_count> batch_links;
+    auto check_batch = [&] {
+        auto hits = batch.possibly_hit_by(from, to);
+        for (int i = 0; i != batch.size(); ++i) {
+            if (hits & (1u << i))
+                { check_candidate(*batch_links[i]); }
+        }
+        batch.clear();
+    };
+    for (auto & entry : candidates) {
+        const auto & link_ptr = link_of(entry);
+        batch_links[batch.size()] = &link_ptr;
+        batch.push(link_ptr->segment());
+        if (batch.is_full())
+            { check_batch(); }
+    }
+    if (!batch.is_empty())
+        { check_batch(); }
+    return make_tuple(candidate, candidate_intx);
+}
+
 template <typename Vec1, typename Vec2>
 void verify_decreasing_displacement
     (EnableIf<cul::VectorTraits<Vec1>::k_is_vector_type, const Vec1 &> displc,
@@ -272,4 +476,14 @@ void verify_decreasing_displacement
     }
 }
 
+bool is_hit_before(const TriangleSegment & lhs, const TriangleSegment & rhs) {
+    auto key_of = [] (const TriangleSegment & triangle) {
+        auto a = triangle.point_a();
+        auto b = triangle.point_b();
+        auto c = triangle.point_c();
+        return std::array<Real, 9>{a.x, a.y, a.z, b.x, b.y, b.z, c.x, c.y, c.z};
+    };
+    return key_of(lhs) < key_of(rhs);
+}
+
 } // end of <anonymous> namespace
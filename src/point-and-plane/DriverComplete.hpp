@@ -33,6 +33,10 @@ namespace point_and_plane {
 // maybe top level it's like a controller
 class DriverComplete final : public Driver {
 public:
+    DriverComplete() {}
+
+    explicit DriverComplete(BroadphaseType);
+
     void add_triangle(const SharedPtr<const TriangleLink> &) final;
 
     void remove_triangle(const SharedPtr<const TriangleLink> &) final;
@@ -43,13 +47,38 @@ public:
 
     State operator () (const State &, const EventHandler &) const final;
 
+    /// bodies near each other (in the same group cell) share one broadphase
+    /// query; groups are divided among threads
+    void step_all(const View<BodyStep *> &, int thread_count = 1) const final;
+
 private:
+    using LinkContainer =
+        Variant<FrameTimeLinkContainer, FrameTimeLinkGrid, FrameTimeLinkTree>;
+    using LinkPointers = std::vector<const SharedPtr<const TriangleLink> *>;
+
+    /// links near a group of bodies, queried once for all of them
+    struct SharedCandidates final {
+        BoundingBox bounds;
+        LinkPointers links;
+    };
+
+    /// width of the cells bodies are grouped by, when stepped together
+    static constexpr const Real k_group_cell_size = 4;
+
+    static LinkContainer make_link_container(BroadphaseType);
+
+    State step(const State &, const EventHandler &,
+               const SharedCandidates *) const;
+
+    void step_group(const View<BodyStep *> & group) const;
+
     // the job of each method here is to reduce displacement
-    State handle_freebody(const InAir &, const EventHandler &) const;
+    State handle_freebody(const InAir &, const EventHandler &,
+                          const SharedCandidates *) const;
 
     State handle_tracker(const OnSegment &, const EventHandler &) const;
 
-    FrameTimeLinkContainer m_frametime_link_container;
+    LinkContainer m_frametime_link_container;
 };
 
 } // end of point_and_plane namespace
@@ -0,0 +1,231 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "DynamicSpatialPartitionMap.hpp"
+
+namespace {
+
+using Interval = ProjectionLine::Interval;
+using Iterator = DynamicSpatialPartitionMap::Iterator;
+using BucketIterator = DynamicSpatialPartitionMap::BucketIterator;
+using Element = DynamicSpatialPartitionMap::Element;
+using EntryContainer = DynamicSpatialPartitionMap::EntryContainer;
+
+} // end of <anonymous> namespace
+
+DynamicSpatialPartitionMap::Iterator::Iterator
+    (BucketIterator bucket_, BucketIterator bucket_end_):
+    m_bucket(bucket_),
+    m_bucket_end(bucket_end_)
+{
+    if (m_bucket != m_bucket_end)
+        { m_itr = m_bucket->begin(); }
+    skip_empty_buckets();
+}
+
+Iterator & DynamicSpatialPartitionMap::Iterator::operator ++ () {
+    ++m_itr;
+    skip_empty_buckets();
+    return *this;
+}
+
+bool DynamicSpatialPartitionMap::Iterator::operator ==
+    (const Iterator & rhs) const
+{
+    if (m_bucket != rhs.m_bucket) return false;
+    // all end iterators are equal, regardless of entry iterator
+    if (m_bucket == m_bucket_end) return true;
+    return m_itr == rhs.m_itr;
+}
+
+/* private */ void DynamicSpatialPartitionMap::Iterator::skip_empty_buckets() {
+    while (m_bucket != m_bucket_end && m_itr == m_bucket->end()) {
+        if (++m_bucket == m_bucket_end) break;
+        m_itr = m_bucket->begin();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+DynamicSpatialPartitionMap::DynamicSpatialPartitionMap()
+    { clear(); }
+
+DynamicSpatialPartitionMap::DynamicSpatialPartitionMap
+    (const EntryContainer & sorted_entries)
+    { populate(sorted_entries); }
+
+void DynamicSpatialPartitionMap::clear() {
+    populate(EntryContainer{});
+}
+
+std::vector<Element> DynamicSpatialPartitionMap::elements() const {
+    std::vector<Element> rv;
+    rv.reserve(m_entry_count);
+    for (std::size_t idx = 0; idx != m_buckets.size(); ++idx) {
+        for (auto & entry : m_buckets[idx]) {
+            // only the bucket containing the interval's start "owns" it
+            if (bucket_index_for(entry.interval.min) != idx) continue;
+            rv.push_back(entry.element);
+        }
+    }
+    return rv;
+}
+
+bool DynamicSpatialPartitionMap::erase(const Entry & entry) {
+    bool found = false;
+    for_each_bucket_in(entry.interval, [&entry, &found] (Bucket & bucket) {
+        auto itr = std::find_if
+            (bucket.begin(), bucket.end(),
+             [&entry] (const Entry & other)
+             { return other.element == entry.element; });
+        if (itr == bucket.end()) return;
+        // order within a bucket does not matter
+        *itr = std::move(bucket.back());
+        bucket.pop_back();
+        found = true;
+    });
+    if (found) {
+        --m_entry_count;
+        ++m_changes_since_populate;
+    }
+    return found;
+}
+
+void DynamicSpatialPartitionMap::insert(const Entry & entry) {
+    for_each_bucket_in(entry.interval, [&entry] (Bucket & bucket)
+        { bucket.push_back(entry); });
+    ++m_entry_count;
+    ++m_changes_since_populate;
+}
+
+bool DynamicSpatialPartitionMap::needs_rebalance() const {
+    auto changes_needed = std::max
+        (k_min_changes_before_rebalance,
+         std::size_t(k_change_ratio_before_rebalance*Real(m_entry_count)));
+    if (m_changes_since_populate < changes_needed)
+        { return false; }
+    return is_unbalanced();
+}
+
+void DynamicSpatialPartitionMap::populate
+    (const EntryContainer & sorted_entries)
+{
+    if (!Helpers::is_sorted(sorted_entries))
+        { throw InvalidArgument{"entries must be sorted"}; }
+
+    auto divisions = Helpers::compute_divisions
+        (sorted_entries, m_target_occupancy);
+    // last division is always at infinity, and only marks the end
+    m_bucket_starts.assign(divisions.begin(), divisions.end() - 1);
+    m_coarse_level.build
+        (m_bucket_starts.begin(), m_bucket_starts.end(),
+         [] (Real position) { return position; });
+    m_buckets.clear();
+    m_buckets.resize(m_bucket_starts.size());
+    m_entry_count = 0;
+    for (auto & entry : sorted_entries) {
+        for_each_bucket_in(entry.interval, [&entry] (Bucket & bucket)
+            { bucket.push_back(entry); });
+        ++m_entry_count;
+    }
+    m_changes_since_populate = 0;
+}
+
+View<Iterator> DynamicSpatialPartitionMap::view_for
+    (const Interval & interval) const
+{
+    auto beg = m_buckets.begin() + bucket_index_for(interval.min);
+    auto end = m_buckets.begin() + bucket_index_for(interval.max) + 1;
+    return View{Iterator{beg, end}, Iterator{end, end}};
+}
+
+/* private */ std::size_t DynamicSpatialPartitionMap::bucket_index_for
+    (Real position) const
+{
+    assert(!m_bucket_starts.empty());
+    // first bucket, whose start is after position; we want the one before it
+    // (the first bucket extends all the way to negative infinity)
+    auto [first, last] = m_coarse_level.is_empty() ?
+        make_tuple(std::size_t(0), m_bucket_starts.size()) :
+        m_coarse_level.slice_for_upper_bound(position, m_bucket_starts.size());
+    auto itr = std::upper_bound
+        (m_bucket_starts.begin() + first, m_bucket_starts.begin() + last,
+         position);
+    if (itr == m_bucket_starts.begin())
+        { return 0; }
+    return (itr - m_bucket_starts.begin()) - 1;
+}
+
+/* private */ bool DynamicSpatialPartitionMap::is_unbalanced() const {
+    auto limit = Real(m_target_occupancy)*k_unbalanced_bucket_factor;
+    return std::any_of
+        (m_buckets.begin(), m_buckets.end(),
+         [limit] (const Bucket & bucket) { return Real(bucket.size()) > limit; });
+}
+
+// ----------------------------------------------------------------------------
+
+void DynamicProjectedSpatialMap::clear() {
+    m_spatial_map.clear();
+    m_projection_line = ProjectionLine{Vector{}, k_east};
+}
+
+bool DynamicProjectedSpatialMap::erase(const Element & link) {
+    using Entry = DynamicSpatialPartitionMap::Entry;
+    return m_spatial_map.erase
+        (Entry{m_projection_line.interval_for(link->segment()), link});
+}
+
+void DynamicProjectedSpatialMap::insert(const Element & link) {
+    using Entry = DynamicSpatialPartitionMap::Entry;
+    m_spatial_map.insert
+        (Entry{m_projection_line.interval_for(link->segment()), link});
+}
+
+void DynamicProjectedSpatialMap::rebalance_if_needed() {
+    if (m_spatial_map.needs_rebalance())
+        { rebalance(); }
+}
+
+View<DynamicProjectedSpatialMap::Iterator>
+    DynamicProjectedSpatialMap::view_for
+    (const Vector & a, const Vector & b) const
+{
+    auto points_interval = m_projection_line.interval_for(a, b);
+    return m_spatial_map.view_for(points_interval);
+}
+
+View<DynamicProjectedSpatialMap::Iterator>
+    DynamicProjectedSpatialMap::view_for(const BoundingBox & box) const
+    { return m_spatial_map.view_for(m_projection_line.interval_for(box)); }
+
+/* private */ void DynamicProjectedSpatialMap::rebalance() {
+    auto links = m_spatial_map.elements();
+    m_projection_line = ProjectedSpatialMap::make_line_for(links);
+
+    EntryContainer entries;
+    entries.reserve(links.size());
+    for (auto & link : links) {
+        entries.emplace_back
+            (m_projection_line.interval_for(link->segment()), link);
+    }
+    Helpers::sort_entries_container(entries);
+    m_spatial_map.populate(entries);
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "SpatialPartitionMap.hpp"
+
+/** A spatial partition map which entries maybe added and removed from without
+ *  repopulating the whole map.
+ *
+ *  Each entry is placed into every bucket its interval overlaps. Insertions
+ *  and removals only touch those buckets. Divisions are left as they are
+ *  until enough changes have accumulated to pay for a full rebalance.
+ */
+class DynamicSpatialPartitionMap final {
+public:
+    using Interval = ProjectionLine::Interval;
+    using Element = SpatialPartitionMap::Element;
+    using Helpers = SpatialPartitionMap::Helpers;
+    using Entry = Helpers::Entry;
+    using EntryContainer = Helpers::EntryContainer;
+    using EntryIterator = Helpers::EntryIterator;
+    using Bucket = EntryContainer;
+    using BucketIterator = std::vector<Bucket>::const_iterator;
+
+    /// a bucket is unbalanced if it holds this many times more entries than
+    /// the target occupancy
+    static constexpr const Real k_unbalanced_bucket_factor = 2;
+
+    /// rebalancing is considered only after this portion of all entries have
+    /// been inserted/removed since the last rebalance
+    static constexpr const Real k_change_ratio_before_rebalance = 0.5;
+
+    static constexpr const std::size_t k_min_changes_before_rebalance = 16;
+
+    class Iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = int;
+        using value_type = Element;
+        using reference = const Element &;
+        using pointer = const Element *;
+
+        Iterator() {}
+
+        Iterator(BucketIterator bucket_, BucketIterator bucket_end_);
+
+        const Element & operator * () const { return m_itr->element; }
+
+        const Element * operator -> () const { return &m_itr->element; }
+
+        Iterator & operator ++ ();
+
+        bool operator != (const Iterator & rhs) const
+            { return !(*this == rhs); }
+
+        bool operator == (const Iterator & rhs) const;
+
+    private:
+        void skip_empty_buckets();
+
+        BucketIterator m_bucket, m_bucket_end;
+        EntryIterator m_itr;
+    };
+
+    DynamicSpatialPartitionMap();
+
+    explicit DynamicSpatialPartitionMap(const EntryContainer & sorted_entries);
+
+    void clear();
+
+    std::size_t count() const noexcept { return m_entry_count; }
+
+    /// @returns each element in this map, exactly once (unless inserted more
+    ///          than once)
+    std::vector<Element> elements() const;
+
+    /// @returns true if the given entry was found (and removed)
+    bool erase(const Entry &);
+
+    void insert(const Entry &);
+
+    bool needs_rebalance() const;
+
+    /// rebuilds divisions and all buckets
+    void populate(const EntryContainer & sorted_entries);
+
+    /// takes effect on the next populate
+    void set_target_occupancy(std::size_t target_occupancy)
+        { m_target_occupancy = target_occupancy; }
+
+    View<Iterator> view_for(const Interval &) const;
+
+private:
+    template <typename Func>
+    void for_each_bucket_in(const Interval &, Func &&);
+
+    std::size_t bucket_index_for(Real) const;
+
+    bool is_unbalanced() const;
+
+    std::vector<Real> m_bucket_starts;
+    CoarseDivisionLevel m_coarse_level;
+    std::vector<Bucket> m_buckets;
+    std::size_t m_target_occupancy = Helpers::k_default_target_occupancy;
+    std::size_t m_entry_count = 0;
+    std::size_t m_changes_since_populate = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+/** Projects triangle links onto a line before placing them into a dynamic
+ *  spatial partition map.
+ *
+ *  The projection line is only recomputed when the map is rebalanced.
+ */
+class DynamicProjectedSpatialMap final {
+public:
+    using TriangleLinks = ProjectedSpatialMap::TriangleLinks;
+    using Element = DynamicSpatialPartitionMap::Element;
+    using Iterator = DynamicSpatialPartitionMap::Iterator;
+    using Helpers = DynamicSpatialPartitionMap::Helpers;
+
+    DynamicProjectedSpatialMap() {}
+
+    void clear();
+
+    std::size_t count() const noexcept { return m_spatial_map.count(); }
+
+    /// @returns true if the given link was present in the map
+    bool erase(const Element &);
+
+    void insert(const Element &);
+
+    /// rebalances only if enough changes have accumulated to warrant it
+    void rebalance_if_needed();
+
+    void set_target_occupancy(std::size_t target_occupancy)
+        { m_spatial_map.set_target_occupancy(target_occupancy); }
+
+    View<Iterator> view_for(const Vector &, const Vector &) const;
+
+    View<Iterator> view_for(const BoundingBox &) const;
+
+private:
+    void rebalance();
+
+    DynamicSpatialPartitionMap m_spatial_map;
+    ProjectionLine m_projection_line = ProjectionLine{Vector{}, k_east};
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename Func>
+/* private */ void DynamicSpatialPartitionMap::for_each_bucket_in
+    (const Interval & interval, Func && f)
+{
+    auto last = bucket_index_for(interval.max);
+    for (auto idx = bucket_index_for(interval.min); idx <= last; ++idx) {
+        f(m_buckets[idx]);
+    }
+}
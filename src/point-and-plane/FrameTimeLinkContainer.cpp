@@ -22,74 +22,76 @@
 #include "../Configuration.hpp"
 
 #include <iostream>
+#include <unordered_map>
 
 namespace {
 
-using Iterator = FrameTimeLinkContainer::Iterator;
-
 constexpr const bool k_report_triangle_drops =
     k_report_physics_driver_dropping_triangles;
 
 } // end of <anonymous> namespace
 
-void FrameTimeLinkContainer::defer_addition_of
+void FrameTimeLinkContainerBase::defer_addition_of
     (const SharedPtr<const TriangleLink> & ptr)
 {
-    m_to_add_links.push_back(ptr);
-    m_add_dirty = true;
+    m_changes.push_back(DeferredChange{ptr, true});
 }
 
-void FrameTimeLinkContainer::defer_removal_of
+void FrameTimeLinkContainerBase::defer_removal_of
     (const SharedPtr<const TriangleLink> & ptr)
 {
-    m_to_remove_links.push_back(ptr);
+    m_changes.push_back(DeferredChange{ptr, false});
 }
 
-void FrameTimeLinkContainer::update() {
-    if (!m_to_remove_links.empty()) {
-        // TODO: this bit doesn't work
-        std::sort(m_to_remove_links.begin(), m_to_remove_links.end());
-        std::sort(m_to_add_links.begin(), m_to_add_links.end());
-        auto rem_itr = m_to_remove_links.begin();
-        auto rem_end = m_to_remove_links.end();
-        auto add_itr = m_to_add_links.begin();
-        auto add_end = m_to_add_links.end();
-        for (; rem_itr != rem_end && add_itr != add_end; ++add_itr) {
-            if (*rem_itr == *add_itr) {
-                *add_itr = nullptr;
-                ++rem_itr;
-            }
-        }
-        m_add_dirty = true;
-        std::size_t old_size = m_to_add_links.size();
-        m_to_add_links.erase
-            (std::remove(m_to_add_links.begin(), m_to_add_links.end(), nullptr),
-             m_to_add_links.end());
-        m_to_remove_links.clear();
-        if constexpr (k_report_triangle_drops) {
-            std::cout << (old_size - m_to_add_links.size())
-                      << " triangles dropped" << std::endl;
-        }
-    }
+/* protected */ void FrameTimeLinkContainerBase::check_not_dirty
+    (const char * caller) const
+{
+    if (!is_dirty()) return;
+    throw RuntimeError
+        {std::string{caller} + ": update must be called first"};
+}
 
-    if (m_add_dirty) {
-        m_spm.populate(m_to_add_links);
-        m_add_dirty = false;
-    }
+/* protected */ void FrameTimeLinkContainerBase::clear_changes() {
+    m_changes.clear();
 }
 
-View<Iterator> FrameTimeLinkContainer::view_for
-    (const Vector & a, const Vector & b) const
+/* private */ Tuple<FrameTimeLinkContainerBase::LinkPtrs,
+                    FrameTimeLinkContainerBase::LinkPtrs>
+    FrameTimeLinkContainerBase::net_changes() const
 {
-    if (!is_dirty())
-        { return m_spm.view_for(a, b); }
-    throw RuntimeError
-        {"FrameTimeLinkContainer::view_for: update must be called first"};
+    struct FirstAndLast final {
+        bool first_is_addition = false;
+        std::size_t last = 0;
+    };
+    // changes to a link alternate between adding and removing it, so only
+    // the first and last say what's changed
+    std::unordered_map<const TriangleLink *, FirstAndLast> first_and_lasts;
+    first_and_lasts.reserve(m_changes.size());
+    for (std::size_t i = 0; i != m_changes.size(); ++i) {
+        const auto & change = m_changes[i];
+        auto [itr, is_new] = first_and_lasts.try_emplace
+            (change.link.get(), FirstAndLast{change.is_addition, i});
+        if (!is_new)
+            { itr->second.last = i; }
+    }
+    LinkPtrs to_remove, to_add;
+    for (std::size_t i = 0; i != m_changes.size(); ++i) {
+        const auto & change = m_changes[i];
+        const auto & first_and_last = first_and_lasts[change.link.get()];
+        if (   first_and_last.last != i
+            || first_and_last.first_is_addition != change.is_addition)
+        { continue; }
+        (change.is_addition ? to_add : to_remove).push_back(change.link);
+    }
+    return make_tuple(std::move(to_remove), std::move(to_add));
 }
 
-void FrameTimeLinkContainer::clear() {
-    m_to_add_links.clear();
-    m_to_remove_links.clear();
-    // v can this accept empty containers?
-    m_spm.populate(m_to_add_links);
+/* private */ void FrameTimeLinkContainerBase::report_drops
+    (std::size_t removed_count) const
+{
+    if constexpr (k_report_triangle_drops) {
+        if (removed_count != 0) {
+            std::cout << removed_count << " triangles dropped" << std::endl;
+        }
+    }
 }
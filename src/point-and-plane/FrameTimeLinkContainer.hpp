@@ -21,28 +21,113 @@
 #pragma once
 
 #include "../TriangleLink.hpp"
-#include "SpatialPartitionMap.hpp"
+#include "DynamicSpatialPartitionMap.hpp"
+#include "HashedLinkGrid.hpp"
+#include "LinkBoundingBoxTree.hpp"
 
-class FrameTimeLinkContainer final {
+/** Holds onto triangle links added/removed while a frame is running, and
+ *  applies those changes all at once, at the start of the next frame.
+ *
+ *  Changes are applied to the underlying spatial map incrementally, so the
+ *  cost of an update is proportional to the number of links changed rather
+ *  than the number of links present.
+ */
+class FrameTimeLinkContainerBase {
 public:
-    using Iterator = ProjectedSpatialMap::Iterator;
-
     void defer_addition_of(const SharedPtr<const TriangleLink> &);
 
     void defer_removal_of(const SharedPtr<const TriangleLink> &);
 
-    void update();
+protected:
+    FrameTimeLinkContainerBase() {}
+
+    ~FrameTimeLinkContainerBase() {}
+
+    /// A spatial map is any type with insert, erase, rebalance_if_needed,
+    /// clear, and view_for (between two points, and for a box) members
+    template <typename SpatialMap>
+    void apply_changes_to(SpatialMap &);
 
-    View<Iterator> view_for(const Vector &, const Vector &) const;
+    void check_not_dirty(const char * caller) const;
 
-    void clear();
+    void clear_changes();
 
 private:
-    bool is_dirty() const noexcept
-        { return m_add_dirty || !m_to_remove_links.empty(); }
+    using LinkPtrs = std::vector<SharedPtr<const TriangleLink>>;
+
+    struct DeferredChange final {
+        SharedPtr<const TriangleLink> link;
+        bool is_addition = false;
+    };
+
+    bool is_dirty() const noexcept { return !m_changes.empty(); }
+
+    /// changes to the same link cancel out if they leave it where it was
+    /// (removed then re-added, or added then removed)
+    ///
+    /// @returns links to remove, and links to add
+    Tuple<LinkPtrs, LinkPtrs> net_changes() const;
+
+    void report_drops(std::size_t removed_count) const;
+
+    // in the order they were deferred
+    std::vector<DeferredChange> m_changes;
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename SpatialMap>
+class FrameTimeLinkContainerOf final : public FrameTimeLinkContainerBase {
+public:
+    using Iterator = typename SpatialMap::Iterator;
+
+    void update()
+        { apply_changes_to(m_spm); }
+
+    View<Iterator> view_for(const Vector & a, const Vector & b) const {
+        check_not_dirty("FrameTimeLinkContainer::view_for");
+        return m_spm.view_for(a, b);
+    }
 
-    std::vector<SharedPtr<const TriangleLink>> m_to_add_links;
-    std::vector<SharedPtr<const TriangleLink>> m_to_remove_links;
-    bool m_add_dirty = false;
-    ProjectedSpatialMap m_spm;
+    /// @returns view of (at least) every link, which overlaps the box
+    View<Iterator> view_for(const BoundingBox & box) const {
+        check_not_dirty("FrameTimeLinkContainer::view_for");
+        return m_spm.view_for(box);
+    }
+
+    void clear() {
+        clear_changes();
+        m_spm.clear();
+    }
+
+private:
+    SpatialMap m_spm;
 };
+
+/// projects links onto a line, good for maps sprawling along one direction
+using FrameTimeLinkContainer = FrameTimeLinkContainerOf<DynamicProjectedSpatialMap>;
+
+using FrameTimeLinkGrid = FrameTimeLinkContainerOf<HashedLinkGrid>;
+
+using FrameTimeLinkTree = FrameTimeLinkContainerOf<LinkBoundingBoxTree>;
+
+// ----------------------------------------------------------------------------
+
+template <typename SpatialMap>
+/* protected */ void FrameTimeLinkContainerBase::apply_changes_to
+    (SpatialMap & spatial_map)
+{
+    // a link removed and re-added (as a revived region's are) stays, and one
+    // added and removed on the same frame never goes in, as both cancel out
+    auto [to_remove, to_add] = net_changes();
+    std::size_t removed_count = 0;
+    for (auto & link : to_remove) {
+        if (spatial_map.erase(link))
+            { ++removed_count; }
+    }
+    for (auto & link : to_add)
+        { spatial_map.insert(link); }
+    report_drops(removed_count);
+    clear_changes();
+    spatial_map.rebalance_if_needed();
+}
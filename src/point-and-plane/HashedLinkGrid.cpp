@@ -0,0 +1,142 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "HashedLinkGrid.hpp"
+
+namespace {
+
+using CellPosition = HashedLinkGrid::CellPosition;
+using CellMap = HashedLinkGrid::CellMap;
+using Iterator = HashedLinkGrid::Iterator;
+
+} // end of <anonymous> namespace
+
+std::size_t HashedLinkGrid::CellPositionHasher::operator ()
+    (const CellPosition & r) const noexcept
+{
+    // large primes, so that neighboring cells do not collide with each other
+    // (as an xor of each component would)
+    auto ux = std::size_t(unsigned(r.x));
+    auto uy = std::size_t(unsigned(r.y));
+    auto uz = std::size_t(unsigned(r.z));
+    return (ux*73856093u) ^ (uy*19349663u) ^ (uz*83492791u);
+}
+
+// ----------------------------------------------------------------------------
+
+HashedLinkGrid::Iterator::Iterator
+    (const CellMap & cells, const CellPosition & low, const CellPosition & high):
+    m_cells(&cells),
+    m_low(low),
+    m_high(high),
+    m_position(low)
+{ seek_occupied_cell(); }
+
+Iterator & HashedLinkGrid::Iterator::operator ++ () {
+    if (++m_index < m_cell->size())
+        { return *this; }
+    advance_position();
+    seek_occupied_cell();
+    return *this;
+}
+
+/* private */ void HashedLinkGrid::Iterator::advance_position() {
+    if (++m_position.x <= m_high.x) return;
+    m_position.x = m_low.x;
+    if (++m_position.y <= m_high.y) return;
+    m_position.y = m_low.y;
+    ++m_position.z;
+}
+
+/* private */ void HashedLinkGrid::Iterator::seek_occupied_cell() {
+    m_cell = nullptr;
+    m_index = 0;
+    for (; m_position.z <= m_high.z; advance_position()) {
+        auto itr = m_cells->find(m_position);
+        if (itr == m_cells->end() || itr->second.empty()) continue;
+        m_cell = &itr->second;
+        return;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+HashedLinkGrid::HashedLinkGrid(Real cell_size):
+    m_cell_size(cell_size)
+{
+    if (cell_size > 0) return;
+    throw InvalidArgument
+        {"HashedLinkGrid::HashedLinkGrid: cell size must be positive"};
+}
+
+void HashedLinkGrid::clear() {
+    m_cells.clear();
+    m_count = 0;
+}
+
+bool HashedLinkGrid::erase(const Element & link) {
+    bool found = false;
+    for_each_cell_position_in
+        (BoundingBox::make_for(link->segment()),
+         [this, &link, &found] (const CellPosition & r)
+    {
+        auto cell_itr = m_cells.find(r);
+        if (cell_itr == m_cells.end()) return;
+        auto & cell = cell_itr->second;
+        auto itr = std::find(cell.begin(), cell.end(), link);
+        if (itr == cell.end()) return;
+        // order within a cell does not matter
+        *itr = std::move(cell.back());
+        cell.pop_back();
+        if (cell.empty())
+            { m_cells.erase(cell_itr); }
+        found = true;
+    });
+    if (found)
+        { --m_count; }
+    return found;
+}
+
+void HashedLinkGrid::insert(const Element & link) {
+    for_each_cell_position_in
+        (BoundingBox::make_for(link->segment()),
+         [this, &link] (const CellPosition & r)
+         { m_cells[r].push_back(link); });
+    ++m_count;
+}
+
+View<Iterator> HashedLinkGrid::view_for
+    (const Vector & a, const Vector & b) const
+    { return view_for(BoundingBox{a, b}); }
+
+View<Iterator> HashedLinkGrid::view_for(const BoundingBox & box) const {
+    return View{Iterator{m_cells, cell_position_of(box.low),
+                         cell_position_of(box.high)},
+                Iterator{}};
+}
+
+/* private */ CellPosition HashedLinkGrid::cell_position_of
+    (const Vector & r) const
+{
+    return CellPosition
+        {int(std::floor(r.x / m_cell_size)),
+         int(std::floor(r.y / m_cell_size)),
+         int(std::floor(r.z / m_cell_size))};
+}
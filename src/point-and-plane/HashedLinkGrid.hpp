@@ -0,0 +1,141 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "BoundingBox.hpp"
+
+#include "../TriangleLink.hpp"
+
+#include <unordered_map>
+
+/** A uniform 3D grid of cells, of which only occupied cells are stored (in a
+ *  hash table).
+ *
+ *  Each link is placed into every cell its bounding box overlaps. Unlike the
+ *  projected spatial map, this does not collapse any axis, so maps sprawling
+ *  in several directions do not return far away links.
+ */
+class HashedLinkGrid final {
+public:
+    using Element = SharedPtr<const TriangleLink>;
+    using Cell = std::vector<Element>;
+
+    struct CellPosition final {
+        CellPosition() {}
+
+        CellPosition(int x_, int y_, int z_):
+            x(x_), y(y_), z(z_) {}
+
+        bool operator == (const CellPosition & rhs) const noexcept
+            { return x == rhs.x && y == rhs.y && z == rhs.z; }
+
+        int x = 0, y = 0, z = 0;
+    };
+
+    struct CellPositionHasher final {
+        std::size_t operator () (const CellPosition &) const noexcept;
+    };
+
+    using CellMap = std::unordered_map<CellPosition, Cell, CellPositionHasher>;
+
+    static constexpr const Real k_default_cell_size = 2;
+
+    class Iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = int;
+        using value_type = Element;
+        using reference = const Element &;
+        using pointer = const Element *;
+
+        Iterator() {}
+
+        Iterator(const CellMap &, const CellPosition & low,
+                 const CellPosition & high);
+
+        const Element & operator * () const { return (*m_cell)[m_index]; }
+
+        const Element * operator -> () const { return &(*m_cell)[m_index]; }
+
+        Iterator & operator ++ ();
+
+        bool operator != (const Iterator & rhs) const
+            { return !(*this == rhs); }
+
+        bool operator == (const Iterator & rhs) const
+            { return m_cell == rhs.m_cell && m_index == rhs.m_index; }
+
+    private:
+        void advance_position();
+
+        void seek_occupied_cell();
+
+        const CellMap * m_cells = nullptr;
+        CellPosition m_low, m_high, m_position;
+        const Cell * m_cell = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    HashedLinkGrid() {}
+
+    explicit HashedLinkGrid(Real cell_size);
+
+    void clear();
+
+    std::size_t count() const noexcept { return m_count; }
+
+    /// @returns true if the given link was present in the grid
+    bool erase(const Element &);
+
+    void insert(const Element &);
+
+    /// grids have nothing to rebalance
+    void rebalance_if_needed() {}
+
+    View<Iterator> view_for(const Vector &, const Vector &) const;
+
+    View<Iterator> view_for(const BoundingBox &) const;
+
+private:
+    CellPosition cell_position_of(const Vector &) const;
+
+    template <typename Func>
+    void for_each_cell_position_in(const BoundingBox &, Func &&) const;
+
+    Real m_cell_size = k_default_cell_size;
+    CellMap m_cells;
+    std::size_t m_count = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename Func>
+/* private */ void HashedLinkGrid::for_each_cell_position_in
+    (const BoundingBox & box, Func && f) const
+{
+    auto low  = cell_position_of(box.low );
+    auto high = cell_position_of(box.high);
+    for (int z = low.z; z <= high.z; ++z) {
+    for (int y = low.y; y <= high.y; ++y) {
+    for (int x = low.x; x <= high.x; ++x) {
+        f(CellPosition{x, y, z});
+    }}}
+}
@@ -0,0 +1,293 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "LinkBoundingBoxTree.hpp"
+
+namespace {
+
+using Node = LinkBoundingBoxTree::Node;
+using Iterator = LinkBoundingBoxTree::Iterator;
+
+constexpr const auto k_no_node = LinkBoundingBoxTree::k_no_node;
+
+Real component_of(const Vector & r, int axis);
+
+} // end of <anonymous> namespace
+
+LinkBoundingBoxTree::Iterator::Iterator
+    (const std::vector<Node> & nodes, int root, const BoundingBox & query):
+    m_nodes(&nodes),
+    m_root(root),
+    m_query(query)
+{ m_node = seek_leaf_from(root); }
+
+Iterator & LinkBoundingBoxTree::Iterator::operator ++ () {
+    m_node = seek_leaf_from(next_subtree_after(m_node));
+    return *this;
+}
+
+/* private */ int LinkBoundingBoxTree::Iterator::next_subtree_after
+    (int node) const
+{
+    const auto & nodes = *m_nodes;
+    while (node != m_root) {
+        auto parent = nodes[node].parent;
+        if (nodes[parent].child_a == node)
+            { return nodes[parent].child_b; }
+        node = parent;
+    }
+    return k_no_node;
+}
+
+/* private */ int LinkBoundingBoxTree::Iterator::seek_leaf_from
+    (int node) const
+{
+    const auto & nodes = *m_nodes;
+    while (node != k_no_node) {
+        const auto & current = nodes[node];
+        if (!current.box.overlaps(m_query)) {
+            node = next_subtree_after(node);
+        } else if (current.is_leaf()) {
+            return node;
+        } else {
+            node = current.child_a;
+        }
+    }
+    return k_no_node;
+}
+
+// ----------------------------------------------------------------------------
+
+void LinkBoundingBoxTree::clear() {
+    m_nodes.clear();
+    m_free_nodes.clear();
+    m_leaves.clear();
+    m_root = k_no_node;
+}
+
+bool LinkBoundingBoxTree::erase(const Element & link) {
+    auto itr = m_leaves.find(link.get());
+    if (itr == m_leaves.end())
+        { return false; }
+    auto leaf = itr->second;
+    m_leaves.erase(itr);
+    remove_leaf(leaf);
+    free_node(leaf);
+    return true;
+}
+
+int LinkBoundingBoxTree::height() const
+    { return m_root == k_no_node ? -1 : m_nodes[m_root].height; }
+
+void LinkBoundingBoxTree::insert(const Element & link) {
+    auto leaf = allocate_node();
+    m_nodes[leaf].box = BoundingBox::make_for(link->segment());
+    m_nodes[leaf].element = link;
+    m_leaves.emplace(link.get(), leaf);
+    insert_leaf(leaf);
+}
+
+void LinkBoundingBoxTree::rebalance_if_needed() {
+    if (count() < 2) return;
+    // a balanced tree is about log2(n) tall, allow a generous margin, as
+    // rebuilding is costly
+    auto limit = 2*int(std::ceil(std::log2(Real(count())))) + 4;
+    if (height() > limit)
+        { rebuild(); }
+}
+
+View<Iterator> LinkBoundingBoxTree::view_for
+    (const Vector & a, const Vector & b) const
+    { return view_for(BoundingBox{a, b}); }
+
+View<Iterator> LinkBoundingBoxTree::view_for(const BoundingBox & box) const
+    { return View{Iterator{m_nodes, m_root, box}, Iterator{}}; }
+
+/* private */ int LinkBoundingBoxTree::allocate_node() {
+    if (m_free_nodes.empty()) {
+        m_nodes.emplace_back();
+        return int(m_nodes.size()) - 1;
+    }
+    auto node = m_free_nodes.back();
+    m_free_nodes.pop_back();
+    return node;
+}
+
+/* private */ int LinkBoundingBoxTree::build_subtree
+    (std::vector<int>::iterator beg, std::vector<int>::iterator end)
+{
+    assert(beg != end);
+    if (end - beg == 1)
+        { return *beg; }
+
+    // split at the median along the axis where centers are most spread out
+    BoundingBox centers{m_nodes[*beg].box.center(), m_nodes[*beg].box.center()};
+    for (auto itr = beg; itr != end; ++itr) {
+        centers = centers.expanded_to(m_nodes[*itr].box.center());
+    }
+    auto extent = centers.high - centers.low;
+    int axis = 0;
+    if (extent.y > component_of(extent, axis)) axis = 1;
+    if (extent.z > component_of(extent, axis)) axis = 2;
+
+    auto mid = beg + (end - beg) / 2;
+    std::nth_element(beg, mid, end, [this, axis] (int lhs, int rhs) {
+        return   component_of(m_nodes[lhs].box.center(), axis)
+               < component_of(m_nodes[rhs].box.center(), axis);
+    });
+    auto child_a = build_subtree(beg, mid);
+    auto child_b = build_subtree(mid, end);
+    auto node = allocate_node();
+    m_nodes[node].child_a = child_a;
+    m_nodes[node].child_b = child_b;
+    m_nodes[child_a].parent = node;
+    m_nodes[child_b].parent = node;
+    refit_from(node);
+    return node;
+}
+
+/* private */ int LinkBoundingBoxTree::find_best_sibling
+    (const BoundingBox & box) const
+{
+    // descend toward whichever child's box grows the least
+    auto node = m_root;
+    while (!m_nodes[node].is_leaf()) {
+        const auto & current = m_nodes[node];
+        auto area = current.box.surface_area();
+        auto combined_area =
+            BoundingBox::make_union(current.box, box).surface_area();
+        // cost of making a new parent for this node and the new leaf
+        auto cost = 2*combined_area;
+        // cost of pushing the leaf further down
+        auto inherited_cost = 2*(combined_area - area);
+        auto child_cost = [this, &box, inherited_cost] (int child) {
+            const auto & child_box = m_nodes[child].box;
+            auto union_area = BoundingBox::make_union(child_box, box).surface_area();
+            if (m_nodes[child].is_leaf())
+                { return union_area + inherited_cost; }
+            return union_area - child_box.surface_area() + inherited_cost;
+        };
+        auto cost_a = child_cost(current.child_a);
+        auto cost_b = child_cost(current.child_b);
+        if (cost < cost_a && cost < cost_b)
+            { break; }
+        node = cost_a < cost_b ? current.child_a : current.child_b;
+    }
+    return node;
+}
+
+/* private */ void LinkBoundingBoxTree::free_node(int node) {
+    m_nodes[node] = Node{};
+    m_free_nodes.push_back(node);
+}
+
+/* private */ void LinkBoundingBoxTree::insert_leaf(int leaf) {
+    if (m_root == k_no_node) {
+        m_root = leaf;
+        m_nodes[leaf].parent = k_no_node;
+        return;
+    }
+    auto sibling = find_best_sibling(m_nodes[leaf].box);
+    auto old_parent = m_nodes[sibling].parent;
+    // careful: allocation may invalidate any references to nodes
+    auto new_parent = allocate_node();
+    m_nodes[new_parent].parent  = old_parent;
+    m_nodes[new_parent].child_a = sibling;
+    m_nodes[new_parent].child_b = leaf;
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf   ].parent = new_parent;
+    if (old_parent == k_no_node) {
+        m_root = new_parent;
+    } else if (m_nodes[old_parent].child_a == sibling) {
+        m_nodes[old_parent].child_a = new_parent;
+    } else {
+        m_nodes[old_parent].child_b = new_parent;
+    }
+    refit_from(new_parent);
+}
+
+/* private */ void LinkBoundingBoxTree::rebuild() {
+    std::vector<Node> old_nodes;
+    std::swap(old_nodes, m_nodes);
+    m_free_nodes.clear();
+    m_root = k_no_node;
+
+    std::vector<int> leaves;
+    leaves.reserve(m_leaves.size());
+    m_nodes.reserve(m_leaves.size()*2);
+    for (auto & [link, leaf] : m_leaves) {
+        (void)link;
+        Node node;
+        node.box = old_nodes[leaf].box;
+        node.element = std::move(old_nodes[leaf].element);
+        leaf = int(m_nodes.size());
+        m_nodes.emplace_back(std::move(node));
+        leaves.push_back(leaf);
+    }
+    if (leaves.empty()) return;
+    m_root = build_subtree(leaves.begin(), leaves.end());
+    m_nodes[m_root].parent = k_no_node;
+}
+
+/* private */ void LinkBoundingBoxTree::refit_from(int node) {
+    while (node != k_no_node) {
+        auto & current = m_nodes[node];
+        const auto & child_a = m_nodes[current.child_a];
+        const auto & child_b = m_nodes[current.child_b];
+        current.box = BoundingBox::make_union(child_a.box, child_b.box);
+        current.height = 1 + std::max(child_a.height, child_b.height);
+        node = current.parent;
+    }
+}
+
+/* private */ void LinkBoundingBoxTree::remove_leaf(int leaf) {
+    if (leaf == m_root) {
+        m_root = k_no_node;
+        return;
+    }
+    auto parent = m_nodes[leaf].parent;
+    auto grand_parent = m_nodes[parent].parent;
+    auto sibling = m_nodes[parent].child_a == leaf ?
+        m_nodes[parent].child_b : m_nodes[parent].child_a;
+    m_nodes[sibling].parent = grand_parent;
+    if (grand_parent == k_no_node) {
+        m_root = sibling;
+    } else if (m_nodes[grand_parent].child_a == parent) {
+        m_nodes[grand_parent].child_a = sibling;
+    } else {
+        m_nodes[grand_parent].child_b = sibling;
+    }
+    free_node(parent);
+    refit_from(grand_parent);
+}
+
+namespace {
+
+Real component_of(const Vector & r, int axis) {
+    switch (axis) {
+    case 0: return r.x;
+    case 1: return r.y;
+    case 2: return r.z;
+    default: break;
+    }
+    throw InvalidArgument{"component_of: axis must be 0, 1, or 2"};
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,136 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "BoundingBox.hpp"
+
+#include "../TriangleLink.hpp"
+
+#include <unordered_map>
+
+/** A binary tree of bounding boxes (bounding volume hierarchy), whose leaves
+ *  are links.
+ *
+ *  Links are inserted next to the sibling which grows the tree's boxes the
+ *  least, and removed by splicing out their leaf. Either way only the boxes
+ *  of that leaf's ancestors are refit. Should the tree grow too tall, it is
+ *  rebuilt from scratch (lazily, on update).
+ */
+class LinkBoundingBoxTree final {
+public:
+    using Element = SharedPtr<const TriangleLink>;
+
+    static constexpr const int k_no_node = -1;
+
+    struct Node final {
+        bool is_leaf() const noexcept { return child_a == k_no_node; }
+
+        BoundingBox box;
+        int parent  = k_no_node;
+        int child_a = k_no_node;
+        int child_b = k_no_node;
+        /// height of the subtree rooted here, leaves are zero
+        int height  = 0;
+        Element element;
+    };
+
+    /// Traverses the tree without a stack, by way of parent indicies, so that
+    /// iterators are cheap to copy, and need not allocate.
+    class Iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = int;
+        using value_type = Element;
+        using reference = const Element &;
+        using pointer = const Element *;
+
+        Iterator() {}
+
+        Iterator(const std::vector<Node> &, int root, const BoundingBox &);
+
+        const Element & operator * () const
+            { return (*m_nodes)[m_node].element; }
+
+        const Element * operator -> () const
+            { return &(*m_nodes)[m_node].element; }
+
+        Iterator & operator ++ ();
+
+        bool operator != (const Iterator & rhs) const
+            { return m_node != rhs.m_node; }
+
+        bool operator == (const Iterator & rhs) const
+            { return m_node == rhs.m_node; }
+
+    private:
+        int next_subtree_after(int node) const;
+
+        int seek_leaf_from(int node) const;
+
+        const std::vector<Node> * m_nodes = nullptr;
+        int m_root = k_no_node;
+        int m_node = k_no_node;
+        BoundingBox m_query;
+    };
+
+    void clear();
+
+    std::size_t count() const noexcept { return m_leaves.size(); }
+
+    /// @returns true if the given link was present in the tree
+    bool erase(const Element &);
+
+    /// @returns height of the tree, -1 if it's empty
+    int height() const;
+
+    void insert(const Element &);
+
+    /// rebuilds the tree, if it has grown far taller than a balanced tree
+    void rebalance_if_needed();
+
+    View<Iterator> view_for(const Vector &, const Vector &) const;
+
+    View<Iterator> view_for(const BoundingBox &) const;
+
+private:
+    using LeafMap = std::unordered_multimap<const TriangleLink *, int>;
+
+    int allocate_node();
+
+    int build_subtree(std::vector<int>::iterator beg, std::vector<int>::iterator end);
+
+    int find_best_sibling(const BoundingBox &) const;
+
+    void free_node(int);
+
+    void insert_leaf(int leaf);
+
+    void rebuild();
+
+    void refit_from(int node);
+
+    void remove_leaf(int leaf);
+
+    std::vector<Node> m_nodes;
+    std::vector<int> m_free_nodes;
+    LeafMap m_leaves;
+    int m_root = k_no_node;
+};
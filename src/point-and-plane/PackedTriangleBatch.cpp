@@ -0,0 +1,189 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "PackedTriangleBatch.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+// GCC and clang lower these to whatever the target has: SSE2/AVX on x86,
+// SIMD128 on WASM (with -msimd128), or plain scalar code otherwise
+#if defined(__GNUC__) || defined(__clang__)
+#   define MACRO_PACKED_TRIANGLES_USE_VECTOR_EXTENSIONS
+#endif
+
+namespace {
+
+constexpr const int k_lane_count = PackedTriangleBatch::k_lane_count;
+
+// TriangleSegment treats anything within are_very_close's tolerance (k_error)
+// as "parallel" (and therefore never hit)
+// margins make sure rounding never rules out what the exact test would hit
+constexpr const Real k_parallel_limit = k_error*0.5;
+constexpr const Real k_along_margin = 0.0001;
+constexpr const Real k_edge_margin = k_error*4;
+
+#ifdef MACRO_PACKED_TRIANGLES_USE_VECTOR_EXTENSIONS
+using RealLanes =
+    Real __attribute__((vector_size(sizeof(Real)*k_lane_count)));
+#endif
+
+/// Works on plain Reals or on vectors of them alike. (Vectors are only ever
+/// passed by reference, so nothing depends on the target's calling
+/// convention for them.)
+///
+/// @returns a bit set for each lane, where the displacement may hit the
+///          triangle
+template <typename T>
+unsigned may_hit
+    (const T & ax, const T & ay, const T & az,
+     const T & bx, const T & by, const T & bz,
+     const T & cx, const T & cy, const T & cz,
+     const Vector & a, const Vector & b);
+
+template <typename T>
+void compute_edge_function
+    (const T & nx, const T & ny, const T & nz,
+     const T & ex, const T & ey, const T & ez,
+     const T & vx, const T & vy, const T & vz,
+     const T & px, const T & py, const T & pz, T & out);
+
+} // end of <anonymous> namespace
+
+void PackedTriangleBatch::push(const TriangleSegment & triangle) {
+    if (is_full()) {
+        throw RuntimeError{"PackedTriangleBatch::push: batch is already full"};
+    }
+    auto a = triangle.point_a();
+    auto b = triangle.point_b();
+    auto c = triangle.point_c();
+    m_ax[m_size] = a.x; m_ay[m_size] = a.y; m_az[m_size] = a.z;
+    m_bx[m_size] = b.x; m_by[m_size] = b.y; m_bz[m_size] = b.z;
+    m_cx[m_size] = c.x; m_cy[m_size] = c.y; m_cz[m_size] = c.z;
+    ++m_size;
+}
+
+unsigned PackedTriangleBatch::possibly_hit_by
+    (const Vector & a, const Vector & b) const
+{
+    unsigned rv = 0;
+#   ifdef MACRO_PACKED_TRIANGLES_USE_VECTOR_EXTENSIONS
+    RealLanes ax, ay, az, bx, by, bz, cx, cy, cz;
+    std::memcpy(&ax, m_ax.data(), sizeof(RealLanes));
+    std::memcpy(&ay, m_ay.data(), sizeof(RealLanes));
+    std::memcpy(&az, m_az.data(), sizeof(RealLanes));
+    std::memcpy(&bx, m_bx.data(), sizeof(RealLanes));
+    std::memcpy(&by, m_by.data(), sizeof(RealLanes));
+    std::memcpy(&bz, m_bz.data(), sizeof(RealLanes));
+    std::memcpy(&cx, m_cx.data(), sizeof(RealLanes));
+    std::memcpy(&cy, m_cy.data(), sizeof(RealLanes));
+    std::memcpy(&cz, m_cz.data(), sizeof(RealLanes));
+    rv = may_hit(ax, ay, az, bx, by, bz, cx, cy, cz, a, b);
+#   else
+    for (int i = 0; i != k_lane_count; ++i) {
+        rv |= may_hit
+            (m_ax[i], m_ay[i], m_az[i], m_bx[i], m_by[i], m_bz[i],
+             m_cx[i], m_cy[i], m_cz[i], a, b) << i;
+    }
+#   endif
+    // lanes beyond size hold stale triangles
+    return rv & ((1u << m_size) - 1u);
+}
+
+namespace {
+
+template <typename T>
+unsigned may_hit
+    (const T & ax, const T & ay, const T & az,
+     const T & bx, const T & by, const T & bz,
+     const T & cx, const T & cy, const T & cz,
+     const Vector & a, const Vector & b)
+{
+    // follows TriangleSegment::limit_with_intersection, but without ever
+    // normalizing the normal (so no square roots); instead both sides of each
+    // comparison are scaled by the normal's magnitude
+    T abx = bx - ax, aby = by - ay, abz = bz - az;
+    T bcx = cx - bx, bcy = cy - by, bcz = cz - bz;
+    T cax = ax - cx, cay = ay - cy, caz = az - cz;
+    T nx = aby*(-caz) - abz*(-cay);
+    T ny = abz*(-cax) - abx*(-caz);
+    T nz = abx*(-cay) - aby*(-cax);
+    T norm_sq = nx*nx + ny*ny + nz*nz;
+
+    auto d = b - a;
+    T denom = nx*d.x + ny*d.y + nz*d.z;
+    T numer = nx*(b.x - ax) + ny*(b.y - ay) + nz*(b.z - az);
+    auto parallel =
+        denom*denom < (k_parallel_limit*k_parallel_limit)*norm_sq;
+    // 0 at b, 1 at a
+    T back_from_head = numer / denom;
+    auto misses_plane =
+          (back_from_head < -k_along_margin)
+        | (back_from_head > 1 + k_along_margin);
+
+    T px = b.x - d.x*back_from_head;
+    T py = b.y - d.y*back_from_head;
+    T pz = b.z - d.z*back_from_head;
+    // each is the edge's length times the distance of p from it (positive
+    // being inside), all times the normal's magnitude
+    T w_ab, w_bc, w_ca;
+    compute_edge_function
+        (nx, ny, nz, abx, aby, abz, ax, ay, az, px, py, pz, w_ab);
+    compute_edge_function
+        (nx, ny, nz, bcx, bcy, bcz, bx, by, bz, px, py, pz, w_bc);
+    compute_edge_function
+        (nx, ny, nz, cax, cay, caz, cx, cy, cz, px, py, pz, w_ca);
+    // points very near to an edge's line count as inside, even if past the
+    // end of the edge (as TriangleSegment's tolerance is a distance, the
+    // margin is scaled by each edge's length)
+    T margin_sq = (k_edge_margin*k_edge_margin)*norm_sq;
+    auto far_from_edges =
+          (w_ab*w_ab > margin_sq*(abx*abx + aby*aby + abz*abz))
+        & (w_bc*w_bc > margin_sq*(bcx*bcx + bcy*bcy + bcz*bcz))
+        & (w_ca*w_ca > margin_sq*(cax*cax + cay*cay + caz*caz));
+    auto outside = (w_ab < 0) | (w_bc < 0) | (w_ca < 0);
+    auto rejects = parallel | misses_plane | (far_from_edges & outside);
+
+    if constexpr (std::is_same_v<T, Real>) {
+        return rejects ? 0u : 1u;
+    } else {
+        unsigned rv = 0;
+        for (int i = 0; i != k_lane_count; ++i) {
+            if (!rejects[i]) rv |= (1u << i);
+        }
+        return rv;
+    }
+}
+
+template <typename T>
+void compute_edge_function
+    (const T & nx, const T & ny, const T & nz,
+     const T & ex, const T & ey, const T & ez,
+     const T & vx, const T & vy, const T & vz,
+     const T & px, const T & py, const T & pz, T & out)
+{
+    // normal cross edge points inward
+    T mx = ny*ez - nz*ey;
+    T my = nz*ex - nx*ez;
+    T mz = nx*ey - ny*ex;
+    out = mx*(px - vx) + my*(py - vy) + mz*(pz - vz);
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,64 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include "../TriangleSegment.hpp"
+
+#include <array>
+
+/** A handful of triangles' points, packed component by component (structure
+ *  of arrays), so that one displacement may be tested against all of them at
+ *  once.
+ *
+ *  This only quickly rules out triangles, which the displacement cannot
+ *  possibly hit. It is conservative: any triangle which
+ *  TriangleSegment::limit_with_intersection would find a solution for is
+ *  never ruled out, so that the caller may run the exact (scalar) test on the
+ *  rest, and arrive at the same answer as before.
+ */
+class PackedTriangleBatch final {
+public:
+    /// four doubles fill one AVX register, two SSE2/WASM SIMD registers
+    static constexpr const int k_lane_count = 4;
+
+    void clear() noexcept { m_size = 0; }
+
+    bool is_full() const noexcept { return m_size == k_lane_count; }
+
+    bool is_empty() const noexcept { return m_size == 0; }
+
+    int size() const noexcept { return m_size; }
+
+    void push(const TriangleSegment &);
+
+    /// @returns a bit for each lane (lowest being the first pushed triangle),
+    ///          set if the displacement from a to b may hit that triangle
+    unsigned possibly_hit_by(const Vector & a, const Vector & b) const;
+
+private:
+    using Lane = std::array<Real, k_lane_count>;
+
+    // lanes beyond size are still tested (and ignored), so keep them zeroed
+    alignas(32) Lane m_ax = {}, m_ay = {}, m_az = {};
+    alignas(32) Lane m_bx = {}, m_by = {}, m_bz = {};
+    alignas(32) Lane m_cx = {}, m_cy = {}, m_cz = {};
+    int m_size = 0;
+};
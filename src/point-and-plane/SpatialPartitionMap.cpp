@@ -49,6 +49,18 @@ Interval ProjectionLine::interval_for
     return interval_for(&pts[0], &pts[0] + pts.size());
 }
 
+Interval ProjectionLine::interval_for(const BoundingBox & box) const {
+    const auto & l = box.low;
+    const auto & h = box.high;
+    std::array pts {
+        Vector{l.x, l.y, l.z}, Vector{h.x, l.y, l.z},
+        Vector{l.x, h.y, l.z}, Vector{h.x, h.y, l.z},
+        Vector{l.x, l.y, h.z}, Vector{h.x, l.y, h.z},
+        Vector{l.x, h.y, h.z}, Vector{h.x, h.y, h.z}
+    };
+    return interval_for(&pts[0], &pts[0] + pts.size());
+}
+
 Real ProjectionLine::point_for(const Vector & r) const {
     auto pt_on_line = find_closest_point_to_line(m_a, m_b, r);
     auto mag = magnitude(pt_on_line - m_a);
@@ -69,6 +81,34 @@ Real ProjectionLine::point_for(const Vector & r) const {
 
 // ----------------------------------------------------------------------------
 
+CoarseDivisionLevel::IndexSlice CoarseDivisionLevel::slice_for_lower_bound
+    (Real value, std::size_t full_count) const
+{
+    auto itr = std::lower_bound(m_positions.begin(), m_positions.end(), value);
+    return slice_for_coarse_index(itr - m_positions.begin(), full_count);
+}
+
+CoarseDivisionLevel::IndexSlice CoarseDivisionLevel::slice_for_upper_bound
+    (Real value, std::size_t full_count) const
+{
+    auto itr = std::upper_bound(m_positions.begin(), m_positions.end(), value);
+    return slice_for_coarse_index(itr - m_positions.begin(), full_count);
+}
+
+/* private */ CoarseDivisionLevel::IndexSlice
+    CoarseDivisionLevel::slice_for_coarse_index
+    (std::size_t coarse_index, std::size_t full_count) const
+{
+    // the coarse position before the found one fails the search, and so the
+    // answer must come after it; the found one passes, and so the answer
+    // cannot come after it (inclusive, which the end of the slice is not)
+    std::size_t first = coarse_index == 0 ? 0 : (coarse_index - 1)*k_stride + 1;
+    std::size_t last  = std::min(coarse_index*k_stride, full_count);
+    return make_tuple(first, last);
+}
+
+// ----------------------------------------------------------------------------
+
 SpatialPartitionMap::Iterator & SpatialPartitionMap::Iterator::operator ++ () {
     ++m_itr;
     return *this;
@@ -144,7 +184,7 @@ View<ProjectedSpatialMap::Iterator>
     return m_spatial_map.view_for(points_interval);
 }
 
-/* private static */ ProjectionLine
+/* static */ ProjectionLine
     ProjectedSpatialMap::make_line_for
     (const TriangleLinks & links)
 {
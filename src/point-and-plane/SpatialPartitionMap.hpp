@@ -21,9 +21,13 @@
 #pragma once
 
 #include "../TriangleLink.hpp"
+#include "../Configuration.hpp"
+#include "BoundingBox.hpp"
 
 #include <ariajanke/cul/VectorUtils.hpp>
 
+#include <queue>
+
 class ProjectionLine final {
 public:
     using Triangle = TriangleSegment;
@@ -45,6 +49,9 @@ public:
 
     Interval interval_for(const Vector &, const Vector &) const;
 
+    /// @returns interval covering every point inside the box
+    Interval interval_for(const BoundingBox &) const;
+
     Real point_for(const Vector &) const;
 
 private:
@@ -87,6 +94,50 @@ private:
         { return lhs.position < rhs.position; }
 };
 
+/** An upper level of a division tree, over a (much larger) sorted sequence
+ *  of division positions.
+ *
+ *  Only every k_stride'th position is kept here. Searching this level first
+ *  narrows a search on the full sequence down to a single slice, which keeps
+ *  lookups local when a map has a great number of divisions.
+ */
+class CoarseDivisionLevel final {
+public:
+    using IndexSlice = Tuple<std::size_t, std::size_t>;
+
+    static constexpr const std::size_t k_stride = 64;
+
+    /// fewer divisions than this are searched directly
+    static constexpr const std::size_t k_min_divisions_for_level = 256;
+
+    CoarseDivisionLevel() {}
+
+    template <typename Iter, typename Func>
+    void build(Iter beg, Iter end, Func && position_of);
+
+    void clear() { m_positions.clear(); }
+
+    bool is_empty() const noexcept { return m_positions.empty(); }
+
+    /// @returns slice of indicies of the full sequence, which must contain
+    ///          the first position not less than the given value (or its
+    ///          end if there's no such position)
+    IndexSlice slice_for_lower_bound
+        (Real value, std::size_t full_count) const;
+
+    /// @returns slice of indicies of the full sequence, which must contain
+    ///          the first position greater than the given value (or its
+    ///          end if there's no such position)
+    IndexSlice slice_for_upper_bound
+        (Real value, std::size_t full_count) const;
+
+private:
+    IndexSlice slice_for_coarse_index
+        (std::size_t coarse_index, std::size_t full_count) const;
+
+    std::vector<Real> m_positions;
+};
+
 template <typename T>
 class SpatialDivisionPopulator final : public SpatialDivisionBase {
 public:
@@ -157,6 +208,7 @@ private:
     void verify_container(const char * caller) const;
 
     Container m_container;
+    CoarseDivisionLevel m_coarse_level;
 };
 
 template <typename Element>
@@ -183,8 +235,18 @@ public:
     template <typename T>
     using DivisionsPopulator = SpatialDivisionPopulator<T>;
 
+    static constexpr const std::size_t k_default_target_occupancy =
+        k_physics_target_bucket_occupancy;
+
+    /** Places divisions by entry count, so that each division holds roughly
+     *  the target number of entries.
+     *
+     *  Entries overlapping a division's start are counted toward that
+     *  division (as they will also be placed there).
+     */
     static std::vector<Real> compute_divisions
-        (const EntryContainer & sorted_entries);
+        (const EntryContainer & sorted_entries,
+         std::size_t target_occupancy = k_default_target_occupancy);
 
     static void make_indexed_divisions
         (const EntryContainer & sorted_entries, const std::vector<Real> & divisions,
@@ -275,6 +337,10 @@ public:
     using Iterator = SpatialPartitionMap::Iterator;
     using Helpers = SpatialPartitionMap::Helpers;
 
+    /// @returns a line along the axis which the given links are most spread
+    ///          across
+    static ProjectionLine make_line_for(const TriangleLinks &);
+
     ProjectedSpatialMap() {}
 
     explicit ProjectedSpatialMap(const TriangleLinks &);
@@ -284,8 +350,6 @@ public:
     View<Iterator> view_for(const Vector &, const Vector &) const;
 
 private:
-    static ProjectionLine make_line_for(const TriangleLinks &);
-
     SpatialPartitionMap m_spatial_map;
     ProjectionLine m_projection_line;
 };
@@ -295,7 +359,12 @@ private:
 template <typename T>
 SpatialDivisionContainer<T>::SpatialDivisionContainer(Populator && population_):
     m_container(std::move(population_.give_container()))
-{ verify_container("SpatialDivisionPairs"); }
+{
+    verify_container("SpatialDivisionPairs");
+    m_coarse_level.build
+        (m_container.begin(), m_container.end(),
+         [] (const Division & div) { return div.position; });
+}
 
 template <typename T>
 template <typename U, typename UtoT>
@@ -307,6 +376,9 @@ SpatialDivisionContainer<T>::SpatialDivisionContainer
         m_container.emplace_back(div, u_to_t(u));
     }
     verify_container("SpatialDivisionContainer");
+    m_coarse_level.build
+        (m_container.begin(), m_container.end(),
+         [] (const Division & div) { return div.position; });
 }
 
 template <typename T>
@@ -331,6 +403,7 @@ Tuple<T, T> SpatialDivisionContainer<T>::pair_for
 template <typename T>
 SpatialDivisionPopulator<T> SpatialDivisionContainer<T>::make_populator() {
     m_container.clear();
+    m_coarse_level.clear();
     return Populator{std::move(m_container)};
 }
 
@@ -339,8 +412,15 @@ template <typename Func>
 /* private */ typename SpatialDivisionContainer<T>::Container::const_iterator
     SpatialDivisionContainer<T>::lower_bound(Real value, Func && pred) const
 {
+    if (m_coarse_level.is_empty()) {
+        return std::lower_bound
+            (m_container.begin(), m_container.end(), value, std::move(pred));
+    }
+    auto [first, last] =
+        m_coarse_level.slice_for_lower_bound(value, m_container.size());
     return std::lower_bound
-        (m_container.begin(), m_container.end(), value, std::move(pred));
+        (m_container.begin() + first, m_container.begin() + last, value,
+         std::move(pred));
 }
 
 template <typename T>
@@ -371,7 +451,7 @@ template <typename T>
 template <typename Element>
 /* static */ std::vector<Real>
     SpatialPartitionMapHelpers<Element>::compute_divisions
-    (const EntryContainer & entries)
+    (const EntryContainer & entries, std::size_t target_occupancy)
 {
     if (entries.empty())
         { return { 0., k_inf }; }
@@ -380,23 +460,36 @@ template <typename Element>
             {"SpatialPartitionMapHelpers::compute_divisions: entries must be "
              "sorted"};
     }
-    // a little more difficult, I'll do hard coded quarters to start
-    auto first_entry_max_is_min = [](const Entry & lhs, const Entry & rhs)
-        { return lhs.interval.max < rhs.interval.max; };
-
-    // they're sorted after all...
-    auto min = entries.front().interval.min;
-    auto max = std::max_element
-        (entries.begin(), entries.end(), first_entry_max_is_min)
-        ->interval.max;
-    // v "denormalize" these divisions v
-    std::vector<Real> divisions{ 0., 0.25, 0.5, 0.75, 0. };
-    // std::vector<Real> divisions{ 0., 0.125, 0.25, 0.375, 0.5,
-    //                                  0.625, 0.75, 0.875, 0. };
-    for (auto & div : divisions) {
-        div = min + div*(max - min);
+    if (target_occupancy == 0) {
+        throw InvalidArgument
+            {"SpatialPartitionMapHelpers::compute_divisions: target occupancy "
+             "must be positive"};
+    }
+    // a division must start at least this many entries, otherwise long
+    // entries may cause many tiny divisions, each copying those same entries
+    const auto min_started = std::max(std::size_t(1), target_occupancy / 2);
+    // maxes of entries which may still overlap the next division's start
+    std::priority_queue<Real, std::vector<Real>, std::greater<Real>>
+        active_maxes;
+    std::vector<Real> divisions{ entries.front().interval.min };
+    std::size_t carried = 0;
+    std::size_t started = 0;
+    for (auto & entry : entries) {
+        auto position = entry.interval.min;
+        bool is_full =    started >= min_started
+                       && carried + started >= target_occupancy;
+        // entries that share a starting position cannot be split up
+        if (is_full && position > divisions.back()) {
+            while (!active_maxes.empty() && active_maxes.top() <= position)
+                { active_maxes.pop(); }
+            divisions.push_back(position);
+            carried = active_maxes.size();
+            started = 0;
+        }
+        active_maxes.push(entry.interval.max);
+        ++started;
     }
-    divisions.back() = k_inf;
+    divisions.push_back(k_inf);
     return divisions;
 }
 
@@ -464,3 +557,17 @@ template <typename Element>
          [](Real last, const Entry & element)
          { return last < element.interval.min; });
 }
+
+// ----------------------------------------------------------------------------
+
+template <typename Iter, typename Func>
+void CoarseDivisionLevel::build(Iter beg, Iter end, Func && position_of) {
+    m_positions.clear();
+    auto count = std::size_t(end - beg);
+    if (count < k_min_divisions_for_level)
+        { return; }
+    m_positions.reserve(count / k_stride + 1);
+    for (std::size_t idx = 0; idx < count; idx += k_stride) {
+        m_positions.push_back(position_of(*(beg + idx)));
+    }
+}
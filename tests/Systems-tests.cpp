@@ -0,0 +1,107 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../src/Systems.hpp"
+
+#include <ariajanke/cul/TreeTestSuite.hpp>
+
+#define mark_it mark_source_position(__LINE__, __FILE__).it
+
+namespace {
+
+constexpr const Real k_wake_distance = 8;
+constexpr const Real k_park_distance = 40;
+
+PhysicsActivity make_asleep_activity() {
+    PhysicsActivity activity;
+    for (int i = 0; i != PhysicsActivity::k_still_frames_to_sleep + 1; ++i)
+        { activity.record_location(Vector{}); }
+    return activity;
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+using namespace cul::tree_ts;
+describe<PhysicsActivity>("PhysicsActivity")([] {
+    mark_it("starts awake", [] {
+        return test_that(PhysicsActivity{}.is_awake());
+    });
+    mark_it("falls asleep after staying still long enough", [] {
+        return test_that(make_asleep_activity().is_asleep());
+    });
+    mark_it("is woken only by pushes well past what counts as still", [] {
+        constexpr auto k_wake_speed = PhysicsActivity::k_wake_speed;
+        return test_that(
+               !PhysicsActivity::is_pushed_awake
+                    (Vector{PhysicsActivity::k_still_distance*2, 0, 0})
+            && !PhysicsActivity::is_pushed_awake(Vector{k_wake_speed*0.5, 0, 0})
+            &&  PhysicsActivity::is_pushed_awake(Vector{k_wake_speed*2, 0, 0}));
+    });
+    mark_it("stays awake while moving", [] {
+        PhysicsActivity activity;
+        for (int i = 0; i != PhysicsActivity::k_still_frames_to_sleep*2; ++i)
+            { activity.record_location(Vector{Real(i), 0, 0}); }
+        return test_that(activity.is_awake());
+    });
+});
+describe<CheckPhysicsActivity>("CheckPhysicsActivity")([] {
+    CheckPhysicsActivity check
+        {Vector{}, Vector{1, 0, 0}, k_wake_distance, k_park_distance};
+    CheckPhysicsActivity still_player_check
+        {Vector{}, Vector{}, k_wake_distance, k_park_distance};
+    mark_it("parks bodies far from the player", [check] {
+        PpState state{PpInAir{Vector{k_park_distance*2, 0, 0}, Vector{}}};
+        PhysicsActivity activity;
+        check(state, activity, EcsOpt<Velocity>{});
+        return test_that(activity.is_parked());
+    });
+    mark_it("wakes sleeping bodies near the player", [check] {
+        PpState state{PpInAir{Vector{k_wake_distance*0.5, 0, 0}, Vector{}}};
+        auto activity = make_asleep_activity();
+        check(state, activity, EcsOpt<Velocity>{});
+        return test_that(activity.is_awake());
+    });
+    mark_it("leaves sleeping bodies near a still player asleep",
+            [still_player_check]
+    {
+        PpState state{PpInAir{Vector{k_wake_distance*0.5, 0, 0}, Vector{}}};
+        auto activity = make_asleep_activity();
+        still_player_check(state, activity, EcsOpt<Velocity>{});
+        return test_that(activity.is_asleep());
+    });
+    mark_it("leaves sleeping bodies away from the player asleep", [check] {
+        PpState state{PpInAir{Vector{k_wake_distance*2, 0, 0}, Vector{}}};
+        auto activity = make_asleep_activity();
+        check(state, activity, EcsOpt<Velocity>{});
+        return test_that(activity.is_asleep());
+    });
+    mark_it("wakes and drops bodies whose triangle was removed", [check] {
+        auto link = make_shared<TriangleLink>
+            (Vector{10, 0, 0}, Vector{11, 0, 0}, Vector{10, 0, 1});
+        PpState state{PpOnSegment{link, false, link->segment().center_in_2d(), Vector2{}}};
+        auto activity = make_asleep_activity();
+        link = nullptr;
+        check(state, activity, EcsOpt<Velocity>{});
+        return test_that(activity.is_awake() && std::holds_alternative<PpInAir>(state));
+    });
+});
+return 1;
+} ();
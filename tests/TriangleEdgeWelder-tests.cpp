@@ -0,0 +1,124 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../src/TriangleEdgeWelder.hpp"
+#include "../src/TriangleLink.hpp"
+
+#include <ariajanke/cul/TreeTestSuite.hpp>
+
+#define mark_it mark_source_position(__LINE__, __FILE__).it
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+using Side = TriangleSegment::Side;
+using Transfer = TriangleLinkTransfer;
+
+static auto are_same_transfers = [] (const Transfer & lhs, const Transfer & rhs) {
+    return    lhs.target_side() == rhs.target_side()
+           && lhs.inverts_normal() == rhs.inverts_normal()
+           && lhs.flips_position() == rhs.flips_position();
+};
+describe<TriangleEdgeWelder>("TriangleEdgeWelder #weld")([] {
+    const TriangleSegment triangle_a
+        {Vector{2.5, 0, -3.5}, Vector{2.5, 0, -4.5}, Vector{3.5, 0, -4.5}};
+    const TriangleSegment triangle_b
+        {Vector{2.5, 0, -3.5}, Vector{3.5, 0, -4.5}, Vector{3.5, 0, -3.5}};
+    mark_it("attaches triangles the same as comparing them directly", [&] {
+        auto welded_a = make_shared<TriangleLink>(triangle_a);
+        auto welded_b = make_shared<TriangleLink>(triangle_b);
+        auto compared_a = make_shared<TriangleLink>(triangle_a);
+        auto compared_b = make_shared<TriangleLink>(triangle_b);
+        TriangleEdgeWelder welder;
+        welder.add(welded_a);
+        welder.add(welded_b);
+        welder.weld();
+        TriangleLink::attach_matching_points(compared_a, compared_b);
+        return test_that
+            (   welded_a->transfers_to(Side::k_side_ca).target() == welded_b.get()
+             && welded_b->transfers_to(Side::k_side_ab).target() == welded_a.get()
+             && are_same_transfers
+                (welded_a->transfers_to(Side::k_side_ca),
+                 compared_a->transfers_to(Side::k_side_ca))
+             && are_same_transfers
+                (welded_b->transfers_to(Side::k_side_ab),
+                 compared_b->transfers_to(Side::k_side_ab)));
+    });
+    mark_it("attaches triangles facing opposite ways", [&] {
+        auto link_a = make_shared<TriangleLink>(triangle_a);
+        auto link_b = make_shared<TriangleLink>
+            (triangle_b.point_c(), triangle_b.point_b(), triangle_b.point_a());
+        auto compared_a = make_shared<TriangleLink>(triangle_a);
+        auto compared_b = make_shared<TriangleLink>(link_b->segment());
+        TriangleEdgeWelder welder;
+        welder.add(link_a);
+        welder.add(link_b);
+        welder.weld();
+        TriangleLink::attach_matching_points(compared_a, compared_b);
+        return test_that
+            (are_same_transfers
+                (link_a->transfers_to(Side::k_side_ca),
+                 compared_a->transfers_to(Side::k_side_ca)));
+    });
+    mark_it("attaches sides which are very nearly the same", [&] {
+        auto link_a = make_shared<TriangleLink>(triangle_a);
+        auto link_b = make_shared<TriangleLink>
+            (triangle_b.point_a() + Vector{0.000001, 0, 0},
+             triangle_b.point_b(), triangle_b.point_c());
+        TriangleEdgeWelder welder;
+        welder.add(link_a);
+        welder.add(link_b);
+        welder.weld();
+        return test_that(link_a->sides_attached_count() == 1);
+    });
+    mark_it("does not attach triangles sharing only a point", [] {
+        auto link_a = make_shared<TriangleLink>
+            (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{0, 0, 1});
+        auto link_b = make_shared<TriangleLink>
+            (Vector{0, 0, 0}, Vector{-1, 0, 0}, Vector{0, 0, -1});
+        TriangleEdgeWelder welder;
+        welder.add(link_a);
+        welder.add(link_b);
+        return test_that(   welder.weld() == 0
+                         && link_a->sides_attached_count() == 0);
+    });
+    mark_it("does not reattach a side already attached", [&] {
+        auto link_a = make_shared<TriangleLink>(triangle_a);
+        auto link_b = make_shared<TriangleLink>(triangle_b);
+        auto link_c = make_shared<TriangleLink>(triangle_b);
+        TriangleEdgeWelder welder;
+        welder.add(link_a);
+        welder.add(link_b);
+        welder.add(link_c);
+        welder.weld();
+        return test_that
+            (link_a->transfers_to(Side::k_side_ca).target() == link_b.get());
+    });
+    mark_it("forgets triangles once welded", [&] {
+        TriangleEdgeWelder welder;
+        welder.add(make_shared<TriangleLink>(triangle_a));
+        welder.add(make_shared<TriangleLink>(triangle_b));
+        welder.weld();
+        return test_that(welder.weld() == 0);
+    });
+});
+return 1;
+
+} ();
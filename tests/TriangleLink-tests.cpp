@@ -42,7 +42,7 @@ describe<TriangleLink>("TriangleLink::reattach_matching_points")([] {
         auto triangle_b = make_tri(Vec2{0, 0}, Vec2{0, 1}, Vec2{-1, 0});
         TriangleLink::attach_matching_points(triangle_a, triangle_b);
         return test_that
-            (    triangle_a->transfers_to(Side::k_side_ab).target() == triangle_b
+            (    triangle_a->transfers_to(Side::k_side_ab).target() == triangle_b.get()
              && !triangle_a->transfers_to(Side::k_side_bc).target()
              && !triangle_a->transfers_to(Side::k_side_ca).target());
     });
@@ -65,7 +65,7 @@ describe<TriangleLink>("TriangleLink::reattach_matching_points")([] {
 
     mark_it("returns a valid transfer object for attached side", [&] {
         auto trans = links_b->transfers_to(Side::k_side_ab);
-        return test_that(trans.target() == links_a);
+        return test_that(trans.target() == links_a.get());
     });
     mark_it("does not invert normal for this case's triangles", [&] {
         return test_that(!links_b->transfers_to(Side::k_side_ab).inverts_normal());
@@ -216,7 +216,7 @@ describe<TriangleLink>("TriangleLink::reattach_matching_points (equal normals, i
     // split this test
     mark_it("attaches lhs to rhs as target", [&] {
         return test_that
-            (links_lhs->transfers_to(Side::k_side_ab).target() == links_rhs);
+            (links_lhs->transfers_to(Side::k_side_ab).target() == links_rhs.get());
     });
     mark_it("attaches lhs inverting the tracker", [&] {
         return test_that
@@ -224,7 +224,7 @@ describe<TriangleLink>("TriangleLink::reattach_matching_points (equal normals, i
     });
     mark_it("attaches rhs to lhs as target", [&] {
         return test_that
-            (links_rhs->transfers_to(Side::k_side_bc).target() == links_lhs);
+            (links_rhs->transfers_to(Side::k_side_bc).target() == links_lhs.get());
     });
     mark_it("attaches lhs inverting the tracker", [&] {
         return test_that
@@ -248,7 +248,7 @@ describe<TriangleLink>("TriangleLink::reattach_matching_points (arbitrary? norma
 
     mark_it("attaches lhs to rhs", [&] {
         auto trans = links_lhs->transfers_to(Side::k_side_ab);
-        return test_that(trans.target() == links_rhs);
+        return test_that(trans.target() == links_rhs.get());
     });
 
     mark_it("inverts tracker normal from lhs to rhs", [&] {
@@ -258,7 +258,7 @@ describe<TriangleLink>("TriangleLink::reattach_matching_points (arbitrary? norma
 
     mark_it("attaches rhs to lhs", [&] {
         auto trans = links_rhs->transfers_to(Side::k_side_bc);
-        return test_that(trans.target() == links_lhs);
+        return test_that(trans.target() == links_lhs.get());
     });
 
     mark_it("inverts tracker normal from rhs to lhs", [&] {
@@ -0,0 +1,104 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../src/TriangleLink.hpp"
+
+#include <ariajanke/cul/TreeTestSuite.hpp>
+
+#define mark_it mark_source_position(__LINE__, __FILE__).it
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+static auto make_link = [] {
+    return make_shared<TriangleLink>
+        (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{0, 1, 0});
+};
+describe<TriangleLinkStore>("TriangleLinkStore #find")([] {
+    mark_it("finds a live link by its id", [] {
+        auto link = make_link();
+        return test_that(TriangleLinkStore::instance().find(link->id()) == link.get());
+    });
+    mark_it("finds nothing for a null id", [] {
+        return test_that(!TriangleLinkStore::instance().find(TriangleId{}));
+    });
+    mark_it("finds nothing for a destroyed link's id", [] {
+        auto link = make_link();
+        auto id = link->id();
+        link = nullptr;
+        return test_that(!TriangleLinkStore::instance().find(id));
+    });
+    mark_it("does not confuse a new link with a destroyed one sharing its slot", [] {
+        auto old_link = make_link();
+        auto old_id = old_link->id();
+        old_link = nullptr;
+        auto new_link = make_link();
+        auto & store = TriangleLinkStore::instance();
+        return test_that(   new_link->id() != old_id
+                         && !store.find(old_id)
+                         && store.find(new_link->id()) == new_link.get());
+    });
+    mark_it("gives copies their own ids", [] {
+        auto link = make_link();
+        TriangleLink copy{*link};
+        return test_that(   copy.id() != link->id()
+                         && TriangleLinkStore::instance().find(copy.id()) == &copy);
+    });
+    mark_it("finds nothing for a suspended link's id", [] {
+        auto link = make_link();
+        TriangleLinkStore::instance().suspend(link->id());
+        return test_that(!TriangleLinkStore::instance().find(link->id()));
+    });
+    mark_it("finds a suspended link again once resumed", [] {
+        auto link = make_link();
+        auto & store = TriangleLinkStore::instance();
+        store.suspend(link->id());
+        store.resume(*link);
+        return test_that(store.find(link->id()) == link.get());
+    });
+});
+describe<TriangleLinkStore>("TriangleLink #transfers_to")([] {
+    mark_it("has no transfer once the neighbor is destroyed", [] {
+        auto lhs = make_shared<TriangleLink>
+            (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{0, 1, 0});
+        auto rhs = make_shared<TriangleLink>
+            (Vector{1, 0, 0}, Vector{0, 0, 0}, Vector{0, -1, 0});
+        TriangleLink::attach_matching_points(lhs, rhs);
+        if (lhs->sides_attached_count() != 1)
+            { return test_that(false); }
+        rhs = nullptr;
+        return test_that(lhs->sides_attached_count() == 0);
+    });
+    mark_it("has no transfer while the neighbor is suspended", [] {
+        auto lhs = make_shared<TriangleLink>
+            (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{0, 1, 0});
+        auto rhs = make_shared<TriangleLink>
+            (Vector{1, 0, 0}, Vector{0, 0, 0}, Vector{0, -1, 0});
+        TriangleLink::attach_matching_points(lhs, rhs);
+        auto & store = TriangleLinkStore::instance();
+        store.suspend(rhs->id());
+        bool detached = lhs->sides_attached_count() == 0;
+        store.resume(*rhs);
+        return test_that(detached && lhs->sides_attached_count() == 1);
+    });
+});
+return 1;
+
+} ();
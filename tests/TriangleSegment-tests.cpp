@@ -22,6 +22,8 @@
 
 #include <ariajanke/cul/TreeTestSuite.hpp>
 
+#include <random>
+
 #define mark_it mark_source_position(__LINE__, __FILE__).it
 
 namespace {
@@ -48,6 +50,33 @@ template <typename T>
 auto test_very_close(const T & lhs, const T & rhs)
     { return cul::tree_ts::test_that(are_very_close(lhs, rhs)); }
 
+/// random triangles, each with a random segment leaving or entering it
+template <typename Func>
+cul::tree_ts::TestAssertion fuzz_side_crossings(Func && f) {
+    std::default_random_engine rng{0x5EED};
+    std::uniform_real_distribution<Real> point_dist{-10, 10};
+    std::uniform_real_distribution<Real> step_dist{-2, 2};
+    auto random_vector = [&] {
+        return Vector{point_dist(rng), point_dist(rng), point_dist(rng)};
+    };
+    for (int i = 0; i != 2000; ++i) {
+        auto a = random_vector(), b = random_vector(), c = random_vector();
+        // skip slivers, which the constructor may refuse
+        if (magnitude(cross(b - a, c - a)) < 0.5) continue;
+        TriangleSegment triangle{a, b, c};
+        auto inside = triangle.center_in_2d();
+        auto outside = inside + Vector2{step_dist(rng), step_dist(rng)}*8;
+        if (triangle.contains_point(outside)) continue;
+        bool leaving = i % 2 == 0;
+        auto crossing = leaving ?
+            triangle.check_for_side_crossing(inside, outside) :
+            triangle.check_for_side_crossing(outside, inside);
+        if (!f(triangle, crossing))
+            { return cul::tree_ts::test_that(false); }
+    }
+    return cul::tree_ts::test_that(true);
+}
+
 } // end of <anonymous> namespace
 
 [[maybe_unused]] static auto s_add_describes = [] {
@@ -140,6 +169,12 @@ describe<TriangleSegment>("TriangleSegment #closest_point")([] {
         auto p = ts.closest_point(Vector(10., -10., -123.));
         return test_very_close(ts.point_at(p), Vector(10., -10., 0.));
     });
+    mark_it("finds points on the plane of a triangle that isn't flat", [] {
+        auto ts = make_not_flat_test();
+        auto on_plane = ts.point_at(Vector2{0.3, -0.7});
+        auto p = ts.closest_point(on_plane + ts.normal()*2);
+        return test_very_close(p, Vector2{0.3, -0.7});
+    });
 });
 describe<TriangleSegment>("TriangleSegment #contains_point")([] {
     mark_it("detects when a point on the plane, is inside the actual triangle segment", [] {
@@ -148,6 +183,17 @@ describe<TriangleSegment>("TriangleSegment #contains_point")([] {
             {Vector{0, 0, 0}, Vector{1.4142, 0, 0}, Vector{0.70711, 0.70711, 0}};
         return test_that(triangle.contains_point(pt));
     });
+    mark_it("contains points on its sides", [] {
+        auto ts = make_flat_test();
+        return test_that(   ts.contains_point(Vector2{0.5, 0  })
+                         && ts.contains_point(Vector2{0.5, 0.5})
+                         && ts.contains_point(Vector2{0  , 0.5}));
+    });
+    mark_it("does not contain points along a side's line, past its ends", [] {
+        auto ts = make_flat_test();
+        return test_that(   !ts.contains_point(Vector2{ 2, 0})
+                         && !ts.contains_point(Vector2{-1, 0}));
+    });
 });
 describe<TriangleSegment>("TriangleSegment #flip")([] {
     mark_it("flips the normal n such that the new normal is -n", [] {
@@ -182,6 +228,37 @@ describe<TriangleSegment>("TriangleSegment #check_for_side_crossing")([] {
         auto side = seg.check_for_side_crossing(outside, inside).side;
         return test_that(TriangleSide::k_side_ca == side);
     });
+    mark_it("finds no crossing between two points inside", [] {
+        auto ts = make_flat_test();
+        auto crossing = ts.check_for_side_crossing
+            (Vector2{0.1, 0.1}, Vector2{0.3, 0.2});
+        return test_that(crossing.side == TriangleSide::k_inside);
+    });
+    mark_it("finds crossing with the inside point contained, and the outside not", [] {
+        return fuzz_side_crossings([] (const TriangleSegment & triangle,
+                                       const TriangleSegment::SideCrossing & crossing)
+        {
+            return    crossing.side != TriangleSide::k_inside
+                   &&  triangle.contains_point(crossing.inside )
+                   && !triangle.contains_point(crossing.outside);
+        });
+    });
+    mark_it("finds crossing points right next to each other", [] {
+        return fuzz_side_crossings([] (const TriangleSegment &,
+                                       const TriangleSegment::SideCrossing & crossing)
+        { return magnitude(crossing.inside - crossing.outside) < 0.000001; });
+    });
+    mark_it("finds crossing points on the crossed side", [] {
+        return fuzz_side_crossings([] (const TriangleSegment & triangle,
+                                       const TriangleSegment::SideCrossing & crossing)
+        {
+            auto [a, b] = triangle.side_points_in_2d(crossing.side);
+            auto ba = b - a;
+            auto along = dot(crossing.inside - a, ba) / dot(ba, ba);
+            auto distance = magnitude(a + ba*along - crossing.inside);
+            return distance < 0.001 && along > -0.001 && along < 1.001;
+        });
+    });
 });
 return 1;
 } ();
@@ -0,0 +1,140 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/map-director/DecayedRegionCache.hpp"
+#include "../../src/map-director/ProducableGrid.hpp"
+#include "../../src/platform.hpp"
+#include "../../src/Texture.hpp"
+
+#include "../test-helpers.hpp"
+
+namespace {
+
+DecayedRegion make_decayed_region(const Vector2I & position) {
+    auto entity = Entity::make_sceneless_entity();
+    entity.add<ModelTranslation, ModelVisibility>() =
+        make_tuple(ModelTranslation{1, 2, 3}, ModelVisibility{});
+    return DecayedRegion{position, nullptr, { entity }};
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+
+describe<DecayedRegion>("DecayedRegion")([] {
+    mark_it("remakes entities with the same components", [] {
+        auto entities = make_decayed_region(Vector2I{}).make_entities();
+        if (entities.size() != 1)
+            { return test_that(false); }
+        auto & entity = entities.front();
+        return test_that(   entity.ptr<ModelVisibility>()
+                         && !entity.ptr<ModelScale>()
+                         && entity.get<ModelTranslation>().value ==
+                            Vector{1, 2, 3});
+    });
+    mark_it("keeps every component producables may give", [] {
+        SharedPtr<const RenderModel> render_model =
+            Platform::null_callbacks().make_render_model();
+        SharedPtr<const Texture> texture =
+            Platform::null_callbacks().make_texture();
+        auto entity = Entity::make_sceneless_entity();
+        entity.add<ModelScale, ModelTranslation, XRotation, YRotation,
+                   TextureTranslation, ModelVisibility,
+                   SharedPtr<const RenderModel>, SharedPtr<const Texture>>() =
+            make_tuple(ModelScale{}, ModelTranslation{}, XRotation{},
+                       YRotation{}, TextureTranslation{}, ModelVisibility{},
+                       render_model, texture);
+        auto remade = DecayedRegion{Vector2I{}, nullptr, { entity }}.
+            make_entities().front();
+        return test_that(   remade.ptr<ModelScale>()
+                         && remade.ptr<ModelTranslation>()
+                         && remade.ptr<XRotation>()
+                         && remade.ptr<YRotation>()
+                         && remade.ptr<TextureTranslation>()
+                         && remade.ptr<ModelVisibility>()
+                         && remade.get<SharedPtr<const RenderModel>>() ==
+                            render_model
+                         && remade.get<SharedPtr<const Texture>>() == texture);
+    });
+    mark_it("remakes entities apart from the originals", [] {
+        auto region = make_decayed_region(Vector2I{});
+        auto first = region.make_entities();
+        auto second = region.make_entities();
+        first.front().get<ModelTranslation>() = ModelTranslation{};
+        return test_that
+            (second.front().get<ModelTranslation>().value == Vector{1, 2, 3});
+    });
+});
+describe<DecayedRegionCache>("DecayedRegionCache")([] {
+    const auto region_size = make_decayed_region(Vector2I{}).memory_size();
+    mark_it("gives back an added region, counting a hit", [region_size] {
+        DecayedRegionCache cache{region_size*4};
+        cache.add(make_decayed_region(Vector2I{1, 2}));
+        auto region = cache.take(Vector2I{1, 2});
+        return test_that(   region
+                         && region->on_field_position() == Vector2I{1, 2}
+                         && cache.metrics().hits == 1
+                         && cache.metrics().bytes_held == 0);
+    });
+    mark_it("gives back a region only once", [region_size] {
+        DecayedRegionCache cache{region_size*4};
+        cache.add(make_decayed_region(Vector2I{}));
+        (void)cache.take(Vector2I{});
+        return test_that(!cache.take(Vector2I{}) && !cache.contains(Vector2I{}));
+    });
+    mark_it("evicts the least recently decayed past its budget", [region_size] {
+        DecayedRegionCache cache{region_size*2};
+        cache.add(make_decayed_region(Vector2I{0, 0}));
+        cache.add(make_decayed_region(Vector2I{1, 0}));
+        cache.add(make_decayed_region(Vector2I{2, 0}));
+        return test_that(   !cache.contains(Vector2I{0, 0})
+                         && cache.contains(Vector2I{1, 0})
+                         && cache.contains(Vector2I{2, 0})
+                         && cache.metrics().evictions == 1
+                         && cache.metrics().bytes_held == region_size*2);
+    });
+    mark_it("replaces an older decay of the same region", [region_size] {
+        DecayedRegionCache cache{region_size*4};
+        cache.add(make_decayed_region(Vector2I{}));
+        cache.add(make_decayed_region(Vector2I{}));
+        return test_that(   cache.size() == 1
+                         && cache.metrics().bytes_held == region_size
+                         && cache.metrics().evictions == 0);
+    });
+    mark_it("keeps nothing without a budget", [] {
+        DecayedRegionCache cache;
+        cache.add(make_decayed_region(Vector2I{}));
+        return test_that(!cache.keeps_regions() && cache.size() == 0);
+    });
+    mark_it("finds hit rate from hits and misses", [region_size] {
+        DecayedRegionCache cache{region_size*4};
+        cache.add(make_decayed_region(Vector2I{}));
+        (void)cache.take(Vector2I{});
+        cache.record_miss();
+        cache.record_miss();
+        cache.record_miss();
+        return test_that(are_very_close(cache.metrics().hit_rate(), Real(0.25)));
+    });
+});
+return 1;
+
+} ();
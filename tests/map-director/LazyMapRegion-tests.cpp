@@ -0,0 +1,154 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/map-director/LazyMapRegion.hpp"
+#include "../../src/map-director/RegionLoadRequest.hpp"
+#include "../../src/platform.hpp"
+
+#include "../test-helpers.hpp"
+
+namespace {
+
+using namespace cul::tree_ts;
+using Clock = LazyMapRegionKeeper::Clock;
+using State = LazyMapRegion::State;
+
+class RequestAllRegions final : public RegionLoadRequestBase {
+public:
+    bool overlaps_with(const RectangleI &) const final { return true; }
+
+    Size2I max_region_size() const final
+        { return Size2I{k_max_int, k_max_int}; }
+
+private:
+    static constexpr auto k_max_int = std::numeric_limits<int>::max();
+};
+
+struct TestMapRegion final : public MapRegion {
+    explicit TestMapRegion(Optional<RectangleI> & received_scope):
+        received(&received_scope) {}
+
+    void process_load_request
+        (const RegionLoadRequestBase &,
+         const RegionPositionFraming &,
+         RegionLoadCollectorBase &,
+         const Optional<RectangleI> & grid_scope) final
+    { *received = grid_scope; }
+
+    Size2I size2() const final { return Size2I{10, 10}; }
+
+    Optional<RectangleI> * received = nullptr;
+};
+
+class TestRegionLoadCollector final : public RegionLoadCollectorBase {
+public:
+    void collect_load_job
+        (const SubRegionPositionFraming &, const ProducableSubGrid &) final {}
+};
+
+class TestTaskCallbacks final : public TaskCallbacks {
+public:
+    void add(const SharedPtr<EveryFrameTask> &) final {}
+
+    void add(const SharedPtr<BackgroundTask> &) final { ++added_tasks; }
+
+    void add(const Entity &) final {}
+
+    void add(const SharedPtr<TriangleLink> &) final {}
+
+    void remove(const SharedPtr<const TriangleLink> &) final {}
+
+    Platform & platform() final { return Platform::null_callbacks(); }
+
+    int added_tasks = 0;
+};
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+describe<LazyMapRegion>("LazyMapRegion")([] {
+    Optional<RectangleI> received_scope;
+    LazyMapRegion region{"parts.tmx", Size2I{2, 2}};
+    TestRegionLoadCollector collector;
+    auto process_scope = [&] (const RectangleI & scope) {
+        region.process_load_request
+            (RequestAllRegions{}, RegionPositionFraming{}, collector, scope);
+    };
+    mark_it("collects itself while unloaded, without loading anything", [&] {
+        process_scope(RectangleI{1, 0, 1, 1});
+        auto collected = collector.take_lazy_regions();
+        return test_that(   collected.size() == 1
+                         && collected.front() == &region
+                         && !received_scope);
+    }).
+    next([&] {
+        region.finish_loading
+            (make_unique<TestMapRegion>(received_scope), 1);
+    }).
+    mark_it("passes nothing on once loaded, until admitted", [&] {
+        process_scope(RectangleI{1, 0, 1, 1});
+        return test_that(   region.state() == State::loaded
+                         && !received_scope);
+    }).
+    next([&] { region.admit(); }).
+    mark_it("passes on scopes in sub map tiles, once admitted", [&] {
+        process_scope(RectangleI{1, 0, 1, 1});
+        return test_that(received_scope == RectangleI{5, 0, 5, 5});
+    }).
+    mark_it("is unloaded again once evicted", [&] {
+        region.evict();
+        return test_that(   region.state() == State::unloaded
+                         && region.size2() == Size2I{});
+    });
+});
+
+describe<LazyMapRegionKeeper>("LazyMapRegionKeeper")([] {
+    Optional<RectangleI> received_scope;
+    LazyMapRegion region{"parts.tmx", Size2I{2, 2}};
+    region.finish_loading(make_unique<TestMapRegion>(received_scope), 1);
+    LazyMapRegionKeeper keeper{30};
+    TestTaskCallbacks callbacks;
+    auto start = Clock::now();
+    auto newly_loaded = keeper.touch({ &region, &region }, callbacks, start);
+    mark_it("gives loaded regions, once each", [&] {
+        return test_that(   newly_loaded.size() == 1
+                         && newly_loaded.front() == &region
+                         && callbacks.added_tasks == 0);
+    }).
+    next([&] { region.admit(); }).
+    mark_it("keeps regions touched recently", [&] {
+        auto later = start + std::chrono::seconds{29};
+        return test_that(   !keeper.has_untouched(later)
+                         && keeper.evict_untouched(later) == 0
+                         && region.state() == State::admitted);
+    }).
+    mark_it("evicts regions left untouched for too long", [&] {
+        auto later = start + std::chrono::seconds{31};
+        return test_that(   keeper.has_untouched(later)
+                         && keeper.evict_untouched(later) == 1
+                         && region.state() == State::unloaded
+                         && keeper.kept_count() == 0);
+    });
+});
+
+return [] {};
+
+} ();
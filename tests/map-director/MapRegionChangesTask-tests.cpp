@@ -0,0 +1,425 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/map-director/MapRegionChangesTask.hpp"
+#include "../../src/map-director/RegionEdgeConnectionsContainer.hpp"
+#include "../../src/TriangleLink.hpp"
+#include "../../src/platform.hpp"
+
+#include "../test-helpers.hpp"
+
+namespace {
+
+class SquareProducableTile final : public ProducableTile {
+public:
+    void operator () (ProducableTileCallbacks & callbacks) const final {
+        callbacks.add_collidable
+            (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{1, 0, -1});
+        callbacks.add_collidable
+            (Vector{0, 0, 0}, Vector{1, 0, -1}, Vector{0, 0, -1});
+        auto model = callbacks.make_render_model();
+        model->load
+            (std::vector<Vertex>
+                { Vertex{Vector{0, 0, 0}, Vector2{}},
+                  Vertex{Vector{1, 0, 0}, Vector2{}},
+                  Vertex{Vector{1, 0, -1}, Vector2{}} },
+             std::vector<unsigned>{ 0, 1, 2 });
+        callbacks.add_entity<SharedPtr<const RenderModel>>(std::move(model));
+    }
+};
+
+class CountingProducableTile final : public ProducableTile {
+public:
+    void operator () (ProducableTileCallbacks & callbacks) const final {
+        ++produced_count;
+        m_square(callbacks);
+    }
+
+    mutable int produced_count = 0;
+
+private:
+    SquareProducableTile m_square;
+};
+
+class ThrowingProducableTile final : public ProducableTile {
+public:
+    void operator () (ProducableTileCallbacks &) const final
+        { throw RuntimeError{"cannot produce"}; }
+};
+
+class TestTaskCallbacks final : public TaskCallbacks {
+public:
+    void add(const SharedPtr<EveryFrameTask> &) final {}
+
+    void add(const SharedPtr<BackgroundTask> &) final {}
+
+    void add(const Entity & entity) final
+        { entities.push_back(entity); }
+
+    void add(const SharedPtr<TriangleLink> & link) final
+        { links.push_back(link); }
+
+    void remove(const SharedPtr<const TriangleLink> &) final {}
+
+    Platform & platform() final { return Platform::null_callbacks(); }
+
+    std::vector<Entity> entities;
+    std::vector<SharedPtr<TriangleLink>> links;
+};
+
+class TestDecayAdder final : public MapRegionContainer::RegionDecayAdder {
+public:
+    void add(const Vector2I & on_field_position,
+             ScaledTriangleViewGrid && triangle_grid,
+             std::vector<Entity> && entities) final
+    {
+        decay_jobs.emplace_back
+            (on_field_position, std::move(triangle_grid), std::move(entities));
+    }
+
+    std::vector<RegionDecayJob> decay_jobs;
+};
+
+ProducableTileViewGrid make_producables(ProducableTile & tile) {
+    ProducableTileGridStacker stacker;
+    stacker.stack_with(Grid<ProducableTile *>{ { &tile } }, {});
+    return stacker.to_producables();
+}
+
+RegionLoadJob make_load_job
+    (const ProducableTileViewGrid & producables, const Vector2I & position)
+{
+    return RegionLoadJob
+        {SubRegionPositionFraming{ScaleComputation{}, position},
+         producables.make_subgrid()};
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+
+describe<PreparedRenderModel>("PreparedRenderModel")([] {
+    mark_it("is not loaded before being uploaded", [] {
+        PreparedRenderModel model;
+        model.load(RenderModelData{std::vector<Vertex>(3), { 0, 1, 2 }});
+        return test_that(!model.is_loaded());
+    });
+    mark_it("is loaded once uploaded", [] {
+        PreparedRenderModel model;
+        model.load(RenderModelData{std::vector<Vertex>(3), { 0, 1, 2 }});
+        model.upload(Platform::null_callbacks());
+        return test_that(model.is_loaded());
+    });
+});
+describe<RegionLoadJob>("RegionLoadJob #prepare")([] {
+    SquareProducableTile tile;
+    auto producables = make_producables(tile);
+    TestTaskCallbacks callbacks;
+    MapRegionContainer container;
+    RegionEdgeConnectionsContainer edge_container;
+    auto adder = edge_container.make_adder();
+    make_load_job(producables, Vector2I{}).prepare().
+        commit(container, adder, callbacks);
+    mark_it("links triangles to each other", [&] {
+        return test_that(   callbacks.links.size() == 2
+                         && callbacks.links[0]->sides_attached_count() == 1
+                         && callbacks.links[1]->sides_attached_count() == 1);
+    });
+    mark_it("uploads render models on commit", [&] {
+        if (callbacks.entities.size() != 1)
+            { return test_that(false); }
+        auto & model = callbacks.entities[0].get<SharedPtr<const RenderModel>>();
+        return test_that(model->is_loaded());
+    });
+    mark_it("sets the region on commit", [&] {
+        return test_that(!!container.region_refresh_at(Vector2I{}));
+    });
+    mark_it("keeps the job's position", [&] {
+        auto prepared = make_load_job(producables, Vector2I{2, 3}).prepare();
+        return test_that(prepared.on_field_position() == Vector2I{2, 3});
+    });
+});
+describe<RegionPreparationQueue>("RegionPreparationQueue")([] {
+    SquareProducableTile tile;
+    auto producables = make_producables(tile);
+    mark_it("prepares jobs on the calling thread without workers", [&] {
+        RegionPreparationQueue queue;
+        queue.push(make_load_job(producables, Vector2I{}));
+        if (!queue.take_finished().empty())
+            { return test_that(false); }
+        queue.prepare_next();
+        return test_that(queue.take_finished().size() == 1);
+    });
+    mark_it("finishes all pushed jobs with workers", [&] {
+        RegionPreparationQueue queue{2};
+        for (int i = 0; i != 8; ++i)
+            { queue.push(make_load_job(producables, Vector2I{i, 0})); }
+        queue.wait_for_all();
+        return test_that(queue.take_finished().size() == 8);
+    });
+    mark_it("hands off finished jobs only once", [&] {
+        RegionPreparationQueue queue{2};
+        queue.push(make_load_job(producables, Vector2I{}));
+        queue.wait_for_all();
+        queue.take_finished();
+        return test_that(queue.take_finished().empty());
+    });
+    mark_it("does not prepare again a region finished but not yet taken", [] {
+        CountingProducableTile counting_tile;
+        auto counting_producables = make_producables(counting_tile);
+        RegionPreparationQueue queue{1};
+        queue.push(make_load_job(counting_producables, Vector2I{}));
+        queue.wait_for_all();
+        bool pushed_again =
+            queue.push(make_load_job(counting_producables, Vector2I{}));
+        queue.wait_for_all();
+        return test_that(   !pushed_again
+                         && queue.take_finished().size() == 1
+                         && counting_tile.produced_count == 1);
+    });
+    mark_it("tells when every job pushed before a ticket is finished", [&] {
+        RegionPreparationQueue queue;
+        queue.push(make_load_job(producables, Vector2I{}));
+        auto ticket = queue.next_ticket();
+        queue.push(make_load_job(producables, Vector2I{1, 0}));
+        bool finished_before_preparing = queue.has_finished_before(ticket);
+        queue.prepare_next();
+        return test_that(   !finished_before_preparing
+                         && queue.has_finished_before(ticket)
+                         && !queue.has_finished_before(queue.next_ticket()));
+    });
+    mark_it("rethrows exceptions from workers on taking finished jobs", [] {
+        ThrowingProducableTile throwing_tile;
+        auto throwing_producables = make_producables(throwing_tile);
+        RegionPreparationQueue queue{1};
+        queue.push(make_load_job(throwing_producables, Vector2I{}));
+        queue.wait_for_all();
+        return expect_exception<RuntimeError>([&queue] {
+            queue.take_finished();
+        });
+    });
+    mark_it("does not prefetch without workers", [&] {
+        RegionPreparationQueue queue;
+        return test_that(!queue.push_prefetch
+            (make_load_job(producables, Vector2I{}), 1));
+    });
+    mark_it("holds onto prefetched regions", [&] {
+        RegionPreparationQueue queue{2};
+        queue.push_prefetch(make_load_job(producables, Vector2I{}), 1);
+        queue.wait_for_all();
+        return test_that(   queue.take_finished().empty()
+                         && queue.prefetched_count() == 1);
+    });
+    mark_it("hands off a prefetched region once pushed for loading", [&] {
+        RegionPreparationQueue queue{2};
+        queue.push_prefetch(make_load_job(producables, Vector2I{}), 1);
+        queue.wait_for_all();
+        queue.push(make_load_job(producables, Vector2I{}));
+        return test_that(   queue.take_finished().size() == 1
+                         && queue.prefetched_count() == 0);
+    });
+    mark_it("hands off a region pushed for loading while prefetching", [&] {
+        RegionPreparationQueue queue{1};
+        queue.push_prefetch(make_load_job(producables, Vector2I{}), 1);
+        queue.push(make_load_job(producables, Vector2I{}));
+        queue.wait_for_all();
+        return test_that(queue.take_finished().size() == 1);
+    });
+    mark_it("drops canceled prefetches", [&] {
+        RegionPreparationQueue queue{2};
+        queue.push_prefetch(make_load_job(producables, Vector2I{}), 1);
+        queue.push_prefetch(make_load_job(producables, Vector2I{1, 0}), 1);
+        queue.cancel_prefetches_except
+            (RegionPreparationQueue::PositionSet{ Vector2I{1, 0} });
+        queue.wait_for_all();
+        return test_that(queue.prefetched_count() == 1);
+    });
+});
+describe<PreparedRegion>("PreparedRegion #commit_step")([] {
+    SquareProducableTile tile;
+    auto producables = make_producables(tile);
+    mark_it("takes a step for each render model, links, entities, and region", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        auto adder = edge_container.make_adder();
+        auto prepared = make_load_job(producables, Vector2I{}).prepare();
+        int steps = 1;
+        while (!prepared.commit_step(container, adder, callbacks))
+            { ++steps; }
+        return test_that(steps == 4);
+    });
+    mark_it("registers links before setting the region", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        auto adder = edge_container.make_adder();
+        auto prepared = make_load_job(producables, Vector2I{}).prepare();
+        prepared.commit_step(container, adder, callbacks);
+        prepared.commit_step(container, adder, callbacks);
+        return test_that(   callbacks.links.size() == 2
+                         && !container.region_refresh_at(Vector2I{}));
+    });
+});
+describe<RegionChangeScheduler>("RegionChangeScheduler")([] {
+    SquareProducableTile tile;
+    auto producables = make_producables(tile);
+    auto prepare_at = [&producables] (const Vector2I & position) {
+        std::vector<PreparedRegion> prepared;
+        prepared.emplace_back(make_load_job(producables, position).prepare());
+        return prepared;
+    };
+    mark_it("runs everything without a budget", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        RegionPreparationQueue preparations;
+        RegionChangeScheduler scheduler;
+        scheduler.add(prepare_at(Vector2I{}));
+        scheduler.add(prepare_at(Vector2I{1, 0}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        return test_that(!scheduler.has_pending_changes());
+    });
+    mark_it("ignores the budget while nothing is loaded", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        RegionPreparationQueue preparations;
+        RegionChangeScheduler scheduler{0.000000001};
+        scheduler.add(prepare_at(Vector2I{}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        return test_that(!scheduler.has_pending_changes());
+    });
+    mark_it("defers work past the budget, and counts it", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        RegionPreparationQueue preparations;
+        RegionChangeScheduler scheduler{0.000000001};
+        scheduler.add(prepare_at(Vector2I{}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        scheduler.add(prepare_at(Vector2I{1, 0}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        const auto & counters = scheduler.counters();
+        return test_that(   scheduler.has_pending_changes()
+                         && counters.deferred_frames == 1
+                         && counters.deferred_commits == 1);
+    });
+    mark_it("finishes deferred work on later frames", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        RegionPreparationQueue preparations;
+        RegionChangeScheduler scheduler{0.000000001};
+        scheduler.add(prepare_at(Vector2I{}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        scheduler.add(prepare_at(Vector2I{1, 0}));
+        for (int i = 0; i != 8 && scheduler.has_pending_changes(); ++i)
+            { scheduler.run(callbacks, edge_container, container, preparations); }
+        return test_that(   !scheduler.has_pending_changes()
+                         && !!container.region_refresh_at(Vector2I{1, 0}));
+    });
+    mark_it("decays every frame, even while commits use up the budget", [&] {
+        TestTaskCallbacks callbacks;
+        MapRegionContainer container;
+        RegionEdgeConnectionsContainer edge_container;
+        RegionPreparationQueue preparations;
+        RegionChangeScheduler scheduler{0.000000001};
+        scheduler.add(prepare_at(Vector2I{}));
+        scheduler.add(prepare_at(Vector2I{4, 0}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        // the first frame a region isn't kept, it's only marked
+        TestDecayAdder decays;
+        for (int i = 0; i != 2; ++i) {
+            container.region_refresh_at(Vector2I{4, 0})->keep_this_frame();
+            container.decay_regions(decays);
+        }
+        scheduler.add(std::move(decays.decay_jobs));
+        scheduler.add(prepare_at(Vector2I{1, 0}));
+        scheduler.add(prepare_at(Vector2I{2, 0}));
+        scheduler.run(callbacks, edge_container, container, preparations);
+        const auto & counters = scheduler.counters();
+        return test_that(   counters.deferred_commits > 0
+                         && counters.deferred_decays == 0);
+    });
+    mark_it("tells whether a region is waiting to be committed", [&] {
+        RegionChangeScheduler scheduler;
+        scheduler.add(prepare_at(Vector2I{2, 0}));
+        return test_that(   scheduler.is_committing(Vector2I{2, 0})
+                         && !scheduler.is_committing(Vector2I{}));
+    });
+    mark_it("hands over a pending decay only once", [] {
+        RegionChangeScheduler scheduler;
+        std::vector<RegionDecayJob> decay_jobs;
+        decay_jobs.emplace_back
+            (Vector2I{1, 1}, ScaledTriangleViewGrid{}, std::vector<Entity>{});
+        scheduler.add(std::move(decay_jobs));
+        bool first = !!scheduler.take_decay_at(Vector2I{1, 1});
+        bool second = !!scheduler.take_decay_at(Vector2I{1, 1});
+        return test_that(first && !second && !scheduler.has_pending_changes());
+    });
+});
+describe<RegionDecayCollector>("RegionDecayCollector #run_changes")([] {
+    CountingProducableTile tile;
+    auto producables = make_producables(tile);
+    TestTaskCallbacks callbacks;
+    MapRegionContainer container;
+    RegionEdgeConnectionsContainer edge_container;
+    RegionPreparationQueue preparations;
+    RegionChangeScheduler scheduler{0, 1024*1024};
+    RegionLoadCollector load_collector{container};
+    auto run_frame = [&] (bool loads_region) {
+        if (loads_region) {
+            load_collector.collect_load_job
+                (SubRegionPositionFraming{ScaleComputation{}, Vector2I{}},
+                 producables.make_subgrid());
+        }
+        auto decay_collector = load_collector.finish();
+        container.decay_regions(decay_collector);
+        load_collector = decay_collector.run_changes
+            (callbacks, edge_container, container, preparations, scheduler);
+    };
+    // loads, then decays on the second frame it's not requested
+    run_frame(true);
+    run_frame(false);
+    run_frame(false);
+    bool decayed = !container.region_refresh_at(Vector2I{});
+    callbacks.links.clear();
+    run_frame(true);
+    mark_it("revives a decayed region", [&] {
+        return test_that(decayed && !!container.region_refresh_at(Vector2I{}));
+    });
+    mark_it("does not run producables again to revive", [&] {
+        return test_that(tile.produced_count == 1);
+    });
+    mark_it("revives links already linked to each other", [&] {
+        return test_that(   callbacks.links.size() == 2
+                         && callbacks.links[0]->sides_attached_count() == 1);
+    });
+    mark_it("counts the first load a miss, and the revival a hit", [&] {
+        const auto & metrics = scheduler.decayed_regions().metrics();
+        return test_that(metrics.misses == 1 && metrics.hits == 1);
+    });
+});
+return 1;
+
+} ();
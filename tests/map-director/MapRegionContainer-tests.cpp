@@ -100,6 +100,69 @@ describe<MapRegionContainer>("MapRegionContainer")([]
                                     expected_addresses.begin(), expected_addresses.end()));
     });
 });
+describe<MapRegionContainer>("MapRegionContainer grid")([] {
+    struct CountingDecayAdder final : public MapRegionContainer::RegionDecayAdder {
+        void add(const Vector2I &, ScaledTriangleViewGrid &&,
+                 std::vector<Entity> &&) final
+        { ++count; }
+
+        int count = 0;
+    };
+    constexpr const int k_wrap = MapRegionContainer::k_cell_size*
+                                 MapRegionContainer::k_grid_size;
+    mark_it("keeps regions sharing a grid cell apart", [] {
+        MapRegionContainer container;
+        auto region = SingleLinkGrid::make();
+        container.set_region(Vector2I{}, region.grid, {});
+        container.set_region(Vector2I{k_wrap, 0}, region.grid, {});
+        return test_that(   container.region_refresh_at(Vector2I{})
+                         && container.region_refresh_at(Vector2I{k_wrap, 0})
+                         && container.loaded_count() == 2);
+    });
+    mark_it("decays regions both on and off of the grid", [] {
+        MapRegionContainer container;
+        auto region = SingleLinkGrid::make();
+        container.set_region(Vector2I{}, region.grid, {});
+        container.set_region(Vector2I{10, 0}, region.grid, {});
+        container.set_region(Vector2I{k_wrap, 0}, region.grid, {});
+        CountingDecayAdder adder;
+        container.decay_regions(adder);
+        container.decay_regions(adder);
+        return test_that(adder.count == 3 && container.is_empty());
+    });
+    mark_it("keeps refreshed regions, while decaying others", [] {
+        MapRegionContainer container;
+        auto region = SingleLinkGrid::make();
+        for (int i = 0; i != 4; ++i)
+            { container.set_region(Vector2I{i*10, 0}, region.grid, {}); }
+        CountingDecayAdder adder;
+        container.decay_regions(adder);
+        container.region_refresh_at(Vector2I{10, 0})->keep_this_frame();
+        container.region_refresh_at(Vector2I{30, 0})->keep_this_frame();
+        container.decay_regions(adder);
+        return test_that(   adder.count == 2
+                         && container.region_refresh_at(Vector2I{10, 0})
+                         && container.region_refresh_at(Vector2I{30, 0})
+                         && !container.region_refresh_at(Vector2I{20, 0}));
+    });
+    mark_it("does not mistake a negative position for a positive one", [] {
+        MapRegionContainer container;
+        auto region = SingleLinkGrid::make();
+        container.set_region(Vector2I{-1, -1}, region.grid, {});
+        return test_that(   container.region_refresh_at(Vector2I{-1, -1})
+                         && !container.region_refresh_at(Vector2I{}));
+    });
+});
+describe<Vector2IHasher>("Vector2IHasher")([] {
+    mark_it("hashes swapped coordinates differently", [] {
+        Vector2IHasher hash;
+        return test_that(hash(Vector2I{1, 2}) != hash(Vector2I{2, 1}));
+    });
+    mark_it("hashes points along the diagonal differently", [] {
+        Vector2IHasher hash;
+        return test_that(hash(Vector2I{3, 3}) != hash(Vector2I{5, 5}));
+    });
+});
 
 return [] {};
 
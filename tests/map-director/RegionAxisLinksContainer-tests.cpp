@@ -97,25 +97,7 @@ describe<ForEachTileOnEdge>("for_each_tile_on_edge")([] {
     });
 });
 
-describe<RegionAxisLinkEntry>("RegionAxisLinkEntry::computed_bounds")([] {
-    auto sample_link = make_shared<TriangleLink>
-        (Vector{0, 0, 0}, Vector{-10, 100, 9.76}, Vector{5, 87.6, -400});
-    mark_it("computes correct bounds on x-axis", [sample_link] {
-        auto entry = RegionAxisLinkEntry::computed_bounds
-            (sample_link, RegionAxis::x_ways);
-        return test_that(are_very_close(entry.low_bounds (), -10) &&
-                         are_very_close(entry.high_bounds(),   5)   );
-    }).
-    mark_it("computes correct bounds on z-axis", [sample_link] {
-        auto entry = RegionAxisLinkEntry::computed_bounds
-            (sample_link, RegionAxis::z_ways);
-        return test_that(are_very_close(entry.low_bounds (), -400   ) &&
-                         are_very_close(entry.high_bounds(),    9.76)   );
-    });
-});
-
-describe<RegionAxisLinksAdder>("RegionAxisLinksAdder::dedupelicate").
-    depends_on<RegionAxisLinkEntry>()([]
+describe<RegionAxisLinksAdder>("RegionAxisLinksAdder::dedupelicate")([]
 {
     mark_it("removes dupelicate links from the container", [] {
         auto a = make_shared<TriangleLink>();
@@ -130,25 +112,21 @@ describe<RegionAxisLinksAdder>("RegionAxisLinksAdder::dedupelicate").
     });
 });
 
-describe<RegionAxisLinksAdder>("RegionAxisLinksAdder::sort_and_sweep").
-    depends_on<RegionAxisLinkEntry>()([]
+describe<RegionAxisLinksAdder>("RegionAxisLinksAdder::weld")([]
 {
     // how to get certain overlaps?
     auto a = make_view_grid_for_tile(Vector2I{0, 0});
     auto b = make_view_grid_for_tile(Vector2I{0, 1});
     std::vector<RegionAxisLinkEntry> entries;
-    for (auto & link : { a.e, a.w, b.e, b.w }) {
-        entries.emplace_back(RegionAxisLinkEntry::computed_bounds
-            (link, RegionAxis::x_ways));
-    }
-    entries = RegionAxisLinksAdder::sort_and_sweep(std::move(entries));
+    for (auto & link : { a.e, a.w, b.e, b.w })
+        { entries.emplace_back(link); }
+    entries = RegionAxisLinksAdder::weld(std::move(entries));
     mark_it("links relavant triangles together", [&] {
-        return test_that(a.e->transfers_to(TriangleSide::k_side_bc).target() == b.w);
+        return test_that(a.e->transfers_to(TriangleSide::k_side_bc).target() == b.w.get());
     });
 });
 
-describe<RegionAxisLinksRemover>("RegionAxisLinksRemover::null_out_dupelicates").
-    depends_on<RegionAxisLinkEntry>()([]
+describe<RegionAxisLinksRemover>("RegionAxisLinksRemover::null_out_dupelicates")([]
 {
     using Entry = RegionAxisLinkEntry;
     using LinksRemover = RegionAxisLinksRemover;
@@ -198,8 +176,7 @@ describe<RegionAxisLinksRemover>("RegionAxisLinksRemover::null_out_dupelicates")
     });
 });
 
-describe<RegionAxisLinksRemover>("RegionAxisLinksRemover::remove_nulls").
-    depends_on<RegionAxisLinkEntry>()([]
+describe<RegionAxisLinksRemover>("RegionAxisLinksRemover::remove_nulls")([]
 {
     using Entry = RegionAxisLinkEntry;
     using LinksRemover = RegionAxisLinksRemover;
@@ -115,6 +115,46 @@ describe<Whatevs>("RegionEdgeConnectionsContainer")([] {
     });
 });
 
+describe<Whatevs>("RegionEdgeConnectionsContainer seams")([] {
+    using Axis = RegionAxis;
+    auto samp_0_0 = make_view_grid_for_tile(Vector2I{});
+    auto samp_1_0 = make_view_grid_for_tile(Vector2I{1, 0});
+    auto grid_0_0 = make_scaled_triangle_view_grid(samp_0_0.view_grid);
+    auto grid_1_0 = make_scaled_triangle_view_grid(samp_1_0.view_grid);
+    auto usec10 = samp_1_0.e.use_count();
+
+    RegionEdgeConnectionsContainer container;
+    {
+        auto adder = container.make_adder();
+        adder.add(Vector2I{    }, grid_0_0);
+        adder.add(Vector2I{1, 0}, grid_1_0);
+        container = adder.finish();
+    }
+
+    mark_it("neighboring regions share seams on their common axises", [&] {
+        return test_that(container.seam_count() == 5);
+    }).
+    next([&] {
+        auto remover = container.make_remover();
+        remover.remove_region(Vector2I{}, grid_0_0);
+        container = remover.finish();
+    }).
+    mark_it("then remove one region, only its unshared seam is dropped", [&] {
+        return test_that(container.seam_count() == 4 &&
+                         !container.has_seam_at(RegionAxisAddress{Axis::z_ways, 0}) &&
+                          container.has_seam_at(RegionAxisAddress{Axis::z_ways, 1}));
+    }).
+    next([&] {
+        auto remover = container.make_remover();
+        remover.remove_region(Vector2I{1, 0}, grid_1_0);
+        container = remover.finish();
+    }).
+    mark_it("then remove the other region, no seams are left", [&] {
+        return test_that(container.seam_count() == 0 &&
+                         samp_1_0.e.use_count() == usec10);
+    });
+});
+
 return [] {};
 
 } ();
@@ -0,0 +1,153 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/map-director/RegionGeometryCache.hpp"
+#include "../../src/TriangleLink.hpp"
+
+#include "../test-helpers.hpp"
+
+#include <cstdio>
+
+namespace {
+
+using ViewGridTriangle = RegionGeometryCache::ViewGridTriangle;
+
+constexpr const auto k_cache_filename = "region-geometry-cache-tests.tmp";
+constexpr const auto k_saving_cache_filename =
+    "region-geometry-cache-saving-tests.tmp";
+
+// two triangles in a 2x1 grid, sharing a side
+ViewGridTriangle make_linked_grid() {
+    auto link_w = make_shared<TriangleLink>
+        (Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{0, 0, 1});
+    auto link_e = make_shared<TriangleLink>
+        (Vector{1, 0, 0}, Vector{1, 0, 1}, Vector{0, 0, 1});
+    TriangleLink::attach_matching_points(link_w, link_e);
+    ViewGridInserter<SharedPtr<TriangleLink>> inserter{Size2I{2, 1}};
+    inserter.push(link_w);
+    inserter.advance();
+    inserter.push(link_e);
+    inserter.advance();
+    return inserter.finish();
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+
+describe<RegionContentKey>("RegionContentKey")([] {
+    mark_it("is the same no matter the order files are added", [] {
+        RegionContentKey first, second;
+        first.add_file("a.tmx", "<map/>");
+        first.add_file("b.tsx", "<tileset/>");
+        second.add_file("b.tsx", "<tileset/>");
+        second.add_file("a.tmx", "<map/>");
+        return test_that(first.value() == second.value());
+    });
+    mark_it("differs by file contents", [] {
+        RegionContentKey first, second;
+        first.add_file("a.tmx", "<map/>");
+        second.add_file("a.tmx", "<map></map>");
+        return test_that(first.value() != second.value());
+    });
+});
+
+describe<RegionGeometryCache>("RegionGeometryCache")([] {
+    auto original = make_linked_grid();
+    {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        cache.add(Vector2I{4, 5}, original);
+        (void)cache.save();
+    }
+    mark_it("finds regions saved in an earlier run", [] {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        auto found = cache.find(Vector2I{4, 5});
+        return test_that(   found
+                         && found->size2() == Size2I{2, 1}
+                         && found->elements().end() -
+                            found->elements().begin() == 2
+                         && cache.metrics().file_regions == 1);
+    });
+    mark_it("finds regions with their triangles", [&original] {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        auto found = cache.find(Vector2I{4, 5});
+        if (!found) return test_that(false);
+        auto & found_e = *(*found)(1, 0).begin();
+        auto & original_e = *original(1, 0).begin();
+        return test_that(are_very_close
+            (found_e->segment().point_b(), original_e->segment().point_b()));
+    });
+    mark_it("finds regions with their triangles linked to each other", [] {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        auto found = cache.find(Vector2I{4, 5});
+        if (!found) return test_that(false);
+        auto & found_w = *(*found)(0, 0).begin();
+        auto & found_e = *(*found)(1, 0).begin();
+        return test_that(   found_w->sides_attached_count() == 1
+                         && found_e->sides_attached_count() == 1);
+    });
+    mark_it("finds nothing at positions never added", [] {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        return test_that(   !cache.find(Vector2I{})
+                         && cache.metrics().misses == 1);
+    });
+    mark_it("finds nothing saved under another content key", [] {
+        RegionGeometryCache cache{k_cache_filename, 2};
+        return test_that(!cache.find(Vector2I{4, 5}));
+    });
+    mark_it("keeps regions, while sub maps are unchanged", [] {
+        {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        (void)cache.check_sub_map("parts.tmx", 7);
+        (void)cache.save();
+        }
+        RegionGeometryCache cache{k_cache_filename, 1};
+        bool is_unchanged = cache.check_sub_map("parts.tmx", 7);
+        return test_that(is_unchanged && cache.find(Vector2I{4, 5}));
+    });
+    mark_it("drops all regions, once a sub map has changed", [] {
+        RegionGeometryCache cache{k_cache_filename, 1};
+        bool is_unchanged = cache.check_sub_map("parts.tmx", 8);
+        return test_that(!is_unchanged && !cache.find(Vector2I{4, 5}));
+    });
+    mark_it("saves on its own, once enough regions are added", [] {
+        {
+        RegionGeometryCache cache{k_saving_cache_filename, 1, 2};
+        cache.add(Vector2I{}, make_linked_grid());
+        cache.add(Vector2I{1, 0}, make_linked_grid());
+        }
+        RegionGeometryCache cache{k_saving_cache_filename, 1};
+        bool found_all = cache.find(Vector2I{}) && cache.find(Vector2I{1, 0});
+        std::remove(k_saving_cache_filename);
+        return test_that(found_all);
+    });
+    mark_it("keeps nothing without a file", [] {
+        RegionGeometryCache cache;
+        cache.add(Vector2I{4, 5}, make_linked_grid());
+        return test_that(!cache.find(Vector2I{4, 5}));
+    });
+    std::remove(k_cache_filename);
+});
+
+return [] {};
+
+} ();
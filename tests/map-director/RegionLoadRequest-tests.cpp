@@ -150,5 +150,57 @@ describe<RegionLoadRequestOverlapsWith>("RegionLoadRequest::overlaps_with").
     });
 });
 
+describe<RegionPrefetchPlan>("RegionPrefetchPlan::find")([] {
+    mark_it("has no waypoints when the player is still", [] {
+        auto plan = RegionPrefetchPlan::find(Vector{}, Vector{}, 3, 0.5);
+        return test_that(plan.waypoints().empty());
+    }).
+    mark_it("has no waypoints when only falling", [] {
+        auto plan = RegionPrefetchPlan::find(Vector{}, Vector{0, -10, 0}, 3, 0.5);
+        return test_that(plan.waypoints().empty());
+    }).
+    mark_it("has a waypoint for each step up to the horizon", [] {
+        auto plan = RegionPrefetchPlan::find(Vector{}, Vector{4, 0, 0}, 3, 0.5);
+        return test_that(plan.waypoints().size() == 6);
+    }).
+    mark_it("orders waypoints by arrival", [] {
+        auto plan = RegionPrefetchPlan::find(Vector{}, Vector{4, 0, 0}, 3, 0.5);
+        const auto & waypoints = plan.waypoints();
+        for (std::size_t i = 1; i < waypoints.size(); ++i) {
+            if (  waypoints[i - 1].seconds_to_arrival
+                >= waypoints[i].seconds_to_arrival)
+            { return test_that(false); }
+        }
+        return test_that(true);
+    }).
+    mark_it("requests regions ahead of the player", [] {
+        auto plan = RegionPrefetchPlan::find(Vector{}, Vector{10, 0, 0}, 3, 0.5);
+        // player reaches x = 30 (grid position 30, 0) by the last waypoint
+        const auto & last = plan.waypoints().back().request;
+        return test_that(   last.overlaps_with(RectangleI{30, 0, 1, 1})
+                         && !last.overlaps_with(RectangleI{0, 0, 1, 1}));
+    }).
+    mark_it("throws on a non-positive step", [] {
+        return expect_exception<InvalidArgument>([] {
+            (void)RegionPrefetchPlan::find(Vector{}, Vector{4, 0, 0}, 3, 0);
+        });
+    });
+});
+
+describe<RegionPrefetchPlan>("RegionPrefetchPlan::are_same_headings")([] {
+    mark_it("considers a slight turn the same heading", [] {
+        return test_that(RegionPrefetchPlan::are_same_headings
+            (Vector{1, 0, 0}, normalize(Vector{1, 0, 0.2})));
+    }).
+    mark_it("considers a sharp turn a new heading", [] {
+        return test_that(!RegionPrefetchPlan::are_same_headings
+            (Vector{1, 0, 0}, Vector{0, 0, 1}));
+    }).
+    mark_it("considers starting to move a new heading", [] {
+        return test_that(!RegionPrefetchPlan::are_same_headings
+            (Vector{}, Vector{0, 0, 1}));
+    });
+});
+
 return [] {};
 } ();
@@ -132,6 +132,24 @@ struct RectHash final {
     }
 };
 
+/// overlaps only rectangles containing a point, counting every test
+class PointLoadRequest final : public RegionLoadRequestBase {
+public:
+    explicit PointLoadRequest(const Vector2I & point_):
+        point(point_) {}
+
+    bool overlaps_with(const RectangleI & rect) const final {
+        ++test_count;
+        return    rect.left <= point.x && point.x < rect.left + rect.width
+               && rect.top  <= point.y && point.y < rect.top  + rect.height;
+    }
+
+    Size2I max_region_size() const final { return Size2I{1, 1}; }
+
+    Vector2I point;
+    mutable int test_count = 0;
+};
+
 /* private static */ Size2I TestRegionLoadRequest::s_max_size{2, 1};
 /* private static */ bool TestRegionLoadRequest::s_overlaps = true;
 } // end of <anonymous> namespace
@@ -216,6 +234,41 @@ describe<RegionPositionFraming>("RegionPositionFraming#for_each_overlap_")([] {
     });
 });
 
+describe<RegionPositionFraming>("RegionPositionFraming#for_each_overlap: blocks of sub regions")([] {
+    std::vector<RectangleI> visited;
+    auto visit = [&visited]
+        (const RegionPositionFraming &, const RectangleI & rect)
+    { visited.push_back(rect); };
+    mark_it("visits sub regions in the same order as a plain walk", [&] {
+        TestRegionLoadRequest::set_always_overlaps();
+        TestRegionLoadRequest::set_max_region_size(Size2I{1, 1});
+        visited.clear();
+        RegionPositionFraming{ScaleComputation{}}.for_each_overlap
+            (Size2I{3, 2}, TestRegionLoadRequest::instance(), visit);
+        std::vector<RectangleI> expected = {
+            RectangleI{0, 0, 1, 1}, RectangleI{0, 1, 1, 1},
+            RectangleI{1, 0, 1, 1}, RectangleI{1, 1, 1, 1},
+            RectangleI{2, 0, 1, 1}, RectangleI{2, 1, 1, 1}
+        };
+        return test_that(visited == expected);
+    }).
+    mark_it("finds the one overlapping sub region of many", [&] {
+        visited.clear();
+        PointLoadRequest request{Vector2I{21, 13}};
+        RegionPositionFraming{ScaleComputation{2, 1, 2}}.for_each_overlap
+            (Size2I{64, 64}, request, visit);
+        return test_that(   visited.size() == 1
+                         && visited.front() == RectangleI{10, 6, 1, 1});
+    }).
+    mark_it("tests far fewer rectangles than there are sub regions", [&] {
+        PointLoadRequest request{Vector2I{21, 13}};
+        RegionPositionFraming{ScaleComputation{2, 1, 2}}.for_each_overlap
+            (Size2I{64, 64}, request, visit);
+        // two blocks tested for each halving, down to one sub region
+        return test_that(request.test_count <= 1 + 2*12);
+    });
+});
+
 return [] {};
 
 } ();
@@ -0,0 +1,178 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../../src/map-director/map-loader-task/CompiledMap.hpp"
+
+#include "../../test-helpers.hpp"
+
+#include <map>
+
+namespace {
+
+constexpr const auto k_map_filename = "map.tmx";
+constexpr const auto k_tileset_filename = "tileset.tsx";
+
+constexpr const auto k_map_contents =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<map width=\"2\" height=\"2\" tilewidth=\"32\" tileheight=\"32\">"
+    "<tileset firstgid=\"1\" source=\"tileset.tsx\"/>"
+    "<tileset firstgid=\"5\" name=\"inline-tileset\">"
+      "<tile id=\"0\" type=\"inline-type\"/>"
+    "</tileset>"
+    "<layer width=\"2\" height=\"2\">"
+      "<data encoding=\"csv\">1,2,3,4</data>"
+    "</layer>"
+    "<objectgroup><object id=\"1\" name=\"an-object\"/></objectgroup>"
+    "<layer width=\"2\" height=\"2\">"
+      "<data encoding=\"csv\">0,0,5,0</data>"
+    "</layer>"
+    "</map>";
+
+constexpr const auto k_tileset_contents =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<tileset name=\"file-tileset\" tilecount=\"4\">"
+      "<tile id=\"1\" type=\"file-type\"/>"
+    "</tileset>";
+
+using FileMap = std::map<std::string, std::string>;
+
+FileMap make_files() {
+    return FileMap
+        {{k_map_filename, k_map_contents},
+         {k_tileset_filename, k_tileset_contents}};
+}
+
+CompiledMap compile(const FileMap & files) {
+    return CompiledMap::compile
+        (k_map_filename, [&files] (const std::string & filename) {
+            auto itr = files.find(filename);
+            if (itr == files.end()) return Optional<std::string>{};
+            return Optional<std::string>{itr->second};
+        });
+}
+
+bool has_ids(const Grid<int> & layer, const std::vector<int> & ids) {
+    auto itr = ids.begin();
+    for (Vector2I r; r != layer.end_position(); r = layer.next(r)) {
+        if (itr == ids.end() || layer(r) != *itr++) return false;
+    }
+    return itr == ids.end();
+}
+
+bool contains(const std::string & string, const char * part)
+    { return string.find(part) != std::string::npos; }
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+
+describe<CompiledMap>("CompiledMap::compile")([] {
+    auto compiled = compile(make_files());
+    const auto & document = compiled.document_contents();
+    mark_it("keeps the map's and then each tileset's filename", [&] {
+        const auto & filenames = compiled.source_filenames();
+        return test_that(   filenames.size() == 2
+                         && filenames[0] == k_map_filename
+                         && filenames[1] == k_tileset_filename);
+    }).
+    mark_it("decodes each layer, in order", [&] {
+        const auto & layers = compiled.layers();
+        return test_that(   layers.size() == 2
+                         && has_ids(layers[0], {1, 2, 3, 4})
+                         && has_ids(layers[1], {0, 0, 5, 0}));
+    }).
+    mark_it("leaves no layers in the document", [&] {
+        return test_that(!contains(document, "<layer"));
+    }).
+    mark_it("writes tileset files into the document, with their first gid",
+            [&]
+    {
+        return test_that(   contains(document, "file-type")
+                         && contains(document, "firstgid=\"1\"")
+                         && !contains(document, "source=\"tileset.tsx\""));
+    }).
+    mark_it("keeps tilesets already in the map, and objects", [&] {
+        return test_that(   contains(document, "inline-type")
+                         && contains(document, "an-object"));
+    }).
+    mark_it("throws if a tileset file can't be read", [] {
+        auto files = make_files();
+        files.erase(k_tileset_filename);
+        return expect_exception<RuntimeError>([&files] { compile(files); });
+    }).
+    mark_it("throws if a layer can't be decoded", [] {
+        auto files = make_files();
+        files[k_map_filename] =
+            "<map><layer width=\"1\" height=\"1\"></layer></map>";
+        return expect_exception<RuntimeError>([&files] { compile(files); });
+    });
+});
+
+describe<CompiledMap>("CompiledMap::read")([] {
+    auto compiled = compile(make_files());
+    auto bytes = compiled.write();
+    auto read = CompiledMap::read(bytes);
+    mark_it("reads back what was written", [&] {
+        return test_that(   read
+                         && read->source_filenames() == compiled.source_filenames()
+                         && read->document_contents() == compiled.document_contents()
+                         && read->layers().size() == 2
+                         && has_ids(read->layers()[1], {0, 0, 5, 0}));
+    }).
+    mark_it("reads nothing from truncated contents", [&] {
+        for (std::size_t size = 0; size != bytes.size(); ++size) {
+            if (CompiledMap::read(bytes.substr(0, size)))
+                { return test_that(false); }
+        }
+        return test_that(true);
+    }).
+    mark_it("reads nothing from another version", [&] {
+        auto other_version = bytes;
+        ++other_version[sizeof(std::uint32_t)];
+        return test_that(!CompiledMap::read(other_version));
+    }).
+    mark_it("reads nothing if a byte of a layer has changed", [&] {
+        auto damaged = bytes;
+        auto document_size = compiled.document_contents().size();
+        ++damaged[damaged.size() - document_size - sizeof(std::int32_t)];
+        return test_that(!CompiledMap::read(damaged));
+    });
+});
+
+describe<CompiledMap>("CompiledMap::is_compiled_from")([] {
+    auto compiled = compile(make_files());
+    mark_it("is true for the same contents", [&] {
+        return test_that(compiled.is_compiled_from
+            ({k_map_contents, k_tileset_contents}));
+    }).
+    mark_it("is false if a tileset has changed", [&] {
+        return test_that(!compiled.is_compiled_from
+            ({k_map_contents, std::string{k_tileset_contents} + " "}));
+    }).
+    mark_it("is false if missing a source", [&] {
+        return test_that(!compiled.is_compiled_from({k_map_contents}));
+    });
+});
+
+return [] {};
+
+} ();
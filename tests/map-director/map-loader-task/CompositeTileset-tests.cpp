@@ -162,8 +162,11 @@ describe("CompositeTileset")([] {
     (void)tileset.load(doc, TestMapContentLoader::instance());
     std::vector<NewTaskEntry> new_tasks;
     ReturnToTasksCollection col;
-    mark_it("waits on a map loading task", [&] {
-        return test_that(continuation.has_waited_on_tasks());
+    mark_it("defers loading its sub map, until first overlapped", [&] {
+        return test_that(!continuation.has_waited_on_tasks());
+    }).
+    mark_it("is not shared with other maps", [&] {
+        return test_that(!tileset.is_shareable());
     });
 });
 
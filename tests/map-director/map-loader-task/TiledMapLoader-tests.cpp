@@ -19,6 +19,7 @@
 *****************************************************************************/
 
 #include "../../../src/map-director/map-loader-task/TiledMapLoader.hpp"
+#include "../../../src/map-director/map-loader-task/CompiledMap.hpp"
 #include "TestMapContentLoader.hpp"
 #include "../../test-helpers.hpp"
 
@@ -42,6 +43,20 @@ constexpr auto k_test_map_content =
     "</layer>"
     "</map>";
 
+constexpr auto k_one_tile_test_map_content =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<map version=\"1.8\" tiledversion=\"1.8.0\" orientation=\"orthogonal\" "
+         "renderorder=\"right-down\" width=\"2\" height=\"2\" tilewidth=\"32\" "
+         "tileheight=\"32\" infinite=\"0\" nextlayerid=\"2\" nextobjectid=\"1\">"
+    "<tileset firstgid=\"1\" name=\"test-tileset\" tilewidth=\"32\" tileheight=\"32\" tilecount=\"1\" columns=\"1\">"
+      "<image source=\"test-tileset.png\" width=\"32\" height=\"32\"/>"
+      "<tile id=\"0\" type=\"test-tile-type\"></tile>"
+    "</tileset>"
+    "<layer id=\"1\" name=\"Tile Layer 1\" width=\"2\" height=\"2\">"
+      "<data encoding=\"csv\">1,0,0,0</data>"
+    "</layer>"
+    "</map>";
+
 using namespace cul::tree_ts;
 using ProducableGroupCreation = ProducableGroupFiller::ProducableGroupCreation;
 
@@ -69,6 +84,7 @@ struct Info final {
 class TestMapContentLoader final : public TestMapContentLoaderCommon {
 public:
     static constexpr const auto k_test_map = "test-map";
+    static constexpr const auto k_compiled_test_map = "test-map.compiled";
 
     static TestMapContentLoader & instance() {
         static TestMapContentLoader inst;
@@ -76,14 +92,31 @@ public:
     }
 
     FutureStringPtr promise_file_contents(const char * fn) final {
-        if (::strcmp(fn, k_test_map))
+        Optional<std::string> contents;
+        if (!::strcmp(fn, k_test_map))
+            { contents = std::string{k_test_map_content}; }
+        else if (!::strcmp(fn, k_compiled_test_map))
+            { contents = compiled_map_contents; }
+        else
             { throw "unhandled"; }
         class Impl final : public Future<std::string> {
-            OptionalEither<Lost, std::string> retrieve()
-                { return std::string{k_test_map_content}; }
+        public:
+            explicit Impl(Optional<std::string> && contents_):
+                m_contents(std::move(contents_)) {}
+
+            OptionalEither<Lost, std::string> retrieve() {
+                if (m_contents) return *m_contents;
+                return Lost{};
+            }
+
+        private:
+            Optional<std::string> m_contents;
         };
-        return make_shared<Impl>();
+        return make_shared<Impl>(std::move(contents));
     }
+
+    // there's no compiled map, unless set
+    Optional<std::string> compiled_map_contents;
 };
 
 class TestPlatform final : public Platform {
@@ -129,6 +162,28 @@ public:
         { return TestPlatform::instance(); }
 };
 
+std::string compile_test_map(const char * map_contents) {
+    auto read_file = [map_contents] (const std::string &)
+        { return Optional<std::string>{map_contents}; };
+    return CompiledMap::
+        compile(TestMapContentLoader::k_test_map, read_file).
+        write();
+}
+
+tiled_map_loading::MapLoadStateMachine::MapLoadResult
+    load_test_map(TestMapContentLoader & content_loader)
+{
+    auto sm = tiled_map_loading::MapLoadStateMachine::
+        make_with_starting_state
+            (content_loader, TestMapContentLoader::k_test_map);
+    sm.update_progress(content_loader);
+    (void)content_loader.waited_on_tasks.front()->in_background
+        (TestTaskCallbacks::instance(),
+         content_loader.coninuation_strategy);
+    sm.update_progress(content_loader);
+    return sm.update_progress(content_loader);
+}
+
 } // end of <anonymous> namespace
 
 [[maybe_unused]] static auto s_add_describes = [] {
@@ -140,15 +195,30 @@ describe("TiledMapLoader")([] {
     auto & content_loader =
         TestMapContentLoader::instance() =
         TestMapContentLoader{};
-    auto sm = tiled_map_loading::MapLoadStateMachine::
-        make_with_starting_state
-            (content_loader, TestMapContentLoader::k_test_map);
-    sm.update_progress(content_loader);
-    (void)content_loader.waited_on_tasks.front()->in_background
-        (TestTaskCallbacks::instance(),
-         content_loader.coninuation_strategy);
-    sm.update_progress(content_loader);
-    auto res = sm.update_progress(content_loader);
+    auto res = load_test_map(content_loader);
+    mark_it("successfully loads a map", [&] {
+        return test_that(res.is_right());
+    }).
+    mark_it("creates map of expected size", [&] {
+        std::unordered_set<Vector2I, Vector2IHasher> map_locations =
+            { Vector2I{0, 0}, Vector2I{0, 1}, Vector2I{1, 0}, Vector2I{1, 1} };
+        for (auto & tile : cret.created_tiles()) {
+            map_locations.erase(tile.on_map);
+        }
+        return test_that(map_locations.empty());
+    });
+});
+
+describe("TiledMapLoader with a compiled map")([] {
+    auto & cret =
+        TestProducableGroupCreation::instance() =
+        TestProducableGroupCreation{};
+    auto & content_loader =
+        TestMapContentLoader::instance() =
+        TestMapContentLoader{};
+    content_loader.compiled_map_contents =
+        compile_test_map(k_test_map_content);
+    auto res = load_test_map(content_loader);
     mark_it("successfully loads a map", [&] {
         return test_that(res.is_right());
     }).
@@ -159,6 +229,18 @@ describe("TiledMapLoader")([] {
             map_locations.erase(tile.on_map);
         }
         return test_that(map_locations.empty());
+    }).
+    mark_it("loads the map itself, if compiled from other contents", [&] {
+        auto & cret =
+            TestProducableGroupCreation::instance() =
+            TestProducableGroupCreation{};
+        auto & content_loader =
+            TestMapContentLoader::instance() =
+            TestMapContentLoader{};
+        content_loader.compiled_map_contents =
+            compile_test_map(k_one_tile_test_map_content);
+        auto res = load_test_map(content_loader);
+        return test_that(res.is_right() && cret.created_tiles().size() == 4);
     });
 });
 
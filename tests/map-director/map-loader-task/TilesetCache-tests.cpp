@@ -0,0 +1,127 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../../src/map-director/map-loader-task/TilesetCache.hpp"
+
+#include "../../test-helpers.hpp"
+
+namespace {
+
+using FillerFactoryMap = TilesetCache::FillerFactoryMap;
+
+class TestTileset final : public TilesetBase {
+public:
+    Continuation & load
+        (const DocumentOwningXmlElement &, MapContentLoader &) final
+        { throw "unhandled"; }
+
+    void add_map_elements
+        (TilesetMapElementCollector &, const TilesetLayerWrapper &) const final
+        {}
+
+private:
+    Size2I size2() const final { return Size2I{}; }
+};
+
+const FillerFactoryMap & test_fillers() {
+    static FillerFactoryMap s_fillers;
+    return s_fillers;
+}
+
+TilesetCache::Key test_key_for
+    (const std::string & filename, const std::string & contents)
+{ return TilesetCache::key_for(filename, contents, test_fillers()); }
+
+void add_test_tileset
+    (TilesetCache & cache,
+     const std::string & filename,
+     const std::string & contents)
+{ cache.add(test_key_for(filename, contents), make_shared<TestTileset>()); }
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+
+describe<TilesetCache>("TilesetCache")([] {
+    mark_it("finds an added tileset, counting a hit", [] {
+        TilesetCache cache{1024};
+        auto tileset = make_shared<TestTileset>();
+        cache.add(test_key_for("a.tsx", "contents"), tileset);
+        return test_that(   cache.find(test_key_for("a.tsx", "contents")) ==
+                            tileset
+                         && cache.metrics().hits == 1);
+    });
+    mark_it("does not find a tileset from a changed file", [] {
+        TilesetCache cache{1024};
+        add_test_tileset(cache, "a.tsx", "contents");
+        return test_that(   !cache.find(test_key_for("a.tsx", "changed"))
+                         && cache.metrics().misses == 1);
+    });
+    mark_it("does not find a tileset made with other fillers", [] {
+        TilesetCache cache{1024};
+        FillerFactoryMap other_fillers;
+        other_fillers.emplace("other", nullptr);
+        add_test_tileset(cache, "a.tsx", "contents");
+        return test_that(!cache.find(TilesetCache::key_for
+            ("a.tsx", "contents", other_fillers)));
+    });
+    mark_it("evicts the least recently used past its budget", [] {
+        TilesetCache cache{16};
+        add_test_tileset(cache, "a.tsx", "aaaaaaaa");
+        add_test_tileset(cache, "b.tsx", "bbbbbbbb");
+        (void)cache.find(test_key_for("a.tsx", "aaaaaaaa"));
+        add_test_tileset(cache, "c.tsx", "cccccccc");
+        return test_that(   cache.find(test_key_for("a.tsx", "aaaaaaaa"))
+                         && !cache.find(test_key_for("b.tsx", "bbbbbbbb"))
+                         && cache.find(test_key_for("c.tsx", "cccccccc"))
+                         && cache.metrics().evictions == 1
+                         && cache.metrics().bytes_held == 16);
+    });
+    mark_it("keeps tilesets still in use past its budget", [] {
+        TilesetCache cache{8};
+        auto in_use = make_shared<TestTileset>();
+        cache.add(test_key_for("a.tsx", "aaaaaaaa"), in_use);
+        cache.add(test_key_for("b.tsx", "bbbbbbbb"), in_use);
+        return test_that(   cache.size() == 2
+                         && cache.metrics().evictions == 0);
+    });
+    mark_it("counts loaded bytes toward its budget", [] {
+        TilesetCache cache{1024};
+        cache.add(test_key_for("a.tsx", "aaaaaaaa"),
+                  make_shared<TestTileset>(), 100);
+        return test_that(cache.metrics().bytes_held == 108);
+    });
+    mark_it("is shared only for as long as it's held", [] {
+        auto held = TilesetCache::make_shared_cache();
+        bool was_shared = TilesetCache::shared() == held.get();
+        held = nullptr;
+        return test_that(was_shared && !TilesetCache::shared());
+    });
+    mark_it("keeps nothing without a budget", [] {
+        TilesetCache cache;
+        add_test_tileset(cache, "a.tsx", "contents");
+        return test_that(cache.size() == 0);
+    });
+});
+return 1;
+
+} ();
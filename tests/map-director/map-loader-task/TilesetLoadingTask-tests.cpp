@@ -24,7 +24,9 @@
 
 #include <tinyxml2.h>
 
+#include <chrono>
 #include <set>
+#include <thread>
 
 namespace {
 
@@ -72,6 +74,29 @@ private:
     bool m_file_contents_available = false;
 };
 
+class PooledTestMapContentLoader final : public TestMapContentLoaderCommon {
+public:
+    static PooledTestMapContentLoader & instance() {
+        static PooledTestMapContentLoader inst;
+        return inst;
+    }
+
+    FutureStringPtr promise_file_contents(const char * fn) final {
+        if (::strcmp(fn, TestMapContentLoader::k_test_tileset))
+            { throw "unhandled"; }
+        class Impl final : public Future<std::string> {
+            OptionalEither<Lost, std::string> retrieve()
+                { return std::string{k_test_tileset_content}; }
+        };
+        return make_shared<Impl>();
+    }
+
+    TilesetLoadingPool * tileset_loading_pool() const final {
+        static TilesetLoadingPool pool{1};
+        return &pool;
+    }
+};
+
 class TestTaskCallbacks final : public TaskCallbacks {
 public:
     static TestTaskCallbacks & instance() {
@@ -117,6 +142,28 @@ describe("TilesetLoadingTask")([] {
     });
 });
 
+describe("TilesetLoadingTask with a loading pool")([] {
+    auto task = TilesetLoadingTask::begin_loading
+        (TestMapContentLoader::k_test_tileset,
+         PooledTestMapContentLoader::instance());
+    mark_it("finishes once the worker has loaded the tileset", [&] {
+        auto & callbacks = TestTaskCallbacks::instance();
+        auto & strat =
+            PooledTestMapContentLoader::instance().coninuation_strategy;
+        const auto & completion =
+            BackgroundTask::Continuation::task_completion();
+        for (int i = 0; i != 1000; ++i) {
+            if (&task.in_background(callbacks, strat) == &completion)
+                { break; }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        auto res = task.retrieve();
+        if (res.is_empty()) return test_that(false);
+        auto loaded = res.require();
+        return test_that(loaded.is_right() && !!loaded.right());
+    });
+});
+
 return [] {};
 
 } ();
@@ -0,0 +1,146 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../../src/map-director/map-loader-task/tile-layer-decoding.hpp"
+
+#include "../../test-helpers.hpp"
+
+#include <cstring>
+
+namespace {
+
+using namespace tile_layer_decoding;
+using namespace map_loading_messages;
+
+// tile ids 1 through 6, as little endian 32-bit integers
+constexpr const auto k_base64_ids = "AQAAAAIAAAADAAAABAAAAAUAAAAGAAAA";
+constexpr const auto k_zlib_ids = "eNpjZGBgYAJiZiBmAWJWIGYDYgAA+AAW";
+constexpr const auto k_gzip_ids =
+    "H4sIAAAAAAACA2NkYGBgAmJmIGYBYlYgZgNiAL4Hb68YAAAA";
+
+Grid<int> make_layer() {
+    Grid<int> layer;
+    layer.set_size(3, 2, 0);
+    return layer;
+}
+
+bool has_ids_one_through_six(Grid<int> & layer) {
+    int expected = 1;
+    for (Vector2I r; r != layer.end_position(); r = layer.next(r)) {
+        if (layer(r) != expected++) return false;
+    }
+    return true;
+}
+
+Optional<MapLoadingWarningEnum> decode_csv_(const char * text, Grid<int> & layer)
+    { return decode_csv(text, text + ::strlen(text), layer); }
+
+Optional<MapLoadingWarningEnum> decode_base64_
+    (const char * text, const char * compression, Grid<int> & layer)
+{ return decode_base64(text, text + ::strlen(text), compression, layer); }
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+
+using namespace cul::tree_ts;
+
+describe("tile_layer_decoding::decode_csv")([] {
+    mark_it("writes ids in order, ignoring whitespace", [] {
+        auto layer = make_layer();
+        auto warning = decode_csv_("\n1,2, 3,\n 4,5,6\n", layer);
+        return test_that(!warning && has_ids_one_through_six(layer));
+    }).
+    mark_it("leaves tiles without entries as they were", [] {
+        auto layer = make_layer();
+        auto warning = decode_csv_("1,2", layer);
+        return test_that(!warning && layer(Vector2I{2, 1}) == 0);
+    }).
+    mark_it("rejects empty entries", [] {
+        auto layer = make_layer();
+        return test_that(decode_csv_("1,,2", layer) == k_invalid_tile_data);
+    }).
+    mark_it("rejects entries which are not numbers", [] {
+        auto layer = make_layer();
+        return test_that(decode_csv_("1,a,2", layer) == k_invalid_tile_data);
+    }).
+    mark_it("rejects more entries than tiles", [] {
+        auto layer = make_layer();
+        return test_that
+            (decode_csv_("1,2,3,4,5,6,7", layer) == k_invalid_tile_data);
+    }).
+    mark_it("rejects ids out of range", [] {
+        auto layer = make_layer();
+        return test_that
+            (decode_csv_("2147483648", layer) == k_invalid_tile_data);
+    });
+});
+
+describe("tile_layer_decoding::decode_base64")([] {
+    mark_it("decodes uncompressed ids", [] {
+        auto layer = make_layer();
+        auto warning = decode_base64_(k_base64_ids, nullptr, layer);
+        return test_that(!warning && has_ids_one_through_six(layer));
+    }).
+    mark_it("decodes zlib compressed ids", [] {
+        auto layer = make_layer();
+        auto warning = decode_base64_(k_zlib_ids, "zlib", layer);
+        return test_that(!warning && has_ids_one_through_six(layer));
+    }).
+    mark_it("decodes gzip compressed ids", [] {
+        auto layer = make_layer();
+        auto warning = decode_base64_(k_gzip_ids, "gzip", layer);
+        return test_that(!warning && has_ids_one_through_six(layer));
+    }).
+    mark_it("rejects data that does not fill the layer exactly", [] {
+        Grid<int> layer;
+        layer.set_size(2, 2, 0);
+        return test_that
+            (decode_base64_(k_base64_ids, nullptr, layer) == k_invalid_tile_data);
+    }).
+    mark_it("rejects corrupted compressed data", [] {
+        auto layer = make_layer();
+        // last character changed, breaking the checksum
+        return test_that(decode_base64_
+            ("eNpjZGBgYAJiZiBmAWJWIGYDYgAA+AAX", "zlib", layer)
+            == k_invalid_tile_data);
+    }).
+    mark_it("does not support other compressions", [] {
+        auto layer = make_layer();
+        return test_that(decode_base64_(k_zlib_ids, "zstd", layer)
+                         == k_unsupported_tile_data_encoding);
+    });
+});
+
+describe("tile_layer_decoding::base64_to_bytes")([] {
+    mark_it("decodes padded text", [] {
+        const char * text = "aGVsbG8=";
+        auto bytes = base64_to_bytes(text, text + ::strlen(text));
+        return test_that(bytes && *bytes == Bytes{'h', 'e', 'l', 'l', 'o'});
+    }).
+    mark_it("rejects characters outside of its alphabet", [] {
+        const char * text = "aGVs*bG8=";
+        return test_that(!base64_to_bytes(text, text + ::strlen(text)));
+    });
+});
+
+return [] {};
+
+} ();
@@ -0,0 +1,117 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/point-and-plane/DriverComplete.hpp"
+
+#include "../test-helpers.hpp"
+
+namespace {
+
+using namespace point_and_plane;
+
+class StopOnHitHandler final : public EventHandler {
+public:
+    Variant<Vector2, Vector>
+        on_triangle_hit
+        (const Triangle &, const Vector &, const Vector2 &, const Vector &) const final
+        { return Vector2{}; }
+
+    Variant<Vector, Vector2>
+        on_transfer_absent_link
+        (const Triangle &, const SideCrossing &, const Vector2 &) const final
+        { return Vector2{}; }
+
+    Variant<Vector, TransferOnSegment>
+        on_transfer
+        (const Triangle &, const SideCrossing &, const Triangle &,
+         const Vector &) const final
+        { return TransferOnSegment{Vector2{}, false}; }
+};
+
+void add_floor(DriverComplete & driver) {
+    for (int z = 0; z != 8; ++z) {
+    for (int x = 0; x != 8; ++x) {
+        Vector r{Real(x), 0, Real(z)};
+        driver.add_triangle(make_shared<TriangleLink>
+            (r, r + Vector{1, 0, 0}, r + Vector{1, 0, 1}));
+        driver.add_triangle(make_shared<TriangleLink>
+            (r, r + Vector{1, 0, 1}, r + Vector{0, 0, 1}));
+    }}
+    driver.update();
+}
+
+std::vector<State> make_falling_bodies() {
+    std::vector<State> states;
+    for (int i = 0; i != 24; ++i) {
+        Vector r{0.3 + (i % 6)*1.1, 1, 0.4 + (i / 6)*1.7};
+        states.emplace_back(InAir{r, Vector{0.05, -2, 0.05}});
+    }
+    // one that never lands
+    states.emplace_back(InAir{Vector{-5, 1, -5}, Vector{0, -2, 0}});
+    return states;
+}
+
+bool step_all_matches_each
+    (BroadphaseType broadphase_type, int thread_count)
+{
+    DriverComplete driver{broadphase_type};
+    add_floor(driver);
+    StopOnHitHandler handler;
+    auto states = make_falling_bodies();
+    std::vector<BodyStep> steps;
+    for (auto & state : states)
+        { steps.emplace_back(&state, &handler); }
+    auto expected = make_falling_bodies();
+    for (auto & state : expected)
+        { state = driver(state, handler); }
+    driver.step_all
+        (View{steps.data(), steps.data() + steps.size()}, thread_count);
+    for (std::size_t i = 0; i != states.size(); ++i) {
+        if (states[i].index() != expected[i].index())
+            { return false; }
+        if (!are_very_close(location_of(states[i]), location_of(expected[i])))
+            { return false; }
+    }
+    return true;
+}
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+using namespace cul::tree_ts;
+
+describe<DriverComplete>("DriverComplete #step_all")([] {
+    using Bt = BroadphaseType;
+    mark_it("lands bodies just as stepping each would", [] {
+        return test_that(step_all_matches_each(Bt::projected_partition, 1));
+    });
+    mark_it("does so with a hashed grid", [] {
+        return test_that(step_all_matches_each(Bt::hashed_grid, 1));
+    });
+    mark_it("does so with a bounding box tree", [] {
+        return test_that(step_all_matches_each(Bt::bounding_box_tree, 1));
+    });
+    mark_it("does so across several threads", [] {
+        return test_that(step_all_matches_each(Bt::projected_partition, 3));
+    });
+});
+
+return 1;
+} ();
@@ -0,0 +1,136 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/point-and-plane/DynamicSpatialPartitionMap.hpp"
+
+#include "../test-helpers.hpp"
+
+namespace {
+
+using Interval = ProjectionLine::Interval;
+
+template <typename ... Types>
+SharedPtr<const TriangleLink> make_triangle_link(Types && ... args)
+    { return make_shared<TriangleLink>(std::forward<Types>(args)...); }
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+using namespace cul::tree_ts;
+
+describe<DynamicSpatialPartitionMap>("DynamicSpatialPartitionMap")([] {
+    using Entry = DynamicSpatialPartitionMap::Entry;
+    using EntryContainer = DynamicSpatialPartitionMap::EntryContainer;
+
+    auto a_link = make_triangle_link();
+    auto b_link = make_triangle_link();
+    auto c_link = make_triangle_link();
+    auto d_link = make_triangle_link();
+    auto e_link = make_triangle_link();
+    Entry a{0.  , 0.25, a_link};
+    Entry b{0.2 , 0.45, b_link};
+    Entry c{0.3 , 0.55, c_link};
+    Entry d{0.5 , 0.6 , d_link};
+    Entry e{0.55, 0.65, e_link};
+
+    mark_it("an empty map provides an empty view", [] {
+        DynamicSpatialPartitionMap container;
+        auto view = container.view_for(Interval{-k_inf, k_inf});
+        return test_that(view.begin() == view.end());
+    });
+    mark_it("finds entries present when populated", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c, d, e}};
+        auto view = container.view_for(Interval{0.29, 0.4});
+        return test_that(   view_contains(view, b_link)
+                         && view_contains(view, c_link));
+    });
+    mark_it("finds an entry inserted after populating", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c, d}};
+        container.insert(e);
+        auto view = container.view_for(Interval{0.62, 0.63});
+        return test_that(view_contains(view, e_link));
+    });
+    mark_it("finds an entry inserted outside of all divisions", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c}};
+        auto f_link = make_triangle_link();
+        container.insert(Entry{-10., -9., f_link});
+        auto view = container.view_for(Interval{-9.5, -9.5});
+        return test_that(view_contains(view, f_link));
+    });
+    mark_it("does not find an erased entry", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c, d, e}};
+        bool erased = container.erase(c);
+        auto view = container.view_for(Interval{-k_inf, k_inf});
+        return test_that(erased && !view_contains(view, c_link));
+    });
+    mark_it("still finds other entries after one is erased", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c, d, e}};
+        container.erase(c);
+        auto view = container.view_for(Interval{0.29, 0.4});
+        return test_that(view_contains(view, b_link));
+    });
+    mark_it("provides each element exactly once", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c, d, e}};
+        auto elements = container.elements();
+        return test_that(   elements.size() == 5
+                         && std::count(elements.begin(), elements.end(), c_link) == 1);
+    });
+    mark_it("needs rebalancing after many inserts into one bucket", [&] {
+        DynamicSpatialPartitionMap container{EntryContainer{a, b, c, d, e}};
+        for (int i = 0; i != 32; ++i) {
+            container.insert(Entry{0.01, 0.02, make_triangle_link()});
+        }
+        return test_that(container.needs_rebalance());
+    });
+});
+
+describe<DynamicProjectedSpatialMap>("DynamicProjectedSpatialMap").
+    depends_on<DynamicSpatialPartitionMap>()([]
+{
+    auto make_link_at = [] (Real x) {
+        return make_triangle_link
+            (Vector{x, 0, 0}, Vector{x + 1, 0, 0}, Vector{x + 1, 1, 0});
+    };
+    DynamicProjectedSpatialMap psm;
+    std::vector<SharedPtr<const TriangleLink>> links;
+    for (int i = 0; i != 64; ++i) {
+        links.push_back(make_link_at(Real(i)));
+        psm.insert(links.back());
+    }
+    psm.rebalance_if_needed();
+    mark_it("finds a triangle after rebalancing", [&] {
+        auto view = psm.view_for(Vector{40.5, 0, 0}, Vector{40.5, 0, 0});
+        return test_that(view_contains(view, links[40]));
+    });
+    mark_it("does not find a triangle removed after rebalancing", [&] {
+        psm.erase(links[40]);
+        auto view = psm.view_for(Vector{40.5, 0, 0}, Vector{40.5, 0, 0});
+        return test_that(!view_contains(view, links[40]));
+    });
+    mark_it("finds a triangle inserted far beyond all others", [&] {
+        auto far_link = make_link_at(1000);
+        psm.insert(far_link);
+        auto view = psm.view_for(Vector{1000.5, 0, 0}, Vector{1000.5, 0, 0});
+        return test_that(view_contains(view, far_link));
+    });
+});
+
+return 1;
+} ();
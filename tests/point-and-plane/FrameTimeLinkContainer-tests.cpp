@@ -56,6 +56,22 @@ describe<FrameTimeLinkContainer>("FrameTimeLinkContainer")([] {
         auto b_res = std::find(view.begin(), view.end(), b);
         return test_that(b_res == view.end());
     });
+    mark_it("keeps an object removed and re-added before update", [&] {
+        ftlc.defer_removal_of(a);
+        ftlc.defer_addition_of(a);
+        ftlc.update();
+        auto view = make_view();
+        auto a_res = std::find(view.begin(), view.end(), a);
+        return test_that(a_res != view.end());
+    });
+    mark_it("never adds an object added and removed before update", [&] {
+        ftlc.defer_addition_of(b);
+        ftlc.defer_removal_of(b);
+        ftlc.update();
+        auto view = make_view();
+        auto b_res = std::find(view.begin(), view.end(), b);
+        return test_that(b_res == view.end());
+    });
 });
 
 class Dummy final {};
@@ -0,0 +1,71 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/point-and-plane/HashedLinkGrid.hpp"
+
+#include "../test-helpers.hpp"
+
+[[maybe_unused]] static auto s_add_describes = [] {
+using namespace cul::tree_ts;
+
+describe<HashedLinkGrid>("HashedLinkGrid")([] {
+    auto a = make_triangle_link_near(Vector{  0, 0,   0});
+    auto b = make_triangle_link_near(Vector{ 10, 0,   0});
+    auto c = make_triangle_link_near(Vector{  0, 0, -10});
+    mark_it("an empty grid provides an empty view", [] {
+        HashedLinkGrid grid;
+        auto view = grid.view_for(Vector{-10, -10, -10}, Vector{10, 10, 10});
+        return test_that(view.begin() == view.end());
+    });
+    mark_it("finds a link near the query", [&] {
+        HashedLinkGrid grid;
+        for (auto & link : { a, b, c }) grid.insert(link);
+        auto view = grid.view_for(Vector{9.5, 1, 0.5}, Vector{10.5, -1, 0.5});
+        return test_that(view_contains(view, b));
+    });
+    mark_it("does not find links far away in any direction", [&] {
+        HashedLinkGrid grid;
+        for (auto & link : { a, b, c }) grid.insert(link);
+        auto view = grid.view_for(Vector{9.5, 1, 0.5}, Vector{10.5, -1, 0.5});
+        return test_that(   !view_contains(view, a)
+                         && !view_contains(view, c));
+    });
+    mark_it("no longer finds an erased link", [&] {
+        HashedLinkGrid grid;
+        for (auto & link : { a, b, c }) grid.insert(link);
+        bool erased = grid.erase(b);
+        auto view = grid.view_for(Vector{-20, -20, -20}, Vector{20, 20, 20});
+        return test_that(   erased && grid.count() == 2
+                         && !view_contains(view, b));
+    });
+    mark_it("does not erase a link never inserted", [&] {
+        HashedLinkGrid grid;
+        grid.insert(a);
+        return test_that(!grid.erase(c));
+    });
+    mark_it("throws on non-positive cell size", [] {
+        return expect_exception<InvalidArgument>([] {
+            HashedLinkGrid{0.};
+        });
+    });
+});
+
+return 1;
+} ();
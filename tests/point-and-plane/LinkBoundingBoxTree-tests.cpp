@@ -0,0 +1,91 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/point-and-plane/LinkBoundingBoxTree.hpp"
+
+#include "../test-helpers.hpp"
+
+namespace {
+
+template <typename ViewType>
+int count_in(const ViewType & view)
+    { return int(std::distance(view.begin(), view.end())); }
+
+} // end of <anonymous> namespace
+
+[[maybe_unused]] static auto s_add_describes = [] {
+using namespace cul::tree_ts;
+
+describe<LinkBoundingBoxTree>("LinkBoundingBoxTree")([] {
+    auto a = make_triangle_link_near(Vector{  0, 0,   0});
+    auto b = make_triangle_link_near(Vector{ 10, 0,   0});
+    auto c = make_triangle_link_near(Vector{  0, 0, -10});
+    mark_it("an empty tree provides an empty view", [] {
+        LinkBoundingBoxTree tree;
+        auto view = tree.view_for(Vector{-10, -10, -10}, Vector{10, 10, 10});
+        return test_that(view.begin() == view.end() && tree.height() == -1);
+    });
+    mark_it("finds a link near the query, and only that link", [&] {
+        LinkBoundingBoxTree tree;
+        for (auto & link : { a, b, c }) tree.insert(link);
+        auto view = tree.view_for(Vector{10.5, 1, 0.5}, Vector{10.5, -1, 0.5});
+        return test_that(view_contains(view, b) && count_in(view) == 1);
+    });
+    mark_it("finds every link with a query covering all of them", [&] {
+        LinkBoundingBoxTree tree;
+        for (auto & link : { a, b, c }) tree.insert(link);
+        auto view = tree.view_for(Vector{-20, -20, -20}, Vector{20, 20, 20});
+        return test_that(count_in(view) == 3);
+    });
+    mark_it("no longer finds an erased link", [&] {
+        LinkBoundingBoxTree tree;
+        for (auto & link : { a, b, c }) tree.insert(link);
+        bool erased = tree.erase(a);
+        auto view = tree.view_for(Vector{-20, -20, -20}, Vector{20, 20, 20});
+        return test_that(   erased && tree.count() == 2
+                         && !view_contains(view, a) && count_in(view) == 2);
+    });
+    mark_it("stays near balanced, after inserting a long row of links", [] {
+        LinkBoundingBoxTree tree;
+        for (int i = 0; i != 1024; ++i)
+            { tree.insert(make_triangle_link_near(Vector{Real(i), 0, 0})); }
+        tree.rebalance_if_needed();
+        // a perfectly balanced tree would have a height of 10
+        return test_that(tree.height() <= 2*10 + 4);
+    });
+    mark_it("finds all links, after erasing and reinserting many", [] {
+        LinkBoundingBoxTree tree;
+        std::vector<SharedPtr<const TriangleLink>> links;
+        for (int i = 0; i != 64; ++i) {
+            links.push_back(make_triangle_link_near(Vector{Real(i % 8), 0, Real(i / 8)}));
+            tree.insert(links.back());
+        }
+        for (int i = 0; i < 64; i += 2)
+            { tree.erase(links[i]); }
+        for (int i = 0; i < 64; i += 4)
+            { tree.insert(links[i]); }
+        tree.rebalance_if_needed();
+        auto view = tree.view_for(Vector{-1, -1, -1}, Vector{10, 1, 10});
+        return test_that(count_in(view) == 32 + 16);
+    });
+});
+
+return 1;
+} ();
@@ -0,0 +1,88 @@
+/******************************************************************************
+
+    GPLv3 License
+    Copyright (c) 2023 Aria Janke
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "../../src/point-and-plane/PackedTriangleBatch.hpp"
+
+#include "../test-helpers.hpp"
+
+#include <random>
+
+[[maybe_unused]] static auto s_add_describes = [] {
+using namespace cul::tree_ts;
+
+describe<PackedTriangleBatch>("PackedTriangleBatch")([] {
+    TriangleSegment flat
+        {Vector{0, 0, 0}, Vector{1, 0, 0}, Vector{0, 0, 1}};
+    mark_it("keeps a triangle that's hit", [&] {
+        PackedTriangleBatch batch;
+        batch.push(flat);
+        auto hits = batch.possibly_hit_by
+            (Vector{0.25, 1, 0.25}, Vector{0.25, -1, 0.25});
+        return test_that(hits == 1u);
+    });
+    mark_it("rules out a triangle, whose plane isn't reached", [&] {
+        PackedTriangleBatch batch;
+        batch.push(flat);
+        auto hits = batch.possibly_hit_by
+            (Vector{0.25, 2, 0.25}, Vector{0.25, 1, 0.25});
+        return test_that(hits == 0u);
+    });
+    mark_it("rules out a triangle, hitting its plane far away", [&] {
+        PackedTriangleBatch batch;
+        batch.push(flat);
+        auto hits = batch.possibly_hit_by
+            (Vector{-3, 1, -5}, Vector{-3, -1, -5});
+        return test_that(hits == 0u);
+    });
+    mark_it("only reports lanes that were pushed", [&] {
+        PackedTriangleBatch batch;
+        batch.push(flat);
+        batch.push(flat);
+        auto hits = batch.possibly_hit_by
+            (Vector{0.25, 1, 0.25}, Vector{0.25, -1, 0.25});
+        return test_that(hits == 3u);
+    });
+    mark_it("never rules out a triangle that limit_with_intersection hits", [] {
+        std::default_random_engine rng{0x5eed};
+        std::uniform_real_distribution<Real> dist{-2, 2};
+        auto random_vector = [&] { return Vector{dist(rng), dist(rng), dist(rng)}; };
+        PackedTriangleBatch batch;
+        for (int i = 0; i != 4000; ++i) {
+            auto a = random_vector();
+            auto b = random_vector();
+            auto c = random_vector();
+            // skip slivers, which the constructor may refuse
+            if (magnitude(cross(b - a, c - a)) < 0.5) continue;
+            TriangleSegment triangle{a, b, c};
+            auto from = random_vector();
+            auto to = from + random_vector()*0.5;
+            batch.clear();
+            batch.push(triangle);
+            bool hit = cul::is_solution
+                (triangle.limit_with_intersection(from, to).intersection);
+            if (hit && batch.possibly_hit_by(from, to) == 0)
+                { return test_that(false); }
+        }
+        return test_that(true);
+    });
+});
+
+return 1;
+} ();
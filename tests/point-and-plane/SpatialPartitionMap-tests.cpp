@@ -132,6 +132,87 @@ describe<SpatialPartitionMapHelpers<int>>
     // v "framework"
     // mark_it("fuck", [] { return test_that(false); });
 });
+describe<SpatialPartitionMapHelpers<int>>
+    ("SpatialPartitionMapHelpers ::compute_divisions").
+    depends_on<SpatialDivisionContainer<int>>()([]
+{
+    using Helpers = SpatialPartitionMapHelpers<int>;
+    using EntryContainer = Helpers::EntryContainer;
+
+    // a dense cluster, followed by a few sparse entries
+    EntryContainer container;
+    for (int i = 0; i != 100; ++i) {
+        container.emplace_back(i*0.001, i*0.001 + 0.0005, i);
+    }
+    for (int i = 0; i != 5; ++i) {
+        container.emplace_back(1. + i*2., 2. + i*2., 100 + i);
+    }
+    auto divisions = Helpers::compute_divisions(container, 10);
+    mark_it("always ends divisions with infinity", [&] {
+        return test_that(divisions.back() == k_inf);
+    });
+    mark_it("splits a dense cluster into many divisions", [&] {
+        auto in_cluster = std::count_if
+            (divisions.begin(), divisions.end(),
+             [] (Real div) { return div < 0.1; });
+        return test_that(in_cluster >= 8);
+    });
+    mark_it("places few divisions over sparse entries", [&] {
+        auto in_sparse = std::count_if
+            (divisions.begin(), divisions.end(),
+             [] (Real div) { return div >= 0.1 && div != k_inf; });
+        return test_that(in_sparse <= 1);
+    });
+    mark_it("does not split entries sharing a starting position", [&] {
+        EntryContainer same_start;
+        for (int i = 0; i != 40; ++i) {
+            same_start.emplace_back(0., 1., i);
+        }
+        auto same_start_divisions = Helpers::compute_divisions(same_start, 10);
+        return test_that(same_start_divisions.size() == 2);
+    });
+});
+
+describe<CoarseDivisionLevel>("CoarseDivisionLevel")([] {
+    std::vector<Real> positions;
+    for (int i = 0; i != 1000; ++i) {
+        positions.push_back(i*0.5);
+    }
+    CoarseDivisionLevel level;
+    level.build(positions.begin(), positions.end(),
+                [] (Real position) { return position; });
+    auto slice_lower_bound = [&] (Real value) {
+        auto [first, last] = level.slice_for_lower_bound(value, positions.size());
+        return std::lower_bound
+            (positions.begin() + first, positions.begin() + last, value);
+    };
+    auto slice_upper_bound = [&] (Real value) {
+        auto [first, last] = level.slice_for_upper_bound(value, positions.size());
+        return std::upper_bound
+            (positions.begin() + first, positions.begin() + last, value);
+    };
+    mark_it("is built for a large number of positions", [&] {
+        return test_that(!level.is_empty());
+    });
+    mark_it("agrees with a full lower bound search", [&] {
+        for (Real value : { -1., 0., 0.25, 31.5, 32., 250.25, 499.5, 600. }) {
+            auto expected = std::lower_bound
+                (positions.begin(), positions.end(), value);
+            if (slice_lower_bound(value) != expected)
+                { return test_that(false); }
+        }
+        return test_that(true);
+    });
+    mark_it("agrees with a full upper bound search", [&] {
+        for (Real value : { -1., 0., 0.25, 31.5, 32., 250.25, 499.5, 600. }) {
+            auto expected = std::upper_bound
+                (positions.begin(), positions.end(), value);
+            if (slice_upper_bound(value) != expected)
+                { return test_that(false); }
+        }
+        return test_that(true);
+    });
+});
 describe<SpatialPartitionMap>("SpatialPartitionMap").
     depends_on<SpatialPartitionMapHelpers<int>>()([]
 {
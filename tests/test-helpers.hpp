@@ -22,5 +22,19 @@
 
 #define mark_it mark_source_position(__LINE__, __FILE__).it
 
+#include "../src/TriangleLink.hpp"
+
 #include <ariajanke/cul/TreeTestSuite.hpp>
 
+#include <algorithm>
+
+/// @returns a small flat link, with a corner at r
+inline SharedPtr<const TriangleLink> make_triangle_link_near(const Vector & r) {
+    return make_shared<TriangleLink>
+        (r, r + Vector{1, 0, 0}, r + Vector{0, 0, 1});
+}
+
+template <typename ViewType>
+bool view_contains(const ViewType & view, const SharedPtr<const TriangleLink> & ptr)
+    { return std::find(view.begin(), view.end(), ptr) != view.end(); }
+